@@ -389,7 +389,7 @@ let package = Package(
         ),
         .target(
             name: "Netmap",
-            dependencies: ["CNetmap", "FreeBSDKit"]
+            dependencies: ["CNetmap", "Cpuset", "FreeBSDKit"]
         ),
         .target(
             name: "OpenCrypto",
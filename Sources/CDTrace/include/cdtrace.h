@@ -9,6 +9,7 @@
 
 #include <dtrace.h>
 #include <stdint.h>
+#include <stdatomic.h>
 #include <libproc.h>
 
 /*
@@ -518,6 +519,28 @@ static inline dtrace_probedesc_t *cdtrace_probedata_pdesc(const dtrace_probedata
     return data->dtpda_pdesc;
 }
 
+static inline uint16_t cdtrace_recdesc_format(const dtrace_recdesc_t *rec) {
+    return rec->dtrd_format;
+}
+
+/* Record action constants exported to Swift. */
+typedef enum {
+    CDTRACE_ACT_DIFEXPR = DTRACEACT_DIFEXPR,
+    CDTRACE_ACT_EXIT    = DTRACEACT_EXIT,
+    CDTRACE_ACT_PRINTF  = DTRACEACT_PRINTF,
+    CDTRACE_ACT_PRINTA  = DTRACEACT_PRINTA,
+    CDTRACE_ACT_SYSTEM  = DTRACEACT_SYSTEM,
+    CDTRACE_ACT_FREOPEN = DTRACEACT_FREOPEN,
+    CDTRACE_ACT_STACK   = DTRACEACT_STACK,
+    CDTRACE_ACT_USTACK  = DTRACEACT_USTACK,
+    CDTRACE_ACT_JSTACK  = DTRACEACT_JSTACK,
+    CDTRACE_ACT_SYM     = DTRACEACT_SYM,
+    CDTRACE_ACT_MOD     = DTRACEACT_MOD,
+    CDTRACE_ACT_USYM    = DTRACEACT_USYM,
+    CDTRACE_ACT_UMOD    = DTRACEACT_UMOD,
+    CDTRACE_ACT_UADDR   = DTRACEACT_UADDR,
+} cdtrace_act_kind_t;
+
 /*
  * Compile from file
  */
@@ -560,4 +583,23 @@ typedef enum {
     CDTRACE_BUFDATA_AGGLAST   = DTRACE_BUFDATA_AGGLAST
 } cdtrace_bufdata_flag_t;
 
+/*
+ * Single-producer/single-consumer queue indices. Each side owns one
+ * index: it publishes with a release store, and the other side reads
+ * it with an acquire load, so slot contents written before the store
+ * are visible after the load.
+ */
+
+static inline uint64_t cdtrace_index_load_acquire(const uint64_t *index) {
+    return atomic_load_explicit((_Atomic uint64_t *)(uintptr_t)index, memory_order_acquire);
+}
+
+static inline uint64_t cdtrace_index_load_relaxed(const uint64_t *index) {
+    return atomic_load_explicit((_Atomic uint64_t *)(uintptr_t)index, memory_order_relaxed);
+}
+
+static inline void cdtrace_index_store_release(uint64_t *index, uint64_t value) {
+    atomic_store_explicit((_Atomic uint64_t *)index, value, memory_order_release);
+}
+
 #endif /* CDTRACE_H */
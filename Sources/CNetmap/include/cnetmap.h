@@ -9,6 +9,7 @@
 #include <sys/types.h>
 #include <sys/ioctl.h>
 #include <sys/mman.h>
+#include <sys/eventfd.h>
 #include <net/if.h>
 #include <net/netmap.h>
 #include <net/netmap_user.h>
@@ -18,6 +19,7 @@
 #include <string.h>
 #include <errno.h>
 #include <stdatomic.h>
+#include <time.h>
 
 /*
  * Netmap API version
@@ -226,6 +228,12 @@ cnm_pkt_copy(const void *src, void *dst, int len) {
     nm_pkt_copy(src, dst, len);
 }
 
+/// Prefetch a buffer for reading
+static inline void
+cnm_prefetch(const void *addr) {
+    __builtin_prefetch(addr, 0, 3);
+}
+
 /*
  * Structure access helpers
  * (Using void* for Swift OpaquePointer compatibility)
@@ -805,6 +813,50 @@ cnm_csb_ktoa_kern_need_kick(const struct nm_csb_ktoa *csb) {
     return atomic_load_explicit((_Atomic uint32_t *)&csb->kern_need_kick, memory_order_relaxed);
 }
 
+/*
+ * CSB application-side sync protocol (see nm_sync_kloop_appl_write/read
+ * in netmap_virt.h). Ring updates must be visible before head moves, and
+ * ring reads must not be hoisted above the hwtail load.
+ */
+
+/// Publish cur then head; prior ring writes are released with head
+static inline void
+cnm_csb_appl_write(struct nm_csb_atok *atok, uint32_t cur, uint32_t head) {
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit((_Atomic uint32_t *)&atok->cur, cur, memory_order_relaxed);
+    atomic_store_explicit((_Atomic uint32_t *)&atok->head, head, memory_order_release);
+}
+
+/// Read hwtail then hwcur; later ring reads are ordered after hwtail
+static inline void
+cnm_csb_appl_read(const struct nm_csb_ktoa *ktoa, uint32_t *hwtail, uint32_t *hwcur) {
+    *hwtail = atomic_load_explicit((_Atomic uint32_t *)&ktoa->hwtail, memory_order_acquire);
+    *hwcur = atomic_load_explicit((_Atomic uint32_t *)&ktoa->hwcur, memory_order_acquire);
+}
+
+/// Store-load barrier for the need_kick double check
+static inline void
+cnm_csb_full_fence(void) {
+    atomic_thread_fence(memory_order_seq_cst);
+}
+
+/// Set the application's copy of tail; in CSB mode the kernel only
+/// reports hwtail through ktoa
+static inline void
+cnm_csb_ring_set_tail(void *ring_ptr, uint32_t tail) {
+    struct netmap_ring *ring = (struct netmap_ring *)ring_ptr;
+    *(volatile uint32_t *)(uintptr_t)&ring->tail = tail;
+}
+
+/// Create an eventfd for kloop kicks
+static inline int
+cnm_eventfd(unsigned int initval, int flags) {
+    return eventfd(initval, flags);
+}
+
+static const int CNM_EFD_NONBLOCK = EFD_NONBLOCK;
+static const int CNM_EFD_CLOEXEC = EFD_CLOEXEC;
+
 /*
  * OPT_SYNC_KLOOP_EVENTFDS - Eventfd notifications for kloop
  */
@@ -851,3 +903,144 @@ cnm_init_opt_sync_kloop_mode(struct nmreq_opt_sync_kloop_mode *mode,
     cnm_init_option(&mode->nro_opt, NETMAP_REQ_OPT_SYNC_KLOOP_MODE, 0);
     mode->mode = mode_flags;
 }
+
+/*
+ * Simulated memory region
+ *
+ * These helpers lay out netmap_if, netmap_ring and buffer memory the way
+ * the kernel does, so user-space code can drive rings without /dev/netmap.
+ * Fields the kernel owns are const in netmap.h and are written through casts.
+ */
+
+/// Size of a netmap_if with room for nrings ring offsets
+static inline size_t
+cnm_sim_if_size(uint32_t nrings) {
+    return sizeof(struct netmap_if) + nrings * sizeof(ssize_t);
+}
+
+/// Size of a netmap_ring with num_slots slots
+static inline size_t
+cnm_sim_ring_size(uint32_t num_slots) {
+    return sizeof(struct netmap_ring) + num_slots * sizeof(struct netmap_slot);
+}
+
+/// Initialize a netmap_if with no host rings
+static inline void
+cnm_sim_init_if(void *nifp_ptr, const char *name,
+                uint32_t tx_rings, uint32_t rx_rings) {
+    struct netmap_if *nifp = (struct netmap_if *)nifp_ptr;
+    strlcpy(nifp->ni_name, name, sizeof(nifp->ni_name));
+    *(uint32_t *)(uintptr_t)&nifp->ni_version = NETMAP_API;
+    *(uint32_t *)(uintptr_t)&nifp->ni_flags = 0;
+    *(uint32_t *)(uintptr_t)&nifp->ni_tx_rings = tx_rings;
+    *(uint32_t *)(uintptr_t)&nifp->ni_rx_rings = rx_rings;
+    *(uint32_t *)(uintptr_t)&nifp->ni_host_tx_rings = 0;
+    *(uint32_t *)(uintptr_t)&nifp->ni_host_rx_rings = 0;
+    nifp->ni_bufs_head = 0;
+}
+
+/// Set the offset of ring index (TX rings first, then RX) from nifp
+static inline void
+cnm_sim_set_ring_ofs(void *nifp_ptr, uint32_t index, ssize_t ofs) {
+    struct netmap_if *nifp = (struct netmap_if *)nifp_ptr;
+    *(ssize_t *)(uintptr_t)&nifp->ring_ofs[index] = ofs;
+}
+
+/// Initialize a ring whose slots own buffers first_buf ..< first_buf + num_slots
+/// dir is 0 for TX and 1 for RX. TX rings start with every slot but one
+/// free; RX rings start empty.
+static inline void
+cnm_sim_init_ring(void *ring_ptr, int64_t buf_ofs, uint32_t num_slots,
+                  uint32_t buf_size, uint16_t ringid, uint16_t dir,
+                  uint32_t first_buf) {
+    struct netmap_ring *ring = (struct netmap_ring *)ring_ptr;
+    memset(ring, 0, cnm_sim_ring_size(num_slots));
+    *(int64_t *)(uintptr_t)&ring->buf_ofs = buf_ofs;
+    *(uint32_t *)(uintptr_t)&ring->num_slots = num_slots;
+    *(uint32_t *)(uintptr_t)&ring->nr_buf_size = buf_size;
+    *(uint16_t *)(uintptr_t)&ring->ringid = ringid;
+    *(uint16_t *)(uintptr_t)&ring->dir = dir;
+    ring->head = 0;
+    ring->cur = 0;
+    *(uint32_t *)(uintptr_t)&ring->tail = dir == 0 ? num_slots - 1 : 0;
+    for (uint32_t i = 0; i < num_slots; i++) {
+        ring->slot[i].buf_idx = first_buf + i;
+    }
+}
+
+/// Set the kernel-owned tail pointer
+static inline void
+cnm_sim_set_tail(void *ring_ptr, uint32_t tail) {
+    struct netmap_ring *ring = (struct netmap_ring *)ring_ptr;
+    *(volatile uint32_t *)(uintptr_t)&ring->tail = tail;
+}
+
+/// Initialize a registration result for a simulated port
+static inline void
+cnm_sim_init_register(struct nmreq_register *reg, uint64_t offset,
+                      uint64_t memsize, uint16_t mem_id,
+                      uint32_t tx_rings, uint32_t rx_rings, uint32_t num_slots) {
+    memset(reg, 0, sizeof(*reg));
+    reg->nr_offset = offset;
+    reg->nr_memsize = memsize;
+    reg->nr_mem_id = mem_id;
+    reg->nr_tx_rings = tx_rings;
+    reg->nr_rx_rings = rx_rings;
+    reg->nr_tx_slots = num_slots;
+    reg->nr_rx_slots = num_slots;
+    reg->nr_mode = NR_REG_ALL_NIC;
+}
+
+/// Kernel-side CSB read for the simulated sync loop: head then cur
+static inline void
+cnm_sim_csb_read(const struct nm_csb_atok *atok, uint32_t *head, uint32_t *cur) {
+    *head = atomic_load_explicit((_Atomic uint32_t *)&atok->head, memory_order_acquire);
+    *cur = atomic_load_explicit((_Atomic uint32_t *)&atok->cur, memory_order_relaxed);
+}
+
+/// Kernel-side CSB write for the simulated sync loop: hwcur then hwtail
+static inline void
+cnm_sim_csb_write(struct nm_csb_ktoa *ktoa, uint32_t hwcur, uint32_t hwtail) {
+    atomic_store_explicit((_Atomic uint32_t *)&ktoa->hwcur, hwcur, memory_order_relaxed);
+    atomic_store_explicit((_Atomic uint32_t *)&ktoa->hwtail, hwtail, memory_order_release);
+}
+
+/// Kernel-side need-kick flag for the simulated sync loop
+static inline void
+cnm_sim_csb_set_kern_need_kick(struct nm_csb_ktoa *ktoa, uint32_t need_kick) {
+    atomic_store_explicit((_Atomic uint32_t *)&ktoa->kern_need_kick, need_kick, memory_order_relaxed);
+}
+
+/*
+ * Single-writer statistics counters. The owning thread updates with a
+ * relaxed load and store (no locked read-modify-write); readers on other
+ * threads load relaxed and see a recent value.
+ */
+
+static inline void
+cnm_counter_add(uint64_t *counter, uint64_t value) {
+    _Atomic uint64_t *c = (_Atomic uint64_t *)counter;
+    atomic_store_explicit(c, atomic_load_explicit(c, memory_order_relaxed) + value,
+                          memory_order_relaxed);
+}
+
+static inline void
+cnm_counter_max(uint64_t *counter, uint64_t value) {
+    _Atomic uint64_t *c = (_Atomic uint64_t *)counter;
+    if (value > atomic_load_explicit(c, memory_order_relaxed)) {
+        atomic_store_explicit(c, value, memory_order_relaxed);
+    }
+}
+
+static inline uint64_t
+cnm_counter_load(const uint64_t *counter) {
+    return atomic_load_explicit((_Atomic uint64_t *)(uintptr_t)counter, memory_order_relaxed);
+}
+
+/// Monotonic time in nanoseconds
+static inline uint64_t
+cnm_monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
@@ -19,7 +19,7 @@ import Foundation
 /// what the script's grouping expression evaluated to. The wrapper
 /// preserves the underlying type when it can recognize it; anything
 /// else falls through as raw bytes.
-public enum AggregationKey: Sendable, Equatable {
+public enum AggregationKey: Sendable, Hashable {
     case int(Int64)
     case string(String)
     case bytes([UInt8])
@@ -38,47 +38,93 @@ public enum AggregationKey: Sendable, Equatable {
 
 /// The summarized value of an aggregation row.
 ///
-/// Scalar aggregations (`count`, `sum`, `min`, `max`, `avg`, `stddev`)
-/// are decoded into `Int64`. Bucketed aggregations (`quantize`,
-/// `lquantize`, `llquantize`) are surfaced as raw bytes for now —
-/// follow-up work will decode their bucket layouts.
-///
-/// - Note: `stddev` currently carries the rolling **mean**, not the
-///   computed standard deviation. The kernel records (count, sum,
-///   sum-of-squares) but the sqrt-over-second-moment math is left to
-///   a follow-up; the value here is reported so callers at least see
-///   something useful, and the field name will become accurate when
-///   that math lands. Use the `quantize` family if you want the full
-///   distribution today.
+/// Scalar aggregations (`count`, `sum`, `min`, `max`, `avg`) are
+/// decoded into `Int64`. `stddev` keeps the kernel's (count, sum,
+/// sum-of-squares) moments so it can be merged, and bucketed
+/// aggregations (`quantize`, `lquantize`, `llquantize`) are decoded
+/// into an ``AggregationHistogram`` with bucket bounds.
 public enum AggregationValue: Sendable, Equatable {
     case count(Int64)
     case sum(Int64)
     case min(Int64)
     case max(Int64)
     case avg(Int64)
-    case stddev(Int64)
-    /// A `quantize` (power-of-2 histogram) value, as raw bytes. Decode
-    /// with libdtrace until typed support lands.
-    case quantize(Data)
-    /// An `lquantize` (linear histogram) value, as raw bytes.
-    case lquantize(Data)
-    /// An `llquantize` (log-linear histogram) value, as raw bytes.
-    case llquantize(Data)
+    /// A `stddev` value. ``AggregationMoments/standardDeviation`` is
+    /// the number `printa` shows.
+    case stddev(AggregationMoments)
+    /// A `quantize` (power-of-2 histogram) value.
+    case quantize(AggregationHistogram)
+    /// An `lquantize` (linear histogram) value.
+    case lquantize(AggregationHistogram)
+    /// An `llquantize` (log-linear histogram) value.
+    case llquantize(AggregationHistogram)
     /// An aggregation kind we did not recognize, with the raw payload.
     case unknown(action: UInt16, Data)
 
     /// Convenience: pull a scalar Int64 out of any of the integer-shaped
-    /// cases (count/sum/min/max/avg/stddev). Returns `nil` for the
-    /// histogram cases.
+    /// cases (count/sum/min/max/avg/stddev). `stddev` yields the
+    /// standard deviation truncated to an integer, as `printa` prints
+    /// it. Returns `nil` for the histogram cases.
     public var asInt: Int64? {
         switch self {
         case .count(let v), .sum(let v), .min(let v),
-             .max(let v),   .avg(let v), .stddev(let v):
+             .max(let v),   .avg(let v):
             return v
+        case .stddev(let moments):
+            return Int64(moments.standardDeviation)
+        default:
+            return nil
+        }
+    }
+
+    /// The histogram of a `quantize`, `lquantize`, or `llquantize`
+    /// value; `nil` for every other case.
+    public var histogram: AggregationHistogram? {
+        switch self {
+        case .quantize(let h), .lquantize(let h), .llquantize(let h):
+            return h
         default:
             return nil
         }
     }
+
+    /// Combines two snapshots of the same aggregation row.
+    ///
+    /// Counts and sums add, `min`/`max` keep the extreme, `stddev`
+    /// moments and histogram buckets add. `avg` only carries the
+    /// finished mean, which cannot be combined without the counts
+    /// behind it, so it — like mismatched kinds or histogram layouts
+    /// and unknown payloads — returns `nil`.
+    public func merging(_ other: AggregationValue) -> AggregationValue? {
+        switch (self, other) {
+        case (.count(let a), .count(let b)):           return .count(a &+ b)
+        case (.sum(let a), .sum(let b)):               return .sum(a &+ b)
+        case (.min(let a), .min(let b)):               return .min(Swift.min(a, b))
+        case (.max(let a), .max(let b)):               return .max(Swift.max(a, b))
+        case (.stddev(let a), .stddev(let b)):         return .stddev(a.merging(b))
+        case (.quantize(let a), .quantize(let b)):     return a.merging(b).map { .quantize($0) }
+        case (.lquantize(let a), .lquantize(let b)):   return a.merging(b).map { .lquantize($0) }
+        case (.llquantize(let a), .llquantize(let b)): return a.merging(b).map { .llquantize($0) }
+        default:                                       return nil
+        }
+    }
+
+    /// The change from an earlier snapshot of the same row to this one.
+    ///
+    /// Counts, sums, `stddev` moments, and histogram buckets subtract.
+    /// `min`, `max`, and `avg` are not differences of anything and
+    /// return `nil`, as do mismatched kinds and histogram layouts.
+    public func subtracting(_ earlier: AggregationValue) -> AggregationValue? {
+        switch (self, earlier) {
+        case (.count(let a), .count(let b)):           return .count(a &- b)
+        case (.sum(let a), .sum(let b)):               return .sum(a &- b)
+        case (.stddev(let a), .stddev(let b)):         return .stddev(a.subtracting(b))
+        case (.quantize(let a), .quantize(let b)):     return a.subtracting(b).map { .quantize($0) }
+        case (.lquantize(let a), .lquantize(let b)):   return a.subtracting(b).map { .lquantize($0) }
+        case (.llquantize(let a), .llquantize(let b)): return a.subtracting(b).map { .llquantize($0) }
+        default:                                       return nil
+        }
+    }
 }
 
 // MARK: - Aggregation record
@@ -107,6 +153,49 @@ public struct AggregationRecord: Sendable, Equatable {
     }
 }
 
+// MARK: - Merging
+
+extension AggregationRecord {
+
+    /// Combines several snapshots into one, row by row.
+    ///
+    /// Rows are matched by aggregation name and keys and combined with
+    /// ``AggregationValue/merging(_:)``; a row present in only some
+    /// snapshots is carried as is. Where values cannot be combined
+    /// (`avg`, or a kind mismatch) the later snapshot's row wins.
+    ///
+    /// ```swift
+    /// // Fold per-host captures into one latency distribution
+    /// let combined = AggregationRecord.merge([hostA, hostB])
+    /// ```
+    ///
+    /// - Parameter snapshots: Results of ``DTraceSession/snapshot(sorted:)``.
+    /// - Returns: One row per distinct (name, keys), in order of first
+    ///   appearance.
+    public static func merge(_ snapshots: [[AggregationRecord]]) -> [AggregationRecord] {
+        struct RowID: Hashable {
+            let name: String
+            let keys: [AggregationKey]
+        }
+
+        var merged: [AggregationRecord] = []
+        var index: [RowID: Int] = [:]
+        for snapshot in snapshots {
+            for record in snapshot {
+                let id = RowID(name: record.name, keys: record.keys)
+                guard let i = index[id] else {
+                    index[id] = merged.count
+                    merged.append(record)
+                    continue
+                }
+                let value = merged[i].value.merging(record.value) ?? record.value
+                merged[i] = AggregationRecord(name: record.name, keys: record.keys, value: value)
+            }
+        }
+        return merged
+    }
+}
+
 // MARK: - Decoder
 
 extension AggregationRecord {
@@ -240,20 +329,23 @@ extension AggregationRecord {
         case UInt32(CDTRACE_AGG_AVG.rawValue):
             return .avg(loadAvg())
         case UInt32(CDTRACE_AGG_STDDEV.rawValue):
-            // The stddev record is laid out as (count, sum, sum_of_squares).
-            // The full sample standard deviation needs sqrt over the
-            // second moment, which we don't compute today. Surface the
-            // rolling mean (which matches the first column libdtrace
-            // prints) so callers at least see something they can index
-            // by, and document that the value is the mean, not the
-            // deviation.
-            return .stddev(loadAvg())
+            // The stddev record is laid out as (count, sum, sum_of_squares),
+            // with the sum of squares kept as 128 bits.
+            return .stddev(AggregationMoments.decode(raw, size: size))
         case UInt32(CDTRACE_AGG_QUANTIZE.rawValue):
-            return .quantize(loadBytes())
+            return .quantize(AggregationHistogram.decodeQuantize(raw, size: size))
         case UInt32(CDTRACE_AGG_LQUANTIZE.rawValue):
-            return .lquantize(loadBytes())
+            // A record too short for its parameter word is malformed;
+            // hand it back raw rather than guessing a layout.
+            guard let histogram = AggregationHistogram.decodeLinear(raw, size: size) else {
+                return .unknown(action: action, loadBytes())
+            }
+            return .lquantize(histogram)
         case UInt32(CDTRACE_AGG_LLQUANTIZE.rawValue):
-            return .llquantize(loadBytes())
+            guard let histogram = AggregationHistogram.decodeLogLinear(raw, size: size) else {
+                return .unknown(action: action, loadBytes())
+            }
+            return .llquantize(histogram)
         default:
             return .unknown(action: action, loadBytes())
         }
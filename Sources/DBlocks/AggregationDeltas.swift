@@ -0,0 +1,348 @@
+/*
+ * Copyright (c) 2026 Kory Heard
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+import DTraceCore
+import CDTrace
+import Foundation
+
+// MARK: - Delta row
+
+/// One aggregation row that changed since the previous scrape.
+public struct AggregationDelta: Sendable, Equatable {
+    /// Name of the aggregation. Shared between every row of the same
+    /// aggregation rather than rebuilt per row.
+    public let name: String
+
+    /// Key columns, decoded once when the row first appears.
+    public let keys: [AggregationKey]
+
+    /// The row's value: cumulative, or accumulated since the previous
+    /// scrape when the snapshotter clears rows.
+    public let value: AggregationValue
+
+    /// What changed since the previous scrape. Counts, sums, `stddev`
+    /// moments, and histogram buckets are differences; `min`, `max`,
+    /// and `avg` carry the current value. Equal to `value` for new
+    /// rows and when the snapshotter clears rows.
+    public let change: AggregationValue
+
+    /// Whether this is the first scrape that saw the row.
+    public let isNew: Bool
+}
+
+// MARK: - Snapshotter
+
+/// Scrapes a session's aggregations repeatedly, reporting only the
+/// rows that changed.
+///
+/// ``DTraceSession/snapshot(sorted:)`` decodes every row on every
+/// call, building a name `String` and a key array for each. That is
+/// fine for a one-off report but dominates the cost of a once-a-second
+/// exporter over aggregations with many keys, most of which did not
+/// move. A snapshotter keeps per-row state between scrapes instead:
+///
+/// - Aggregation names and record layouts are interned once per
+///   aggregation.
+/// - Each row's raw key bytes index an open-addressing table; keys are
+///   decoded only the first time a row is seen.
+/// - The previous raw value bytes are kept in a flat arena and compared
+///   with `memcmp`, so an unchanged row costs one hash, one key compare
+///   and one value compare, with no allocation and no decoding.
+///
+/// ```swift
+/// let snapshotter = AggregationSnapshotter()
+/// while running {
+///     session.process(for: 1.0)
+///     for row in try snapshotter.next(from: session) {
+///         export(row.name, row.keys, row.change)
+///     }
+/// }
+/// ```
+///
+/// ## Clearing
+///
+/// With `clearing: true` every reported row is cleared in the
+/// library's aggregation buffer as it is read, the way `printa`
+/// followed by `clear()` works in D. Each scrape then sees only what
+/// accumulated since the previous one, so `count` and `sum` rows come
+/// out directly as per-interval rates and `min`/`max`/`avg`/`quantize`
+/// describe the interval rather than the whole run.
+///
+/// Rows removed from the buffer (for example by `trunc()`) keep their
+/// table entry until ``reset()``. A snapshotter must only be used with
+/// one session, from one thread at a time.
+public final class AggregationSnapshotter {
+
+    /// Whether rows are cleared after each scrape.
+    public let clearing: Bool
+
+    /// Location of one record in a row's data buffer.
+    struct Field {
+        let action: UInt16
+        let offset: Int
+        let size: Int
+    }
+
+    /// Name and record layout of one aggregation.
+    struct Aggregation {
+        let name: String
+        let keys: [Field]
+        let value: Field
+    }
+
+    /// One tracked row. Key and value bytes live in the arenas.
+    private struct Row {
+        let aggregation: Int
+        let hash: Int
+        let keyStart: Int
+        let keyLength: Int
+        let valueStart: Int
+        let valueLength: Int
+        let keys: [AggregationKey]
+    }
+
+    private var aggregations: [Aggregation] = []
+    private var aggregationIndex: [UnsafeRawPointer: Int] = [:]
+
+    private var rows: [Row] = []
+    private var slots: [Int32]
+    private var keyArena: [UInt8] = []
+    private var valueArena: [UInt8] = []
+    private var scratch: [UInt8] = []
+    private var changes: [AggregationDelta] = []
+
+    /// Creates an empty snapshotter.
+    ///
+    /// - Parameters:
+    ///   - clearing: Clear each reported row after reading it, so every
+    ///     scrape reports per-interval values.
+    ///   - capacity: Expected number of rows, to size the table.
+    public init(clearing: Bool = false, capacity: Int = 1024) {
+        self.clearing = clearing
+        var size = 16
+        while size < capacity * 2 { size <<= 1 }
+        self.slots = [Int32](repeating: -1, count: size)
+    }
+
+    /// Number of rows being tracked.
+    public var rowCount: Int {
+        rows.count
+    }
+
+    /// Forgets every row, so the next scrape reports all rows as new.
+    public func reset() {
+        aggregations.removeAll()
+        aggregationIndex.removeAll()
+        rows.removeAll()
+        keyArena.removeAll()
+        valueArena.removeAll()
+        for i in slots.indices { slots[i] = -1 }
+    }
+
+    // MARK: Scraping
+
+    /// Snapshots the session's aggregations and returns the rows that
+    /// changed since the previous call.
+    ///
+    /// The first call reports every row as new.
+    ///
+    /// - Parameter session: The session to scrape. Must be the same
+    ///   session on every call.
+    /// - Returns: Changed rows, in the library's unsorted walk order.
+    /// - Throws: `DTraceCoreError.aggregateFailed` if the snap or walk
+    ///   fails.
+    public func next(from session: borrowing DTraceSession) throws -> [AggregationDelta] {
+        try session.walkAggregationRows(sorted: false) { [self] aggdata in
+            guard let desc = cdtrace_aggdata_desc(aggdata),
+                  let data = cdtrace_aggdata_data(aggdata),
+                  let aggregation = intern(descriptor: desc) else {
+                return .next
+            }
+            return observe(aggregation: aggregation, buffer: UnsafeRawPointer(data))
+        }
+        return finishScrape()
+    }
+
+    /// Interns an aggregation description, decoding its name and record
+    /// layout the first time it is seen.
+    private func intern(descriptor desc: UnsafeMutablePointer<dtrace_aggdesc_t>) -> Int? {
+        let key = UnsafeRawPointer(desc)
+        if let index = aggregationIndex[key] {
+            return index
+        }
+
+        let nrecs = Int(cdtrace_aggdesc_nrecs(desc))
+        guard nrecs >= 1 else { return nil }
+        let fields = (0..<nrecs).compactMap { i -> Field? in
+            guard let rec = cdtrace_aggdesc_rec(desc, Int32(i)) else { return nil }
+            return Field(
+                action: cdtrace_recdesc_action(rec),
+                offset: Int(cdtrace_recdesc_offset(rec)),
+                size: Int(cdtrace_recdesc_size(rec))
+            )
+        }
+        guard fields.count == nrecs else { return nil }
+
+        let name = cdtrace_aggdesc_name(desc).map { String(cString: $0) } ?? ""
+        let index = intern(Aggregation(name: name, keys: Array(fields.dropLast()), value: fields[nrecs - 1]))
+        aggregationIndex[key] = index
+        return index
+    }
+
+    /// Registers an aggregation layout. Exposed so tests can drive the
+    /// table without a live handle.
+    func intern(_ aggregation: Aggregation) -> Int {
+        aggregations.append(aggregation)
+        return aggregations.count - 1
+    }
+
+    /// Compares one row against the table and records it if it changed.
+    ///
+    /// - Returns: `.clear` if the row should be cleared, else `.next`.
+    func observe(aggregation index: Int, buffer: UnsafeRawPointer) -> DTraceHandle.AggregateWalkResult {
+        let aggregation = aggregations[index]
+
+        scratch.removeAll(keepingCapacity: true)
+        for field in aggregation.keys {
+            scratch.append(contentsOf: UnsafeRawBufferPointer(start: buffer + field.offset, count: field.size))
+        }
+        let hash = scratch.withUnsafeBytes { bytes -> Int in
+            var hasher = Hasher()
+            hasher.combine(index)
+            hasher.combine(bytes: bytes)
+            return hasher.finalize()
+        }
+
+        let field = aggregation.value
+        let current = UnsafeRawBufferPointer(start: buffer + field.offset, count: field.size)
+
+        guard let rowIndex = find(aggregation: index, hash: hash) else {
+            let keys = aggregation.keys.map {
+                AggregationRecord.decodeKey(action: $0.action, offset: $0.offset, size: $0.size, buffer: buffer)
+            }
+            let row = Row(
+                aggregation: index,
+                hash: hash,
+                keyStart: keyArena.count,
+                keyLength: scratch.count,
+                valueStart: valueArena.count,
+                valueLength: field.size,
+                keys: keys
+            )
+            keyArena.append(contentsOf: scratch)
+            valueArena.append(contentsOf: current)
+            insert(row)
+
+            let value = AggregationRecord.decodeValue(action: field.action, offset: field.offset, size: field.size, buffer: buffer)
+            changes.append(AggregationDelta(name: aggregation.name, keys: keys, value: value, change: value, isNew: true))
+            return finishRow(rows.count - 1)
+        }
+
+        let row = rows[rowIndex]
+        let unchanged = valueArena.withUnsafeBytes { arena in
+            row.valueLength == field.size && memcmp(arena.baseAddress! + row.valueStart, current.baseAddress!, field.size) == 0
+        }
+        guard !unchanged else { return .next }
+
+        let value = AggregationRecord.decodeValue(action: field.action, offset: field.offset, size: field.size, buffer: buffer)
+        let change: AggregationValue
+        if clearing || row.valueLength != field.size {
+            change = value
+        } else {
+            let previous = valueArena.withUnsafeBytes { arena in
+                AggregationRecord.decodeValue(action: field.action, offset: row.valueStart, size: row.valueLength, buffer: arena.baseAddress!)
+            }
+            change = value.subtracting(previous) ?? value
+        }
+        changes.append(AggregationDelta(name: aggregation.name, keys: row.keys, value: value, change: change, isNew: false))
+
+        if row.valueLength == field.size {
+            valueArena.withUnsafeMutableBytes { arena in
+                arena.baseAddress!.advanced(by: row.valueStart).copyMemory(from: current.baseAddress!, byteCount: field.size)
+            }
+        } else {
+            // A layout change (never expected within one session): move
+            // the value to a fresh slot of the arena.
+            rows[rowIndex] = Row(
+                aggregation: row.aggregation, hash: row.hash,
+                keyStart: row.keyStart, keyLength: row.keyLength,
+                valueStart: valueArena.count, valueLength: field.size,
+                keys: row.keys
+            )
+            valueArena.append(contentsOf: current)
+        }
+        return finishRow(rowIndex)
+    }
+
+    /// In clearing mode, replaces the stored value with what the row
+    /// looks like once cleared and asks the walk to clear it.
+    private func finishRow(_ rowIndex: Int) -> DTraceHandle.AggregateWalkResult {
+        guard clearing else { return .next }
+        let row = rows[rowIndex]
+        let action = aggregations[row.aggregation].value.action
+        valueArena.withUnsafeMutableBytes { arena in
+            // libdtrace zeroes a cleared row, keeping the parameter word
+            // of lquantize() and llquantize() records.
+            var start = row.valueStart
+            var length = row.valueLength
+            if (action == UInt16(CDTRACE_AGG_LQUANTIZE.rawValue) ||
+                action == UInt16(CDTRACE_AGG_LLQUANTIZE.rawValue)), length >= 8 {
+                start += 8
+                length -= 8
+            }
+            memset(arena.baseAddress! + start, 0, length)
+        }
+        return .clear
+    }
+
+    /// Returns and resets the rows collected during a walk.
+    func finishScrape() -> [AggregationDelta] {
+        defer { changes.removeAll(keepingCapacity: true) }
+        return changes
+    }
+
+    // MARK: Table
+
+    private func find(aggregation: Int, hash: Int) -> Int? {
+        let mask = slots.count - 1
+        var slot = hash & mask
+        while true {
+            let index = slots[slot]
+            if index < 0 { return nil }
+            let row = rows[Int(index)]
+            if row.hash == hash, row.aggregation == aggregation, row.keyLength == scratch.count {
+                let equal = keyArena.withUnsafeBytes { arena in
+                    scratch.withUnsafeBytes { key in
+                        key.count == 0 || memcmp(arena.baseAddress! + row.keyStart, key.baseAddress!, key.count) == 0
+                    }
+                }
+                if equal { return Int(index) }
+            }
+            slot = (slot + 1) & mask
+        }
+    }
+
+    private func insert(_ row: Row) {
+        rows.append(row)
+        if rows.count * 2 > slots.count {
+            slots = [Int32](repeating: -1, count: slots.count * 2)
+            for (index, existing) in rows.enumerated() {
+                place(existing.hash, at: Int32(index))
+            }
+        } else {
+            place(row.hash, at: Int32(rows.count - 1))
+        }
+    }
+
+    private func place(_ hash: Int, at index: Int32) {
+        let mask = slots.count - 1
+        var slot = hash & mask
+        while slots[slot] >= 0 {
+            slot = (slot + 1) & mask
+        }
+        slots[slot] = index
+    }
+}
@@ -0,0 +1,351 @@
+/*
+ * Copyright (c) 2026 Kory Heard
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+import Foundation
+
+// MARK: - Histogram
+
+/// A decoded `quantize`, `lquantize`, or `llquantize` aggregation value.
+///
+/// The kernel stores each histogram as a flat array of `int64` bucket
+/// counts; `lquantize` and `llquantize` prepend one word encoding
+/// their parameters. The bucket *bounds* are never stored — libdtrace
+/// recomputes them from the aggregation kind and parameters when it
+/// prints. This type does the same, so callers get bucket ranges,
+/// percentile estimates, and merges without going through `printa`.
+///
+/// ```swift
+/// for record in try session.snapshot() {
+///     guard case .quantize(let latency) = record.value else { continue }
+///     print(record.name,
+///           "p50:", latency.percentile(50) ?? 0,
+///           "p99:", latency.percentile(99) ?? 0)
+/// }
+/// ```
+///
+/// Histograms with the same layout merge losslessly by adding counts,
+/// so snapshots taken from several sessions (or several CPUs' worth of
+/// runs) can be combined before estimating percentiles.
+public struct AggregationHistogram: Sendable, Equatable {
+
+    /// How values map to buckets. Fixed when the D script is compiled.
+    public enum Layout: Sendable, Equatable {
+        /// `quantize()`: power-of-two buckets, mirrored for negative
+        /// values, with a single bucket for zero.
+        case quantize
+
+        /// `lquantize(expr, base, limit, step)`: an underflow bucket,
+        /// `levels` buckets of width `step` starting at `base`, and an
+        /// overflow bucket.
+        case linear(base: Int32, step: UInt16, levels: UInt16)
+
+        /// `llquantize(expr, factor, low, high, steps)`: an underflow
+        /// bucket below `factor^low`, up to `steps` linear buckets per
+        /// power of `factor` through `factor^(high+1)`, and an overflow
+        /// bucket.
+        case logLinear(factor: UInt16, low: UInt16, high: UInt16, steps: UInt16)
+    }
+
+    /// One bucket: the inclusive range of values it counts.
+    ///
+    /// Open-ended buckets (values below the first bound or above the
+    /// last) extend to `Int64.min` or `Int64.max`.
+    public struct Bucket: Sendable, Equatable {
+        public let range: ClosedRange<Int64>
+        public let count: Int64
+    }
+
+    /// The bucket layout.
+    public let layout: Layout
+
+    /// Bucket counts in the kernel's order, lowest range first.
+    public private(set) var counts: [Int64]
+
+    /// Creates a histogram from bucket counts.
+    ///
+    /// - Parameters:
+    ///   - layout: The bucket layout.
+    ///   - counts: One count per bucket of `layout`. Missing trailing
+    ///     buckets are treated as empty; extra counts are dropped.
+    public init(layout: Layout, counts: [Int64]) {
+        self.layout = layout
+        let expected = Self.lowerBounds(for: layout).count
+        if counts.count == expected {
+            self.counts = counts
+        } else {
+            self.counts = Array(counts.prefix(expected))
+                + Array(repeating: 0, count: Swift.max(expected - counts.count, 0))
+        }
+    }
+
+    /// Every bucket, empty ones included.
+    public var buckets: [Bucket] {
+        let lower = Self.lowerBounds(for: layout)
+        return counts.indices.map { i in
+            let upper = i + 1 < lower.count ? lower[i + 1] - 1 : Int64.max
+            return Bucket(range: lower[i]...upper, count: counts[i])
+        }
+    }
+
+    /// Buckets with a non-zero count, which is what `printa` shows
+    /// (minus the zero-count rows it adds for context).
+    public var nonEmptyBuckets: [Bucket] {
+        buckets.filter { $0.count != 0 }
+    }
+
+    /// Total number of values recorded.
+    public var totalCount: Int64 {
+        counts.reduce(0, &+)
+    }
+
+    // MARK: Percentiles
+
+    /// Estimates the value below which `percent` of recorded values
+    /// fall.
+    ///
+    /// The bucket holding that rank is found exactly; the position
+    /// inside it is interpolated linearly, so the estimate is never
+    /// outside the bucket's range. Open-ended buckets report their
+    /// finite bound.
+    ///
+    /// - Parameter percent: Percentile in 0...100.
+    /// - Returns: The estimate, or `nil` if the histogram is empty.
+    public func percentile(_ percent: Double) -> Int64? {
+        let total = totalCount
+        guard total > 0 else { return nil }
+
+        let clamped = Swift.min(Swift.max(percent, 0), 100)
+        let rank = Swift.max(clamped / 100 * Double(total), 1)
+
+        var seen: Int64 = 0
+        for bucket in buckets where bucket.count > 0 {
+            let before = Double(seen)
+            seen += bucket.count
+            guard Double(seen) >= rank else { continue }
+
+            let range = bucket.range
+            if range.lowerBound == Int64.min { return range.upperBound }
+            if range.upperBound == Int64.max { return range.lowerBound }
+
+            let fraction = (rank - before) / Double(bucket.count)
+            let width = Double(range.upperBound) - Double(range.lowerBound)
+            return range.lowerBound + Int64((fraction * width).rounded(.down))
+        }
+        return buckets.last(where: { $0.count > 0 })?.range.lowerBound
+    }
+
+    // MARK: Merging
+
+    /// Adds another histogram's counts to this one.
+    ///
+    /// - Parameter other: A histogram from the same aggregation.
+    /// - Returns: The merged histogram, or `nil` if the layouts differ
+    ///   and the buckets therefore do not line up.
+    public func merging(_ other: AggregationHistogram) -> AggregationHistogram? {
+        guard layout == other.layout else { return nil }
+        var merged = self
+        for i in merged.counts.indices {
+            merged.counts[i] &+= other.counts[i]
+        }
+        return merged
+    }
+
+    /// Removes an earlier snapshot's counts from this one.
+    ///
+    /// - Parameter earlier: A previous snapshot of the same aggregation row.
+    /// - Returns: The per-bucket change, or `nil` if the layouts differ.
+    public func subtracting(_ earlier: AggregationHistogram) -> AggregationHistogram? {
+        guard layout == earlier.layout else { return nil }
+        var delta = self
+        for i in delta.counts.indices {
+            delta.counts[i] &-= earlier.counts[i]
+        }
+        return delta
+    }
+
+    // MARK: Bucket bounds
+
+    /// `DTRACE_QUANTIZE_NBUCKETS`: 63 negative, one zero, 63 positive.
+    static let quantizeBucketCount = 127
+
+    /// `DTRACE_QUANTIZE_ZEROBUCKET`.
+    static let quantizeZeroBucket = 63
+
+    /// Inclusive lower bound of every bucket of a layout, following the
+    /// kernel's `dtrace_aggregate_*quantize` bucketing.
+    static func lowerBounds(for layout: Layout) -> [Int64] {
+        switch layout {
+        case .quantize:
+            // Negative bucket i holds (-2^(63-i), -2^(62-i)]; positive
+            // bucket i holds [2^(i-64), 2^(i-63)), with 63 holding zero.
+            return (0..<quantizeBucketCount).map { i in
+                if i == 0 { return Int64.min }
+                if i < quantizeZeroBucket {
+                    return -(Int64(1) << Int64(63 - i)) + 1
+                }
+                if i == quantizeZeroBucket { return 0 }
+                return Int64(1) << Int64(i - quantizeZeroBucket - 1)
+            }
+
+        case .linear(let base, let step, let levels):
+            var bounds: [Int64] = [Int64.min]
+            for level in 0...Int64(levels) {
+                bounds.append(Int64(base) + level * Int64(step))
+            }
+            return bounds
+
+        case .logLinear(let factor, let low, let high, let steps):
+            var bounds: [Int64] = [Int64.min]
+            let factor = Int64(factor)
+            guard factor >= 2, steps > 0 else { return bounds }
+
+            var this: Int64 = 1
+            for _ in 0..<low {
+                let (next, overflow) = this.multipliedReportingOverflow(by: factor)
+                guard !overflow else { return bounds }
+                this = next
+            }
+
+            // Each order of magnitude [last, this) is split into at most
+            // `steps` buckets; the ones below `last` belong to the
+            // previous order and are skipped.
+            var last = this
+            var (upper, overflow) = this.multipliedReportingOverflow(by: factor)
+            var order = Int(low)
+            while !overflow, order <= Int(high) {
+                let width = upper / Swift.min(upper, Int64(steps))
+                var value = last
+                while value < upper {
+                    bounds.append(value)
+                    value += width
+                }
+                last = upper
+                (upper, overflow) = upper.multipliedReportingOverflow(by: factor)
+                order += 1
+            }
+            bounds.append(last)
+            return bounds
+        }
+    }
+
+    // MARK: Decoding
+
+    /// Decodes a `quantize` record: 127 `int64` counts.
+    static func decodeQuantize(_ raw: UnsafeRawPointer, size: Int) -> AggregationHistogram {
+        AggregationHistogram(layout: .quantize, counts: loadCounts(raw, count: size / 8))
+    }
+
+    /// Decodes an `lquantize` record: an encoded parameter word
+    /// (`DTRACE_LQUANTIZE_{STEP,LEVELS,BASE}`), then `levels + 2`
+    /// counts.
+    static func decodeLinear(_ raw: UnsafeRawPointer, size: Int) -> AggregationHistogram? {
+        guard size >= 8 else { return nil }
+        let arg = raw.loadUnaligned(as: UInt64.self)
+        let layout = Layout.linear(
+            base: Int32(truncatingIfNeeded: arg),
+            step: UInt16(truncatingIfNeeded: arg >> 48),
+            levels: UInt16(truncatingIfNeeded: arg >> 32)
+        )
+        return AggregationHistogram(layout: layout, counts: loadCounts(raw + 8, count: size / 8 - 1))
+    }
+
+    /// Decodes an `llquantize` record: an encoded parameter word
+    /// (`DTRACE_LLQUANTIZE_{FACTOR,LOW,HIGH,NSTEP}`), then the counts.
+    static func decodeLogLinear(_ raw: UnsafeRawPointer, size: Int) -> AggregationHistogram? {
+        guard size >= 8 else { return nil }
+        let arg = raw.loadUnaligned(as: UInt64.self)
+        let layout = Layout.logLinear(
+            factor: UInt16(truncatingIfNeeded: arg >> 48),
+            low: UInt16(truncatingIfNeeded: arg >> 32),
+            high: UInt16(truncatingIfNeeded: arg >> 16),
+            steps: UInt16(truncatingIfNeeded: arg)
+        )
+        return AggregationHistogram(layout: layout, counts: loadCounts(raw + 8, count: size / 8 - 1))
+    }
+
+    private static func loadCounts(_ raw: UnsafeRawPointer, count: Int) -> [Int64] {
+        (0..<Swift.max(count, 0)).map { raw.loadUnaligned(fromByteOffset: $0 * 8, as: Int64.self) }
+    }
+}
+
+// MARK: - Moments
+
+/// A decoded `stddev` aggregation value: the kernel's running count,
+/// sum, and 128-bit sum of squares.
+///
+/// Keeping the raw moments rather than a finished deviation is what
+/// makes the value mergeable: two snapshots' moments add, while their
+/// deviations do not.
+public struct AggregationMoments: Sendable, Equatable {
+    /// Number of values recorded.
+    public var count: Int64
+
+    /// Sum of the values.
+    public var sum: Int64
+
+    /// Low 64 bits of the sum of squares.
+    public var sumOfSquaresLow: UInt64
+
+    /// High 64 bits of the sum of squares.
+    public var sumOfSquaresHigh: UInt64
+
+    public init(count: Int64, sum: Int64, sumOfSquaresLow: UInt64, sumOfSquaresHigh: UInt64 = 0) {
+        self.count = count
+        self.sum = sum
+        self.sumOfSquaresLow = sumOfSquaresLow
+        self.sumOfSquaresHigh = sumOfSquaresHigh
+    }
+
+    /// Arithmetic mean, or 0 when nothing was recorded.
+    public var mean: Double {
+        count == 0 ? 0 : Double(sum) / Double(count)
+    }
+
+    /// Population standard deviation, the quantity `printa` reports
+    /// for `stddev()`: `sqrt(sumsq / count - mean^2)`.
+    public var standardDeviation: Double {
+        guard count > 0 else { return 0 }
+        let sumOfSquares = Double(sumOfSquaresHigh) * 0x1p64 + Double(sumOfSquaresLow)
+        let variance = sumOfSquares / Double(count) - mean * mean
+        return variance > 0 ? variance.squareRoot() : 0
+    }
+
+    /// Adds another snapshot's moments to these.
+    public func merging(_ other: AggregationMoments) -> AggregationMoments {
+        let (low, carry) = sumOfSquaresLow.addingReportingOverflow(other.sumOfSquaresLow)
+        return AggregationMoments(
+            count: count &+ other.count,
+            sum: sum &+ other.sum,
+            sumOfSquaresLow: low,
+            sumOfSquaresHigh: sumOfSquaresHigh &+ other.sumOfSquaresHigh &+ (carry ? 1 : 0)
+        )
+    }
+
+    /// Removes an earlier snapshot's moments from these.
+    public func subtracting(_ earlier: AggregationMoments) -> AggregationMoments {
+        let (low, borrow) = sumOfSquaresLow.subtractingReportingOverflow(earlier.sumOfSquaresLow)
+        return AggregationMoments(
+            count: count &- earlier.count,
+            sum: sum &- earlier.sum,
+            sumOfSquaresLow: low,
+            sumOfSquaresHigh: sumOfSquaresHigh &- earlier.sumOfSquaresHigh &- (borrow ? 1 : 0)
+        )
+    }
+
+    /// Decodes a `stddev` record: `count`, `sum`, then the sum of
+    /// squares as a low/high pair of `uint64` words.
+    static func decode(_ raw: UnsafeRawPointer, size: Int) -> AggregationMoments {
+        func word(_ index: Int) -> UInt64 {
+            index * 8 + 8 <= size ? raw.loadUnaligned(fromByteOffset: index * 8, as: UInt64.self) : 0
+        }
+        return AggregationMoments(
+            count: Int64(bitPattern: word(0)),
+            sum: Int64(bitPattern: word(1)),
+            sumOfSquaresLow: word(2),
+            sumOfSquaresHigh: word(3)
+        )
+    }
+}
@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) 2026 Kory Heard
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+import Foundation
+import Glibc
+
+// MARK: - Script Cache
+
+/// An on-disk cache of rendered, validated, and linted scripts.
+///
+/// Starting a session from a large profile such as
+/// ``DBlocks/Dwatch`` regenerates the script, renders its D source,
+/// and runs ``DBlocks/validate()`` and ``DBlocks/lint()`` every time. A
+/// tool that starts many short sessions pays that on each start. The
+/// cache does the work once per key and stores the result:
+///
+/// - `<fingerprint>.d` — the rendered D source
+/// - `<fingerprint>.json` — the script's ``DBlocks/jsonData()``
+/// - `<fingerprint>.manifest` — key, options, source fingerprint, and
+///   lint warnings
+///
+/// A later lookup of the same key and options reads the source from
+/// disk and never calls the generator.
+///
+/// ```swift
+/// let cache = DBlocksCache()
+/// let entry = try cache.entry(for: "dwatch.open", options: ["target": "all"]) {
+///     DBlocks.Dwatch.open()
+/// }
+/// var session = try DTraceSession.create()
+/// session.add(entry)
+/// try session.start()
+/// ```
+///
+/// Keys name what the generator produces, so whatever changes its
+/// output — a target, a rate — belongs in `options`. The cache format
+/// and ``libraryVersion`` are folded into every key, so a DBlocks
+/// upgrade never reads scripts rendered by an older release. Entries
+/// whose manifest does not match the key, options, versions, or source
+/// fingerprint are treated as missing and regenerated.
+///
+/// Cached source is loaded into the kernel, so the cache only trusts
+/// what this user alone could have written. The directory is created
+/// with mode 0700 and files with 0600. A directory or file that is
+/// owned by another user, writable by group or other, or a symbolic
+/// link is ignored. Writing is best effort: if the directory is not
+/// writable or not trusted, lookups still succeed and simply regenerate
+/// each time.
+public struct DBlocksCache: Sendable {
+
+    /// A cached script.
+    public struct Entry: Sendable {
+        /// The key the entry was looked up by.
+        public let key: String
+
+        /// The rendered D source.
+        public let source: String
+
+        /// The script's lint warnings, rendered as text.
+        public let warnings: [String]
+
+        /// Whether the entry was read from disk rather than generated.
+        public let isCached: Bool
+
+        /// Location of the script's JSON.
+        let scriptURL: URL
+
+        /// The script itself, when it was just generated.
+        let generated: DBlocks?
+
+        /// The script's structure: the generated script on a miss, or
+        /// decoded from its cached JSON on a hit.
+        ///
+        /// - Throws: File system or `DecodingError` errors.
+        public func script() throws -> DBlocks {
+            if let generated {
+                return generated
+            }
+            return try DBlocks(jsonData: Data(contentsOf: scriptURL))
+        }
+    }
+
+    /// Directory holding the cache files.
+    public let directory: URL
+
+    /// Version of the on-disk layout; bumping it invalidates every entry.
+    static let formatVersion = 1
+
+    /// DBlocks release whose generators rendered the cached scripts.
+    /// Bump it with any release that changes the D a builder renders.
+    public static let libraryVersion = "1.0.0"
+
+    /// Creates a cache in `directory`, which is created with mode 0700 on
+    /// first write.
+    ///
+    /// - Parameter directory: Cache directory. Defaults to
+    ///   ``defaultDirectory``.
+    public init(directory: URL = DBlocksCache.defaultDirectory) {
+        self.directory = directory
+    }
+
+    /// `/var/cache/dblocks` when running as root; otherwise
+    /// `$XDG_CACHE_HOME/dblocks`, or `~/.cache/dblocks`.
+    ///
+    /// Root ignores `XDG_CACHE_HOME` and `HOME`: both may point into a
+    /// directory another user controls, such as under `sudo`.
+    public static var defaultDirectory: URL {
+        if geteuid() == 0 {
+            return URL(fileURLWithPath: "/var/cache/dblocks")
+        }
+        if let base = ProcessInfo.processInfo.environment["XDG_CACHE_HOME"], !base.isEmpty {
+            return URL(fileURLWithPath: base).appendingPathComponent("dblocks")
+        }
+        return FileManager.default.homeDirectoryForCurrentUser
+            .appendingPathComponent(".cache")
+            .appendingPathComponent("dblocks")
+    }
+
+    // MARK: Lookup
+
+    /// Returns the cached script for `key` and `options`, generating,
+    /// validating, linting, and storing it on a miss.
+    ///
+    /// - Parameters:
+    ///   - key: Names the script, e.g. `"dwatch.open"`.
+    ///   - options: Everything else the generated script depends on.
+    ///   - make: Builds the script. Called only on a miss.
+    /// - Returns: The cached or freshly generated entry.
+    /// - Throws: Errors from `make`, or `DBlocksError` from
+    ///   ``DBlocks/validate()``. Invalid scripts are never stored.
+    public func entry(
+        for key: String,
+        options: [String: String] = [:],
+        make: () throws -> DBlocks
+    ) throws -> Entry {
+        let name = Self.fileName(key: key, options: options)
+        let sourceURL = directory.appendingPathComponent(name + ".d")
+        let scriptURL = directory.appendingPathComponent(name + ".json")
+        let manifestURL = directory.appendingPathComponent(name + ".manifest")
+
+        if Self.isTrusted(directory, isDirectory: true),
+           let manifestData = Self.readTrusted(manifestURL),
+           let manifest = try? JSONDecoder().decode(Manifest.self, from: manifestData),
+           manifest.formatVersion == Self.formatVersion,
+           manifest.libraryVersion == Self.libraryVersion,
+           manifest.key == key,
+           manifest.options == options,
+           let sourceData = Self.readTrusted(sourceURL),
+           Self.fingerprint(sourceData) == manifest.sourceFingerprint,
+           Self.isTrusted(scriptURL, isDirectory: false) {
+            return Entry(
+                key: key,
+                source: String(decoding: sourceData, as: UTF8.self),
+                warnings: manifest.warnings,
+                isCached: true,
+                scriptURL: scriptURL,
+                generated: nil
+            )
+        }
+
+        let script = try make()
+        try script.validate()
+        let warnings = script.lint().map(\.description)
+        let source = script.source
+        let sourceData = Data(source.utf8)
+
+        let manifest = Manifest(
+            formatVersion: Self.formatVersion,
+            libraryVersion: Self.libraryVersion,
+            key: key,
+            options: options,
+            sourceFingerprint: Self.fingerprint(sourceData),
+            warnings: warnings
+        )
+        // Manifest last: a reader only trusts files a manifest vouches for.
+        if Self.createDirectory(directory),
+           Self.writePrivate(sourceData, to: sourceURL),
+           let scriptData = try? script.jsonData(),
+           Self.writePrivate(scriptData, to: scriptURL),
+           let manifestData = try? JSONEncoder().encode(manifest) {
+            _ = Self.writePrivate(manifestData, to: manifestURL)
+        }
+
+        return Entry(
+            key: key,
+            source: source,
+            warnings: warnings,
+            isCached: false,
+            scriptURL: scriptURL,
+            generated: script
+        )
+    }
+
+    /// Removes every cache file.
+    ///
+    /// Only files the cache names are removed: a 16 hex digit stem with a
+    /// `.d`, `.json`, or `.manifest` extension. Anything else in the
+    /// directory is left alone.
+    ///
+    /// - Throws: File system errors other than a missing directory.
+    public func removeAll() throws {
+        let fm = FileManager.default
+        guard fm.fileExists(atPath: directory.path) else { return }
+        for file in try fm.contentsOfDirectory(at: directory, includingPropertiesForKeys: nil)
+        where Self.isCacheFile(file) {
+            try fm.removeItem(at: file)
+        }
+    }
+
+    // MARK: Internals
+
+    private struct Manifest: Codable {
+        let formatVersion: Int
+        let libraryVersion: String
+        let key: String
+        let options: [String: String]
+        let sourceFingerprint: String
+        let warnings: [String]
+    }
+
+    /// File name stem for a key and its options, under the current cache
+    /// format and library version.
+    static func fileName(key: String, options: [String: String]) -> String {
+        var bytes = Data("\(formatVersion)".utf8)
+        bytes.append(0)
+        bytes.append(contentsOf: libraryVersion.utf8)
+        bytes.append(0)
+        bytes.append(contentsOf: key.utf8)
+        for (name, value) in options.sorted(by: { $0.key < $1.key }) {
+            bytes.append(0)
+            bytes.append(contentsOf: name.utf8)
+            bytes.append(0x3d)
+            bytes.append(contentsOf: value.utf8)
+        }
+        return fingerprint(bytes)
+    }
+
+    /// 64-bit FNV-1a of `data`, as 16 hex digits. Stable across
+    /// processes, unlike `Hasher`.
+    static func fingerprint(_ data: Data) -> String {
+        var hash: UInt64 = 0xcbf2_9ce4_8422_2325
+        for byte in data {
+            hash ^= UInt64(byte)
+            hash = hash &* 0x0000_0100_0000_01b3
+        }
+        let digits = String(hash, radix: 16)
+        return String(repeating: "0", count: 16 - digits.count) + digits
+    }
+
+    /// Whether `url` is a file name the cache writes.
+    static func isCacheFile(_ url: URL) -> Bool {
+        let stem = url.deletingPathExtension().lastPathComponent
+        return ["d", "json", "manifest"].contains(url.pathExtension)
+            && stem.utf8.count == 16
+            && stem.allSatisfy(\.isHexDigit)
+    }
+
+    /// Whether `url` is a directory or regular file, not a symbolic link,
+    /// owned by this user and not writable by group or other.
+    static func isTrusted(_ url: URL, isDirectory: Bool) -> Bool {
+        var info = stat()
+        guard lstat(url.path, &info) == 0 else { return false }
+        guard info.st_mode & S_IFMT == (isDirectory ? S_IFDIR : S_IFREG) else { return false }
+        return info.st_uid == geteuid() && info.st_mode & (S_IWGRP | S_IWOTH) == 0
+    }
+
+    /// Contents of `url` if it is trusted.
+    private static func readTrusted(_ url: URL) -> Data? {
+        guard isTrusted(url, isDirectory: false) else { return nil }
+        return try? Data(contentsOf: url)
+    }
+
+    /// Creates `directory` with mode 0700 if needed and reports whether
+    /// it can be trusted.
+    private static func createDirectory(_ directory: URL) -> Bool {
+        _ = try? FileManager.default.createDirectory(
+            at: directory,
+            withIntermediateDirectories: true,
+            attributes: [.posixPermissions: 0o700]
+        )
+        return isTrusted(directory, isDirectory: true)
+    }
+
+    /// Writes `data` atomically and restricts it to mode 0600, so the
+    /// umask cannot leave it group-writable.
+    private static func writePrivate(_ data: Data, to url: URL) -> Bool {
+        guard (try? data.write(to: url, options: .atomic)) != nil else { return false }
+        return (try? FileManager.default.setAttributes([.posixPermissions: 0o600], ofItemAtPath: url.path)) != nil
+    }
+}
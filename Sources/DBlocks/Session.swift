@@ -67,6 +67,7 @@ import Glibc
 public struct DTraceSession: ~Copyable {
     private var handle: DTraceHandle
     private var scripts: [DBlocks] = []
+    private var sources: [String] = []
     private var isEnabled: Bool = false
     private var outputDestination: DTraceOutput = .stdout
 
@@ -153,6 +154,21 @@ public struct DTraceSession: ~Copyable {
     /// ```
     public mutating func add(_ script: DBlocks) {
         scripts.append(script)
+        sources.append(script.source)
+    }
+
+    /// Adds a script loaded from a ``DBlocksCache``.
+    ///
+    /// Only the entry's rendered source is used, so the script is not
+    /// regenerated, and it is not listed in ``allScripts``.
+    ///
+    /// ```swift
+    /// let cache = DBlocksCache()
+    /// let entry = try cache.entry(for: "dwatch.open") { DBlocks.Dwatch.open() }
+    /// session.add(entry)
+    /// ```
+    public mutating func add(_ entry: DBlocksCache.Entry) {
+        sources.append(entry.source)
     }
 
     /// Adds a script using a result builder.
@@ -166,7 +182,7 @@ public struct DTraceSession: ~Copyable {
     /// }
     /// ```
     public mutating func add(@DBlocksBuilder _ builder: () -> [ProbeClause]) {
-        scripts.append(DBlocks(builder))
+        add(DBlocks(builder))
     }
 
     // MARK: - Execution (Simple)
@@ -227,8 +243,8 @@ public struct DTraceSession: ~Copyable {
     /// }
     /// ```
     public mutating func start() throws {
-        for script in scripts {
-            let program = try handle.compile(script.source)
+        for source in sources {
+            let program = try handle.compileCached(source)
             try handle.exec(program)
         }
         try handle.go()
@@ -252,6 +268,51 @@ public struct DTraceSession: ~Copyable {
         }
     }
 
+    /// Processes available trace data into a record stream instead of
+    /// the output destination.
+    ///
+    /// Each record is decoded into a typed value and delivered in
+    /// batches through `stream.batches`; nothing is formatted.
+    ///
+    /// ```swift
+    /// let stream = DTraceRecordStream()
+    /// Task { for await batch in stream.batches { ingest(batch) } }
+    /// while session.process(into: stream) == .okay {
+    ///     session.wait()
+    /// }
+    /// stream.finish()
+    /// ```
+    public func process(into stream: DTraceRecordStream) -> DTraceWorkStatus {
+        handle.poll(into: stream)
+    }
+
+    /// Compiles all added scripts and hands the session's handle to a
+    /// consumer that traces on its own thread.
+    ///
+    /// The session is consumed; configure it (buffer sizes, options)
+    /// first. Call ``DTraceConsumer/start()`` to begin tracing.
+    ///
+    /// ```swift
+    /// var session = try DTraceSession.create()
+    /// session.add { Probe("syscall:::entry") { Trace("pid") } }
+    /// let consumer = try session.makeConsumer()
+    /// try consumer.start()
+    /// ```
+    ///
+    /// - Parameter configuration: Consumer rates, sizes, and queue capacity.
+    /// - Returns: A consumer that owns the handle.
+    /// - Throws: `DTraceCoreError.compileFailed`/`execFailed` if a script
+    ///   is rejected, or the consumer's setup errors.
+    public consuming func makeConsumer(
+        configuration: DTraceConsumer.Configuration = .init()
+    ) throws -> DTraceConsumer {
+        for source in sources {
+            let program = try handle.compileCached(source)
+            try handle.exec(program)
+        }
+        return try DTraceConsumer(handle: handle, configuration: configuration)
+    }
+
     /// Processes trace data for a specific duration.
     ///
     /// ```swift
@@ -339,11 +400,11 @@ public struct DTraceSession: ~Copyable {
     /// }
     /// ```
     ///
-    /// Scalar aggregations (`count`, `sum`, `min`, `max`, `avg`,
-    /// `stddev`) are decoded into typed `Int64` values; histogram
-    /// aggregations (`quantize`, `lquantize`, `llquantize`) are
-    /// surfaced as raw bytes for now and can be re-fed to libdtrace's
-    /// printers if needed.
+    /// Scalar aggregations (`count`, `sum`, `min`, `max`, `avg`) are
+    /// decoded into typed `Int64` values, `stddev` into its moments,
+    /// and histogram aggregations (`quantize`, `lquantize`,
+    /// `llquantize`) into an ``AggregationHistogram`` that supports
+    /// percentile estimates and merging.
     ///
     /// - Parameter sorted: Walk the kernel's aggregation buffer in
     ///   sorted order (by value). Defaults to `true`.
@@ -352,10 +413,8 @@ public struct DTraceSession: ~Copyable {
     /// - Throws: `DTraceCoreError.aggregateFailed` if the snap or walk
     ///   fails.
     public func snapshot(sorted: Bool = true) throws -> [AggregationRecord] {
-        try snapshotAggregations()
         var records: [AggregationRecord] = []
-        try handle.aggregateWalk(sorted: sorted) { dataPtr, _ in
-            let aggdata = dataPtr.assumingMemoryBound(to: dtrace_aggdata_t.self)
+        try walkAggregationRows(sorted: sorted) { aggdata in
             if let record = AggregationRecord.decode(from: aggdata) {
                 records.append(record)
             }
@@ -364,6 +423,17 @@ public struct DTraceSession: ~Copyable {
         return records
     }
 
+    /// Snapshots the aggregation buffer and hands each row's
+    /// `dtrace_aggdata_t` to `body`, which may ask for the row to be
+    /// cleared.
+    func walkAggregationRows(
+        sorted: Bool,
+        _ body: @escaping (UnsafePointer<dtrace_aggdata_t>) -> DTraceHandle.AggregateWalkResult
+    ) throws {
+        try snapshotAggregations()
+        try handle.aggregateWalkRows(sorted: sorted, body)
+    }
+
     // MARK: - Probe Discovery
 
     /// Lists probes matching a pattern.
@@ -428,7 +498,7 @@ public struct DTraceSession: ~Copyable {
 
     /// Returns the combined D source code.
     public var source: String {
-        scripts.map { $0.source }.joined(separator: "\n\n")
+        sources.joined(separator: "\n\n")
     }
 }
 
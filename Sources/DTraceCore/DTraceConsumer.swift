@@ -0,0 +1,554 @@
+/*
+ * Copyright (c) 2026 Kory Heard
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+import CDTrace
+import Foundation
+import Glibc
+
+// MARK: - Consumer
+
+/// Runs the DTrace work loop on a dedicated thread.
+///
+/// Driving `dtrace_sleep`/`dtrace_work` from the application's own
+/// thread means buffers are only read when the application is idle; a
+/// burst that arrives while it is busy fills the kernel buffers and is
+/// dropped. A consumer takes ownership of a configured handle and reads
+/// it on its own thread at a rate it adapts from the drops it sees:
+///
+/// - Every principal buffer drop doubles `switchrate` (up to
+///   ``Configuration/maximumSwitchRate``), so buffers are switched
+///   before they fill again. Other drops are counted but do not change
+///   the rate: dynamic variable, aggregation, and speculation space are
+///   sized by their own options, not by how often buffers switch.
+/// - ``Configuration/idlePollsBeforeSlowdown`` consecutive polls with
+///   no data halve it (down to ``Configuration/minimumSwitchRate``), so
+///   a quiet session does not wake the thread needlessly.
+///
+/// Records are decoded as by ``DTraceRecordStream`` and handed to the
+/// application through a bounded, lock-free single-producer,
+/// single-consumer queue. The consumer thread never blocks on the
+/// application: when the queue is full, batches are dropped and counted
+/// in ``Metrics/droppedBatches``.
+///
+/// ```swift
+/// let handle = try DTraceHandle.open()
+/// let program = try handle.compile("syscall:::entry { trace(pid); }")
+/// try handle.exec(program)
+///
+/// let consumer = try DTraceConsumer(handle: handle)
+/// try consumer.start()
+/// while running {
+///     consumer.drain { batch in ingest(batch) }
+///     report(consumer.metrics)
+/// }
+/// try consumer.stop()
+/// ```
+///
+/// `bufsize` is fixed once tracing starts. The consumer applies
+/// ``Configuration/bufferSize`` before ``start()`` if it is set, and
+/// otherwise keeps the handle's own `bufsize`. When drops persist at
+/// the maximum switch rate it doubles ``Metrics/recommendedBufferSize``
+/// for the caller to use in the next session.
+///
+/// The consumer installs its own drop handler to count drops. A handler
+/// already installed on the handle is still called, after the consumer
+/// records the drop, and its result decides whether tracing continues.
+///
+/// ``dequeue()`` and ``drain(_:)`` must be called from one thread at a
+/// time. ``metrics`` may be read from any thread.
+public final class DTraceConsumer: @unchecked Sendable {
+
+    /// Consumer configuration.
+    public struct Configuration: Sendable {
+        /// Events per decoded batch.
+        public var batchSize: Int
+
+        /// Batches the queue holds before new ones are dropped. Rounded
+        /// up to a power of two.
+        public var queueCapacity: Int
+
+        /// Principal buffer size in bytes, set before tracing starts, or
+        /// `nil` to keep the handle's `bufsize`.
+        public var bufferSize: Int?
+
+        /// Upper bound for ``Metrics/recommendedBufferSize``.
+        public var maximumBufferSize: Int
+
+        /// Initial buffer switch rate, in Hz, or `nil` to start from the
+        /// handle's `switchrate`.
+        public var switchRate: Int?
+
+        /// Lowest switch rate the consumer slows down to, in Hz.
+        public var minimumSwitchRate: Int
+
+        /// Highest switch rate the consumer speeds up to, in Hz.
+        public var maximumSwitchRate: Int
+
+        /// Consecutive empty polls after which the switch rate is halved.
+        public var idlePollsBeforeSlowdown: Int
+
+        public init(
+            batchSize: Int = 4096,
+            queueCapacity: Int = 256,
+            bufferSize: Int? = nil,
+            maximumBufferSize: Int = 256 << 20,
+            switchRate: Int? = nil,
+            minimumSwitchRate: Int = 10,
+            maximumSwitchRate: Int = 1000,
+            idlePollsBeforeSlowdown: Int = 16
+        ) {
+            self.batchSize = batchSize
+            self.queueCapacity = queueCapacity
+            self.bufferSize = bufferSize
+            self.maximumBufferSize = maximumBufferSize
+            self.switchRate = switchRate
+            self.minimumSwitchRate = minimumSwitchRate
+            self.maximumSwitchRate = maximumSwitchRate
+            self.idlePollsBeforeSlowdown = idlePollsBeforeSlowdown
+        }
+
+        /// DTrace's `bufsize` when the handle does not set one.
+        static let defaultBufferSize = 4 << 20
+
+        /// Starting switch rate when the handle does not set one, in Hz.
+        static let defaultSwitchRate = 50
+    }
+
+    /// A point-in-time view of the consumer's counters.
+    public struct Metrics: Sendable, Equatable {
+        /// Records dropped from principal buffers.
+        public let principalDrops: UInt64
+
+        /// Records dropped from aggregation buffers.
+        public let aggregationDrops: UInt64
+
+        /// Dynamic variable drops.
+        public let dynamicDrops: UInt64
+
+        /// Speculation drops.
+        public let speculationDrops: UInt64
+
+        /// Events handed to the queue.
+        public let deliveredEvents: UInt64
+
+        /// Batches dropped because the queue was full.
+        public let droppedBatches: UInt64
+
+        /// Events in the dropped batches.
+        public let droppedEvents: UInt64
+
+        /// Batches waiting in the queue.
+        public let queueDepth: Int
+
+        /// Capacity of the queue, in batches.
+        public let queueCapacity: Int
+
+        /// Work loop iterations.
+        public let polls: UInt64
+
+        /// Current buffer switch rate, in Hz.
+        public let switchRate: Int
+
+        /// Principal buffer size in use, in bytes.
+        public let bufferSize: Int
+
+        /// Buffer size suggested for the next session, in bytes.
+        public let recommendedBufferSize: Int
+
+        /// Drops reported by the kernel, of any kind.
+        public var kernelDrops: UInt64 {
+            principalDrops + aggregationDrops + dynamicDrops + speculationDrops
+        }
+    }
+
+    /// The configuration in effect, with an unset buffer size and switch
+    /// rate filled in from the handle.
+    public let configuration: Configuration
+
+    private var handle: DTraceHandle
+    private let drops: DropCounters
+    private let queue: DTraceBatchQueue
+    private let decoder: DTraceRecordDecoder
+
+    private let lock = NSLock()
+    private let exited = DispatchSemaphore(value: 0)
+    private var controller: DTraceRateController
+    private var polls: UInt64 = 0
+    private var started = false
+    private var stopRequested = false
+    private var hasExited = false
+    private var _lastStatus: DTraceWorkStatus = .okay
+
+    /// Takes ownership of a handle whose programs are already compiled
+    /// and executed, and applies the buffer size and switch rate the
+    /// configuration sets. Options it leaves `nil` keep the values
+    /// already set on the handle, such as a buffer size set through
+    /// `DTraceSession.bufferSize(_:)`.
+    ///
+    /// - Parameters:
+    ///   - handle: The handle to consume. Tracing must not have started.
+    ///   - configuration: Rates, sizes, and queue capacity.
+    /// - Throws: `DTraceCoreError.setOptFailed` or `getOptFailed` if an
+    ///   option is rejected, or `DTraceCoreError.handlerFailed` if the
+    ///   drop handler cannot be installed.
+    public init(handle: consuming DTraceHandle, configuration: Configuration = .init()) throws {
+        if let bufferSize = configuration.bufferSize {
+            try handle.setOption("bufsize", value: String(bufferSize))
+        }
+        let currentSize = try Self.optionValue(handle.getOption("bufsize"))
+        let currentRate = try Self.optionValue(handle.getOption("switchrate")).map {
+            // switchrate is stored as an interval in nanoseconds
+            max(Int(1_000_000_000 / $0), 1)
+        }
+
+        var resolved = configuration
+        resolved.bufferSize = configuration.bufferSize ?? currentSize ?? Configuration.defaultBufferSize
+        resolved.switchRate = configuration.switchRate ?? currentRate ?? Configuration.defaultSwitchRate
+        let controller = DTraceRateController(configuration: resolved)
+        resolved.switchRate = controller.switchRate
+
+        if controller.switchRate != currentRate {
+            try handle.setOption("switchrate", value: "\(controller.switchRate)hz")
+        }
+
+        // The handler must not capture self: the handle's handler storage
+        // would keep the consumer alive.
+        let drops = DropCounters()
+        let previousHandler = handle.dropHandler
+        try handle.onDrop { info in
+            drops.record(info)
+            return previousHandler?(info) ?? true
+        }
+
+        let queue = DTraceBatchQueue(capacity: resolved.queueCapacity)
+        self.configuration = resolved
+        self.handle = handle
+        self.drops = drops
+        self.queue = queue
+        self.decoder = DTraceRecordDecoder(batchSize: resolved.batchSize) { batch in
+            queue.enqueue(batch)
+        }
+        self.controller = controller
+    }
+
+    /// An option's value, or `nil` if the handle leaves it unset
+    /// (`DTRACEOPT_UNSET`, which is negative).
+    private static func optionValue(_ value: Int64) -> Int? {
+        value > 0 ? Int(value) : nil
+    }
+
+    // MARK: Lifecycle
+
+    /// Starts tracing and the consumer thread.
+    ///
+    /// - Throws: `DTraceCoreError.goFailed` if tracing cannot start.
+    public func start() throws {
+        lock.lock()
+        let alreadyStarted = started
+        started = true
+        lock.unlock()
+        guard !alreadyStarted else { return }
+
+        do {
+            try handle.go()
+        } catch {
+            lock.lock()
+            started = false
+            lock.unlock()
+            throw error
+        }
+
+        let thread = Thread { [self] in
+            run()
+            lock.lock()
+            hasExited = true
+            lock.unlock()
+            exited.signal()
+        }
+        thread.name = "com.dtrace.consumer"
+        thread.start()
+    }
+
+    /// Stops the consumer thread, waits for it to exit, and stops
+    /// tracing. Batches already queued remain available to ``drain(_:)``.
+    ///
+    /// The thread notices within one switch interval.
+    ///
+    /// - Throws: `DTraceCoreError.stopFailed` if tracing cannot be stopped.
+    public func stop() throws {
+        lock.lock()
+        let wasStarted = started
+        stopRequested = true
+        let done = hasExited
+        lock.unlock()
+        guard wasStarted else { return }
+        if !done {
+            exited.wait()
+            exited.signal()   // Let later stop() calls through
+        }
+        try handle.stop()
+    }
+
+    /// Whether the consumer thread is running.
+    public var isRunning: Bool {
+        lock.lock()
+        defer { lock.unlock() }
+        return started && !hasExited
+    }
+
+    /// Status returned by the most recent poll. `.done` once the
+    /// program has called `exit()` or the buffers have filled.
+    public var lastStatus: DTraceWorkStatus {
+        lock.lock()
+        defer { lock.unlock() }
+        return _lastStatus
+    }
+
+    // MARK: Output
+
+    /// Removes the oldest decoded batch from the queue.
+    public func dequeue() -> DTraceRecordBatch? {
+        queue.dequeue()
+    }
+
+    /// Removes every queued batch, oldest first.
+    ///
+    /// - Parameter body: Called for each batch.
+    /// - Returns: The number of batches removed.
+    @discardableResult
+    public func drain(_ body: (DTraceRecordBatch) throws -> Void) rethrows -> Int {
+        var count = 0
+        while let batch = queue.dequeue() {
+            try body(batch)
+            count += 1
+        }
+        return count
+    }
+
+    /// The consumer's current counters.
+    public var metrics: Metrics {
+        let kinds = drops.snapshot()
+        lock.lock()
+        let polls = self.polls
+        let controller = self.controller
+        lock.unlock()
+        return Metrics(
+            principalDrops: kinds.principal,
+            aggregationDrops: kinds.aggregation,
+            dynamicDrops: kinds.dynamic,
+            speculationDrops: kinds.speculation,
+            deliveredEvents: decoder.deliveredEvents,
+            droppedBatches: decoder.droppedBatches,
+            droppedEvents: decoder.droppedEvents,
+            queueDepth: queue.count,
+            queueCapacity: queue.capacity,
+            polls: polls,
+            switchRate: controller.switchRate,
+            bufferSize: configuration.bufferSize ?? Configuration.defaultBufferSize,
+            recommendedBufferSize: controller.recommendedBufferSize
+        )
+    }
+
+    // MARK: Work Loop
+
+    private func run() {
+        while true {
+            lock.lock()
+            let stopping = stopRequested
+            lock.unlock()
+            if stopping { break }
+
+            handle.sleep()
+
+            let eventsBefore = decoder.deliveredEvents + decoder.droppedEvents
+            let dropsBefore = drops.principalDrops
+            let status = handle.poll(decoder: decoder)
+            let events = decoder.deliveredEvents + decoder.droppedEvents - eventsBefore
+            let newDrops = drops.principalDrops - dropsBefore
+
+            lock.lock()
+            polls += 1
+            _lastStatus = status
+            let previousRate = controller.switchRate
+            controller.update(events: events, drops: newDrops)
+            let rate = controller.switchRate
+            lock.unlock()
+
+            if rate != previousRate {
+                try? handle.setOption("switchrate", value: "\(rate)hz")
+            }
+            if status != .okay { break }
+        }
+    }
+}
+
+// MARK: - Rate Controller
+
+/// Adapts the buffer switch rate from per-poll drop and event counts.
+///
+/// Pure state, kept separate from the consumer so tests can drive it.
+struct DTraceRateController: Sendable {
+    let minimumSwitchRate: Int
+    let maximumSwitchRate: Int
+    let idlePollsBeforeSlowdown: Int
+    let maximumBufferSize: Int
+
+    private(set) var switchRate: Int
+    private(set) var recommendedBufferSize: Int
+    private var idlePolls = 0
+
+    init(configuration: DTraceConsumer.Configuration) {
+        minimumSwitchRate = max(configuration.minimumSwitchRate, 1)
+        maximumSwitchRate = max(configuration.maximumSwitchRate, minimumSwitchRate)
+        idlePollsBeforeSlowdown = max(configuration.idlePollsBeforeSlowdown, 1)
+        let bufferSize = configuration.bufferSize ?? DTraceConsumer.Configuration.defaultBufferSize
+        let switchRate = configuration.switchRate ?? DTraceConsumer.Configuration.defaultSwitchRate
+        maximumBufferSize = max(configuration.maximumBufferSize, bufferSize)
+        self.switchRate = min(max(switchRate, minimumSwitchRate), maximumSwitchRate)
+        recommendedBufferSize = bufferSize
+    }
+
+    /// Records one poll.
+    ///
+    /// - Parameters:
+    ///   - events: Events the poll decoded.
+    ///   - drops: Principal buffer drops reported during the poll.
+    mutating func update(events: UInt64, drops: UInt64) {
+        if drops > 0 {
+            idlePolls = 0
+            if switchRate < maximumSwitchRate {
+                switchRate = min(switchRate * 2, maximumSwitchRate)
+            } else {
+                // Switching as fast as allowed and still dropping: only a
+                // bigger buffer helps.
+                recommendedBufferSize = min(recommendedBufferSize * 2, maximumBufferSize)
+            }
+            return
+        }
+
+        guard events == 0 else {
+            idlePolls = 0
+            return
+        }
+        idlePolls += 1
+        if idlePolls >= idlePollsBeforeSlowdown {
+            idlePolls = 0
+            switchRate = max(switchRate / 2, minimumSwitchRate)
+        }
+    }
+}
+
+// MARK: - Drop Counters
+
+/// Drop totals by kind, updated from the drop handler.
+private final class DropCounters: @unchecked Sendable {
+    struct Totals {
+        var principal: UInt64 = 0
+        var aggregation: UInt64 = 0
+        var dynamic: UInt64 = 0
+        var speculation: UInt64 = 0
+    }
+
+    private let lock = NSLock()
+    private var totals = Totals()
+
+    func record(_ info: DTraceHandle.DropInfo) {
+        lock.lock()
+        defer { lock.unlock() }
+        switch info.kind {
+        case .principal: totals.principal += info.drops
+        case .aggregation: totals.aggregation += info.drops
+        case .dynamic: totals.dynamic += info.drops
+        case .speculation: totals.speculation += info.drops
+        case .unknown: break
+        }
+    }
+
+    /// Principal buffer drops, the only kind a faster switch rate or a
+    /// bigger buffer can prevent.
+    var principalDrops: UInt64 {
+        lock.lock()
+        defer { lock.unlock() }
+        return totals.principal
+    }
+
+    func snapshot() -> Totals {
+        lock.lock()
+        defer { lock.unlock() }
+        return totals
+    }
+}
+
+// MARK: - Batch Queue
+
+/// A bounded, lock-free single-producer, single-consumer queue of
+/// batches.
+///
+/// The producer owns the tail index and the consumer the head; each
+/// publishes its index with a release store and reads the other's with
+/// an acquire load. The two indices sit on separate cache lines so the
+/// threads do not contend for one line on every operation.
+final class DTraceBatchQueue: @unchecked Sendable {
+    /// Number of slots, a power of two.
+    let capacity: Int
+
+    private let slots: UnsafeMutablePointer<DTraceRecordBatch?>
+    private let indices: UnsafeMutableRawPointer
+    private let head: UnsafeMutablePointer<UInt64>
+    private let tail: UnsafeMutablePointer<UInt64>
+
+    private static let lineSize = 128
+
+    init(capacity: Int) {
+        var size = 2
+        while size < capacity { size <<= 1 }
+        self.capacity = size
+        slots = .allocate(capacity: size)
+        slots.initialize(repeating: nil, count: size)
+        indices = .allocate(byteCount: 2 * Self.lineSize, alignment: Self.lineSize)
+        head = indices.bindMemory(to: UInt64.self, capacity: 1)
+        tail = (indices + Self.lineSize).bindMemory(to: UInt64.self, capacity: 1)
+        head.initialize(to: 0)
+        tail.initialize(to: 0)
+    }
+
+    deinit {
+        slots.deinitialize(count: capacity)
+        slots.deallocate()
+        indices.deallocate()
+    }
+
+    /// Number of queued batches.
+    var count: Int {
+        let h = cdtrace_index_load_acquire(head)
+        let t = cdtrace_index_load_acquire(tail)
+        return Int(t &- h)
+    }
+
+    /// Appends a batch. Producer only.
+    ///
+    /// - Returns: `false` if the queue is full.
+    func enqueue(_ batch: DTraceRecordBatch) -> Bool {
+        let t = cdtrace_index_load_relaxed(tail)
+        let h = cdtrace_index_load_acquire(head)
+        guard t &- h < UInt64(capacity) else { return false }
+        slots[Int(t & UInt64(capacity - 1))] = batch
+        cdtrace_index_store_release(tail, t &+ 1)
+        return true
+    }
+
+    /// Removes the oldest batch. Consumer only.
+    func dequeue() -> DTraceRecordBatch? {
+        let h = cdtrace_index_load_relaxed(head)
+        let t = cdtrace_index_load_acquire(tail)
+        guard h != t else { return nil }
+        let slot = slots + Int(h & UInt64(capacity - 1))
+        let batch = slot.pointee
+        slot.pointee = nil
+        cdtrace_index_store_release(head, h &+ 1)
+        return batch
+    }
+}
@@ -35,6 +35,9 @@ public struct DTraceHandle: ~Copyable {
     @usableFromInline
     internal var _handle: OpaquePointer?
 
+    /// Programs compiled through ``compileCached(_:flags:)``.
+    internal let programCache = DTraceProgramCache()
+
     /// Opens a new DTrace handle.
     ///
     /// - Parameter flags: Flags controlling how the handle is opened.
@@ -121,6 +124,7 @@ public struct DTraceHandle: ~Copyable {
         if result != 0 {
             throw DTraceCoreError.setOptFailed(option: option, message: lastErrorMessage)
         }
+        programCache.setOption(option, value: value)
     }
 
     /// Gets a DTrace option value.
@@ -250,6 +254,43 @@ public struct DTraceHandle: ~Copyable {
         return DTraceProgram(program: prog)
     }
 
+    /// Compiles a D program, reusing this handle's earlier compilation
+    /// of the same source.
+    ///
+    /// Programs are keyed by their exact source, the compile flags, and
+    /// every option set on the handle so far, since options such as
+    /// `defaultargs` or `strsize` change what the compiler produces.
+    /// Compiling a large script takes tens to hundreds of milliseconds;
+    /// a cache hit is a dictionary lookup.
+    ///
+    /// libdtrace keeps every program until the handle is closed, so
+    /// cached programs stay valid for the life of the handle.
+    ///
+    /// - Parameters:
+    ///   - source: The D program source code.
+    ///   - flags: Compilation flags.
+    /// - Returns: A compiled program that can be executed.
+    /// - Throws: `DTraceCoreError.compileFailed` if compilation fails.
+    public func compileCached(
+        _ source: String,
+        flags: DTraceCompileFlags = []
+    ) throws -> DTraceProgram {
+        guard _handle != nil else { throw DTraceCoreError.invalidHandle }
+
+        let key = programCache.key(source: source, flags: flags.rawValue)
+        if let program = programCache.programs[key] {
+            return DTraceProgram(program: program)
+        }
+        let program = try compile(source, flags: flags)
+        programCache.programs[key] = program.unsafeProgram()
+        return program
+    }
+
+    /// Number of programs held by ``compileCached(_:flags:)``.
+    public var cachedProgramCount: Int {
+        programCache.programs.count
+    }
+
     /// Compiles a D program from a file.
     ///
     /// - Parameters:
@@ -519,6 +560,39 @@ public struct DTraceHandle: ~Copyable {
         }
     }
 
+    /// Walks aggregation rows, passing each row's `dtrace_aggdata_t`.
+    ///
+    /// ``aggregateWalk(sorted:_:)`` passes only the row's data buffer;
+    /// this variant also exposes the row's description (aggregation
+    /// name and key/value record layout) for callers that decode the
+    /// records themselves.
+    ///
+    /// - Parameters:
+    ///   - sorted: If true, walks in sorted order (by value).
+    ///   - callback: Called for each row. Return `.next` to continue,
+    ///     `.clear` to zero the row after reading it.
+    /// - Throws: `DTraceCoreError.aggregateFailed` if walk fails.
+    public func aggregateWalkRows(
+        sorted: Bool = true,
+        _ callback: @escaping (UnsafePointer<dtrace_aggdata_t>) -> AggregateWalkResult
+    ) throws {
+        guard let h = _handle else { throw DTraceCoreError.invalidHandle }
+
+        var context = RowAggregateWalkContext(callback: callback)
+
+        let result = withUnsafeMutablePointer(to: &context) { ctxPtr in
+            if sorted {
+                return cdtrace_aggregate_walk_sorted(h, rowAggregateWalkCallback, ctxPtr)
+            } else {
+                return cdtrace_aggregate_walk(h, rowAggregateWalkCallback, ctxPtr)
+            }
+        }
+
+        if result < 0 {
+            throw DTraceCoreError.aggregateFailed(message: lastErrorMessage)
+        }
+    }
+
     // MARK: - Typed Aggregation Walking
 
     /// The aggregation action type, matching DTrace's `DTRACEAGG_*` constants.
@@ -711,6 +785,12 @@ public struct DTraceHandle: ~Copyable {
         }
     }
 
+    /// The handler installed by ``onDrop(_:)``, if any.
+    var dropHandler: ((DropInfo) -> Bool)? {
+        guard let h = _handle else { return nil }
+        return HandlerStorage.shared.dropHandler(for: h)
+    }
+
     /// Information about buffered output.
     public struct BufferedOutput: Sendable {
         /// The formatted output string from DTrace.
@@ -1013,6 +1093,22 @@ private func aggregateWalkCallback(
     return result.rawValue
 }
 
+private struct RowAggregateWalkContext {
+    var callback: (UnsafePointer<dtrace_aggdata_t>) -> DTraceHandle.AggregateWalkResult
+}
+
+private func rowAggregateWalkCallback(
+    _ data: UnsafePointer<dtrace_aggdata_t>?,
+    _ arg: UnsafeMutableRawPointer?
+) -> Int32 {
+    guard let arg = arg, let data = data else {
+        return DTRACE_AGGWALK_NEXT
+    }
+
+    let context = arg.assumingMemoryBound(to: RowAggregateWalkContext.self)
+    return context.pointee.callback(data).rawValue
+}
+
 // MARK: - Typed Aggregation Walk Internals
 
 private struct TypedAggregateWalkContext {
@@ -1317,6 +1413,33 @@ private func bufferedHandlerCallback(
     return handler(info) ? DTRACE_HANDLE_OK : DTRACE_HANDLE_ABORT
 }
 
+// MARK: - Program Cache Internals
+
+/// Compiled programs of one handle, keyed by source, flags, and options.
+final class DTraceProgramCache {
+    struct Key: Hashable {
+        let source: String
+        let flags: UInt32
+        let options: [String]
+    }
+
+    var programs: [Key: OpaquePointer] = [:]
+
+    /// Options set on the handle, by name. A boolean option's value is
+    /// empty.
+    private var options: [String: String] = [:]
+    private var optionList: [String] = []
+
+    func setOption(_ option: String, value: String?) {
+        options[option] = value ?? ""
+        optionList = options.sorted { $0.key < $1.key }.map { "\($0.key)=\($0.value)" }
+    }
+
+    func key(source: String, flags: UInt32) -> Key {
+        Key(source: source, flags: flags, options: optionList)
+    }
+}
+
 // MARK: - Consume Internals
 
 private struct ConsumeContext {
@@ -0,0 +1,503 @@
+/*
+ * Copyright (c) 2026 Kory Heard
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+import CDTrace
+import Foundation
+import Glibc
+
+// MARK: - Record Values
+
+/// A typed value decoded from one trace record.
+///
+/// Values are decoded straight from libdtrace's per-CPU buffer; no
+/// `printf` formatting takes place.
+public enum DTraceRecordValue: Sendable, Equatable {
+    /// A 1-, 2-, 4-, or 8-byte `trace()` or `printf()` argument.
+    case int(Int64)
+
+    /// A NUL-terminated `trace()` or `printf()` argument, such as a
+    /// string variable.
+    case string(String)
+
+    /// Any other `trace()` or `printf()` argument, copied verbatim.
+    case bytes([UInt8])
+
+    /// A `printf()`, `printa()`, `system()`, or `freopen()` action.
+    ///
+    /// `index` identifies the action's format string within the
+    /// program; the action's arguments follow as separate values in a
+    /// stream's events.
+    case format(action: UInt16, index: UInt16)
+
+    /// Kernel program counters from `stack()`, innermost first.
+    case stack([UInt64])
+
+    /// User program counters from `ustack()` or `jstack()`, innermost
+    /// first.
+    case userStack(pid: UInt64, frames: [UInt64])
+
+    /// The address recorded by `sym()`, `mod()`, `usym()`, `umod()`,
+    /// or `uaddr()`.
+    case address(UInt64)
+
+    /// A record of any other action, copied verbatim.
+    case other(action: UInt16, bytes: [UInt8])
+
+    /// Pure-data decoder for one trace record, exposed as `internal`
+    /// so unit tests can drive it without a live DTrace handle.
+    ///
+    /// - Parameters:
+    ///   - action: The record's `dtrd_action`.
+    ///   - size: The record's size in bytes.
+    ///   - format: The record's format index, for printf-like actions.
+    ///   - data: The record's bytes.
+    /// - Returns: The decoded value, or `nil` for records that carry no
+    ///   data for the consumer (`exit()`).
+    static func decode(
+        action: UInt16,
+        size: Int,
+        format: UInt16,
+        data: UnsafeRawPointer
+    ) -> DTraceRecordValue? {
+        // All multi-byte loads use loadUnaligned: records are packed at
+        // their own alignment within the buffer.
+        func words() -> [UInt64] {
+            (0..<size / 8).map { data.loadUnaligned(fromByteOffset: $0 * 8, as: UInt64.self) }
+        }
+
+        func bytes() -> [UInt8] {
+            Array(UnsafeRawBufferPointer(start: data, count: size))
+        }
+
+        switch UInt32(action) {
+        case CDTRACE_ACT_EXIT.rawValue:
+            return nil
+
+        case CDTRACE_ACT_PRINTF.rawValue, CDTRACE_ACT_PRINTA.rawValue,
+             CDTRACE_ACT_SYSTEM.rawValue, CDTRACE_ACT_FREOPEN.rawValue:
+            return .format(action: action, index: format)
+
+        case CDTRACE_ACT_STACK.rawValue:
+            // Unused frames are zero-filled.
+            return .stack(Array(words().prefix { $0 != 0 }))
+
+        case CDTRACE_ACT_USTACK.rawValue, CDTRACE_ACT_JSTACK.rawValue:
+            // The pid, then the frames, zero-terminated.
+            let all = words()
+            guard let pid = all.first else { return .userStack(pid: 0, frames: []) }
+            return .userStack(pid: pid, frames: Array(all.dropFirst().prefix { $0 != 0 }))
+
+        case CDTRACE_ACT_SYM.rawValue, CDTRACE_ACT_MOD.rawValue,
+             CDTRACE_ACT_USYM.rawValue, CDTRACE_ACT_UMOD.rawValue,
+             CDTRACE_ACT_UADDR.rawValue:
+            // The user variants store the pid ahead of the address.
+            guard size >= 8 else { return .other(action: action, bytes: bytes()) }
+            return .address(data.loadUnaligned(fromByteOffset: size - 8, as: UInt64.self))
+
+        case CDTRACE_ACT_DIFEXPR.rawValue:
+            // Same heuristic as `dtrace(1)`: int-sized records are
+            // signed integers, printable NUL-terminated records are
+            // strings, and anything else is raw bytes.
+            switch size {
+            case 8:
+                return .int(data.loadUnaligned(as: Int64.self))
+            case 4:
+                return .int(Int64(data.loadUnaligned(as: Int32.self)))
+            case 2:
+                return .int(Int64(data.loadUnaligned(as: Int16.self)))
+            case 1:
+                return .int(Int64(data.load(as: Int8.self)))
+            default:
+                let buffer = UnsafeBufferPointer(
+                    start: data.assumingMemoryBound(to: UInt8.self),
+                    count: size
+                )
+                if let nul = buffer.firstIndex(of: 0), nul > 0,
+                   buffer[..<nul].allSatisfy({ $0 >= 0x20 || $0 == 0x09 || $0 == 0x0a }) {
+                    return .string(String(decoding: buffer[..<nul], as: UTF8.self))
+                }
+                return .bytes(Array(buffer))
+            }
+
+        default:
+            return .other(action: action, bytes: bytes())
+        }
+    }
+}
+
+// MARK: - Batches
+
+/// A batch of decoded probe firings.
+///
+/// Values for every event in the batch share one flat array; each
+/// event's `values` is a slice of it, so a batch costs a handful of
+/// allocations regardless of how many events it holds.
+public struct DTraceRecordBatch: Sendable, RandomAccessCollection {
+
+    /// One probe firing and the values its actions recorded, in action
+    /// order.
+    public struct Event: Sendable {
+        public let cpu: Int32
+        public let probe: DTraceProbeDescription
+        public let values: ArraySlice<DTraceRecordValue>
+    }
+
+    private struct Header: Sendable {
+        let cpu: Int32
+        let probe: DTraceProbeDescription
+        var end: Int
+    }
+
+    private var headers: [Header] = []
+
+    /// Every value in the batch, in event order.
+    public private(set) var values: [DTraceRecordValue] = []
+
+    /// Creates an empty batch with room for `capacity` events.
+    init(capacity: Int) {
+        headers.reserveCapacity(capacity)
+        values.reserveCapacity(capacity * 2)
+    }
+
+    public var startIndex: Int { 0 }
+    public var endIndex: Int { headers.count }
+
+    public subscript(position: Int) -> Event {
+        let header = headers[position]
+        let start = position == 0 ? 0 : headers[position - 1].end
+        return Event(cpu: header.cpu, probe: header.probe, values: values[start..<header.end])
+    }
+
+    /// Starts a new event.
+    mutating func begin(cpu: Int32, probe: DTraceProbeDescription) {
+        headers.append(Header(cpu: cpu, probe: probe, end: values.count))
+    }
+
+    /// Appends a value to the current event.
+    mutating func append(_ value: DTraceRecordValue) {
+        guard !headers.isEmpty else { return }
+        values.append(value)
+        headers[headers.count - 1].end = values.count
+    }
+}
+
+// MARK: - Record Stream
+
+/// Delivers decoded trace records as an `AsyncSequence` of batches.
+///
+/// Pass the stream to ``DTraceHandle/poll(into:)`` in place of
+/// ``DTraceHandle/poll()``. Every record of every probe firing is
+/// decoded into a ``DTraceRecordValue`` and appended to the current
+/// batch; a batch is yielded to ``batches`` once it holds `batchSize`
+/// events and at the end of every poll. Records are never formatted,
+/// so `printf()` and `printa()` actions contribute a
+/// ``DTraceRecordValue/format(action:index:)`` marker followed by their
+/// arguments rather than text.
+///
+/// ```swift
+/// let stream = DTraceRecordStream()
+/// Task {
+///     for await batch in stream.batches {
+///         for event in batch { ingest(event) }
+///     }
+/// }
+/// while handle.poll(into: stream) == .okay {
+///     handle.sleep()
+/// }
+/// stream.finish()
+/// ```
+///
+/// `DTraceHandle` is `~Copyable` and cannot move into a task, so the
+/// polling loop stays with the handle's owner and only the batches
+/// cross into async code. A stream must be fed by one handle, from one
+/// thread at a time; ``batches`` may be iterated from anywhere.
+///
+/// When the consumer falls behind by more than `bufferedBatches`
+/// batches, new batches are dropped and counted in
+/// ``droppedBatches`` and ``droppedEvents`` rather than blocking the
+/// polling thread, which would otherwise let the kernel buffers fill
+/// and drop at the source.
+public final class DTraceRecordStream: @unchecked Sendable {
+
+    /// The decoded batches.
+    public let batches: AsyncStream<DTraceRecordBatch>
+
+    /// Number of events after which a batch is yielded.
+    public var batchSize: Int {
+        decoder.batchSize
+    }
+
+    private let continuation: AsyncStream<DTraceRecordBatch>.Continuation
+    let decoder: DTraceRecordDecoder
+
+    /// Creates a record stream.
+    ///
+    /// - Parameters:
+    ///   - batchSize: Number of events per batch.
+    ///   - bufferedBatches: Batches held for a slow consumer before new
+    ///     ones are dropped.
+    public init(batchSize: Int = 4096, bufferedBatches: Int = 64) {
+        let (batches, continuation) = AsyncStream.makeStream(
+            of: DTraceRecordBatch.self,
+            bufferingPolicy: .bufferingOldest(max(bufferedBatches, 1))
+        )
+        self.batches = batches
+        self.continuation = continuation
+        self.decoder = DTraceRecordDecoder(batchSize: batchSize) { batch in
+            if case .dropped = continuation.yield(batch) {
+                return false
+            }
+            return true
+        }
+    }
+
+    deinit {
+        continuation.finish()
+    }
+
+    /// Number of batches dropped because the consumer fell behind.
+    public var droppedBatches: Int {
+        Int(decoder.droppedBatches)
+    }
+
+    /// Number of events in the dropped batches.
+    public var droppedEvents: Int {
+        Int(decoder.droppedEvents)
+    }
+
+    /// Yields any partial batch and ends ``batches``.
+    public func finish() {
+        decoder.flush()
+        continuation.finish()
+    }
+
+    // MARK: Producer
+
+    func begin(cpu: Int32, pdesc: UnsafePointer<dtrace_probedesc_t>?) {
+        decoder.begin(cpu: cpu, pdesc: pdesc)
+    }
+
+    func record(action: UInt16, size: Int, format: UInt16, data: UnsafeRawPointer) {
+        decoder.record(action: action, size: size, format: format, data: data)
+    }
+
+    func end() {
+        decoder.end()
+    }
+}
+
+// MARK: - Record Decoder
+
+/// Producer side shared by ``DTraceRecordStream`` and
+/// ``DTraceConsumer``: decodes records into the current batch and hands
+/// full batches to a delivery closure.
+///
+/// Touched only by the polling thread, except for the drop counters.
+final class DTraceRecordDecoder {
+
+    /// Number of events after which a batch is delivered.
+    let batchSize: Int
+
+    /// Hands a batch to the consumer. Returns `false` if it was dropped.
+    private let deliver: (DTraceRecordBatch) -> Bool
+
+    private var current: DTraceRecordBatch
+    private var probes: [UnsafeRawPointer: DTraceProbeDescription] = [:]
+
+    private let lock = NSLock()
+    private var _droppedBatches: UInt64 = 0
+    private var _droppedEvents: UInt64 = 0
+    private var _deliveredEvents: UInt64 = 0
+
+    init(batchSize: Int, deliver: @escaping (DTraceRecordBatch) -> Bool) {
+        self.batchSize = max(batchSize, 1)
+        self.deliver = deliver
+        self.current = DTraceRecordBatch(capacity: self.batchSize)
+    }
+
+    /// Number of batches the consumer did not accept.
+    var droppedBatches: UInt64 {
+        lock.lock()
+        defer { lock.unlock() }
+        return _droppedBatches
+    }
+
+    /// Number of events in the dropped batches.
+    var droppedEvents: UInt64 {
+        lock.lock()
+        defer { lock.unlock() }
+        return _droppedEvents
+    }
+
+    /// Number of events the consumer accepted.
+    var deliveredEvents: UInt64 {
+        lock.lock()
+        defer { lock.unlock() }
+        return _deliveredEvents
+    }
+
+    /// Starts an event for a probe firing.
+    func begin(cpu: Int32, pdesc: UnsafePointer<dtrace_probedesc_t>?) {
+        current.begin(cpu: cpu, probe: probe(for: pdesc))
+    }
+
+    /// Decodes one record into the current event.
+    func record(action: UInt16, size: Int, format: UInt16, data: UnsafeRawPointer) {
+        guard let value = DTraceRecordValue.decode(action: action, size: size, format: format, data: data) else {
+            return
+        }
+        current.append(value)
+
+        // A printf-like record that carries data holds the action's
+        // first argument.
+        if case .format = value, size > 0,
+           let argument = DTraceRecordValue.decode(
+               action: UInt16(CDTRACE_ACT_DIFEXPR.rawValue), size: size, format: 0, data: data
+           ) {
+            current.append(argument)
+        }
+    }
+
+    /// Ends the current event, delivering the batch if it is full.
+    func end() {
+        if current.count >= batchSize {
+            flush()
+        }
+    }
+
+    /// Delivers the current batch if it holds any events.
+    func flush() {
+        guard !current.isEmpty else { return }
+        let batch = current
+        current = DTraceRecordBatch(capacity: batchSize)
+        let accepted = deliver(batch)
+        lock.lock()
+        if accepted {
+            _deliveredEvents += UInt64(batch.count)
+        } else {
+            _droppedBatches += 1
+            _droppedEvents += UInt64(batch.count)
+        }
+        lock.unlock()
+    }
+
+    /// Returns the description of a probe, decoding it the first time
+    /// it fires. libdtrace keeps one description per enabled probe for
+    /// the life of the handle, so its address is a stable key.
+    private func probe(for pdesc: UnsafePointer<dtrace_probedesc_t>?) -> DTraceProbeDescription {
+        guard let pdesc else {
+            return DTraceProbeDescription(id: 0, provider: "", module: "", function: "", name: "")
+        }
+        let key = UnsafeRawPointer(pdesc)
+        if let probe = probes[key] {
+            return probe
+        }
+        let probe = DTraceProbeDescription(
+            id: cdtrace_probedesc_id(pdesc),
+            provider: String(cString: cdtrace_probedesc_provider(pdesc)),
+            module: String(cString: cdtrace_probedesc_mod(pdesc)),
+            function: String(cString: cdtrace_probedesc_func(pdesc)),
+            name: String(cString: cdtrace_probedesc_name(pdesc))
+        )
+        probes[key] = probe
+        return probe
+    }
+}
+
+// MARK: - Handle Integration
+
+extension DTraceHandle {
+
+    /// Processes available trace data, decoding records into `stream`.
+    ///
+    /// Behaves like ``poll()`` but formats nothing: every record is
+    /// decoded into the stream's current batch, and the batch is
+    /// yielded before returning.
+    ///
+    /// - Parameter stream: The stream to deliver records to.
+    /// - Returns: `.okay` to continue polling, `.done` when tracing
+    ///   finished, `.error` on failure.
+    public func poll(into stream: DTraceRecordStream) -> DTraceWorkStatus {
+        poll(decoder: stream.decoder)
+    }
+
+    /// Processes available trace data into a record decoder, then
+    /// delivers its partial batch.
+    func poll(decoder: DTraceRecordDecoder) -> DTraceWorkStatus {
+        guard let h = _handle else { return .error }
+        // Every record callback returns NEXT, so libdtrace never
+        // formats a record and the NULL FILE* is never written.
+        let status = withExtendedLifetime(decoder) {
+            cdtrace_work(h, nil, recordProbeCallback, recordRecCallback,
+                         Unmanaged.passUnretained(decoder).toOpaque())
+        }
+        decoder.flush()
+        return DTraceWorkStatus(from: status)
+    }
+
+    /// Consumes available trace data once, decoding records into
+    /// `stream`.
+    ///
+    /// Unlike ``poll(into:)``, does not check whether tracing has
+    /// finished.
+    ///
+    /// - Parameter stream: The stream to deliver records to.
+    /// - Throws: `DTraceCoreError.consumeFailed` if consumption fails.
+    public func consume(into stream: DTraceRecordStream) throws {
+        guard let h = _handle else { throw DTraceCoreError.invalidHandle }
+        let decoder = stream.decoder
+        let result = withExtendedLifetime(decoder) {
+            cdtrace_consume(h, nil, recordProbeCallback, recordRecCallback,
+                            Unmanaged.passUnretained(decoder).toOpaque())
+        }
+        decoder.flush()
+        if result < 0 {
+            throw DTraceCoreError.consumeFailed(message: lastErrorMessage)
+        }
+    }
+}
+
+// MARK: - Record Internals
+
+private func recordProbeCallback(
+    _ data: UnsafePointer<dtrace_probedata_t>?,
+    _ arg: UnsafeMutableRawPointer?
+) -> Int32 {
+    guard let data = data, let arg = arg else {
+        return DTRACE_CONSUME_NEXT
+    }
+    let decoder = Unmanaged<DTraceRecordDecoder>.fromOpaque(arg).takeUnretainedValue()
+    decoder.begin(cpu: cdtrace_probedata_cpu(data), pdesc: cdtrace_probedata_pdesc(data))
+    return DTRACE_CONSUME_THIS
+}
+
+private func recordRecCallback(
+    _ data: UnsafePointer<dtrace_probedata_t>?,
+    _ rec: UnsafePointer<dtrace_recdesc_t>?,
+    _ arg: UnsafeMutableRawPointer?
+) -> Int32 {
+    guard let arg = arg else {
+        return DTRACE_CONSUME_NEXT
+    }
+    let decoder = Unmanaged<DTraceRecordDecoder>.fromOpaque(arg).takeUnretainedValue()
+
+    // A NULL record is the epilogue that ends each probe firing.
+    guard let rec = rec else {
+        decoder.end()
+        return DTRACE_CONSUME_NEXT
+    }
+
+    // libdtrace points dtpda_data at the current record.
+    if let data = data, let bytes = cdtrace_probedata_data(data) {
+        decoder.record(
+            action: cdtrace_recdesc_action(rec),
+            size: Int(cdtrace_recdesc_size(rec)),
+            format: cdtrace_recdesc_format(rec),
+            data: UnsafeRawPointer(bytes)
+        )
+    }
+    return DTRACE_CONSUME_NEXT
+}
@@ -217,6 +217,30 @@ public extension SocketDescriptor where Self: ~Copyable {
     func sendDescriptors(
         _ descriptors: [OpaqueDescriptorRef],
         payload: Data
+    ) throws {
+        // Allow empty payload for FD-only messages
+        // Use a 1-byte dummy if payload is empty (portable pattern)
+        let actualPayload = payload.isEmpty ? Data([0]) : payload
+
+        try actualPayload.withUnsafeBytes { payloadPtr in
+            try sendDescriptors(descriptors, gathering: [payloadPtr])
+        }
+    }
+
+    /// Sends descriptors with a payload gathered from several buffers.
+    ///
+    /// The segments are handed to `sendmsg(2)` as an iovec array, so the kernel
+    /// copies them straight into the socket buffer without the caller first
+    /// concatenating them. On SEQPACKET sockets the segments form one record.
+    ///
+    /// - Parameters:
+    ///   - descriptors: Descriptors to pass via `SCM_RIGHTS`.
+    ///   - segments: Buffers to send, in order. Empty segments are skipped;
+    ///     at least one byte must be sent in total.
+    /// - Throws: A BSD error if the send fails.
+    func sendDescriptors(
+        _ descriptors: [OpaqueDescriptorRef],
+        gathering segments: [UnsafeRawBufferPointer]
     ) throws {
         try self.unsafe { sockFD in
             var rawFDs: [RawDesc] = []
@@ -230,51 +254,51 @@ public extension SocketDescriptor where Self: ~Copyable {
                 rawFDs.append(rawFD)
             }
 
-            // Allow empty payload for FD-only messages
-            // Use a 1-byte dummy if payload is empty (portable pattern)
-            let actualPayload = payload.isEmpty ? Data([0]) : payload
+            var iovecs: [iovec] = segments.compactMap { segment in
+                guard segment.count > 0 else { return nil }
+                return iovec(
+                    iov_base: UnsafeMutableRawPointer(mutating: segment.baseAddress),
+                    iov_len: segment.count
+                )
+            }
+            guard !iovecs.isEmpty else {
+                throw POSIXError(.EINVAL)
+            }
 
             let controlLen = CMSG_SPACE(rawFDs.count * MemoryLayout<RawDesc>.size)
             var control = [UInt8](repeating: 0, count: controlLen)
 
-            try actualPayload.withUnsafeBytes { payloadPtr in
-                var iov = iovec(
-                    iov_base: UnsafeMutableRawPointer(mutating: payloadPtr.baseAddress),
-                    iov_len: payloadPtr.count
-                )
-
-                try control.withUnsafeMutableBytes { ctrlPtr in
-                    try withUnsafeMutablePointer(to: &iov) { iovPtr in
-                        var msg = msghdr(
-                            msg_name: nil,
-                            msg_namelen: 0,
-                            msg_iov: iovPtr,
-                            msg_iovlen: 1,
-                            msg_control: ctrlPtr.baseAddress,
-                            msg_controllen: socklen_t(ctrlPtr.count),
-                            msg_flags: 0
-                        )
+            try control.withUnsafeMutableBytes { ctrlPtr in
+                try iovecs.withUnsafeMutableBufferPointer { iovPtr in
+                    var msg = msghdr(
+                        msg_name: nil,
+                        msg_namelen: 0,
+                        msg_iov: iovPtr.baseAddress,
+                        msg_iovlen: Int32(iovPtr.count),
+                        msg_control: ctrlPtr.baseAddress,
+                        msg_controllen: socklen_t(ctrlPtr.count),
+                        msg_flags: 0
+                    )
 
-                        guard let cmsg = CMSG_FIRSTHDR(&msg) else {
-                            throw POSIXError(.EINVAL)
-                        }
+                    guard let cmsg = CMSG_FIRSTHDR(&msg) else {
+                        throw POSIXError(.EINVAL)
+                    }
 
-                        cmsg.pointee.cmsg_level = SOL_SOCKET
-                        cmsg.pointee.cmsg_type  = SCM_RIGHTS
-                        cmsg.pointee.cmsg_len   =
-                            socklen_t(CMSG_LEN(rawFDs.count * MemoryLayout<RawDesc>.size))
+                    cmsg.pointee.cmsg_level = SOL_SOCKET
+                    cmsg.pointee.cmsg_type  = SCM_RIGHTS
+                    cmsg.pointee.cmsg_len   =
+                        socklen_t(CMSG_LEN(rawFDs.count * MemoryLayout<RawDesc>.size))
 
-                        let dataPtr = CMSG_DATA(cmsg).assumingMemoryBound(to: RawDesc.self)
-                        for (i, fd) in rawFDs.enumerated() {
-                            dataPtr[i] = fd
-                        }
+                    let dataPtr = CMSG_DATA(cmsg).assumingMemoryBound(to: RawDesc.self)
+                    for (i, fd) in rawFDs.enumerated() {
+                        dataPtr[i] = fd
+                    }
 
-                        // MSG_EOR marks end-of-record for SEQPACKET sockets.
-                        // This preserves message boundaries on the receiving side.
-                        let ret = Glibc.sendmsg(sockFD, &msg, MSG_NOSIGNAL | MSG_EOR)
-                        guard ret >= 0 else {
-                            try BSDError.throwErrno(errno)
-                        }
+                    // MSG_EOR marks end-of-record for SEQPACKET sockets.
+                    // This preserves message boundaries on the receiving side.
+                    let ret = Glibc.sendmsg(sockFD, &msg, MSG_NOSIGNAL | MSG_EOR)
+                    guard ret >= 0 else {
+                        try BSDError.throwErrno(errno)
                     }
                 }
             }
@@ -467,6 +491,23 @@ public extension SocketDescriptor where Self: ~Copyable {
         }
     }
 
+    /// Stops persistent credential delivery enabled by
+    /// ``enablePersistentCredentials()``.
+    ///
+    /// Subsequent messages carry no `SCM_CREDS2` control message, so the
+    /// kernel no longer builds one per send. Connection-time credentials
+    /// remain available via `LOCAL_PEERCRED`.
+    ///
+    /// - Throws: A BSD error if the socket option cannot be set.
+    func disablePersistentCredentials() throws {
+        try self.unsafe { fd in
+            var zero: Int32 = 0
+            guard setsockopt(fd, SOL_LOCAL, LOCAL_CREDS_PERSISTENT, &zero, socklen_t(MemoryLayout<Int32>.size)) == 0 else {
+                try BSDError.throwErrno(errno)
+            }
+        }
+    }
+
     /// Receives data, file descriptors, and optionally sender credentials.
     ///
     /// This is an extended version of `recvDescriptors` that also parses
@@ -484,11 +525,7 @@ public extension SocketDescriptor where Self: ~Copyable {
         try self.unsafe { sockFD in
             var buffer = [UInt8](repeating: 0, count: bufferSize)
 
-            // Calculate control buffer size to accommodate both SCM_RIGHTS and SCM_CREDS2
-            // SCM_CREDS2 uses sockcred2 which has a variable-length groups array
-            let rightsSpace = CMSG_SPACE(maxDescriptors * MemoryLayout<RawDesc>.size)
-            let credsSpace = CMSG_SPACE(MemoryLayout<sockcred2>.size + Int(NGROUPS_MAX) * MemoryLayout<gid_t>.size)
-            let controlLen = rightsSpace + credsSpace
+            let controlLen = rightsAndCredentialsSpace(maxDescriptors: maxDescriptors)
 
             var control = [UInt8](repeating: 0, count: controlLen)
 
@@ -526,79 +563,541 @@ public extension SocketDescriptor where Self: ~Copyable {
                             throw POSIXError(.EMSGSIZE)
                         }
 
-                        var receivedFDs: [OpaqueDescriptorRef] = []
-                        var credentials: SocketCredentials? = nil
+                        let (receivedFDs, credentials) = try parseRightsAndCredentials(&msg)
 
-                        var cmsg = CMSG_FIRSTHDR(&msg)
-                        while let hdr = cmsg {
-                            if hdr.pointee.cmsg_level == SOL_SOCKET &&
-                               hdr.pointee.cmsg_type == SCM_RIGHTS {
-                                // Parse file descriptors
-                                let dataLen = Int(hdr.pointee.cmsg_len) - CMSG_LEN(0)
+                        let data = Data(bytes: bufPtr.baseAddress!, count: bytesRead)
 
-                                guard dataLen >= 0 else {
-                                    throw POSIXError(.EINVAL)
-                                }
+                        return RecvDescriptorsResult(
+                            data: data,
+                            descriptors: receivedFDs,
+                            credentials: credentials
+                        )
+                    }
+                }
+            }
+        }
+    }
+}
 
-                                guard dataLen % MemoryLayout<RawDesc>.size == 0 else {
-                                    throw POSIXError(.EINVAL)
-                                }
+// MARK: - Recycled Receive Buffers
 
-                                let count = dataLen / MemoryLayout<RawDesc>.size
-                                let dataPtr = CMSG_DATA(hdr).assumingMemoryBound(to: Int32.self)
+/// Reusable control-message storage for
+/// ``SocketDescriptor/recvDescriptorsWithCredentials(into:control:)``.
+///
+/// Sized once for `SCM_RIGHTS` plus `SCM_CREDS2`, so repeated receives
+/// neither allocate nor zero a control buffer. A control buffer must only be
+/// used by one receiver at a time.
+public final class RecvControlBuffer: @unchecked Sendable {
+    fileprivate let storage: UnsafeMutableRawBufferPointer
+
+    /// - Parameter maxDescriptors: Maximum descriptors accepted per message.
+    public init(maxDescriptors: Int = 8) {
+        self.storage = .allocate(
+            byteCount: rightsAndCredentialsSpace(maxDescriptors: maxDescriptors),
+            alignment: MemoryLayout<cmsghdr>.alignment
+        )
+    }
 
-                                for i in 0..<count {
-                                    receivedFDs.append(OpaqueDescriptorRef(dataPtr[i]))
-                                }
-                            } else if hdr.pointee.cmsg_level == SOL_SOCKET &&
-                                      hdr.pointee.cmsg_type == SCM_CREDS2 {
-                                // Parse credentials
-                                let dataLen = Int(hdr.pointee.cmsg_len) - CMSG_LEN(0)
-
-                                guard dataLen >= MemoryLayout<sockcred2>.size else {
-                                    // Invalid credentials, skip but don't fail
-                                    cmsg = CMSG_NXTHDR(&msg, hdr)
-                                    continue
-                                }
+    deinit {
+        storage.deallocate()
+    }
+}
 
-                                let credsPtr = CMSG_DATA(hdr).assumingMemoryBound(to: sockcred2.self)
-                                let sc = credsPtr.pointee
-
-                                // Extract supplementary groups
-                                var groupList: [gid_t] = []
-                                let ngroups = Int(sc.sc_ngroups)
-                                if ngroups > 0 {
-                                    withUnsafePointer(to: credsPtr.pointee.sc_groups) { groupsPtr in
-                                        let gidsPtr = UnsafeRawPointer(groupsPtr).assumingMemoryBound(to: gid_t.self)
-                                        for i in 0..<min(ngroups, Int(NGROUPS_MAX)) {
-                                            groupList.append(gidsPtr[i])
-                                        }
-                                    }
-                                }
+/// Remembers the last `SCM_CREDS2` payload received on a socket.
+///
+/// Credentials rarely change within a connection. When a receive is given a
+/// cache, the raw `sockcred2` bytes are compared with the previous message's
+/// and, if identical, the previously built ``SocketCredentials`` is returned
+/// unchanged, so its `groups` array is shared rather than rebuilt. A cache
+/// must only be used by one receiver at a time.
+public final class SocketCredentialCache: @unchecked Sendable {
+    private let storage: UnsafeMutableRawBufferPointer
+    private var length = 0
+    private var cached: SocketCredentials?
+
+    /// Receives answered from the cache.
+    public private(set) var hits = 0
+
+    /// Receives that decoded new credentials.
+    public private(set) var misses = 0
+
+    public init() {
+        self.storage = .allocate(
+            byteCount: MemoryLayout<sockcred2>.size + Int(NGROUPS_MAX) * MemoryLayout<gid_t>.size,
+            alignment: MemoryLayout<sockcred2>.alignment
+        )
+    }
 
-                                credentials = SocketCredentials(
-                                    realUID: sc.sc_uid,
-                                    effectiveUID: sc.sc_euid,
-                                    realGID: sc.sc_gid,
-                                    effectiveGID: sc.sc_egid,
-                                    pid: sc.sc_pid,
-                                    groups: groupList
-                                )
-                            }
+    deinit {
+        storage.deallocate()
+    }
 
-                            cmsg = CMSG_NXTHDR(&msg, hdr)
+    /// Returns the cached credentials if `raw` matches the last stored bytes.
+    fileprivate func lookup(_ raw: UnsafeRawBufferPointer) -> SocketCredentials? {
+        guard let cached, raw.count == length,
+              memcmp(storage.baseAddress!, raw.baseAddress!, length) == 0 else {
+            misses += 1
+            return nil
+        }
+        hits += 1
+        return cached
+    }
+
+    fileprivate func store(_ raw: UnsafeRawBufferPointer, as credentials: SocketCredentials) {
+        guard raw.count <= storage.count else {
+            cached = nil
+            return
+        }
+        storage.copyMemory(from: raw)
+        length = raw.count
+        cached = credentials
+    }
+}
+
+public extension SocketDescriptor where Self: ~Copyable {
+
+    /// Receives one message into caller-owned storage.
+    ///
+    /// Behaves like ``recvDescriptorsWithCredentials(maxDescriptors:bufferSize:)``
+    /// but reads the payload into `buffer` and the control data into `control`
+    /// instead of allocating both per call. The payload is left in `buffer`;
+    /// nothing is copied into a `Data`.
+    ///
+    /// - Parameters:
+    ///   - buffer: Destination for the payload.
+    ///   - control: Reusable control-message storage.
+    ///   - credentialCache: Optional cache that reuses the previous
+    ///     message's credentials when the raw `SCM_CREDS2` bytes match.
+    /// - Returns: The byte count, descriptors, and optional credentials.
+    /// - Throws: A BSD error if receiving fails, or `EMSGSIZE` if the message
+    ///   or its control data was truncated.
+    func recvDescriptorsWithCredentials(
+        into buffer: UnsafeMutableRawBufferPointer,
+        control: RecvControlBuffer,
+        credentialCache: SocketCredentialCache? = nil
+    ) throws -> RecvRecord {
+        try self.unsafe { sockFD in
+            var iov = iovec(
+                iov_base: buffer.baseAddress,
+                iov_len: buffer.count
+            )
+
+            return try withUnsafeMutablePointer(to: &iov) { iovPtr in
+                var msg = msghdr(
+                    msg_name: nil,
+                    msg_namelen: 0,
+                    msg_iov: iovPtr,
+                    msg_iovlen: 1,
+                    msg_control: control.storage.baseAddress,
+                    msg_controllen: socklen_t(control.storage.count),
+                    msg_flags: 0
+                )
+
+                let bytesRead = Glibc.recvmsg(sockFD, &msg, MSG_CMSG_CLOEXEC)
+                guard bytesRead >= 0 else {
+                    try BSDError.throwErrno(errno)
+                }
+
+                // Parse before checking truncation so received descriptors are closed
+                let (descriptors, credentials) = try parseRightsAndCredentials(&msg, cache: credentialCache)
+
+                if (msg.msg_flags & MSG_CTRUNC) != 0 || (msg.msg_flags & MSG_TRUNC) != 0 {
+                    throw POSIXError(.EMSGSIZE)
+                }
+
+                return RecvRecord(
+                    byteCount: bytesRead,
+                    descriptors: descriptors,
+                    credentials: credentials
+                )
+            }
+        }
+    }
+}
+
+// MARK: - Batched I/O (sendmmsg/recvmmsg)
+
+/// One outgoing record for ``SocketDescriptor/sendMultiple(_:)``.
+///
+/// The segment pointers must stay valid for the duration of the call.
+public struct SendRecord {
+    /// Descriptors to pass via `SCM_RIGHTS` with this record.
+    public var descriptors: [OpaqueDescriptorRef]
+
+    /// Buffers forming the record, in order. Empty segments are skipped.
+    public var segments: [UnsafeRawBufferPointer]
+
+    public init(descriptors: [OpaqueDescriptorRef] = [], segments: [UnsafeRawBufferPointer]) {
+        self.descriptors = descriptors
+        self.segments = segments
+    }
+}
+
+/// One record received into caller-owned storage, by
+/// ``SocketDescriptor/recvMultipleWithCredentials(into:waitForOne:)`` or
+/// ``SocketDescriptor/recvDescriptorsWithCredentials(into:control:)``.
+///
+/// The payload bytes stay in the caller's buffer (for a batch, the
+/// ``RecvBatchBuffer`` slot with the same index) and are only valid until
+/// that buffer is reused.
+public struct RecvRecord: Sendable {
+    /// Number of payload bytes received into the slot.
+    public let byteCount: Int
+
+    /// File descriptors received via SCM_RIGHTS.
+    public let descriptors: [OpaqueDescriptorRef]
+
+    /// Sender credentials from SCM_CREDS2, if available.
+    public let credentials: SocketCredentials?
+}
+
+/// Reusable receive storage for `recvmmsg(2)`.
+///
+/// Allocates one data slot and one control slot per record, plus the iovec
+/// and `mmsghdr` vectors, once up front so that draining a batch performs no
+/// allocation beyond the returned descriptor arrays.
+///
+/// A batch buffer must only be used by one receiver at a time.
+public final class RecvBatchBuffer: @unchecked Sendable {
+    /// Maximum number of records received per call.
+    public let capacity: Int
+
+    /// Size of each record's data slot.
+    public let recordSize: Int
+
+    private let controlSize: Int
+    /// Failure held back so the records received before it could be returned.
+    fileprivate var deferredError: Error?
+    private let data: UnsafeMutableRawPointer
+    private let control: UnsafeMutableRawPointer
+    private let iovecs: UnsafeMutablePointer<iovec>
+    fileprivate let headers: UnsafeMutablePointer<mmsghdr>
+
+    /// Creates batch storage.
+    ///
+    /// - Parameters:
+    ///   - capacity: Maximum records per receive (minimum 1).
+    ///   - recordSize: Data slot size; larger records are reported as `EMSGSIZE`.
+    ///   - maxDescriptors: Maximum descriptors accepted per record.
+    public init(capacity: Int, recordSize: Int, maxDescriptors: Int = 8) {
+        self.capacity = max(capacity, 1)
+        self.recordSize = recordSize
+        self.controlSize = rightsAndCredentialsSpace(maxDescriptors: maxDescriptors)
+
+        self.data = .allocate(byteCount: self.capacity * recordSize, alignment: 16)
+        self.control = .allocate(
+            byteCount: self.capacity * controlSize,
+            alignment: MemoryLayout<cmsghdr>.alignment
+        )
+        self.iovecs = .allocate(capacity: self.capacity)
+        self.headers = .allocate(capacity: self.capacity)
+
+        for i in 0..<self.capacity {
+            (iovecs + i).initialize(to: iovec(
+                iov_base: data + i * recordSize,
+                iov_len: recordSize
+            ))
+        }
+        reset()
+    }
+
+    deinit {
+        data.deallocate()
+        control.deallocate()
+        iovecs.deallocate()
+        headers.deallocate()
+    }
+
+    /// Payload bytes of the record received into slot `index`.
+    public func bytes(at index: Int, count: Int) -> UnsafeRawBufferPointer {
+        precondition(index < capacity && count <= recordSize)
+        return UnsafeRawBufferPointer(start: data + index * recordSize, count: count)
+    }
+
+    /// Restores every header before a receive; the kernel rewrites
+    /// `msg_controllen` and `msg_flags` on each call.
+    fileprivate func reset() {
+        for i in 0..<capacity {
+            (headers + i).initialize(to: mmsghdr(
+                msg_hdr: msghdr(
+                    msg_name: nil,
+                    msg_namelen: 0,
+                    msg_iov: iovecs + i,
+                    msg_iovlen: 1,
+                    msg_control: control + i * controlSize,
+                    msg_controllen: socklen_t(controlSize),
+                    msg_flags: 0
+                ),
+                msg_len: 0
+            ))
+        }
+    }
+}
+
+public extension SocketDescriptor where Self: ~Copyable {
+
+    /// Sends several records with a single `sendmmsg(2)` call.
+    ///
+    /// Each record is sent as its own SEQPACKET record (`MSG_EOR`), exactly as
+    /// if ``sendDescriptors(_:gathering:)`` had been called once per record.
+    ///
+    /// The kernel may stop early, e.g. when the socket buffer fills on a
+    /// non-blocking socket; the caller resends from the returned index.
+    ///
+    /// - Parameter records: Records to send, in order.
+    /// - Returns: Number of leading records that were sent.
+    /// - Throws: A BSD error if the first record could not be sent.
+    func sendMultiple(_ records: [SendRecord]) throws -> Int {
+        guard !records.isEmpty else { return 0 }
+
+        return try self.unsafe { sockFD in
+            let iovCount = records.reduce(0) { $0 + $1.segments.count }
+            var controlOffsets: [Int] = []
+            controlOffsets.reserveCapacity(records.count)
+            var controlLen = 0
+            for record in records {
+                controlOffsets.append(controlLen)
+                if !record.descriptors.isEmpty {
+                    controlLen += CMSG_SPACE(record.descriptors.count * MemoryLayout<RawDesc>.size)
+                }
+            }
+
+            let iovecs = UnsafeMutablePointer<iovec>.allocate(capacity: max(iovCount, 1))
+            defer { iovecs.deallocate() }
+            let control = UnsafeMutableRawPointer.allocate(
+                byteCount: max(controlLen, 1),
+                alignment: MemoryLayout<cmsghdr>.alignment
+            )
+            defer { control.deallocate() }
+            control.initializeMemory(as: UInt8.self, repeating: 0, count: max(controlLen, 1))
+            let headers = UnsafeMutablePointer<mmsghdr>.allocate(capacity: records.count)
+            defer { headers.deallocate() }
+
+            var iovIndex = 0
+            for (i, record) in records.enumerated() {
+                let first = iovIndex
+                for segment in record.segments where segment.count > 0 {
+                    (iovecs + iovIndex).initialize(to: iovec(
+                        iov_base: UnsafeMutableRawPointer(mutating: segment.baseAddress),
+                        iov_len: segment.count
+                    ))
+                    iovIndex += 1
+                }
+                guard iovIndex > first else {
+                    throw POSIXError(.EINVAL)
+                }
+
+                var msg = msghdr(
+                    msg_name: nil,
+                    msg_namelen: 0,
+                    msg_iov: iovecs + first,
+                    msg_iovlen: Int32(iovIndex - first),
+                    msg_control: nil,
+                    msg_controllen: 0,
+                    msg_flags: 0
+                )
+
+                if !record.descriptors.isEmpty {
+                    let dataLen = record.descriptors.count * MemoryLayout<RawDesc>.size
+                    let cmsg = (control + controlOffsets[i]).assumingMemoryBound(to: cmsghdr.self)
+                    cmsg.pointee.cmsg_level = SOL_SOCKET
+                    cmsg.pointee.cmsg_type  = SCM_RIGHTS
+                    cmsg.pointee.cmsg_len   = socklen_t(CMSG_LEN(dataLen))
+
+                    let dataPtr = CMSG_DATA(cmsg).assumingMemoryBound(to: RawDesc.self)
+                    for (j, d) in record.descriptors.enumerated() {
+                        guard let rawFD = d.toBSDValue() else {
+                            throw POSIXError(.EINVAL)
                         }
+                        dataPtr[j] = rawFD
+                    }
 
-                        let data = Data(bytes: bufPtr.baseAddress!, count: bytesRead)
+                    msg.msg_control = UnsafeMutableRawPointer(cmsg)
+                    msg.msg_controllen = socklen_t(CMSG_SPACE(dataLen))
+                }
 
-                        return RecvDescriptorsResult(
-                            data: data,
-                            descriptors: receivedFDs,
-                            credentials: credentials
-                        )
+                (headers + i).initialize(to: mmsghdr(msg_hdr: msg, msg_len: 0))
+            }
+
+            let sent = Glibc.sendmmsg(sockFD, headers, records.count, MSG_NOSIGNAL | MSG_EOR)
+            guard sent >= 0 else {
+                try BSDError.throwErrno(errno)
+            }
+            return sent
+        }
+    }
+
+    /// Receives up to `batch.capacity` records with a single `recvmmsg(2)` call.
+    ///
+    /// Payload bytes land in the batch buffer's slots; descriptors and
+    /// `SCM_CREDS2` credentials are parsed per record as in
+    /// ``recvDescriptorsWithCredentials(maxDescriptors:bufferSize:)``.
+    ///
+    /// - Parameters:
+    ///   - batch: Reusable receive storage.
+    ///   - waitForOne: Block only until the first record arrives
+    ///     (`MSG_WAITFORONE`), then return whatever else is already queued.
+    ///   - credentialCache: Optional cache that reuses the previous record's
+    ///     credentials when the raw `SCM_CREDS2` bytes match.
+    /// If a record is rejected after earlier records in the same call were
+    /// received intact, those records are returned and the error is thrown
+    /// by the next call on `batch` instead. Descriptors carried by the
+    /// rejected record and every record after it are closed.
+    ///
+    /// - Returns: The received records; slot `i` holds record `i`'s payload.
+    /// - Throws: A BSD error if receiving fails, or `EMSGSIZE` if a record or
+    ///   its control data was truncated.
+    func recvMultipleWithCredentials(
+        into batch: RecvBatchBuffer,
+        waitForOne: Bool = true,
+        credentialCache: SocketCredentialCache? = nil
+    ) throws -> [RecvRecord] {
+        try self.unsafe { sockFD in
+            if let error = batch.deferredError {
+                batch.deferredError = nil
+                throw error
+            }
+            batch.reset()
+
+            var flags = MSG_CMSG_CLOEXEC
+            if waitForOne {
+                flags |= MSG_WAITFORONE
+            }
+
+            let count = Glibc.recvmmsg(sockFD, batch.headers, batch.capacity, flags, nil)
+            guard count >= 0 else {
+                try BSDError.throwErrno(errno)
+            }
+
+            var records: [RecvRecord] = []
+            records.reserveCapacity(count)
+            var failure: Error?
+            for i in 0..<count {
+                let header = batch.headers + i
+                do {
+                    // Parse before checking truncation so received descriptors
+                    // are owned (and closed) even when the record is rejected.
+                    // After a failure, later records are still parsed so that
+                    // their descriptors are closed rather than leaked.
+                    let (descriptors, credentials) = try parseRightsAndCredentials(
+                        &header.pointee.msg_hdr,
+                        cache: credentialCache
+                    )
+                    guard failure == nil else { continue }
+
+                    let msgFlags = header.pointee.msg_hdr.msg_flags
+                    if (msgFlags & MSG_CTRUNC) != 0 || (msgFlags & MSG_TRUNC) != 0 {
+                        throw POSIXError(.EMSGSIZE)
+                    }
+
+                    records.append(RecvRecord(
+                        byteCount: Int(header.pointee.msg_len),
+                        descriptors: descriptors,
+                        credentials: credentials
+                    ))
+                } catch {
+                    failure = failure ?? error
+                }
+            }
+
+            if let failure {
+                guard !records.isEmpty else { throw failure }
+                batch.deferredError = failure
+            }
+            return records
+        }
+    }
+}
+
+// MARK: - Control Message Parsing
+
+/// Control buffer space for `maxDescriptors` `SCM_RIGHTS` descriptors plus an
+/// `SCM_CREDS2` message. `sockcred2` ends in a variable-length groups array,
+/// so room is left for `NGROUPS_MAX` groups.
+private func rightsAndCredentialsSpace(maxDescriptors: Int) -> Int {
+    CMSG_SPACE(maxDescriptors * MemoryLayout<RawDesc>.size) +
+    CMSG_SPACE(MemoryLayout<sockcred2>.size + Int(NGROUPS_MAX) * MemoryLayout<gid_t>.size)
+}
+
+/// Extracts `SCM_RIGHTS` descriptors and `SCM_CREDS2` credentials from a
+/// message filled in by `recvmsg(2)` or `recvmmsg(2)`. With a `cache`,
+/// credentials whose raw bytes match the previous message's are not decoded
+/// again.
+private func parseRightsAndCredentials(
+    _ msg: UnsafePointer<msghdr>,
+    cache: SocketCredentialCache? = nil
+) throws -> ([OpaqueDescriptorRef], SocketCredentials?) {
+    var receivedFDs: [OpaqueDescriptorRef] = []
+    var credentials: SocketCredentials? = nil
+
+    var cmsg = CMSG_FIRSTHDR(msg)
+    while let hdr = cmsg {
+        if hdr.pointee.cmsg_level == SOL_SOCKET &&
+           hdr.pointee.cmsg_type == SCM_RIGHTS {
+            // Parse file descriptors
+            let dataLen = Int(hdr.pointee.cmsg_len) - CMSG_LEN(0)
+
+            guard dataLen >= 0 else {
+                throw POSIXError(.EINVAL)
+            }
+
+            guard dataLen % MemoryLayout<RawDesc>.size == 0 else {
+                throw POSIXError(.EINVAL)
+            }
+
+            let count = dataLen / MemoryLayout<RawDesc>.size
+            let dataPtr = CMSG_DATA(hdr).assumingMemoryBound(to: Int32.self)
+
+            for i in 0..<count {
+                receivedFDs.append(OpaqueDescriptorRef(dataPtr[i]))
+            }
+        } else if hdr.pointee.cmsg_level == SOL_SOCKET &&
+                  hdr.pointee.cmsg_type == SCM_CREDS2 {
+            // Parse credentials
+            let dataLen = Int(hdr.pointee.cmsg_len) - CMSG_LEN(0)
+
+            guard dataLen >= MemoryLayout<sockcred2>.size else {
+                // Invalid credentials, skip but don't fail
+                cmsg = CMSG_NXTHDR(msg, hdr)
+                continue
+            }
+
+            let raw = UnsafeRawBufferPointer(start: CMSG_DATA(hdr), count: dataLen)
+            if let cache, let hit = cache.lookup(raw) {
+                credentials = hit
+                cmsg = CMSG_NXTHDR(msg, hdr)
+                continue
+            }
+
+            let credsPtr = CMSG_DATA(hdr).assumingMemoryBound(to: sockcred2.self)
+            let sc = credsPtr.pointee
+
+            // Extract supplementary groups
+            var groupList: [gid_t] = []
+            let ngroups = Int(sc.sc_ngroups)
+            if ngroups > 0 {
+                withUnsafePointer(to: credsPtr.pointee.sc_groups) { groupsPtr in
+                    let gidsPtr = UnsafeRawPointer(groupsPtr).assumingMemoryBound(to: gid_t.self)
+                    for i in 0..<min(ngroups, Int(NGROUPS_MAX)) {
+                        groupList.append(gidsPtr[i])
                     }
                 }
             }
+
+            let decoded = SocketCredentials(
+                realUID: sc.sc_uid,
+                effectiveUID: sc.sc_euid,
+                realGID: sc.sc_gid,
+                effectiveGID: sc.sc_egid,
+                pid: sc.sc_pid,
+                groups: groupList
+            )
+            cache?.store(raw, as: decoded)
+            credentials = decoded
         }
+
+        cmsg = CMSG_NXTHDR(msg, hdr)
     }
-}
\ No newline at end of file
+
+    return (receivedFDs, credentials)
+}
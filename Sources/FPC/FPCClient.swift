@@ -35,9 +35,14 @@ public struct FPCClient {
     /// - Parameters:
     ///   - path: The filesystem path of the server's socket
     ///   - ioQueue: Optional custom DispatchQueue for I/O operations. If `nil`, a default queue is created.
+    ///   - eventLoop: Optional shared ``FPCEventLoop`` to multiplex this connection on.
     /// - Returns: A new, unstarted ``FPCEndpoint``. Call ``start()`` before use.
     /// - Throws: A system error if the socket cannot be created or the connection is refused
-    public static func connect(path: String, ioQueue: DispatchQueue? = nil) throws -> FPCEndpoint {
+    public static func connect(
+        path: String,
+        ioQueue: DispatchQueue? = nil,
+        eventLoop: FPCEventLoop? = nil
+    ) throws -> FPCEndpoint {
         let socket = try SocketCapability.socket(
             domain: .unix,
             type: [.seqpacket, .cloexec],
@@ -49,7 +54,7 @@ public struct FPCClient {
         // Enable persistent credentials for per-message credential delivery
         try socket.enablePersistentCredentials()
 
-        return FPCEndpoint(socket: socket, ioQueue: ioQueue)
+        return FPCEndpoint(socket: socket, ioQueue: ioQueue, eventLoop: eventLoop)
     }
 
     /// Connects to a SEQPACKET FPC server using a path relative to a directory.
@@ -65,12 +70,14 @@ public struct FPCClient {
     ///   - directory: A directory descriptor to use as the base for the path.
     ///   - path: The relative path to the server's socket within the directory.
     ///   - ioQueue: Optional custom DispatchQueue for I/O operations. If `nil`, a default queue is created.
+    ///   - eventLoop: Optional shared ``FPCEventLoop`` to multiplex this connection on.
     /// - Returns: A new, unstarted ``FPCEndpoint``. Call ``start()`` before use.
     /// - Throws: A system error if the socket cannot be created or the connection is refused.
     public static func connect<D: DirectoryDescriptor>(
         at directory: borrowing D,
         path: String,
-        ioQueue: DispatchQueue? = nil
+        ioQueue: DispatchQueue? = nil,
+        eventLoop: FPCEventLoop? = nil
     ) throws -> FPCEndpoint where D: ~Copyable {
         let socket = try SocketCapability.socket(
             domain: .unix,
@@ -83,6 +90,6 @@ public struct FPCClient {
         // Enable persistent credentials for per-message credential delivery
         try socket.enablePersistentCredentials()
 
-        return FPCEndpoint(socket: socket, ioQueue: ioQueue)
+        return FPCEndpoint(socket: socket, ioQueue: ioQueue, eventLoop: eventLoop)
     }
 }
@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) 2026 Kory Heard
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+import Foundation
+
+// MARK: - CorrelationTable
+
+/// Open-addressing hash table from correlation ID to a pending request.
+///
+/// Correlation IDs are dense, monotonically increasing, non-zero `UInt64`s,
+/// so a flat table with Fibonacci hashing and linear probing keeps every
+/// lookup within a cache line or two and never allocates per request. Key 0
+/// marks an empty slot. Deletion uses backward shifting, so no tombstones
+/// accumulate under request churn.
+///
+/// The table has no internal synchronisation: ``FPCEndpoint`` only touches it
+/// from actor-isolated code.
+struct CorrelationTable<Value> {
+    private var keys: [UInt64]
+    private var values: [Value?]
+    private var mask: Int
+    private var shift: UInt64
+
+    /// Number of entries.
+    private(set) var count = 0
+
+    /// Creates a table sized for `capacity` entries without growing.
+    init(capacity: Int = 1024) {
+        let slots = Self.slotCount(for: capacity)
+        self.keys = [UInt64](repeating: 0, count: slots)
+        self.values = [Value?](repeating: nil, count: slots)
+        self.mask = slots - 1
+        self.shift = UInt64(64 - slots.trailingZeroBitCount)
+    }
+
+    var isEmpty: Bool { count == 0 }
+
+    /// Inserts or replaces the value for `key`.
+    ///
+    /// - Precondition: `key != 0`
+    mutating func insert(_ value: Value, for key: UInt64) {
+        precondition(key != 0, "correlation ID 0 is reserved")
+        if (count + 1) * 2 > keys.count {
+            grow()
+        }
+
+        var index = home(key)
+        while keys[index] != 0 {
+            if keys[index] == key {
+                values[index] = value
+                return
+            }
+            index = (index + 1) & mask
+        }
+        keys[index] = key
+        values[index] = value
+        count += 1
+    }
+
+    /// Returns the value for `key`, if present.
+    func value(forKey key: UInt64) -> Value? {
+        guard let index = find(key) else { return nil }
+        return values[index]
+    }
+
+    /// Removes and returns the value for `key`, if present.
+    @discardableResult
+    mutating func removeValue(forKey key: UInt64) -> Value? {
+        guard var hole = find(key) else { return nil }
+        let removed = values[hole]
+        keys[hole] = 0
+        values[hole] = nil
+        count -= 1
+
+        // Backward-shift deletion: pull later members of the probe run into
+        // the hole unless that would move them before their home slot.
+        var index = hole
+        while true {
+            index = (index + 1) & mask
+            let key = keys[index]
+            guard key != 0 else { break }
+
+            let home = home(key)
+            let inRange = hole <= index
+                ? (home > hole && home <= index)
+                : (home > hole || home <= index)
+            if !inRange {
+                keys[hole] = key
+                values[hole] = values[index]
+                keys[index] = 0
+                values[index] = nil
+                hole = index
+            }
+        }
+        return removed
+    }
+
+    /// Removes and returns every value, leaving the capacity in place.
+    mutating func removeAll() -> [Value] {
+        var drained: [Value] = []
+        drained.reserveCapacity(count)
+        for index in keys.indices where keys[index] != 0 {
+            if let value = values[index] {
+                drained.append(value)
+            }
+            keys[index] = 0
+            values[index] = nil
+        }
+        count = 0
+        return drained
+    }
+
+    // MARK: Private
+
+    private static func slotCount(for capacity: Int) -> Int {
+        // Keep the load factor at or below 0.5
+        var slots = 16
+        while slots < capacity * 2 {
+            slots <<= 1
+        }
+        return slots
+    }
+
+    @inline(__always)
+    private func home(_ key: UInt64) -> Int {
+        Int(truncatingIfNeeded: (key &* 0x9E37_79B9_7F4A_7C15) >> shift) & mask
+    }
+
+    private func find(_ key: UInt64) -> Int? {
+        guard key != 0 else { return nil }
+        var index = home(key)
+        while keys[index] != 0 {
+            if keys[index] == key {
+                return index
+            }
+            index = (index + 1) & mask
+        }
+        return nil
+    }
+
+    private mutating func grow() {
+        let oldKeys = keys
+        let oldValues = values
+        let slots = keys.count * 2
+        keys = [UInt64](repeating: 0, count: slots)
+        values = [Value?](repeating: nil, count: slots)
+        mask = slots - 1
+        shift = UInt64(64 - slots.trailingZeroBitCount)
+        count = 0
+
+        for index in oldKeys.indices where oldKeys[index] != 0 {
+            if let value = oldValues[index] {
+                insert(value, for: oldKeys[index])
+            }
+        }
+    }
+}
+
+// MARK: - TimerWheel
+
+/// A hashed timing wheel for request timeouts.
+///
+/// Deadlines are rounded up to ``tickDuration`` and hashed into
+/// `slotCount` buckets. Advancing the wheel visits only the buckets whose
+/// ticks have elapsed and returns every due correlation ID in one batch, so
+/// arming a timeout is an array append and no per-request task is created or
+/// cancelled.
+///
+/// ``schedule(_:after:now:)`` returns the entry's deadline tick, which
+/// locates its bucket; a request that completes first passes it to
+/// ``cancel(_:deadline:)`` so the wheel only ever holds live timeouts and
+/// empties, letting its driver stop, as soon as nothing is outstanding.
+/// Each entry's position in its bucket is tracked, so cancelling swaps the
+/// bucket's last entry into the hole instead of scanning: a burst of
+/// requests sharing one bucket completes in O(1) per reply.
+struct TimerWheel {
+    /// Timer resolution. Timeouts fire up to one tick late, never early.
+    static let tickDuration: Duration = .milliseconds(10)
+
+    private struct Entry {
+        let id: UInt64
+        let deadline: UInt64
+    }
+
+    private let origin: ContinuousClock.Instant
+    private var slots: [[Entry]]
+    private var currentTick: UInt64 = 0
+
+    /// Position of each armed ID within its bucket.
+    private var positions: [UInt64: Int] = [:]
+
+    /// Number of armed entries.
+    private(set) var count = 0
+
+    /// - Parameters:
+    ///   - slotCount: Buckets in the wheel; one rotation spans
+    ///     `slotCount * tickDuration` (default: 512 × 10ms ≈ 5s).
+    ///   - origin: Instant corresponding to tick 0.
+    init(slotCount: Int = 512, origin: ContinuousClock.Instant = .now) {
+        self.origin = origin
+        self.slots = [[Entry]](repeating: [], count: max(slotCount, 1))
+    }
+
+    var isEmpty: Bool { count == 0 }
+
+    /// Arms a timeout for `id` expiring `timeout` after `now`.
+    ///
+    /// - Returns: The deadline tick, for ``cancel(_:deadline:)``.
+    @discardableResult
+    mutating func schedule(_ id: UInt64, after timeout: Duration, now: ContinuousClock.Instant = .now) -> UInt64 {
+        let deadline = max(Self.ticks(now - origin + timeout, roundingUp: true), currentTick + 1)
+        let index = Int(deadline % UInt64(slots.count))
+        positions[id] = slots[index].count
+        slots[index].append(Entry(id: id, deadline: deadline))
+        count += 1
+        return deadline
+    }
+
+    /// Disarms the timeout for `id` scheduled with `deadline`.
+    ///
+    /// - Returns: `false` if it had already expired or been cancelled.
+    @discardableResult
+    mutating func cancel(_ id: UInt64, deadline: UInt64) -> Bool {
+        let index = Int(deadline % UInt64(slots.count))
+        guard let position = positions[id],
+              position < slots[index].count, slots[index][position].id == id else {
+            return false
+        }
+        positions[id] = nil
+        let last = slots[index].removeLast()
+        if position < slots[index].count {
+            slots[index][position] = last
+            positions[last.id] = position
+        }
+        count -= 1
+        return true
+    }
+
+    /// Advances the wheel to `now` and returns every ID whose deadline has passed.
+    mutating func advance(to now: ContinuousClock.Instant = .now) -> [UInt64] {
+        let target = Self.ticks(now - origin, roundingUp: false)
+        guard target > currentTick else { return [] }
+
+        // After a full rotation every bucket has been visited once
+        let steps = min(target - currentTick, UInt64(slots.count))
+        var expired: [UInt64] = []
+        for step in 1...steps {
+            let index = Int((currentTick + step) % UInt64(slots.count))
+            guard !slots[index].isEmpty else { continue }
+
+            var remaining: [Entry] = []
+            for entry in slots[index] {
+                if entry.deadline <= target {
+                    expired.append(entry.id)
+                    positions[entry.id] = nil
+                } else {
+                    positions[entry.id] = remaining.count
+                    remaining.append(entry)   // Due on a later rotation
+                }
+            }
+            slots[index] = remaining
+        }
+
+        currentTick = target
+        count -= expired.count
+        return expired
+    }
+
+    /// Drops every armed entry.
+    mutating func removeAll() {
+        for index in slots.indices {
+            slots[index].removeAll()
+        }
+        positions.removeAll()
+        count = 0
+    }
+
+    private static func ticks(_ duration: Duration, roundingUp: Bool) -> UInt64 {
+        let nanos = max(duration.nanoseconds, 0)
+        let tick = tickDuration.nanoseconds
+        return UInt64(roundingUp ? (nanos + tick - 1) / tick : nanos / tick)
+    }
+}
+
+private extension Duration {
+    var nanoseconds: Int64 {
+        let (seconds, attoseconds) = components
+        return seconds * 1_000_000_000 + attoseconds / 1_000_000_000
+    }
+}
@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2026 Kory Heard
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+import Foundation
+
+// MARK: - FPCDispatcher
+
+/// Runs server-side request handlers concurrently over a bounded worker pool.
+///
+/// Iterating ``FPCEndpoint/incoming()`` and awaiting a handler per message
+/// processes one request per connection at a time, so a single slow request
+/// stalls everything behind it. A dispatcher instead starts each request as
+/// soon as it arrives, subject to two limits:
+///
+/// - **Worker pool**: at most ``Configuration/maxConcurrentRequests`` handlers
+///   run at once across every connection served by the dispatcher.
+/// - **Per-connection window**: once a connection has
+///   ``Configuration/maxInFlightPerConnection`` requests in flight, the
+///   dispatcher stops reading from its socket until one completes, so a
+///   flooding client is throttled by its own socket buffer rather than by
+///   server memory.
+///
+/// Handlers return the reply instead of sending it; the dispatcher sends it
+/// with ``FPCEndpoint/reply(to:id:payload:descriptors:)``. With
+/// ``Ordering/perConnection``, replies on each connection are sent in the
+/// order the requests arrived, even though the handlers run concurrently.
+///
+/// ```swift
+/// let dispatcher = FPCDispatcher(configuration: .init(maxConcurrentRequests: 32))
+///
+/// for try await endpoint in try await listener.connections() {
+///     await endpoint.start()
+///     Task {
+///         try await dispatcher.serve(endpoint) { request, _ in
+///             FPCMessage(id: .pong, payload: try await lookup(request.payload))
+///         }
+///     }
+/// }
+/// ```
+public final class FPCDispatcher: Sendable {
+
+    /// Reply ordering within one connection.
+    public enum Ordering: Sendable {
+        /// Replies are sent as soon as each handler finishes.
+        case none
+        /// Replies are sent in request arrival order.
+        case perConnection
+    }
+
+    /// Dispatcher limits.
+    public struct Configuration: Sendable {
+        /// Maximum handlers running at once across all connections.
+        public var maxConcurrentRequests: Int
+
+        /// Maximum requests in flight on one connection before its socket
+        /// stops being read.
+        public var maxInFlightPerConnection: Int
+
+        /// Reply ordering within one connection.
+        public var ordering: Ordering
+
+        public init(
+            maxConcurrentRequests: Int = 64,
+            maxInFlightPerConnection: Int = 16,
+            ordering: Ordering = .none
+        ) {
+            self.maxConcurrentRequests = max(maxConcurrentRequests, 1)
+            self.maxInFlightPerConnection = max(maxInFlightPerConnection, 1)
+            self.ordering = ordering
+        }
+
+        /// 64 workers, 16 requests in flight per connection, unordered replies.
+        public static let `default` = Configuration()
+    }
+
+    /// Produces the reply to a request, or `nil` to send none.
+    ///
+    /// The reply's `id`, `payload`, and `descriptors` are used; its
+    /// correlation ID is taken from the request.
+    public typealias Handler = @Sendable (_ request: FPCMessage, _ endpoint: FPCEndpoint) async throws -> FPCMessage?
+
+    /// Called when a handler throws or its reply cannot be sent.
+    public typealias ErrorHandler = @Sendable (_ error: Error, _ request: FPCMessage) -> Void
+
+    public let configuration: Configuration
+
+    private let errorHandler: ErrorHandler?
+    private let workers: AsyncSemaphore
+
+    /// Creates a dispatcher.
+    ///
+    /// - Parameters:
+    ///   - configuration: Worker pool and per-connection limits.
+    ///   - onError: Optional callback for handler and reply failures. A
+    ///     request whose handler throws gets no reply.
+    public init(
+        configuration: Configuration = .default,
+        onError: ErrorHandler? = nil
+    ) {
+        self.configuration = configuration
+        self.errorHandler = onError
+        self.workers = AsyncSemaphore(permits: configuration.maxConcurrentRequests)
+    }
+
+    /// Serves requests from `endpoint` until its message stream ends.
+    ///
+    /// Claims the endpoint's ``FPCEndpoint/incoming()`` stream, so the endpoint
+    /// must be started and its stream not yet claimed. Returns once the
+    /// connection has closed and every in-flight handler has finished. Call
+    /// once per connection; any number of connections may be served at once.
+    ///
+    /// The handler is per connection, so it can capture connection state
+    /// such as the peer's credentials.
+    ///
+    /// - Parameters:
+    ///   - endpoint: A started endpoint.
+    ///   - handler: Computes the reply to each request on this connection.
+    /// - Throws: ``FPCError/notStarted``, ``FPCError/stopped``, or
+    ///   ``FPCError/streamAlreadyClaimed`` if the stream cannot be claimed.
+    public func serve(_ endpoint: FPCEndpoint, handler: @escaping Handler) async throws {
+        // The endpoint stops reading its socket once the window is full, so
+        // further requests stay in the socket buffer, not in the stream
+        let messages = try await endpoint.incoming(window: configuration.maxInFlightPerConnection)
+        let sequencer = configuration.ordering == .perConnection ? ReplySequencer() : nil
+
+        await withDiscardingTaskGroup { group in
+            var sequence: UInt64 = 0
+            for await message in messages {
+                let position = sequence
+                sequence += 1
+
+                group.addTask { [self] in
+                    await handle(message, on: endpoint, with: handler, position: position, sequencer: sequencer)
+                    await endpoint.releaseIncoming()
+                }
+            }
+        }
+    }
+
+    // MARK: - Private
+
+    private func handle(
+        _ message: FPCMessage,
+        on endpoint: FPCEndpoint,
+        with handler: Handler,
+        position: UInt64,
+        sequencer: ReplySequencer?
+    ) async {
+        await workers.wait()
+        let reply: FPCMessage?
+        do {
+            reply = try await handler(message, endpoint)
+        } catch {
+            reply = nil
+            errorHandler?(error, message)
+        }
+        workers.signal()
+
+        // Replies wait for their turn without holding a worker
+        if let sequencer {
+            await sequencer.waitForTurn(position)
+        }
+        defer { sequencer?.finish(position) }
+
+        guard let reply else { return }
+        do {
+            try await endpoint.reply(
+                to: message,
+                id: reply.id,
+                payload: reply.payload,
+                descriptors: reply.descriptors
+            )
+        } catch {
+            errorHandler?(error, message)
+        }
+    }
+}
+
+// MARK: - AsyncSemaphore
+
+/// A counting semaphore that suspends tasks instead of blocking threads.
+final class AsyncSemaphore: @unchecked Sendable {
+    private var permits: Int
+    private var waiters: [CheckedContinuation<Void, Never>] = []
+    private var head = 0
+    private let lock = NSLock()
+
+    init(permits: Int) {
+        self.permits = permits
+    }
+
+    /// Takes a permit, suspending until one is free. Waiters are served FIFO.
+    func wait() async {
+        await withCheckedContinuation { continuation in
+            lock.lock()
+            if permits > 0 {
+                permits -= 1
+                lock.unlock()
+                continuation.resume()
+            } else {
+                waiters.append(continuation)
+                lock.unlock()
+            }
+        }
+    }
+
+    /// Returns a permit, handing it straight to the oldest waiter if any.
+    func signal() {
+        lock.lock()
+        guard head < waiters.count else {
+            permits += 1
+            lock.unlock()
+            return
+        }
+        let next = waiters[head]
+        head += 1
+        if head == waiters.count {
+            waiters.removeAll(keepingCapacity: true)
+            head = 0
+        }
+        lock.unlock()
+        next.resume()
+    }
+}
+
+// MARK: - ReplySequencer
+
+/// Releases replies on one connection in request arrival order.
+final class ReplySequencer: @unchecked Sendable {
+    private var next: UInt64 = 0
+    private var waiters: [UInt64: CheckedContinuation<Void, Never>] = [:]
+    private let lock = NSLock()
+
+    /// Suspends until every earlier position has called ``finish(_:)``.
+    func waitForTurn(_ position: UInt64) async {
+        await withCheckedContinuation { continuation in
+            lock.lock()
+            if position == next {
+                lock.unlock()
+                continuation.resume()
+            } else {
+                waiters[position] = continuation
+                lock.unlock()
+            }
+        }
+    }
+
+    /// Marks `position` done and wakes the next one if it is waiting.
+    func finish(_ position: UInt64) {
+        lock.lock()
+        next = position + 1
+        let waiter = waiters.removeValue(forKey: next)
+        lock.unlock()
+        waiter?.resume()
+    }
+}
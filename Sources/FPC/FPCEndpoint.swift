@@ -26,20 +26,68 @@ import Capsicum
 public actor FPCEndpoint: Endpoint {
     private let socketHolder: SocketHolder
     private let ioQueue: DispatchQueue
+    private let eventLoop: FPCEventLoop?
+    private let slabs = SlabChannel()
+    private let framing = FrameNegotiation()
+    private var advertiseCompactFraming = false
+    private var receiveBatch: RecvBatchBuffer?
+    private let receiveFailure = DeferredFailure()
+    private let receiveBuffers = FPCReceiveBufferPool(bufferSize: FPCEndpoint.maxFrameSize)
+    private let receiveControl = RecvControlBuffer(maxDescriptors: FPCFrameLayout.maxDescriptors)
+    private let credentialCache = MessageCredentialCache()
     private var nextCorrelationID: UInt64 = 1
-    private var pendingReplies: [UInt64: CheckedContinuation<FPCMessage, Error>] = [:]
-    private var pendingTimeouts: [UInt64: Task<Void, Never>] = [:]
+    private var pendingReplies = CorrelationTable<PendingReply>()
+    private var timeouts = TimerWheel()
+    private var timeoutDriver: Task<Void, Never>?
     private var incomingContinuation: AsyncStream<FPCMessage>.Continuation?
     private var incomingStream: AsyncStream<FPCMessage>?
     private var receiveLoopTask: Task<Void, Never>?
+    private var receivePaused = false
+    private var heldMessages: [FPCMessage] = []
+
+    /// Messages yielded to the incoming stream and not yet released with
+    /// ``releaseIncoming()``, and the most that may be outstanding before
+    /// the socket stops being read (`nil` for no limit).
+    private var incomingOutstanding = 0
+    private var incomingWindow: Int?
+    private var receiveResumption: CheckedContinuation<Void, Never>?
     private var state: LifecycleState = .idle
 
+    /// A `request()` caller waiting for its reply.
+    private struct PendingReply {
+        let continuation: CheckedContinuation<FPCMessage, Error>
+        /// Deadline tick of the armed timeout, if the request has one.
+        let deadline: UInt64?
+    }
+
     // MARK: Init
 
-    public init(socket: consuming SocketCapability, ioQueue: DispatchQueue? = nil) {
+    /// Creates an endpoint over a connected SEQPACKET socket.
+    ///
+    /// - Parameters:
+    ///   - socket: A connected SEQPACKET socket.
+    ///   - ioQueue: Optional custom DispatchQueue for blocking I/O. Ignored when
+    ///              `eventLoop` is provided.
+    ///   - eventLoop: Optional shared ``FPCEventLoop``. When provided, the socket is
+    ///                switched to non-blocking mode and readiness is multiplexed
+    ///                on the loop's threads instead of parking a thread per endpoint.
+    ///                If the socket cannot be made non-blocking, the endpoint falls
+    ///                back to `ioQueue`.
+    public init(
+        socket: consuming SocketCapability,
+        ioQueue: DispatchQueue? = nil,
+        eventLoop: FPCEventLoop? = nil
+    ) {
+        var nonBlocking = false
+        if eventLoop != nil {
+            nonBlocking = socket.unsafe { fd in
+                (try? FPCEventLoop.setNonBlocking(fd)) != nil
+            }
+        }
         self.socketHolder = SocketHolder(socket: socket)
         // IMPORTANT: Must be concurrent so send() doesn't block behind receive loop
         self.ioQueue = ioQueue ?? DispatchQueue(label: "com.fpc.endpoint.io", qos: .userInitiated, attributes: .concurrent)
+        self.eventLoop = nonBlocking ? eventLoop : nil
     }
 
     // MARK: - Connection State
@@ -65,6 +113,115 @@ public actor FPCEndpoint: Endpoint {
         }
     }
 
+    /// Selects how sender credentials are delivered on inbound messages.
+    ///
+    /// Listeners, clients, and ``pair(firstQueue:secondQueue:eventLoop:)``
+    /// enable `LOCAL_CREDS_PERSISTENT`, so by default every message carries an
+    /// `SCM_CREDS2` control message that is decoded into new
+    /// ``MessageCredentials``. ``FPCCredentialMode/cached`` reuses the previous
+    /// message's credentials when the raw bytes are unchanged;
+    /// ``FPCCredentialMode/connectionOnly`` turns per-message credentials off
+    /// on this socket entirely.
+    ///
+    /// Only affects messages sent to this endpoint. May be called at any time;
+    /// messages already queued keep the credentials they were sent with.
+    ///
+    /// - Parameter mode: The credential mode.
+    /// - Throws: ``FPCError/disconnected`` if the socket is closed, or a BSD
+    ///   error if the socket option cannot be set.
+    public func setCredentialMode(_ mode: FPCCredentialMode) throws {
+        try socketHolder.withSocketOrThrow { socket in
+            if mode == .connectionOnly {
+                try socket.disablePersistentCredentials()
+            } else {
+                try socket.enablePersistentCredentials()
+            }
+        }
+        credentialCache.configure(mode)
+    }
+
+    /// Applies `mode` to the receive path when the socket option has already
+    /// been set by the creator (see ``FPCListener``).
+    func configureCredentialMode(_ mode: FPCCredentialMode) {
+        credentialCache.configure(mode)
+    }
+
+    // MARK: - Slab Pool
+
+    /// Enables a reusable shared-memory slab pool for large outbound payloads.
+    ///
+    /// By default every payload over the inline limit is sent through a fresh
+    /// anonymous shm segment. With a slab pool, a single segment is created,
+    /// mapped, and offered to the peer on the first large send; later large
+    /// payloads cost one copy into a free slab and one small control frame.
+    /// The peer credits each slab back once it has copied the payload out.
+    ///
+    /// Payloads larger than ``FPCSlabConfiguration/slabSize``, or sent while
+    /// every slab is in flight, fall back to per-message shm transparently.
+    ///
+    /// The receiving side needs no configuration. Has no effect once the pool
+    /// has been offered.
+    ///
+    /// - Parameter configuration: Slab size and count for the pool.
+    public func enableSlabPool(_ configuration: FPCSlabConfiguration = .default) {
+        slabs.enable(configuration)
+    }
+
+    /// Free slabs in the outbound pool, or `nil` before it has been offered.
+    nonisolated var slabPoolAvailableCount: Int? {
+        slabs.outboundAvailableCount
+    }
+
+    // MARK: - Compact Framing
+
+    /// Advertises compact (v1) framing support to the peer.
+    ///
+    /// Version 0 frames carry a fixed 256-byte header and 256-byte trailer. The
+    /// compact layout keeps the same 19 header bytes, appends one byte per
+    /// descriptor, and drops the trailer, so a small message costs tens of
+    /// bytes instead of more than 512.
+    ///
+    /// On ``start()`` the endpoint sends a ``MessageID/frameVersionOffer``;
+    /// the peer switches its outbound frames to v1 once it has received it.
+    /// Both layouts are always decoded, so each direction switches
+    /// independently and frames already in flight stay valid. Enable on both
+    /// ends for compact framing in both directions.
+    ///
+    /// Must be called before ``start()``; has no effect afterwards.
+    public func enableCompactFraming() {
+        guard state == .idle else { return }
+        advertiseCompactFraming = true
+    }
+
+    /// Whether outbound frames use the compact layout, i.e. the peer's
+    /// ``MessageID/frameVersionOffer`` has arrived.
+    nonisolated var sendsCompactFrames: Bool {
+        framing.sendCompact
+    }
+
+    // MARK: - Batched Receive
+
+    /// Drains up to `maxMessages` queued messages per socket wakeup.
+    ///
+    /// By default the receive loop performs one `recvmsg(2)` and one actor hop
+    /// per message. With batched receive enabled, each wakeup issues a single
+    /// `recvmmsg(2)` that returns everything already queued (up to
+    /// `maxMessages`), and the whole batch is dispatched in one hop.
+    ///
+    /// Reserves `maxMessages` receive slots of the maximum SEQPACKET size
+    /// (typically 64KB each) for the lifetime of the endpoint. Must be called
+    /// before ``start()``; has no effect afterwards.
+    ///
+    /// - Parameter maxMessages: Maximum messages drained per wakeup (default: 32).
+    public func enableBatchedReceive(maxMessages: Int = 32) {
+        guard state == .idle else { return }
+        receiveBatch = RecvBatchBuffer(
+            capacity: maxMessages,
+            recordSize: Self.maxFrameSize,
+            maxDescriptors: FPCFrameLayout.maxDescriptors
+        )
+    }
+
     // MARK: Lifecycle
 
     public func start() {
@@ -77,6 +234,13 @@ public actor FPCEndpoint: Endpoint {
         receiveLoopTask = Task {
             await receiveLoop()
         }
+
+        if advertiseCompactFraming {
+            // Best effort: if the offer cannot be sent the peer keeps using v0
+            Task {
+                try? await self.send(FrameNegotiation.offer)
+            }
+        }
     }
 
     public func stop() {
@@ -84,7 +248,8 @@ public actor FPCEndpoint: Endpoint {
         state = .stopped
         receiveLoopTask?.cancel()
         receiveLoopTask = nil
-        socketHolder.close()
+        resumeReceiving()
+        closeSocket()
         teardown(throwing: FPCError.stopped)
     }
 
@@ -92,6 +257,13 @@ public actor FPCEndpoint: Endpoint {
 
     /// Sends a fire-and-forget message. Suspends until the bytes are on the wire.
     public func send(_ message: FPCMessage) async throws {
+        if let eventLoop {
+            guard let fd = socketHolder.rawDescriptor else { throw FPCError.disconnected }
+            return try await eventLoop.perform(fd: fd, waitingFor: .writable) {
+                try self.socketSend(message)
+            }
+        }
+
         try await withCheckedThrowingContinuation { (continuation: CheckedContinuation<Void, Error>) in
             ioQueue.async {
                 do {
@@ -104,6 +276,39 @@ public actor FPCEndpoint: Endpoint {
         }
     }
 
+    /// Sends several fire-and-forget messages, coalescing them into as few
+    /// system calls as possible. Suspends until every message is on the wire.
+    ///
+    /// Runs of inline messages are written with a single `sendmmsg(2)` per
+    /// run; each message is still its own SEQPACKET record, so the peer
+    /// receives them exactly as if ``send(_:)`` had been called in order.
+    /// Messages that need out-of-line or slab transport are sent individually
+    /// at their position in the sequence.
+    ///
+    /// If an error is thrown, a prefix of `messages` may already have been sent.
+    public func send(contentsOf messages: [FPCMessage]) async throws {
+        guard !messages.isEmpty else { return }
+        let cursor = BatchCursor()
+
+        if let eventLoop {
+            guard let fd = socketHolder.rawDescriptor else { throw FPCError.disconnected }
+            return try await eventLoop.perform(fd: fd, waitingFor: .writable) {
+                try self.socketSend(contentsOf: messages, cursor: cursor)
+            }
+        }
+
+        try await withCheckedThrowingContinuation { (continuation: CheckedContinuation<Void, Error>) in
+            ioQueue.async {
+                do {
+                    try self.socketSend(contentsOf: messages, cursor: cursor)
+                    continuation.resume()
+                } catch {
+                    continuation.resume(throwing: error)
+                }
+            }
+        }
+    }
+
     /// Sends a message and suspends until the matching reply arrives.
     ///
     /// A correlation ID is assigned automatically; the `correlationID` field of
@@ -126,18 +331,21 @@ public actor FPCEndpoint: Endpoint {
 
         return try await withTaskCancellationHandler {
             try await withCheckedThrowingContinuation { continuation in
-                // Register continuation BEFORE sending to avoid lost-reply race
-                pendingReplies[correlationID] = continuation
-
-                // Start a timeout task if timeout is specified
+                // Arm a timeout on the shared wheel if timeout is specified
+                var deadline: UInt64? = nil
                 if let timeout = timeout {
-                    let timeoutTask = Task { [correlationID] in
-                        try? await Task.sleep(for: timeout)
-                        await self.handleTimeout(correlationID)
-                    }
-                    pendingTimeouts[correlationID] = timeoutTask
+                    deadline = timeouts.schedule(correlationID, after: timeout)
+                    startTimeoutDriver()
                 }
 
+                // Register continuation BEFORE sending to avoid lost-reply race
+                pendingReplies.insert(
+                    PendingReply(continuation: continuation, deadline: deadline),
+                    for: correlationID
+                )
+                // A paused receive loop must run again to read the reply
+                wakeReceiveLoop()
+
                 // Check for early cancellation before sending
                 if Task.isCancelled {
                     Task { await self.failPendingRequest(correlationID, error: CancellationError()) }
@@ -223,6 +431,39 @@ public actor FPCEndpoint: Endpoint {
         return stream
     }
 
+    /// Claims the incoming stream with a delivery window.
+    ///
+    /// At most `window` messages are yielded to the stream and not yet
+    /// released with ``releaseIncoming()``. While the window is full the
+    /// socket is not read, as with ``pauseReceiving()``, so further
+    /// messages wait in the kernel socket buffer instead of the stream's.
+    /// Used by ``FPCDispatcher``.
+    func incoming(window: Int) throws -> AsyncStream<FPCMessage> {
+        let stream = try incoming()
+        incomingWindow = max(window, 1)
+        return stream
+    }
+
+    /// Returns one slot of the window set by ``incoming(window:)``, once the
+    /// consumer has finished with a message it received.
+    func releaseIncoming() {
+        incomingOutstanding -= 1
+        deliverHeldMessages()
+        wakeReceiveLoop()
+    }
+
+    /// Credential cache hits and misses on this endpoint's receive path.
+    /// Both stay zero unless the mode is ``FPCCredentialMode/cached``.
+    nonisolated var credentialCacheStatistics: (hits: Int, misses: Int) {
+        credentialCache.statistics
+    }
+
+    /// Messages taken from the socket but not yet released: those in the
+    /// incoming stream or being handled, plus any held back.
+    var incomingBacklog: Int {
+        incomingOutstanding + heldMessages.count
+    }
+
     // MARK: - Pair
 
     /// Creates a pair of connected ``FPCEndpoint`` instances using `socketpair(2)`.
@@ -242,11 +483,14 @@ public actor FPCEndpoint: Endpoint {
     ///                 If `nil`, a default queue is created.
     ///   - secondQueue: Optional custom DispatchQueue for the second endpoint's I/O operations.
     ///                  If `nil`, a default queue is created.
+    ///   - eventLoop: Optional shared ``FPCEventLoop`` for both endpoints. When provided,
+    ///                the queues are not used for I/O.
     /// - Returns: A tuple of two connected SEQPACKET endpoints, each with its own I/O queue.
     /// - Throws: A system error if the socketpair cannot be created.
     public static func pair(
         firstQueue: DispatchQueue? = nil,
-        secondQueue: DispatchQueue? = nil
+        secondQueue: DispatchQueue? = nil,
+        eventLoop: FPCEventLoop? = nil
     ) throws -> (FPCEndpoint, FPCEndpoint) {
         let socketPair = try SocketCapability.socketPair(
             domain: .unix,
@@ -258,26 +502,125 @@ public actor FPCEndpoint: Endpoint {
         try socketPair.first.enablePersistentCredentials()
         try socketPair.second.enablePersistentCredentials()
 
-        return (FPCEndpoint(socket: socketPair.first, ioQueue: firstQueue),
-                FPCEndpoint(socket: socketPair.second, ioQueue: secondQueue))
+        return (FPCEndpoint(socket: socketPair.first, ioQueue: firstQueue, eventLoop: eventLoop),
+                FPCEndpoint(socket: socketPair.second, ioQueue: secondQueue, eventLoop: eventLoop))
+    }
+
+    // MARK: - Flow Control
+
+    /// Stops delivering requests and unsolicited messages.
+    ///
+    /// While no ``request(_:timeout:)`` is waiting, the socket is not read
+    /// at all: unread messages stay in the kernel socket buffer; once it
+    /// fills, the peer's sends block (or park on its event loop),
+    /// propagating backpressure to the sender.
+    ///
+    /// Replies are still delivered, here and while the window set by
+    /// ``incoming(window:)`` is full. A handler that calls `request()` on its
+    /// own connection while the dispatcher's window is full would otherwise
+    /// never see its reply. While a request is outstanding the socket is
+    /// read; anything that is not a reply is held and delivered, in order,
+    /// by ``resumeReceiving()``.
+    func pauseReceiving() {
+        receivePaused = true
+    }
+
+    /// Resumes a receive loop stopped by ``pauseReceiving()``, first
+    /// delivering the messages held while paused.
+    func resumeReceiving() {
+        receivePaused = false
+        deliverHeldMessages()
+        wakeReceiveLoop()
+    }
+
+    /// Whether delivery is stopped by ``pauseReceiving()`` or a full window.
+    private var deliveryBlocked: Bool {
+        if receivePaused { return true }
+        guard let incomingWindow else { return false }
+        return incomingOutstanding >= incomingWindow
+    }
+
+    /// Yields held messages, in order, while delivery is not blocked.
+    private func deliverHeldMessages() {
+        var delivered = 0
+        while delivered < heldMessages.count, !deliveryBlocked {
+            yieldIncoming(heldMessages[delivered])
+            delivered += 1
+        }
+        heldMessages.removeFirst(delivered)
+    }
+
+    private func yieldIncoming(_ message: FPCMessage) {
+        incomingOutstanding += 1
+        incomingContinuation?.yield(message)
+    }
+
+    /// Resumes a receive loop parked by ``pauseReceiving()``, if any.
+    private func wakeReceiveLoop() {
+        receiveResumption?.resume()
+        receiveResumption = nil
     }
 
     // MARK: - Private
 
-    private func handleTimeout(_ correlationID: UInt64) async {
-        pendingTimeouts.removeValue(forKey: correlationID)
-        if let pending = pendingReplies.removeValue(forKey: correlationID) {
-            pending.resume(throwing: FPCError.timeout)
+    /// Fails any I/O parked on the event loop for the socket, then closes it.
+    ///
+    /// Parked operations are cancelled while the descriptor is still open:
+    /// closing it silently drops its kqueue registrations, and once closed
+    /// the number can be reused by an unrelated descriptor whose
+    /// registration the cancel would then hit.
+    private func closeSocket() {
+        if let eventLoop, let fd = socketHolder.rawDescriptor {
+            eventLoop.cancel(fd: fd, error: FPCError.disconnected)
+        }
+        socketHolder.close()
+    }
+
+    /// Starts the task that ticks the timeout wheel, if it is not running.
+    ///
+    /// One task serves every outstanding timeout on the endpoint. It exits
+    /// once the wheel is empty and is restarted by the next timed request.
+    private func startTimeoutDriver() {
+        guard timeoutDriver == nil else { return }
+        timeoutDriver = Task {
+            while !Task.isCancelled {
+                try? await Task.sleep(for: TimerWheel.tickDuration)
+                guard !Task.isCancelled, await self.expireTimeouts() else { return }
+            }
+        }
+    }
+
+    /// Fails every request whose timeout has elapsed, in one batch.
+    ///
+    /// - Returns: `false` once no timeouts remain and the driver should exit.
+    private func expireTimeouts() -> Bool {
+        for correlationID in timeouts.advance() {
+            // The wheel has already dropped the entry
+            if let pending = pendingReplies.removeValue(forKey: correlationID) {
+                pending.continuation.resume(throwing: FPCError.timeout)
+            }
+        }
+
+        guard !timeouts.isEmpty else {
+            timeoutDriver = nil
+            return false
         }
+        return true
     }
 
     private func failPendingRequest(_ correlationID: UInt64, error: Error) async {
-        if let timeoutTask = pendingTimeouts.removeValue(forKey: correlationID) {
-            timeoutTask.cancel()
+        removePendingReply(correlationID)?.resume(throwing: error)
+    }
+
+    /// Removes a pending request and disarms its timeout, if one is armed.
+    private func removePendingReply(_ correlationID: UInt64) -> CheckedContinuation<FPCMessage, Error>? {
+        guard let pending = pendingReplies.removeValue(forKey: correlationID) else {
+            return nil
         }
-        if let pending = pendingReplies.removeValue(forKey: correlationID) {
-            pending.resume(throwing: error)
+        if let deadline = pending.deadline {
+            timeouts.cancel(correlationID, deadline: deadline)
         }
+        return pending.continuation
     }
 
     /// Routes an incoming message to a waiting `request()` caller or the unsolicited stream.
@@ -288,22 +631,19 @@ public actor FPCEndpoint: Endpoint {
     ///
     /// Messages with `correlationID == 0` are always unsolicited and go to messages().
     private func dispatch(_ message: FPCMessage) {
-        if message.correlationID != 0 {
-            // Check if this is a reply to a pending request we sent
-            if let continuation = pendingReplies.removeValue(forKey: message.correlationID) {
-                // It's a reply - cancel timeout and deliver to caller
-                if let timeoutTask = pendingTimeouts.removeValue(forKey: message.correlationID) {
-                    timeoutTask.cancel()
-                }
-                continuation.resume(returning: message)
-            } else {
-                // No pending request - this is an incoming request expecting a reply
-                // Deliver to messages() stream so the handler can process and reply
-                incomingContinuation?.yield(message)
-            }
+        // A reply to a pending request - deliver to caller
+        if message.correlationID != 0, let continuation = removePendingReply(message.correlationID) {
+            continuation.resume(returning: message)
+            return
+        }
+
+        // An incoming request expecting a reply, or an unsolicited message
+        // (correlationID == 0). While delivery is blocked, the socket is only
+        // read so that replies get through; hold these until it unblocks.
+        if deliveryBlocked || !heldMessages.isEmpty {
+            heldMessages.append(message)
         } else {
-            // Unsolicited message (correlationID == 0)
-            incomingContinuation?.yield(message)
+            yieldIncoming(message)
         }
     }
 
@@ -312,32 +652,53 @@ public actor FPCEndpoint: Endpoint {
             // Ensure cleanup if loop exits unexpectedly
             if state == .running {
                 state = .stopped
-                socketHolder.close()
+                closeSocket()
                 teardown(throwing: FPCError.disconnected)
             }
         }
 
         while !Task.isCancelled {
+            // A blocked endpoint still reads while a request awaits its reply
+            if deliveryBlocked && pendingReplies.isEmpty {
+                await withCheckedContinuation { receiveResumption = $0 }
+                continue
+            }
+
             do {
-                let message = try await receiveFromSocket()
-                dispatch(message)
+                // One actor hop per wakeup, however many messages it drained
+                for message in try await receiveFromSocket() {
+                    dispatch(message)
+                }
             } catch {
                 state = .stopped
-                socketHolder.close()
+                closeSocket()
                 teardown(throwing: error)
                 break
             }
         }
     }
 
-    /// Suspends until one complete message arrives on the socket.
-    /// Blocking I/O is pushed off the cooperative thread pool onto `ioQueue`.
-    private func receiveFromSocket() async throws -> FPCMessage {
-        try await withCheckedThrowingContinuation { continuation in
+    /// Suspends until at least one complete message arrives on the socket.
+    /// Blocking I/O is pushed off the cooperative thread pool onto `ioQueue`,
+    /// or parked on the shared ``FPCEventLoop`` when one is configured.
+    ///
+    /// Returns a single message, or every queued message up to the batch size
+    /// when batched receive is enabled.
+    private func receiveFromSocket() async throws -> [FPCMessage] {
+        let batch = receiveBatch
+
+        if let eventLoop {
+            guard let fd = socketHolder.rawDescriptor else { throw FPCError.disconnected }
+            return try await eventLoop.perform(fd: fd, waitingFor: .readable) {
+                try self.socketReceive(batch: batch)
+            }
+        }
+
+        return try await withCheckedThrowingContinuation { continuation in
             ioQueue.async {
                 do {
-                    let message = try self.socketReceive()
-                    continuation.resume(returning: message)
+                    let messages = try self.socketReceive(batch: batch)
+                    continuation.resume(returning: messages)
                 } catch {
                     continuation.resume(throwing: error)
                 }
@@ -347,17 +708,15 @@ public actor FPCEndpoint: Endpoint {
 
     /// Fails all suspended callers and closes the unsolicited message stream.
     private func teardown(throwing error: Error) {
-        // Cancel all pending timeout tasks
-        for (_, task) in pendingTimeouts {
-            task.cancel()
-        }
-        pendingTimeouts.removeAll()
+        // Stop the timeout wheel
+        timeoutDriver?.cancel()
+        timeoutDriver = nil
+        timeouts.removeAll()
 
         // Fail all pending replies
-        for (_, continuation) in pendingReplies {
-            continuation.resume(throwing: error)
+        for pending in pendingReplies.removeAll() {
+            pending.continuation.resume(throwing: error)
         }
-        pendingReplies.removeAll()
         incomingContinuation?.finish()
         incomingContinuation = nil
     }
@@ -383,13 +742,30 @@ public actor FPCEndpoint: Endpoint {
         return available > 0 ? available : 0
     }()
 
+    /// Largest frame that can arrive inline: header + payload + trailer.
+    private static let maxFrameSize =
+        FPCFrameLayout.headerSize + MAX_INLINE_PAYLOAD + FPCFrameLayout.trailerSize
+
+    /// Upper bound on messages coalesced into one `sendmmsg(2)` call.
+    private static let MAX_SEND_BATCH = 64
+
     nonisolated private func socketSend(_ message: FPCMessage) throws {
         var payload = message.payload
         var descriptors = message.descriptors
         var useOOL = false
 
+        // Prefer a pooled slab for large payloads when one is free.
+        // The offer travels inline, so this never recurses into the pool.
+        var slab: (pool: FPCSlabPool, index: UInt32)? = nil
+        if payload.count > Self.MAX_INLINE_PAYLOAD,
+           let pool = try slabs.outboundPool(offer: { try self.socketSend($0) }),
+           payload.count <= pool.configuration.slabSize,
+           let index = pool.acquire() {
+            payload = pool.fill(slab: index, with: payload).encode()
+            slab = (pool, index)
+        }
+
         // Handle out-of-line payload if needed
-        var shmDescriptor: Int32? = nil
         if payload.count > Self.MAX_INLINE_PAYLOAD {
             // Check descriptor limit (254 max, OOL adds one more)
             guard descriptors.count < FPCFrameLayout.maxDescriptors else {
@@ -428,9 +804,9 @@ public actor FPCEndpoint: Endpoint {
             ])
             _ = shm.limit(rights: readOnlyRights)
 
-            // Track fd for cleanup on send failure
-            shmDescriptor = shm.take()
-            let shmRef = OpaqueDescriptorRef(shmDescriptor!, kind: .shm)
+            // The ref owns the fd from here on and closes it when released,
+            // whether or not the send succeeds
+            let shmRef = OpaqueDescriptorRef(shm.take(), kind: .shm)
 
             // Prepend OOL descriptor
             descriptors.insert(shmRef, at: 0)
@@ -444,89 +820,357 @@ public actor FPCEndpoint: Endpoint {
         }
 
         // Build wire message using FPCFrameLayout
+        var flags: UInt8 = 0
+        if useOOL { flags |= FPCFrameLayout.flagOOLPayload }
+        if slab != nil { flags |= FPCFrameLayout.flagSlabPayload }
+
         let header = FPCFrameHeader(
             messageID: message.id.rawValue,
             correlationID: message.correlationID,
             payloadLength: UInt32(payload.count),
             descriptorCount: UInt8(descriptors.count),
-            flags: useOOL ? FPCFrameLayout.flagOOLPayload : 0
+            flags: flags
         )
 
         let descriptorKinds = descriptors.prefix(FPCFrameLayout.maxDescriptors).map { $0.kind.wireValue }
         let trailer = FPCFrameTrailer(descriptorKinds: Array(descriptorKinds))
 
-        // Assemble wire data
-        var wireData = header.encode()
-        wireData.append(payload)
-        wireData.append(trailer.encode(hasOOLPayload: useOOL))
-
         do {
-            try socketHolder.withSocketOrThrow { socket in
-                try socket.sendDescriptors(descriptors, payload: wireData)
+            // Header and trailer are encoded into one stack allocation and the
+            // payload is sent from the caller's buffer in place: sendmsg gathers
+            // all three segments, so the payload is never copied in userspace.
+            // A compact frame needs at most 19 + 254 bytes and has no trailer.
+            let headerSize = FPCFrameLayout.headerSize
+            let compact = framing.sendCompact
+            try withUnsafeTemporaryAllocation(
+                byteCount: headerSize + FPCFrameLayout.trailerSize,
+                alignment: MemoryLayout<UInt64>.alignment
+            ) { frame in
+                let segments: (header: UnsafeRawBufferPointer, trailer: UnsafeRawBufferPointer)
+                if compact {
+                    let compactHeader = FPCCompactHeader(header: header, descriptorKinds: trailer)
+                    let headerBytes = UnsafeMutableRawBufferPointer(rebasing: frame[..<compactHeader.size])
+                    compactHeader.encode(into: headerBytes)
+                    segments = (UnsafeRawBufferPointer(headerBytes), UnsafeRawBufferPointer(start: nil, count: 0))
+                } else {
+                    let headerBytes = UnsafeMutableRawBufferPointer(rebasing: frame[..<headerSize])
+                    let trailerBytes = UnsafeMutableRawBufferPointer(rebasing: frame[headerSize...])
+                    header.encode(into: headerBytes)
+                    trailer.encode(into: trailerBytes, hasOOLPayload: useOOL)
+                    segments = (UnsafeRawBufferPointer(headerBytes), UnsafeRawBufferPointer(trailerBytes))
+                }
+
+                try payload.withUnsafeBytes { payloadBytes in
+                    try socketHolder.withSocketOrThrow { socket in
+                        try socket.sendDescriptors(descriptors, gathering: [
+                            segments.header,
+                            payloadBytes,
+                            segments.trailer,
+                        ])
+                    }
+                }
             }
         } catch {
-            // Clean up OOL descriptor if send failed
-            if let fd = shmDescriptor {
-                _ = Glibc.close(fd)
+            // The peer never saw the slab, so it will never credit it back
+            if let slab {
+                slab.pool.release([slab.index])
             }
             throw error
         }
     }
 
+    /// Sends `messages` from `cursor.next` onwards, advancing the cursor as
+    /// messages reach the wire so that a retry resumes where this one stopped.
+    nonisolated private func socketSend(contentsOf messages: [FPCMessage], cursor: BatchCursor) throws {
+        while cursor.next < messages.count {
+            var end = cursor.next
+            while end < messages.count,
+                  end - cursor.next < Self.MAX_SEND_BATCH,
+                  messages[end].payload.count <= Self.MAX_INLINE_PAYLOAD,
+                  messages[end].descriptors.count <= FPCFrameLayout.maxDescriptors {
+                end += 1
+            }
+
+            if end == cursor.next {
+                // Needs OOL/slab transport, or is invalid: take the single-message path
+                try socketSend(messages[cursor.next])
+                cursor.next += 1
+            } else {
+                cursor.next += try socketSendCoalesced(messages[cursor.next..<end])
+            }
+        }
+    }
+
+    /// Encodes a run of inline messages back to back into one buffer and
+    /// hands them to a single `sendmmsg(2)`.
+    ///
+    /// Unlike ``socketSend(_:)`` each payload is copied once into the frame
+    /// buffer; for the small messages this path targets, the copy is far
+    /// cheaper than the per-message system call it replaces.
+    ///
+    /// - Returns: Number of leading messages sent.
+    nonisolated private func socketSendCoalesced(_ messages: ArraySlice<FPCMessage>) throws -> Int {
+        let compact = framing.sendCompact
+        let frameOverhead: (FPCMessage) -> Int = { message in
+            compact
+                ? FPCFrameLayout.compactHeaderSize + message.descriptors.count
+                : FPCFrameLayout.headerSize + FPCFrameLayout.trailerSize
+        }
+        let totalSize = messages.reduce(0) { $0 + frameOverhead($1) + $1.payload.count }
+
+        let buffer = UnsafeMutableRawBufferPointer.allocate(
+            byteCount: totalSize,
+            alignment: MemoryLayout<UInt64>.alignment
+        )
+        defer { buffer.deallocate() }
+
+        var records: [SendRecord] = []
+        records.reserveCapacity(messages.count)
+        var offset = 0
+        for message in messages {
+            let frameSize = frameOverhead(message) + message.payload.count
+            let frame = UnsafeMutableRawBufferPointer(rebasing: buffer[offset..<(offset + frameSize)])
+            offset += frameSize
+
+            let header = FPCFrameHeader(
+                messageID: message.id.rawValue,
+                correlationID: message.correlationID,
+                payloadLength: UInt32(message.payload.count),
+                descriptorCount: UInt8(message.descriptors.count),
+                flags: 0
+            )
+            let trailer = FPCFrameTrailer(descriptorKinds: message.descriptors.map { $0.kind.wireValue })
+
+            let payloadStart: Int
+            if compact {
+                let compactHeader = FPCCompactHeader(header: header, descriptorKinds: trailer)
+                compactHeader.encode(into: frame)
+                payloadStart = compactHeader.size
+            } else {
+                header.encode(into: frame)
+                trailer.encode(
+                    into: UnsafeMutableRawBufferPointer(rebasing: frame[(frameSize - FPCFrameLayout.trailerSize)...]),
+                    hasOOLPayload: false
+                )
+                payloadStart = FPCFrameLayout.headerSize
+            }
+            _ = message.payload.copyBytes(
+                to: UnsafeMutableRawBufferPointer(rebasing: frame[payloadStart..<(payloadStart + message.payload.count)])
+            )
+
+            records.append(SendRecord(
+                descriptors: message.descriptors,
+                segments: [UnsafeRawBufferPointer(frame)]
+            ))
+        }
+
+        return try socketHolder.withSocketOrThrow { socket in
+            try socket.sendMultiple(records)
+        }
+    }
+
+    /// Receives the next application message, or the next batch of them when
+    /// `batch` is set.
+    nonisolated private func socketReceive(batch: RecvBatchBuffer?) throws -> [FPCMessage] {
+        if let batch {
+            return try socketReceiveBatch(into: batch)
+        }
+        return [try socketReceive()]
+    }
+
+    /// Receives the next application message, consuming control messages
+    /// (``MessageID/slabPoolOffer``, ``MessageID/slabCredit``,
+    /// ``MessageID/frameVersionOffer``) inline.
     nonisolated private func socketReceive() throws -> FPCMessage {
+        while true {
+            let message = try socketReceiveFrame()
+            if try !consumeControlMessage(message) {
+                return message
+            }
+        }
+    }
+
+    /// Drains every queued frame (up to the batch capacity) with one
+    /// `recvmmsg(2)`, returning the application messages among them.
+    ///
+    /// If a frame fails to parse, the messages parsed before it are still
+    /// returned and the error is thrown by the next call. Descriptors of the
+    /// frames that were not parsed are closed when their records are released.
+    nonisolated private func socketReceiveBatch(into batch: RecvBatchBuffer) throws -> [FPCMessage] {
+        try receiveFailure.throwIfPending()
+        while true {
+            let records = try socketHolder.withSocketOrThrow { socket in
+                try socket.recvMultipleWithCredentials(
+                    into: batch,
+                    credentialCache: credentialCache.socketCredentialCache
+                )
+            }
+
+            var messages: [FPCMessage] = []
+            messages.reserveCapacity(records.count)
+            for (index, record) in records.enumerated() {
+                // A zero-length record is EOF. Deliver what preceded it; the
+                // next receive observes EOF again and reports the disconnect.
+                guard record.byteCount > 0 else {
+                    guard !messages.isEmpty else { throw FPCError.disconnected }
+                    return messages
+                }
+
+                do {
+                    let message = try parseMessage(
+                        wireData: batch.bytes(at: index, count: record.byteCount),
+                        receivedDescriptors: record.descriptors,
+                        credentials: credentialCache.messageCredentials(record.credentials)
+                    )
+                    if try !consumeControlMessage(message) {
+                        messages.append(message)
+                    }
+                } catch {
+                    guard !messages.isEmpty else { throw error }
+                    receiveFailure.hold(error)
+                    return messages
+                }
+            }
+
+            if !messages.isEmpty {
+                return messages
+            }
+        }
+    }
+
+    /// Credits slab `index` back to the peer's pool.
+    ///
+    /// On a non-blocking socket the credit can fail with `EAGAIN`; dropping
+    /// it would leak the peer's slab for good. It is queued instead and sent
+    /// from the event loop once the socket is writable. Any other failure
+    /// means the connection is gone, which the receive loop will observe on
+    /// its next read.
+    nonisolated private func sendCredit(_ index: UInt32) {
+        do {
+            try socketSend(SlabChannel.credit(for: [index]))
+        } catch where FPCEventLoop.wouldBlock(error) {
+            guard slabs.deferCredit(index),
+                  let eventLoop,
+                  let fd = socketHolder.rawDescriptor else { return }
+            Task {
+                try? await eventLoop.perform(fd: fd, waitingFor: .writable) {
+                    try self.slabs.flushDeferredCredits { try self.socketSend($0) }
+                }
+            }
+        } catch {
+            // Connection is gone; nothing left to credit
+        }
+    }
+
+    /// Applies slab pool and framing control messages. Returns `false` for
+    /// application messages.
+    nonisolated private func consumeControlMessage(_ message: FPCMessage) throws -> Bool {
+        switch message.id {
+        case .slabPoolOffer:
+            try slabs.acceptOffer(message)
+            return true
+        case .slabCredit:
+            try slabs.applyCredit(message)
+            return true
+        case .frameVersionOffer:
+            try framing.acceptOffer(message)
+            return true
+        default:
+            return false
+        }
+    }
+
+    nonisolated private func socketReceiveFrame() throws -> FPCMessage {
         // SEQPACKET guarantees message boundaries: each recv() returns exactly one message.
         // No buffering needed - the kernel preserves message atomicity.
-        let maxBufferSize = FPCFrameLayout.headerSize + Self.MAX_INLINE_PAYLOAD + FPCFrameLayout.trailerSize
+        //
+        // The frame buffer and control buffer are recycled across receives; the
+        // receive loop is serial, so only one frame is ever in flight here.
+        let buffer = receiveBuffers.acquire()
+        var adopted = false
+        defer {
+            if !adopted { receiveBuffers.release(buffer) }
+        }
 
         let result = try socketHolder.withSocketOrThrow { socket in
             try socket.recvDescriptorsWithCredentials(
-                maxDescriptors: FPCFrameLayout.maxDescriptors,
-                bufferSize: maxBufferSize
+                into: buffer,
+                control: receiveControl,
+                credentialCache: credentialCache.socketCredentialCache
             )
         }
 
         // Check for connection closed (0 bytes)
-        guard result.data.count > 0 else {
+        guard result.byteCount > 0 else {
             throw FPCError.disconnected
         }
 
         // Convert SocketCredentials to MessageCredentials if present
-        let messageCredentials: MessageCredentials? = result.credentials.map { creds in
-            MessageCredentials(
-                realUID: creds.realUID,
-                effectiveUID: creds.effectiveUID,
-                realGID: creds.realGID,
-                effectiveGID: creds.effectiveGID,
-                pid: creds.pid,
-                groups: creds.groups
-            )
-        }
+        let messageCredentials = credentialCache.messageCredentials(result.credentials)
 
         return try parseMessage(
-            wireData: result.data,
+            wireData: UnsafeRawBufferPointer(rebasing: buffer[..<result.byteCount]),
             receivedDescriptors: result.descriptors,
-            credentials: messageCredentials
+            credentials: messageCredentials,
+            inlinePayload: { bytes in
+                // Large payloads keep the frame buffer instead of being copied
+                guard bytes.count >= FPCReceiveBufferPool.adoptionThreshold else {
+                    return Data(bytes)
+                }
+                adopted = true
+                return receiveBuffers.adopt(buffer, payload: bytes)
+            }
         )
     }
 
     /// Parses a complete BPC message from wire data.
+    ///
+    /// Header and trailer are decoded in place from `wireData`. An inline
+    /// payload is turned into `Data` by `inlinePayload`, which copies it out by
+    /// default.
     nonisolated private func parseMessage(
-        wireData: Data,
+        wireData: UnsafeRawBufferPointer,
         receivedDescriptors: [OpaqueDescriptorRef],
-        credentials: MessageCredentials? = nil
+        credentials: MessageCredentials? = nil,
+        inlinePayload: (UnsafeRawBufferPointer) -> Data = { Data($0) }
     ) throws -> FPCMessage {
-        guard wireData.count >= FPCFrameLayout.minimumMessageSize else {
-            throw FPCError.invalidMessageFormat
-        }
+        let header: FPCFrameHeader
+        let trailer: FPCFrameTrailer
+        let payloadStart: Int
+
+        if FPCFrameLayout.isCompactFrame(wireData) {
+            // v1: descriptor kinds follow the fixed header; no trailer
+            let compact = try FPCCompactHeader.decode(from: wireData)
+            header = compact.header
+            trailer = compact.descriptorKinds
+            payloadStart = compact.size
+            try compact.validate()
+
+            guard wireData.count == compact.size + Int(header.payloadLength) else {
+                throw FPCError.invalidMessageFormat
+            }
+        } else {
+            guard wireData.count >= FPCFrameLayout.minimumMessageSize else {
+                throw FPCError.invalidMessageFormat
+            }
 
-        // Parse and validate header
-        let header = try FPCFrameHeader.decode(from: wireData)
-        try header.validate()
+            // Parse and validate header
+            header = try FPCFrameHeader.decode(from: wireData)
+            payloadStart = FPCFrameLayout.headerSize
+            try header.validate()
 
-        // Validate total message size
-        let expectedTotal = FPCFrameLayout.headerSize + Int(header.payloadLength) + FPCFrameLayout.trailerSize
-        guard wireData.count == expectedTotal else {
-            throw FPCError.invalidMessageFormat
+            // Validate total message size
+            let expectedTotal = FPCFrameLayout.headerSize + Int(header.payloadLength) + FPCFrameLayout.trailerSize
+            guard wireData.count == expectedTotal else {
+                throw FPCError.invalidMessageFormat
+            }
+
+            // Parse trailer
+            let trailerStart = wireData.count - FPCFrameLayout.trailerSize
+            trailer = try FPCFrameTrailer.decode(
+                from: UnsafeRawBufferPointer(rebasing: wireData[trailerStart...]),
+                descriptorCount: Int(header.descriptorCount)
+            )
         }
 
         // Validate descriptor count matches
@@ -534,11 +1178,8 @@ public actor FPCEndpoint: Endpoint {
             throw FPCError.invalidMessageFormat
         }
 
-        // Parse and validate trailer
-        let trailerStart = wireData.count - FPCFrameLayout.trailerSize
-        let trailerData = Data(wireData[trailerStart...])
-        let trailer = try FPCFrameTrailer.decode(from: trailerData, descriptorCount: Int(header.descriptorCount))
         try trailer.validate(hasOOLPayload: header.hasOOLPayload)
+        let payloadEnd = payloadStart + Int(header.payloadLength)
 
         // Apply descriptor kinds from trailer
         var descriptors = receivedDescriptors
@@ -588,10 +1229,16 @@ public actor FPCEndpoint: Endpoint {
             }
 
             payload = Data(bytes: mappedPtr, count: shmSize)
+        } else if header.hasSlabPayload {
+            let reference = try FPCSlabReference.decode(
+                from: UnsafeRawBufferPointer(rebasing: wireData[payloadStart..<payloadEnd])
+            )
+            payload = try slabs.resolve(reference)
+
+            // Payload has been copied out; hand the slab straight back.
+            sendCredit(reference.index)
         } else {
-            let payloadStart = FPCFrameLayout.headerSize
-            let payloadEnd = payloadStart + Int(header.payloadLength)
-            payload = Data(wireData[payloadStart..<payloadEnd])
+            payload = inlinePayload(UnsafeRawBufferPointer(rebasing: wireData[payloadStart..<payloadEnd]))
         }
 
         return FPCMessage(
@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2026 Kory Heard
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+import Foundation
+import Glibc
+import FreeBSDKit
+import Descriptors
+import Capabilities
+
+// MARK: - FPCEventLoop
+
+/// A shared, kqueue-driven I/O engine for FPC endpoints and listeners.
+///
+/// By default every ``FPCEndpoint`` and ``FPCListener`` parks a blocking
+/// `recvmsg`/`accept` on its own `DispatchQueue`, which costs one GCD thread
+/// per idle connection. An event loop instead switches sockets to
+/// non-blocking mode and multiplexes readiness for all of them over a small,
+/// fixed set of threads, each owning one kqueue.
+///
+/// I/O is attempted optimistically on the calling thread first; only when the
+/// socket would block is the operation parked on the loop, re-run on the loop
+/// thread once `EVFILT_READ`/`EVFILT_WRITE` fires, and the waiting actor
+/// continuation resumed from there.
+///
+/// ```swift
+/// let loop = try FPCEventLoop(threadCount: 2)
+/// let listener = try FPCListener.listen(on: "/var/run/aged.sock", eventLoop: loop)
+/// ```
+///
+/// Endpoints accepted by a listener inherit its loop. Call ``shutdown()``
+/// after stopping everything that uses the loop.
+public final class FPCEventLoop: @unchecked Sendable {
+    /// Number of kqueue threads servicing this loop.
+    public var threadCount: Int { workers.count }
+
+    private let workers: [Worker]
+
+    /// Creates an event loop and starts its threads.
+    ///
+    /// - Parameter threadCount: Number of kqueue threads (default: 2, minimum 1).
+    /// - Throws: A system error if a kqueue cannot be created.
+    public init(threadCount: Int = 2) throws {
+        var workers: [Worker] = []
+        for index in 0..<max(threadCount, 1) {
+            workers.append(try Worker(index: index))
+        }
+        self.workers = workers
+        workers.forEach { $0.start() }
+    }
+
+    deinit {
+        shutdown()
+    }
+
+    /// Stops all loop threads. Parked operations fail with ``FPCError/stopped``.
+    public func shutdown() {
+        workers.forEach { $0.shutdown() }
+    }
+
+    // MARK: - Internal API
+
+    /// Readiness condition an operation waits for.
+    enum Readiness: Hashable {
+        case readable
+        case writable
+    }
+
+    /// Runs `operation` against a non-blocking descriptor, parking it on the
+    /// loop until `fd` becomes ready whenever it fails with `EAGAIN`.
+    func perform<T: Sendable>(
+        fd: Int32,
+        waitingFor readiness: Readiness,
+        _ operation: @escaping @Sendable () throws -> T
+    ) async throws -> T {
+        // Fast path: data or buffer space is often already available
+        do {
+            return try operation()
+        } catch where Self.wouldBlock(error) {
+            // Fall through and park on the loop
+        }
+
+        return try await withCheckedThrowingContinuation { continuation in
+            let waiter = Waiter(
+                fire: {
+                    do {
+                        continuation.resume(returning: try operation())
+                        return true
+                    } catch where Self.wouldBlock(error) {
+                        return false
+                    } catch {
+                        continuation.resume(throwing: error)
+                        return true
+                    }
+                },
+                cancel: { error in
+                    continuation.resume(throwing: error)
+                }
+            )
+            worker(for: fd).park(waiter, fd: fd, readiness: readiness)
+        }
+    }
+
+    /// Fails every operation parked on `fd`.
+    ///
+    /// Must be called before the descriptor is closed: closing removes its
+    /// knotes, so a parked operation would otherwise never be resumed.
+    func cancel(fd: Int32, error: Error) {
+        worker(for: fd).cancel(fd: fd, error: error)
+    }
+
+    /// Puts `fd` into non-blocking mode.
+    static func setNonBlocking(_ fd: Int32) throws {
+        let flags = Glibc.fcntl(fd, F_GETFL)
+        guard flags >= 0, Glibc.fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0 else {
+            try BSDError.throwErrno(errno)
+        }
+    }
+
+    static func wouldBlock(_ error: Error) -> Bool {
+        if case .posix(let posix) = error as? BSDError {
+            return posix.code == .EAGAIN
+        }
+        if let posix = error as? POSIXError {
+            return posix.code == .EAGAIN
+        }
+        return false
+    }
+
+    private func worker(for fd: Int32) -> Worker {
+        workers[Int(fd) % workers.count]
+    }
+}
+
+// MARK: - Worker
+
+extension FPCEventLoop {
+
+    struct Waiter {
+        /// Re-runs the operation; returns `false` if it would still block.
+        let fire: () -> Bool
+        /// Fails the operation without running it.
+        let cancel: (Error) -> Void
+    }
+
+    fileprivate struct Key: Hashable {
+        let fd: Int32
+        let readiness: Readiness
+    }
+
+    /// One kqueue and the thread that waits on it.
+    ///
+    /// kqueue keeps a single knote per (descriptor, filter), so several
+    /// operations waiting on the same socket share one oneshot registration.
+    final class Worker: @unchecked Sendable {
+        private static let shutdownEventID: UInt = 0
+
+        private let kqueue: KqueueCapability
+        private let index: Int
+        private var waiters: [Key: [Waiter]] = [:]
+        private var stopped = false
+        private let lock = NSLock()
+
+        init(index: Int) throws {
+            self.kqueue = try KqueueCapability.makeKqueue()
+            self.index = index
+            try kqueue.addUserEvent(id: Self.shutdownEventID)
+        }
+
+        func start() {
+            let thread = Thread { [self] in run() }
+            thread.name = "com.fpc.eventloop.\(index)"
+            thread.start()
+        }
+
+        func shutdown() {
+            lock.lock()
+            let alreadyStopped = stopped
+            lock.unlock()
+            guard !alreadyStopped else { return }
+            try? kqueue.triggerUserEvent(id: Self.shutdownEventID)
+        }
+
+        func park(_ waiter: Waiter, fd: Int32, readiness: Readiness) {
+            lock.lock()
+            guard !stopped else {
+                lock.unlock()
+                waiter.cancel(FPCError.stopped)
+                return
+            }
+            let key = Key(fd: fd, readiness: readiness)
+            let needsRegistration = waiters[key, default: []].isEmpty
+            waiters[key, default: []].append(waiter)
+            lock.unlock()
+
+            guard needsRegistration else { return }
+            do {
+                try arm(key)
+            } catch {
+                fail(key, error: error)
+            }
+        }
+
+        func cancel(fd: Int32, error: Error) {
+            fail(Key(fd: fd, readiness: .readable), error: error)
+            fail(Key(fd: fd, readiness: .writable), error: error)
+        }
+
+        private func arm(_ key: Key) throws {
+            let flags: KEventFlags = [.add, .enable, .oneshot]
+            switch key.readiness {
+            case .readable: try kqueue.register(KEvent.read(fd: key.fd, flags: flags))
+            case .writable: try kqueue.register(KEvent.write(fd: key.fd, flags: flags))
+            }
+        }
+
+        private func fail(_ key: Key, error: Error) {
+            lock.lock()
+            let pending = waiters.removeValue(forKey: key) ?? []
+            lock.unlock()
+            pending.forEach { $0.cancel(error) }
+        }
+
+        private func ready(_ key: Key) {
+            lock.lock()
+            let pending = waiters.removeValue(forKey: key) ?? []
+            lock.unlock()
+
+            // Anything still blocked (spurious wakeup, or another waiter drained
+            // the socket first) is parked again behind a fresh registration.
+            for waiter in pending where !waiter.fire() {
+                park(waiter, fd: key.fd, readiness: key.readiness)
+            }
+        }
+
+        private func run() {
+            while true {
+                let events: [KEventResult]
+                do {
+                    events = try kqueue.wait(maxEvents: 64, timeout: nil)
+                } catch {
+                    if case .posix(let posix) = error as? BSDError, posix.code == .EINTR {
+                        continue
+                    }
+                    break
+                }
+
+                for event in events {
+                    switch event {
+                    case .readable(let fd, _, _, _):
+                        ready(Key(fd: fd, readiness: .readable))
+                    case .writable(let fd, _, _, _):
+                        ready(Key(fd: fd, readiness: .writable))
+                    case .user(let id, _, _) where id == Self.shutdownEventID:
+                        drain()
+                        return
+                    default:
+                        break
+                    }
+                }
+            }
+            drain()
+        }
+
+        private func drain() {
+            lock.lock()
+            stopped = true
+            let pending = waiters
+            waiters.removeAll()
+            lock.unlock()
+            for (_, list) in pending {
+                list.forEach { $0.cancel(FPCError.stopped) }
+            }
+        }
+    }
+}
@@ -23,7 +23,9 @@ import Descriptors
 //   - version (UInt8):           1 byte  at offset 17 (currently 0)
 //   - flags (UInt8):             1 byte  at offset 18
 //       - bit 0: hasOOLPayload (1 if payload sent via shared memory)
-//       - bits 1-7: reserved
+//       - bit 1: hasSlabPayload (1 if payload lives in the peer's slab pool;
+//                inline payload is an 8-byte FPCSlabReference)
+//       - bits 2-7: reserved
 //   - reserved:                237 bytes at offset 19-255
 //
 // Trailer (256 bytes):
@@ -31,6 +33,18 @@ import Descriptors
 //       - Each byte encodes DescriptorKind.wireValue
 //       - Value 255 marks the out-of-line payload descriptor (index 0 only)
 //   - reserved:          2 bytes at offset 254-255
+//
+// Version 1 (compact) layout: variable header | variable payload, no trailer
+//
+// Header (19 + descriptorCount bytes):
+//   - messageID, correlationID, payloadLength, descriptorCount, version, flags
+//     at the same offsets as version 0 (version = 1)
+//   - descriptorKinds: descriptorCount bytes at offset 19, encoded as in the
+//     version 0 trailer
+//
+// The version byte sits at offset 17 in both layouts, so a receiver decodes
+// either. A sender only emits version 1 once the peer has advertised support
+// with MessageID.frameVersionOffer.
 
 /// Wire format constants and utilities for BPC protocol.
 public enum FPCFrameLayout {
@@ -49,6 +63,17 @@ public enum FPCFrameLayout {
     /// Current protocol version.
     public static let currentVersion: UInt8 = 0
 
+    /// Compact framing version, negotiated per connection.
+    public static let compactVersion: UInt8 = 1
+
+    /// Size of the fixed part of a compact (v1) header.
+    public static let compactHeaderSize = 19
+
+    /// Whether `frame` uses the compact (v1) layout.
+    public static func isCompactFrame(_ frame: UnsafeRawBufferPointer) -> Bool {
+        frame.count > versionOffset && frame[versionOffset] == compactVersion
+    }
+
     // Header field offsets
     public static let messageIDOffset = 0
     public static let correlationIDOffset = 4
@@ -59,6 +84,7 @@ public enum FPCFrameLayout {
 
     // Flag bits
     public static let flagOOLPayload: UInt8 = 0x01
+    public static let flagSlabPayload: UInt8 = 0x02
 }
 
 // MARK: - FPCFrameHeader
@@ -76,6 +102,10 @@ public struct FPCFrameHeader: Equatable, Sendable {
         (flags & FPCFrameLayout.flagOOLPayload) != 0
     }
 
+    public var hasSlabPayload: Bool {
+        (flags & FPCFrameLayout.flagSlabPayload) != 0
+    }
+
     public init(
         messageID: UInt32,
         correlationID: UInt64,
@@ -92,23 +122,29 @@ public struct FPCFrameHeader: Equatable, Sendable {
         self.flags = flags
     }
 
+    /// Encodes the header directly into a caller-provided buffer.
+    ///
+    /// Writes exactly ``FPCFrameLayout/headerSize`` bytes; reserved bytes are zeroed.
+    ///
+    /// - Parameter buffer: At least 256 bytes of writable memory (e.g. a stack
+    ///   allocation from `withUnsafeTemporaryAllocation`)
+    public func encode(into buffer: UnsafeMutableRawBufferPointer) {
+        precondition(buffer.count >= FPCFrameLayout.headerSize)
+        let header = UnsafeMutableRawBufferPointer(rebasing: buffer[..<FPCFrameLayout.headerSize])
+        header.initializeMemory(as: UInt8.self, repeating: 0)
+
+        header.storeBytes(of: messageID, toByteOffset: FPCFrameLayout.messageIDOffset, as: UInt32.self)
+        header.storeBytes(of: correlationID, toByteOffset: FPCFrameLayout.correlationIDOffset, as: UInt64.self)
+        header.storeBytes(of: payloadLength, toByteOffset: FPCFrameLayout.payloadLengthOffset, as: UInt32.self)
+        header[FPCFrameLayout.descriptorCountOffset] = descriptorCount
+        header[FPCFrameLayout.versionOffset] = version
+        header[FPCFrameLayout.flagsOffset] = flags
+    }
+
     /// Encodes the header to wire format bytes.
     public func encode() -> Data {
         var header = Data(count: FPCFrameLayout.headerSize)
-
-        var msgID = messageID
-        header.replaceSubrange(0..<4, with: Data(bytes: &msgID, count: 4))
-
-        var corrID = correlationID
-        header.replaceSubrange(4..<12, with: Data(bytes: &corrID, count: 8))
-
-        var payloadLen = payloadLength
-        header.replaceSubrange(12..<16, with: Data(bytes: &payloadLen, count: 4))
-
-        header[16] = descriptorCount
-        header[17] = version
-        header[18] = flags
-
+        header.withUnsafeMutableBytes { encode(into: $0) }
         return header
     }
 
@@ -118,25 +154,25 @@ public struct FPCFrameHeader: Equatable, Sendable {
     /// - Returns: Parsed header
     /// - Throws: `FPCError.invalidMessageFormat` if data is too short
     public static func decode(from data: Data) throws -> FPCFrameHeader {
-        guard data.count >= FPCFrameLayout.headerSize else {
-            throw FPCError.invalidMessageFormat
-        }
-
-        let messageID = data.withUnsafeBytes {
-            $0.loadUnaligned(fromByteOffset: FPCFrameLayout.messageIDOffset, as: UInt32.self)
-        }
-
-        let correlationID = data.withUnsafeBytes {
-            $0.loadUnaligned(fromByteOffset: FPCFrameLayout.correlationIDOffset, as: UInt64.self)
-        }
+        try data.withUnsafeBytes { try decode(from: $0) }
+    }
 
-        let payloadLength = data.withUnsafeBytes {
-            $0.loadUnaligned(fromByteOffset: FPCFrameLayout.payloadLengthOffset, as: UInt32.self)
+    /// Decodes a header in place from raw wire bytes, without copying.
+    ///
+    /// - Parameter buffer: At least 256 bytes of header data
+    /// - Returns: Parsed header
+    /// - Throws: `FPCError.invalidMessageFormat` if the buffer is too short
+    public static func decode(from buffer: UnsafeRawBufferPointer) throws -> FPCFrameHeader {
+        guard buffer.count >= FPCFrameLayout.headerSize else {
+            throw FPCError.invalidMessageFormat
         }
 
-        let descriptorCount = data[FPCFrameLayout.descriptorCountOffset]
-        let version = data[FPCFrameLayout.versionOffset]
-        let flags = data[FPCFrameLayout.flagsOffset]
+        let messageID = buffer.loadUnaligned(fromByteOffset: FPCFrameLayout.messageIDOffset, as: UInt32.self)
+        let correlationID = buffer.loadUnaligned(fromByteOffset: FPCFrameLayout.correlationIDOffset, as: UInt64.self)
+        let payloadLength = buffer.loadUnaligned(fromByteOffset: FPCFrameLayout.payloadLengthOffset, as: UInt32.self)
+        let descriptorCount = buffer[FPCFrameLayout.descriptorCountOffset]
+        let version = buffer[FPCFrameLayout.versionOffset]
+        let flags = buffer[FPCFrameLayout.flagsOffset]
 
         return FPCFrameHeader(
             messageID: messageID,
@@ -148,15 +184,22 @@ public struct FPCFrameHeader: Equatable, Sendable {
         )
     }
 
-    /// Validates the header for protocol compliance.
+    /// Validates a header decoded from the 256-byte (v0) layout.
+    ///
+    /// Only version 0 is accepted. Compact (v1) frames carry their header in
+    /// the short layout and are validated with ``FPCCompactHeader/validate()``;
+    /// a 256-byte header claiming version 1 is malformed.
     ///
     /// - Throws: `FPCError` describing the validation failure
     public func validate() throws {
-        // Check version
         guard version == FPCFrameLayout.currentVersion else {
             throw FPCError.unsupportedVersion(version)
         }
+        try validateFields()
+    }
 
+    /// Checks the fields shared by the v0 and v1 layouts.
+    func validateFields() throws {
         // Check descriptor count
         guard descriptorCount <= FPCFrameLayout.maxDescriptors else {
             throw FPCError.invalidMessageFormat
@@ -173,6 +216,105 @@ public struct FPCFrameHeader: Equatable, Sendable {
                 throw FPCError.invalidMessageFormat
             }
         }
+
+        // Slab payload consistency checks
+        if hasSlabPayload {
+            // Slab and per-message OOL are mutually exclusive
+            guard !hasOOLPayload else {
+                throw FPCError.invalidMessageFormat
+            }
+            // Inline payload must be exactly one slab reference
+            guard payloadLength == UInt32(FPCSlabReference.encodedSize) else {
+                throw FPCError.invalidMessageFormat
+            }
+        }
+    }
+}
+
+// MARK: - Compact Header
+
+/// A decoded compact (v1) header: the fixed fields plus the descriptor kinds.
+public struct FPCCompactHeader: Equatable, Sendable {
+    public var header: FPCFrameHeader
+    public var descriptorKinds: FPCFrameTrailer
+
+    /// Encoded size in bytes, and so the offset of the payload.
+    public var size: Int {
+        FPCFrameLayout.compactHeaderSize + Int(header.descriptorCount)
+    }
+
+    /// - Parameters:
+    ///   - header: Fixed fields; the version is forced to ``FPCFrameLayout/compactVersion``.
+    ///   - descriptorKinds: One kind per descriptor, as in the v0 trailer.
+    public init(header: FPCFrameHeader, descriptorKinds: FPCFrameTrailer) {
+        var header = header
+        header.version = FPCFrameLayout.compactVersion
+        self.header = header
+        self.descriptorKinds = descriptorKinds
+    }
+
+    /// Encodes the compact header directly into a caller-provided buffer.
+    ///
+    /// - Parameter buffer: At least ``size`` bytes of writable memory
+    public func encode(into buffer: UnsafeMutableRawBufferPointer) {
+        precondition(buffer.count >= size)
+
+        buffer.storeBytes(of: header.messageID, toByteOffset: FPCFrameLayout.messageIDOffset, as: UInt32.self)
+        buffer.storeBytes(of: header.correlationID, toByteOffset: FPCFrameLayout.correlationIDOffset, as: UInt64.self)
+        buffer.storeBytes(of: header.payloadLength, toByteOffset: FPCFrameLayout.payloadLengthOffset, as: UInt32.self)
+        buffer[FPCFrameLayout.descriptorCountOffset] = header.descriptorCount
+        buffer[FPCFrameLayout.versionOffset] = header.version
+        buffer[FPCFrameLayout.flagsOffset] = header.flags
+
+        let kinds = descriptorKinds.descriptorKinds
+        for index in 0..<Int(header.descriptorCount) {
+            let kind = index < kinds.count ? kinds[index] : DescriptorKind.unknown.wireValue
+            buffer[FPCFrameLayout.compactHeaderSize + index] =
+                (index == 0 && header.hasOOLPayload) ? DescriptorKind.oolPayloadWireValue : kind
+        }
+    }
+
+    /// Decodes a compact header in place from raw wire bytes.
+    ///
+    /// - Parameter buffer: A frame starting with a compact header
+    /// - Returns: Parsed header and descriptor kinds
+    /// - Throws: `FPCError.invalidMessageFormat` if the buffer is too short,
+    ///   or `FPCError.unsupportedVersion` if it is not a v1 frame
+    public static func decode(from buffer: UnsafeRawBufferPointer) throws -> FPCCompactHeader {
+        guard buffer.count >= FPCFrameLayout.compactHeaderSize else {
+            throw FPCError.invalidMessageFormat
+        }
+
+        let header = FPCFrameHeader(
+            messageID: buffer.loadUnaligned(fromByteOffset: FPCFrameLayout.messageIDOffset, as: UInt32.self),
+            correlationID: buffer.loadUnaligned(fromByteOffset: FPCFrameLayout.correlationIDOffset, as: UInt64.self),
+            payloadLength: buffer.loadUnaligned(fromByteOffset: FPCFrameLayout.payloadLengthOffset, as: UInt32.self),
+            descriptorCount: buffer[FPCFrameLayout.descriptorCountOffset],
+            version: buffer[FPCFrameLayout.versionOffset],
+            flags: buffer[FPCFrameLayout.flagsOffset]
+        )
+        guard header.version == FPCFrameLayout.compactVersion else {
+            throw FPCError.unsupportedVersion(header.version)
+        }
+
+        let count = Int(header.descriptorCount)
+        guard count <= FPCFrameLayout.maxDescriptors,
+              buffer.count >= FPCFrameLayout.compactHeaderSize + count else {
+            throw FPCError.invalidMessageFormat
+        }
+
+        let kinds = Array(buffer[FPCFrameLayout.compactHeaderSize..<(FPCFrameLayout.compactHeaderSize + count)])
+        return FPCCompactHeader(header: header, descriptorKinds: FPCFrameTrailer(descriptorKinds: kinds))
+    }
+
+    /// Validates the header for protocol compliance.
+    ///
+    /// - Throws: `FPCError` describing the validation failure
+    public func validate() throws {
+        guard header.version == FPCFrameLayout.compactVersion else {
+            throw FPCError.unsupportedVersion(header.version)
+        }
+        try header.validateFields()
     }
 }
 
@@ -187,21 +329,33 @@ public struct FPCFrameTrailer: Equatable, Sendable {
         self.descriptorKinds = descriptorKinds
     }
 
-    /// Encodes the trailer to wire format bytes.
+    /// Encodes the trailer directly into a caller-provided buffer.
     ///
-    /// - Parameter hasOOLPayload: If true, first descriptor kind is marked as OOL (255)
-    public func encode(hasOOLPayload: Bool = false) -> Data {
-        var trailer = Data(count: FPCFrameLayout.trailerSize)
-
-        for (index, kind) in descriptorKinds.enumerated() {
-            guard index < FPCFrameLayout.maxDescriptors else { break }
+    /// Writes exactly ``FPCFrameLayout/trailerSize`` bytes; unused bytes are zeroed.
+    ///
+    /// - Parameters:
+    ///   - buffer: At least 256 bytes of writable memory
+    ///   - hasOOLPayload: If true, first descriptor kind is marked as OOL (255)
+    public func encode(into buffer: UnsafeMutableRawBufferPointer, hasOOLPayload: Bool = false) {
+        precondition(buffer.count >= FPCFrameLayout.trailerSize)
+        let trailer = UnsafeMutableRawBufferPointer(rebasing: buffer[..<FPCFrameLayout.trailerSize])
+        trailer.initializeMemory(as: UInt8.self, repeating: 0)
+
+        for (index, kind) in descriptorKinds.prefix(FPCFrameLayout.maxDescriptors).enumerated() {
             if index == 0 && hasOOLPayload {
                 trailer[index] = DescriptorKind.oolPayloadWireValue
             } else {
                 trailer[index] = kind
             }
         }
+    }
 
+    /// Encodes the trailer to wire format bytes.
+    ///
+    /// - Parameter hasOOLPayload: If true, first descriptor kind is marked as OOL (255)
+    public func encode(hasOOLPayload: Bool = false) -> Data {
+        var trailer = Data(count: FPCFrameLayout.trailerSize)
+        trailer.withUnsafeMutableBytes { encode(into: $0, hasOOLPayload: hasOOLPayload) }
         return trailer
     }
 
@@ -213,19 +367,23 @@ public struct FPCFrameTrailer: Equatable, Sendable {
     /// - Returns: Parsed trailer
     /// - Throws: `FPCError.invalidMessageFormat` if data is too short
     public static func decode(from data: Data, descriptorCount: Int) throws -> FPCFrameTrailer {
-        guard data.count >= FPCFrameLayout.trailerSize else {
-            throw FPCError.invalidMessageFormat
-        }
-
-        // Copy trailer data to reset indices (Data slice keeps original indices)
-        let trailer = Data(data.prefix(FPCFrameLayout.trailerSize))
+        try data.withUnsafeBytes { try decode(from: $0, descriptorCount: descriptorCount) }
+    }
 
-        var kinds: [UInt8] = []
-        for i in 0..<min(descriptorCount, FPCFrameLayout.maxDescriptors) {
-            kinds.append(trailer[i])
+    /// Decodes a trailer in place from raw wire bytes, without copying.
+    ///
+    /// - Parameters:
+    ///   - buffer: At least 256 bytes of trailer data
+    ///   - descriptorCount: Number of descriptors to read
+    /// - Returns: Parsed trailer
+    /// - Throws: `FPCError.invalidMessageFormat` if the buffer is too short
+    public static func decode(from buffer: UnsafeRawBufferPointer, descriptorCount: Int) throws -> FPCFrameTrailer {
+        guard buffer.count >= FPCFrameLayout.trailerSize else {
+            throw FPCError.invalidMessageFormat
         }
 
-        return FPCFrameTrailer(descriptorKinds: kinds)
+        let count = min(descriptorCount, FPCFrameLayout.maxDescriptors)
+        return FPCFrameTrailer(descriptorKinds: Array(buffer.prefix(count)))
     }
 
     /// Validates the trailer for protocol compliance.
@@ -289,45 +447,87 @@ public struct FPCFrame: Equatable, Sendable {
     }
 
     /// Encodes the complete message to wire format bytes.
+    ///
+    /// Header and trailer are written in place; the payload is copied once.
     public func encode() -> Data {
-        var data = header.encode()
-        data.append(payload)
-        data.append(trailer.encode(hasOOLPayload: header.hasOOLPayload))
+        let headerSize = FPCFrameLayout.headerSize
+        var data = Data(count: headerSize + payload.count + FPCFrameLayout.trailerSize)
+        data.withUnsafeMutableBytes { buffer in
+            header.encode(into: buffer)
+            payload.withUnsafeBytes { source in
+                UnsafeMutableRawBufferPointer(rebasing: buffer[headerSize...]).copyMemory(from: source)
+            }
+            trailer.encode(
+                into: UnsafeMutableRawBufferPointer(rebasing: buffer[(headerSize + payload.count)...]),
+                hasOOLPayload: header.hasOOLPayload
+            )
+        }
+        return data
+    }
+
+    /// Encodes the complete message in the compact (v1) layout.
+    public func encodeCompact() -> Data {
+        let compact = FPCCompactHeader(header: header, descriptorKinds: trailer)
+        var data = Data(count: compact.size + payload.count)
+        data.withUnsafeMutableBytes { buffer in
+            compact.encode(into: buffer)
+            payload.withUnsafeBytes { source in
+                UnsafeMutableRawBufferPointer(rebasing: buffer[compact.size...]).copyMemory(from: source)
+            }
+        }
         return data
     }
 
-    /// Decodes a wire message from bytes.
+    /// Decodes a wire message from bytes, in either the v0 or compact layout.
     ///
     /// - Parameter data: Complete wire message bytes
     /// - Returns: Parsed wire message
     /// - Throws: `FPCError` if the message is malformed
     public static func decode(from data: Data) throws -> FPCFrame {
+        let isCompact = data.withUnsafeBytes { FPCFrameLayout.isCompactFrame($0) }
+        if isCompact {
+            return try data.withUnsafeBytes { buffer in
+                let compact = try FPCCompactHeader.decode(from: buffer)
+                try compact.validate()
+                guard buffer.count == compact.size + Int(compact.header.payloadLength) else {
+                    throw FPCError.invalidMessageFormat
+                }
+                try compact.descriptorKinds.validate(hasOOLPayload: compact.header.hasOOLPayload)
+
+                let payload = Data(UnsafeRawBufferPointer(rebasing: buffer[compact.size...]))
+                return FPCFrame(header: compact.header, payload: payload, trailer: compact.descriptorKinds)
+            }
+        }
+
         guard data.count >= FPCFrameLayout.minimumMessageSize else {
             throw FPCError.invalidMessageFormat
         }
 
-        // Decode header
-        let header = try FPCFrameHeader.decode(from: data)
-        try header.validate()
+        return try data.withUnsafeBytes { buffer in
+            // Decode header in place
+            let header = try FPCFrameHeader.decode(from: buffer)
+            try header.validate()
 
-        // Validate total size
-        let expectedSize = FPCFrameLayout.headerSize + Int(header.payloadLength) + FPCFrameLayout.trailerSize
-        guard data.count == expectedSize else {
-            throw FPCError.invalidMessageFormat
-        }
+            // Validate total size
+            let expectedSize = FPCFrameLayout.headerSize + Int(header.payloadLength) + FPCFrameLayout.trailerSize
+            guard buffer.count == expectedSize else {
+                throw FPCError.invalidMessageFormat
+            }
 
-        // Extract payload
-        let payloadStart = FPCFrameLayout.headerSize
-        let payloadEnd = payloadStart + Int(header.payloadLength)
-        let payload = Data(data[payloadStart..<payloadEnd])
+            // Extract payload (the only copy)
+            let payloadStart = FPCFrameLayout.headerSize
+            let payloadEnd = payloadStart + Int(header.payloadLength)
+            let payload = Data(UnsafeRawBufferPointer(rebasing: buffer[payloadStart..<payloadEnd]))
 
-        // Decode trailer
-        let trailerStart = payloadEnd
-        let trailerData = Data(data[trailerStart...])
-        let trailer = try FPCFrameTrailer.decode(from: trailerData, descriptorCount: Int(header.descriptorCount))
-        try trailer.validate(hasOOLPayload: header.hasOOLPayload)
+            // Decode trailer in place
+            let trailer = try FPCFrameTrailer.decode(
+                from: UnsafeRawBufferPointer(rebasing: buffer[payloadEnd...]),
+                descriptorCount: Int(header.descriptorCount)
+            )
+            try trailer.validate(hasOOLPayload: header.hasOOLPayload)
 
-        return FPCFrame(header: header, payload: payload, trailer: trailer)
+            return FPCFrame(header: header, payload: payload, trailer: trailer)
+        }
     }
 
     /// Converts to a BPC FPCMessage (without descriptors - caller must attach).
@@ -23,10 +23,12 @@ import Capabilities
 public actor FPCListener {
     private let socketHolder: SocketHolder
     private let ioQueue: DispatchQueue
+    private let eventLoop: FPCEventLoop?
     private var state: LifecycleState = .idle
     private var connectionStream: AsyncThrowingStream<FPCEndpoint, Error>?
     private var connectionContinuation: AsyncThrowingStream<FPCEndpoint, Error>.Continuation?
     private var acceptLoopTask: Task<Void, Never>?
+    private var credentialMode: FPCCredentialMode = .perMessage
 
     // MARK: - Listen
 
@@ -36,12 +38,14 @@ public actor FPCListener {
     ///   - path: The filesystem path at which to bind the socket.
     ///   - backlog: Maximum length of the pending connection queue (default: 128)
     ///   - ioQueue: Optional custom DispatchQueue for I/O operations. If `nil`, a default queue is created.
+    ///   - eventLoop: Optional shared ``FPCEventLoop`` for the listener and every accepted endpoint.
     /// - Returns: A new, unstarted ``FPCListener``. Call ``start()`` before use.
     /// - Throws: A system error if the socket cannot be created or bound.
     public static func listen(
         on path: String,
         backlog: Int32 = 128,
-        ioQueue: DispatchQueue? = nil
+        ioQueue: DispatchQueue? = nil,
+        eventLoop: FPCEventLoop? = nil
     ) throws -> FPCListener {
         let socket = try SocketCapability.socket(
             domain: .unix,
@@ -51,7 +55,7 @@ public actor FPCListener {
         let address = try UnixSocketAddress(path: path)
         try socket.bind(address: address)
         try socket.listen(backlog: backlog)
-        return FPCListener(socket: socket, ioQueue: ioQueue)
+        return FPCListener(socket: socket, ioQueue: ioQueue, eventLoop: eventLoop)
     }
 
     /// Begins listening on a Unix-domain SEQPACKET socket at a path relative to a directory.
@@ -65,13 +69,15 @@ public actor FPCListener {
     ///   - path: The relative path within the directory at which to bind the socket.
     ///   - backlog: Maximum length of the pending connection queue (default: 128)
     ///   - ioQueue: Optional custom DispatchQueue for I/O operations. If `nil`, a default queue is created.
+    ///   - eventLoop: Optional shared ``FPCEventLoop`` for the listener and every accepted endpoint.
     /// - Returns: A new, unstarted ``FPCListener``. Call ``start()`` before use.
     /// - Throws: A system error if the socket cannot be created or bound.
     public static func listen<D: DirectoryDescriptor>(
         at directory: borrowing D,
         path: String,
         backlog: Int32 = 128,
-        ioQueue: DispatchQueue? = nil
+        ioQueue: DispatchQueue? = nil,
+        eventLoop: FPCEventLoop? = nil
     ) throws -> FPCListener where D: ~Copyable {
         let socket = try SocketCapability.socket(
             domain: .unix,
@@ -81,7 +87,7 @@ public actor FPCListener {
         let address = try UnixSocketAddress(path: path)
         try socket.bind(at: directory, address: address)
         try socket.listen(backlog: backlog)
-        return FPCListener(socket: socket, ioQueue: ioQueue)
+        return FPCListener(socket: socket, ioQueue: ioQueue, eventLoop: eventLoop)
     }
 
     /// Creates a listener from an already-listening socket.
@@ -92,10 +98,38 @@ public actor FPCListener {
     /// - Parameters:
     ///   - socket: An already-bound and listening socket
     ///   - ioQueue: Optional custom DispatchQueue for I/O operations
+    ///   - eventLoop: Optional shared ``FPCEventLoop``. When provided, `accept` is
+    ///                multiplexed on the loop and accepted endpoints join it.
     /// - Returns: A new, unstarted ``FPCListener``. Call ``start()`` before use.
-    public init(socket: consuming SocketCapability, ioQueue: DispatchQueue? = nil) {
+    public init(
+        socket: consuming SocketCapability,
+        ioQueue: DispatchQueue? = nil,
+        eventLoop: FPCEventLoop? = nil
+    ) {
+        var nonBlocking = false
+        if eventLoop != nil {
+            nonBlocking = socket.unsafe { fd in
+                (try? FPCEventLoop.setNonBlocking(fd)) != nil
+            }
+        }
         self.socketHolder = SocketHolder(socket: socket)
         self.ioQueue = ioQueue ?? DispatchQueue(label: "com.fpc.listener.io", qos: .userInitiated)
+        self.eventLoop = nonBlocking ? eventLoop : nil
+    }
+
+    // MARK: - Credentials
+
+    /// Selects how accepted endpoints receive sender credentials.
+    ///
+    /// Applies to connections accepted afterwards. With
+    /// ``FPCCredentialMode/connectionOnly``, `LOCAL_CREDS_PERSISTENT` is never
+    /// enabled on accepted sockets, so clients' messages carry no per-message
+    /// credentials; use ``FPCEndpoint/getPeerCredentials()`` instead.
+    ///
+    /// - Parameter mode: The credential mode (default for new listeners:
+    ///   ``FPCCredentialMode/perMessage``).
+    public func setCredentialMode(_ mode: FPCCredentialMode) {
+        credentialMode = mode
     }
 
     // MARK: Lifecycle
@@ -125,6 +159,10 @@ public actor FPCListener {
         state = .stopped
         acceptLoopTask?.cancel()
         acceptLoopTask = nil
+        // Cancel before closing: a closed number can be reused at once
+        if let eventLoop, let fd = socketHolder.rawDescriptor {
+            eventLoop.cancel(fd: fd, error: FPCError.listenerClosed)
+        }
         socketHolder.close()
         connectionContinuation?.finish()
         connectionContinuation = nil
@@ -152,12 +190,34 @@ public actor FPCListener {
 
     /// Accepts the next incoming connection. Suspends until a client connects.
     ///
-    /// The accepted socket is configured with `LOCAL_CREDS_PERSISTENT` to enable
+    /// Unless the credential mode is ``FPCCredentialMode/connectionOnly``, the
+    /// accepted socket is configured with `LOCAL_CREDS_PERSISTENT` to enable
     /// per-message credential delivery via `SCM_CREDS2`.
     ///
     /// - Throws: ``FPCError/listenerClosed`` if the listener has been stopped.
     public func accept() async throws -> FPCEndpoint {
         guard state == .running else { throw FPCError.listenerClosed }
+        let endpoint = try await acceptEndpoint(persistentCredentials: credentialMode != .connectionOnly)
+        await endpoint.configureCredentialMode(credentialMode)
+        return endpoint
+    }
+
+    private func acceptEndpoint(persistentCredentials: Bool) async throws -> FPCEndpoint {
+        if let eventLoop {
+            guard let fd = socketHolder.rawDescriptor else { throw FPCError.listenerClosed }
+            let socketHolder = self.socketHolder
+            return try await eventLoop.perform(fd: fd, waitingFor: .readable) {
+                guard let clientSocket = try socketHolder.withSocket({ socket in
+                    try socket.accept()
+                }) else {
+                    throw FPCError.listenerClosed
+                }
+                if persistentCredentials {
+                    try clientSocket.enablePersistentCredentials()
+                }
+                return FPCEndpoint(socket: clientSocket, eventLoop: eventLoop)
+            }
+        }
 
         return try await withCheckedThrowingContinuation { continuation in
             ioQueue.async {
@@ -170,7 +230,9 @@ public actor FPCListener {
                     }
 
                     // Enable persistent credentials for per-message credential delivery
-                    try clientSocket.enablePersistentCredentials()
+                    if persistentCredentials {
+                        try clientSocket.enablePersistentCredentials()
+                    }
 
                     continuation.resume(returning: FPCEndpoint(socket: clientSocket))
                 } catch {
@@ -427,6 +427,15 @@ public struct MessageID: RawRepresentable, Hashable, Sendable {
     /// An unsolicited event pushed by the server.
     public static let event = MessageID(rawValue: 7)
 
+    /// Offers a shared-memory slab pool to the peer. Consumed by ``FPCEndpoint``.
+    public static let slabPoolOffer = MessageID(rawValue: 8)
+
+    /// Returns slabs of a previously offered pool to their owner. Consumed by ``FPCEndpoint``.
+    public static let slabCredit = MessageID(rawValue: 9)
+
+    /// Advertises the highest wire format version the sender can decode. Consumed by ``FPCEndpoint``.
+    public static let frameVersionOffer = MessageID(rawValue: 10)
+
     /// Indicates an error condition.
     public static let error = MessageID(rawValue: 255)
 }
@@ -441,6 +450,9 @@ extension MessageID: CustomStringConvertible {
         case 5: return "subscribe"
         case 6: return "subscribeAck"
         case 7: return "event"
+        case 8: return "slabPoolOffer"
+        case 9: return "slabCredit"
+        case 10: return "frameVersionOffer"
         case 255: return "error"
         default:
             if isSystemReserved {
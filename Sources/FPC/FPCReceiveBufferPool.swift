@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2026 Kory Heard
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+import Foundation
+
+// MARK: - FPCReceiveBufferPool
+
+/// Recycled frame-sized receive buffers for one endpoint.
+///
+/// Every inline frame may be up to header + 64KB + trailer, so allocating
+/// (and zeroing) a fresh buffer per `recvmsg` dominates the cost of small
+/// request/reply traffic. The pool hands out uninitialised buffers and takes
+/// them back once the frame has been parsed.
+///
+/// Large inline payloads are not copied out at all: ``adopt(_:payload:)``
+/// wraps the payload bytes in a `Data` that borrows the buffer and returns it
+/// to the pool when the last copy of that `Data` is released. Mutating such a
+/// payload copies it first, as with any `Data`.
+final class FPCReceiveBufferPool: @unchecked Sendable {
+    /// Payloads at least this large are adopted rather than copied.
+    ///
+    /// Below it, copying is cheaper than pinning a whole frame buffer for as
+    /// long as the application holds the message.
+    static let adoptionThreshold = 16 * 1024
+
+    /// Size of every buffer in the pool.
+    let bufferSize: Int
+
+    private let maxCached: Int
+    private var free: [UnsafeMutableRawPointer] = []
+    private let lock = NSLock()
+
+    /// - Parameters:
+    ///   - bufferSize: Size of each buffer (the largest inline frame).
+    ///   - maxCached: Idle buffers kept for reuse; extras are freed on release.
+    init(bufferSize: Int, maxCached: Int = 4) {
+        self.bufferSize = bufferSize
+        self.maxCached = maxCached
+    }
+
+    deinit {
+        free.forEach { $0.deallocate() }
+    }
+
+    /// Takes an idle buffer, allocating one if none is cached.
+    func acquire() -> UnsafeMutableRawBufferPointer {
+        lock.lock()
+        let cached = free.popLast()
+        lock.unlock()
+
+        let base = cached ?? .allocate(byteCount: bufferSize, alignment: MemoryLayout<UInt64>.alignment)
+        return UnsafeMutableRawBufferPointer(start: base, count: bufferSize)
+    }
+
+    /// Returns a buffer obtained from ``acquire()``.
+    func release(_ buffer: UnsafeMutableRawBufferPointer) {
+        guard let base = buffer.baseAddress else { return }
+        lock.lock()
+        if free.count < maxCached {
+            free.append(base)
+            lock.unlock()
+        } else {
+            lock.unlock()
+            base.deallocate()
+        }
+    }
+
+    /// Wraps `payload`, a range inside `buffer`, as `Data` without copying.
+    ///
+    /// Ownership of `buffer` passes to the returned `Data`; the caller must
+    /// not release it.
+    func adopt(_ buffer: UnsafeMutableRawBufferPointer, payload: UnsafeRawBufferPointer) -> Data {
+        guard let start = payload.baseAddress, payload.count > 0 else {
+            release(buffer)
+            return Data()
+        }
+        return Data(
+            bytesNoCopy: UnsafeMutableRawPointer(mutating: start),
+            count: payload.count,
+            deallocator: .custom { [self] _, _ in release(buffer) }
+        )
+    }
+}
@@ -0,0 +1,441 @@
+/*
+ * Copyright (c) 2026 Kory Heard
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+import Foundation
+import Glibc
+import FreeBSDKit
+import Descriptors
+import Capabilities
+import Capsicum
+
+// MARK: - Slab Pool Protocol
+//
+// Large payloads normally travel through a fresh anonymous shm segment per
+// message (create, size, map, copy, unmap, fd transfer, and a map/unmap on the
+// receiver). With a slab pool, the sender creates ONE shm segment divided into
+// fixed-size slabs, maps it once, and hands it to the peer once:
+//
+//   1. sender -> receiver:  slabPoolOffer  (payload: slabSize, slabCount; descriptor: shm)
+//   2. sender -> receiver:  frame with flagSlabPayload, inline payload = FPCSlabReference
+//   3. receiver -> sender:  slabCredit     (payload: UInt32 slab indices to recycle)
+//
+// Each direction of a connection owns its own pool. Control messages use
+// system-reserved message IDs and are consumed by the endpoint; they never
+// appear in `incoming()`. If the pool is exhausted, or a payload is larger
+// than one slab, the sender falls back to the per-message shm path.
+
+/// Sizing for a per-connection shared-memory slab pool.
+///
+/// Pass to ``FPCEndpoint/enableSlabPool(_:)`` before the first large send.
+public struct FPCSlabConfiguration: Sendable, Equatable {
+    /// Size of each slab in bytes. Payloads larger than this use per-message shm.
+    public var slabSize: Int
+
+    /// Number of slabs in the pool (maximum in-flight slab payloads).
+    public var slabCount: Int
+
+    public init(slabSize: Int, slabCount: Int) {
+        self.slabSize = slabSize
+        self.slabCount = slabCount
+    }
+
+    /// 16 slabs of 1 MiB each.
+    public static let `default` = FPCSlabConfiguration(slabSize: 1 << 20, slabCount: 16)
+
+    /// Total size of the backing shared memory segment.
+    ///
+    /// - Precondition: The configuration is valid; an offer is validated
+    ///   before its size is used.
+    public var totalSize: Int { slabSize * slabCount }
+
+    /// Largest pool, in bytes, that either side creates or maps.
+    public static let maximumTotalSize = 1 << 30
+
+    /// Encoded size of the offer payload (slabSize + slabCount as UInt32).
+    static let encodedSize = 8
+
+    func encode() -> Data {
+        var data = Data(count: Self.encodedSize)
+        data.withUnsafeMutableBytes {
+            $0.storeBytes(of: UInt32(slabSize), toByteOffset: 0, as: UInt32.self)
+            $0.storeBytes(of: UInt32(slabCount), toByteOffset: 4, as: UInt32.self)
+        }
+        return data
+    }
+
+    static func decode(from data: Data) throws -> FPCSlabConfiguration {
+        guard data.count == encodedSize else {
+            throw FPCError.invalidMessageFormat
+        }
+        let (size, count) = data.withUnsafeBytes {
+            ($0.loadUnaligned(fromByteOffset: 0, as: UInt32.self),
+             $0.loadUnaligned(fromByteOffset: 4, as: UInt32.self))
+        }
+        let configuration = FPCSlabConfiguration(slabSize: Int(size), slabCount: Int(count))
+        try configuration.validate()
+        return configuration
+    }
+
+    /// Validates that the configuration describes a usable pool.
+    ///
+    /// The dimensions come from the peer's offer, so their product is
+    /// checked for overflow before anything sizes or maps memory with it.
+    ///
+    /// - Throws: ``FPCError/invalidMessageFormat`` if either dimension is zero
+    ///   or does not fit the 32-bit wire fields, or if the total size
+    ///   overflows or exceeds ``maximumTotalSize``.
+    func validate() throws {
+        guard slabSize > 0, slabCount > 0,
+              slabSize <= Int(UInt32.max), slabCount <= Int(UInt32.max) else {
+            throw FPCError.invalidMessageFormat
+        }
+        let (total, overflow) = slabSize.multipliedReportingOverflow(by: slabCount)
+        guard !overflow, total <= Self.maximumTotalSize else {
+            throw FPCError.invalidMessageFormat
+        }
+    }
+}
+
+// MARK: - FPCSlabReference
+
+/// Inline payload of a frame whose body lives in a pool slab.
+///
+/// Layout (8 bytes, host-endian):
+///   - index (UInt32):  slab index at offset 0
+///   - length (UInt32): payload byte count at offset 4
+public struct FPCSlabReference: Equatable, Sendable {
+    public var index: UInt32
+    public var length: UInt32
+
+    public init(index: UInt32, length: UInt32) {
+        self.index = index
+        self.length = length
+    }
+
+    /// Size of an encoded slab reference in bytes.
+    public static let encodedSize = 8
+
+    /// Encodes the reference to wire format bytes.
+    public func encode() -> Data {
+        var data = Data(count: Self.encodedSize)
+        data.withUnsafeMutableBytes {
+            $0.storeBytes(of: index, toByteOffset: 0, as: UInt32.self)
+            $0.storeBytes(of: length, toByteOffset: 4, as: UInt32.self)
+        }
+        return data
+    }
+
+    /// Decodes a reference from wire format bytes.
+    ///
+    /// - Throws: ``FPCError/invalidMessageFormat`` if `data` is not exactly 8 bytes
+    public static func decode(from data: Data) throws -> FPCSlabReference {
+        try data.withUnsafeBytes { try decode(from: $0) }
+    }
+
+    /// Decodes a reference in place from raw wire bytes.
+    ///
+    /// - Throws: ``FPCError/invalidMessageFormat`` if `buffer` is not exactly 8 bytes
+    public static func decode(from buffer: UnsafeRawBufferPointer) throws -> FPCSlabReference {
+        guard buffer.count == encodedSize else {
+            throw FPCError.invalidMessageFormat
+        }
+        return FPCSlabReference(
+            index: buffer.loadUnaligned(fromByteOffset: 0, as: UInt32.self),
+            length: buffer.loadUnaligned(fromByteOffset: 4, as: UInt32.self)
+        )
+    }
+}
+
+// MARK: - FPCSlabPool (sender side)
+
+/// The sending side of a slab pool: a read-write mapping plus a free list.
+///
+/// Thread-safe; `acquire()` and `release(_:)` may be called from any I/O thread.
+final class FPCSlabPool: @unchecked Sendable {
+    let configuration: FPCSlabConfiguration
+    private let base: UnsafeMutableRawPointer
+    private var freeSlabs: [UInt32]
+    private var inFlight: [Bool]
+    private let lock = NSLock()
+
+    /// Creates an anonymous shm segment, maps it read-write, and restricts the
+    /// descriptor to read-only rights for the peer.
+    ///
+    /// - Returns: The pool and the descriptor to send in the offer message.
+    ///   The mapping remains valid after the descriptor is closed.
+    static func create(configuration: FPCSlabConfiguration) throws -> (FPCSlabPool, OpaqueDescriptorRef) {
+        try configuration.validate()
+
+        let shm = try SharedMemoryCapability.anonymous(accessMode: .readWrite)
+        try shm.setSize(configuration.totalSize)
+        let region = try shm.map(
+            size: configuration.totalSize,
+            protection: [.read, .write],
+            flags: [.shared]
+        )
+
+        // The pool owns the mapping from here on and unmaps it in deinit.
+        let base = UnsafeMutableRawPointer(mutating: region.base)
+
+        // Peer may only map the pool read-only
+        let readOnlyRights = CapsicumRightSet(rights: [.mmapR, .fstat, .seek])
+        _ = shm.limit(rights: readOnlyRights)
+
+        let pool = FPCSlabPool(configuration: configuration, base: base)
+        return (pool, OpaqueDescriptorRef(shm.take(), kind: .shm))
+    }
+
+    private init(configuration: FPCSlabConfiguration, base: UnsafeMutableRawPointer) {
+        self.configuration = configuration
+        self.base = base
+        // Reversed so that popLast() hands out slab 0 first
+        self.freeSlabs = (0..<UInt32(configuration.slabCount)).reversed()
+        self.inFlight = Array(repeating: false, count: configuration.slabCount)
+    }
+
+    deinit {
+        Glibc.munmap(base, configuration.totalSize)
+    }
+
+    /// Number of slabs currently available.
+    var availableCount: Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return freeSlabs.count
+    }
+
+    /// Takes a free slab, or returns `nil` if all slabs are in flight.
+    func acquire() -> UInt32? {
+        lock.lock()
+        defer { lock.unlock() }
+        guard let index = freeSlabs.popLast() else { return nil }
+        inFlight[Int(index)] = true
+        return index
+    }
+
+    /// Returns slabs credited back by the peer.
+    ///
+    /// Only slabs handed out by ``acquire()`` and not yet returned are
+    /// released. Out-of-range indices and credits for slabs that are not in
+    /// flight (duplicates, or credits the peer invented) are ignored: putting
+    /// such a slab back on the free list would hand it out twice and
+    /// overwrite a payload the peer may still be reading.
+    ///
+    /// - Returns: The number of slabs actually released.
+    @discardableResult
+    func release<S: Sequence>(_ indices: S) -> Int where S.Element == UInt32 {
+        lock.lock()
+        defer { lock.unlock() }
+        var released = 0
+        for index in indices where Int(index) < configuration.slabCount && inFlight[Int(index)] {
+            inFlight[Int(index)] = false
+            freeSlabs.append(index)
+            released += 1
+        }
+        return released
+    }
+
+    /// Copies `payload` into slab `index` and returns the reference to send.
+    func fill(slab index: UInt32, with payload: Data) -> FPCSlabReference {
+        precondition(payload.count <= configuration.slabSize)
+        let destination = base.advanced(by: Int(index) * configuration.slabSize)
+        payload.withUnsafeBytes { bytes in
+            if let source = bytes.baseAddress {
+                destination.copyMemory(from: source, byteCount: bytes.count)
+            }
+        }
+        return FPCSlabReference(index: index, length: UInt32(payload.count))
+    }
+}
+
+// MARK: - FPCSlabMapping (receiver side)
+
+/// The receiving side of a peer's slab pool: a read-only mapping.
+final class FPCSlabMapping: @unchecked Sendable {
+    let configuration: FPCSlabConfiguration
+    private let base: UnsafeRawPointer
+
+    /// Maps the peer's pool descriptor read-only and verifies its size.
+    ///
+    /// Takes ownership of `descriptor`; it is closed once mapped.
+    init(descriptor: OpaqueDescriptorRef, configuration: FPCSlabConfiguration) throws {
+        guard let fd = descriptor.take() else {
+            throw FPCError.invalidMessageFormat
+        }
+        defer { Glibc.close(fd) }
+
+        var st = stat()
+        guard Glibc.fstat(fd, &st) == 0 else {
+            try BSDError.throwErrno(errno)
+        }
+        guard Int(st.st_size) == configuration.totalSize else {
+            throw FPCError.invalidMessageFormat
+        }
+
+        let ptr = Glibc.mmap(nil, configuration.totalSize, PROT_READ, MAP_SHARED, fd, 0)
+        guard ptr != MAP_FAILED, let mapped = ptr else {
+            try BSDError.throwErrno(errno)
+        }
+
+        self.configuration = configuration
+        self.base = UnsafeRawPointer(mapped)
+    }
+
+    deinit {
+        Glibc.munmap(UnsafeMutableRawPointer(mutating: base), configuration.totalSize)
+    }
+
+    /// Copies the referenced slab contents out of shared memory.
+    ///
+    /// - Throws: ``FPCError/invalidMessageFormat`` if the reference is out of bounds
+    func copyOut(_ reference: FPCSlabReference) throws -> Data {
+        guard Int(reference.index) < configuration.slabCount,
+              Int(reference.length) <= configuration.slabSize else {
+            throw FPCError.invalidMessageFormat
+        }
+        let source = base.advanced(by: Int(reference.index) * configuration.slabSize)
+        return Data(bytes: source, count: Int(reference.length))
+    }
+}
+
+// MARK: - SlabChannel
+
+/// Per-endpoint slab state for both directions of a connection.
+///
+/// The outbound pool is created lazily on the first payload that needs it and
+/// the offer is sent under `lock`, so no slab frame can overtake its offer.
+final class SlabChannel: @unchecked Sendable {
+    private var configuration: FPCSlabConfiguration?
+    private var outbound: FPCSlabPool?
+    private var inbound: FPCSlabMapping?
+    private var deferredCredits: [UInt32] = []
+    private var creditFlushScheduled = false
+    private let lock = NSLock()
+
+    /// Most slab indices carried by one credit message; keeps it inline.
+    static let maxCreditsPerMessage = 1024
+
+    /// Enables the outbound pool. Has no effect once the pool has been offered.
+    func enable(_ configuration: FPCSlabConfiguration) {
+        lock.lock()
+        defer { lock.unlock() }
+        guard outbound == nil else { return }
+        self.configuration = configuration
+    }
+
+    /// Returns the outbound pool, creating and offering it on first use.
+    ///
+    /// - Parameter offer: Sends the offer message; called at most once, under the lock.
+    /// - Returns: The pool, or `nil` if slab transport is not enabled.
+    func outboundPool(offer: (FPCMessage) throws -> Void) throws -> FPCSlabPool? {
+        lock.lock()
+        defer { lock.unlock() }
+        if let pool = outbound { return pool }
+        guard let configuration = configuration else { return nil }
+
+        let (pool, descriptor) = try FPCSlabPool.create(configuration: configuration)
+        try offer(FPCMessage(
+            id: .slabPoolOffer,
+            payload: configuration.encode(),
+            descriptors: [descriptor]
+        ))
+        outbound = pool
+        return pool
+    }
+
+    /// Installs the peer's pool from a ``MessageID/slabPoolOffer`` message.
+    func acceptOffer(_ message: FPCMessage) throws {
+        guard message.descriptors.count == 1 else {
+            throw FPCError.invalidMessageFormat
+        }
+        let configuration = try FPCSlabConfiguration.decode(from: message.payload)
+        let mapping = try FPCSlabMapping(descriptor: message.descriptors[0], configuration: configuration)
+
+        lock.lock()
+        defer { lock.unlock() }
+        inbound = mapping
+    }
+
+    /// Returns credited slabs from a ``MessageID/slabCredit`` message to the outbound pool.
+    func applyCredit(_ message: FPCMessage) throws {
+        guard message.payload.count % MemoryLayout<UInt32>.size == 0 else {
+            throw FPCError.invalidMessageFormat
+        }
+        let indices = message.payload.withUnsafeBytes { bytes in
+            (0..<(bytes.count / 4)).map { bytes.loadUnaligned(fromByteOffset: $0 * 4, as: UInt32.self) }
+        }
+
+        lock.lock()
+        let pool = outbound
+        lock.unlock()
+        pool?.release(indices)
+    }
+
+    /// Free slabs in the outbound pool, or `nil` before it has been offered.
+    var outboundAvailableCount: Int? {
+        lock.lock()
+        let pool = outbound
+        lock.unlock()
+        return pool?.availableCount
+    }
+
+    /// Copies a slab payload out of the peer's pool.
+    func resolve(_ reference: FPCSlabReference) throws -> Data {
+        lock.lock()
+        let mapping = inbound
+        lock.unlock()
+        guard let mapping else {
+            throw FPCError.invalidMessageFormat
+        }
+        return try mapping.copyOut(reference)
+    }
+
+    /// Queues a credit that could not be sent because the socket would block.
+    ///
+    /// - Returns: `true` if the caller must schedule ``flushDeferredCredits(_:)``;
+    ///   `false` if a flush is already scheduled and will pick this credit up.
+    func deferCredit(_ index: UInt32) -> Bool {
+        lock.lock()
+        defer { lock.unlock() }
+        deferredCredits.append(index)
+        guard !creditFlushScheduled else { return false }
+        creditFlushScheduled = true
+        return true
+    }
+
+    /// Sends every deferred credit. Only the flush scheduled by
+    /// ``deferCredit(_:)`` calls this.
+    ///
+    /// Credits leave the queue only once `send` succeeds, so a flush that
+    /// fails with `EAGAIN` can simply be run again.
+    func flushDeferredCredits(_ send: (FPCMessage) throws -> Void) throws {
+        while true {
+            lock.lock()
+            let batch = Array(deferredCredits.prefix(Self.maxCreditsPerMessage))
+            if batch.isEmpty { creditFlushScheduled = false }
+            lock.unlock()
+            guard !batch.isEmpty else { return }
+
+            // Sent without the lock: the send path may take it for the pool
+            try send(Self.credit(for: batch))
+
+            lock.lock()
+            deferredCredits.removeFirst(batch.count)
+            lock.unlock()
+        }
+    }
+
+    /// Builds the credit message returning `indices` to the peer's pool.
+    static func credit(for indices: [UInt32]) -> FPCMessage {
+        var payload = Data(count: indices.count * MemoryLayout<UInt32>.size)
+        payload.withUnsafeMutableBytes { bytes in
+            for (offset, index) in indices.enumerated() {
+                bytes.storeBytes(of: index, toByteOffset: offset * 4, as: UInt32.self)
+            }
+        }
+        return FPCMessage(id: .slabCredit, payload: payload)
+    }
+}
@@ -6,6 +6,7 @@
 
 import Foundation
 import Glibc
+import Descriptors
 
 // MARK: - MessageCredentials
 
@@ -144,3 +145,80 @@ extension MessageCredentials: CustomStringConvertible {
         return desc
     }
 }
+
+// MARK: - FPCCredentialMode
+
+/// How an endpoint obtains sender credentials for inbound messages.
+public enum FPCCredentialMode: Sendable {
+    /// Every message carries `SCM_CREDS2` and gets freshly decoded
+    /// ``MessageCredentials``. The default.
+    case perMessage
+
+    /// Every message carries `SCM_CREDS2`, but when its raw bytes match the
+    /// previous message's, the previous ``MessageCredentials`` is reused
+    /// instead of being decoded and allocated again.
+    case cached
+
+    /// `LOCAL_CREDS_PERSISTENT` is disabled, so messages carry no control
+    /// message and ``FPCMessage/senderCredentials`` is `nil`. Use
+    /// ``FPCEndpoint/getPeerCredentials()`` for the connection-time
+    /// credentials instead.
+    case connectionOnly
+}
+
+// MARK: - MessageCredentialCache
+
+/// Reuses the last ``MessageCredentials`` built on an endpoint's receive path.
+///
+/// The socket-level cache hands back the identical ``SocketCredentials`` value
+/// for identical raw bytes, so comparing against the last one short-circuits
+/// on the shared `groups` storage.
+final class MessageCredentialCache: @unchecked Sendable {
+    @Atomic private var enabled = false
+    private let lock = NSLock()
+    private let socketCache = SocketCredentialCache()
+    private var lastSocket: SocketCredentials?
+    private var lastMessage: MessageCredentials?
+
+    /// Socket-level cache to pass to receives, or `nil` when caching is off.
+    var socketCredentialCache: SocketCredentialCache? {
+        enabled ? socketCache : nil
+    }
+
+    func configure(_ mode: FPCCredentialMode) {
+        enabled = mode == .cached
+    }
+
+    /// Receives answered from the socket-level cache, and receives that
+    /// decoded new credentials.
+    var statistics: (hits: Int, misses: Int) {
+        (socketCache.hits, socketCache.misses)
+    }
+
+    /// Converts socket credentials, reusing the previous result when unchanged.
+    func messageCredentials(_ credentials: SocketCredentials?) -> MessageCredentials? {
+        guard let credentials else { return nil }
+        guard enabled else { return Self.convert(credentials) }
+
+        lock.lock()
+        defer { lock.unlock() }
+        if let lastMessage, lastSocket == credentials {
+            return lastMessage
+        }
+        let converted = Self.convert(credentials)
+        lastSocket = credentials
+        lastMessage = converted
+        return converted
+    }
+
+    private static func convert(_ creds: SocketCredentials) -> MessageCredentials {
+        MessageCredentials(
+            realUID: creds.realUID,
+            effectiveUID: creds.effectiveUID,
+            realGID: creds.realGID,
+            effectiveGID: creds.effectiveGID,
+            pid: creds.pid,
+            groups: creds.groups
+        )
+    }
+}
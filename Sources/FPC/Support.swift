@@ -73,6 +73,16 @@ final class SocketHolder: @unchecked Sendable {
         return try body(socket!)
     }
 
+    /// The raw descriptor, or `nil` once closed.
+    ///
+    /// Used to register the socket with an ``FPCEventLoop``; never perform
+    /// I/O on it directly.
+    var rawDescriptor: Int32? {
+        closeLock.lock()
+        defer { closeLock.unlock() }
+        return fd >= 0 ? fd : nil
+    }
+
     /// Closes the underlying socket and releases it.
     ///
     /// First shuts down the socket to unblock any pending I/O operations,
@@ -98,6 +108,70 @@ final class SocketHolder: @unchecked Sendable {
     }
 }
 
+// MARK: - BatchCursor
+
+/// Progress through a batched send.
+///
+/// `sendmmsg(2)` may accept only a prefix of a batch, and an operation parked
+/// on an ``FPCEventLoop`` is re-run from scratch when the socket becomes
+/// writable, so the index of the next unsent message is kept outside the
+/// operation. Only one thread advances a cursor at a time.
+final class BatchCursor: @unchecked Sendable {
+    var next = 0
+}
+
+// MARK: - DeferredFailure
+
+/// An error held back until the messages received before it are delivered.
+///
+/// A batched receive that fails partway through returns the messages it had
+/// already parsed; the error is reported by the next receive instead. Only
+/// the receive loop touches it.
+final class DeferredFailure: @unchecked Sendable {
+    private var error: Error?
+
+    /// Holds `error` for the next ``throwIfPending()``.
+    func hold(_ error: Error) {
+        self.error = error
+    }
+
+    /// Throws and clears the held error, if any.
+    func throwIfPending() throws {
+        if let error {
+            self.error = nil
+            throw error
+        }
+    }
+}
+
+// MARK: - FrameNegotiation
+
+/// Per-connection wire format state, shared between the send and receive paths.
+///
+/// The peer advertises the highest version it can decode with
+/// ``MessageID/frameVersionOffer``; until then, frames are sent in version 0.
+final class FrameNegotiation: @unchecked Sendable {
+    @Atomic private var peerVersion: UInt8 = FPCFrameLayout.currentVersion
+
+    /// Whether outbound frames may use the compact (v1) layout.
+    var sendCompact: Bool {
+        peerVersion >= FPCFrameLayout.compactVersion
+    }
+
+    /// Records a ``MessageID/frameVersionOffer`` from the peer.
+    func acceptOffer(_ message: FPCMessage) throws {
+        guard let version = message.payload.first else {
+            throw FPCError.invalidMessageFormat
+        }
+        peerVersion = version
+    }
+
+    /// The offer this implementation sends: the highest version it decodes.
+    static var offer: FPCMessage {
+        FPCMessage(id: .frameVersionOffer, payload: Data([FPCFrameLayout.compactVersion]))
+    }
+}
+
 // MARK: - Atomic Property Wrapper
 
 @propertyWrapper
@@ -0,0 +1,355 @@
+/*
+ * Copyright (c) 2026 Kory Heard
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+import CNetmap
+import Foundation
+
+/// A packet parked in a pool buffer, out of any ring.
+public struct NetmapHeldBuffer: Sendable, Equatable {
+    /// Buffer index holding the packet.
+    public let bufferIndex: UInt32
+
+    /// Packet length in bytes.
+    public let length: UInt16
+}
+
+/// A user-space pool over a port's extra buffers.
+///
+/// The pool takes the port's extra buffers off the kernel's linked list
+/// once, at creation, and keeps them in an array. That makes allocation
+/// and release O(1) without touching buffer memory, and allows bulk
+/// operations that move many indices under one lock.
+///
+/// Pool buffers let an application keep packets across ring cycles without
+/// copying: ``hold(_:)`` swaps a slot's buffer for a free pool buffer, so
+/// the packet leaves the ring and the slot goes back to the kernel with a
+/// fresh buffer. A held packet is later transmitted with ``place(_:into:)``
+/// or dropped with ``release(_:)``.
+///
+/// ```swift
+/// let port = try NetmapPort.open(interface: "ix0", extraBuffers: 4096)
+/// let pool = try NetmapBufferPool(port: port)
+/// var queue: [NetmapHeldBuffer] = []
+///
+/// // Queue every packet for shaping
+/// try port.rxSync()
+/// port.rxRing(0).withPackets { batch in
+///     for packet in batch {
+///         if let held = pool.hold(packet.slot) { queue.append(held) }
+///     }
+/// }
+///
+/// // Later: send the queue without copying
+/// let sent = port.txRing(0).withPackets(limit: queue.count) { slots in
+///     for (slot, held) in zip(slots, queue) { pool.place(held, into: slot.slot) }
+///     return slots.count
+/// }
+/// queue.removeFirst(sent)
+/// try port.txSync()
+///
+/// pool.close(returningTo: port)
+/// ```
+///
+/// ## Per-Thread Caches
+///
+/// The pool itself is lock-protected. Threads that allocate and free at
+/// packet rate should use a ``Cache`` from ``makeCache(size:)``, which
+/// serves requests from a private array and refills or spills half its
+/// size to the pool at a time.
+///
+/// ## Closing
+///
+/// ``close(returningTo:)`` links every free pool buffer back onto the
+/// kernel list so the kernel reclaims them when the port is closed. Flush
+/// caches and release held buffers first; buffers still out of the pool at
+/// close are not returned.
+public final class NetmapBufferPool: @unchecked Sendable {
+
+    /// Memory allocator ID the buffers belong to.
+    public let memoryId: UInt16
+
+    /// Size of each buffer in bytes.
+    public let bufferSize: Int
+
+    /// Number of buffers the pool took from the port.
+    public let capacity: Int
+
+    /// A ring of the port, used to resolve buffer indices to addresses.
+    private let ringPtr: UnsafeMutableRawPointer
+
+    private let lock = NSLock()
+    private var freeBuffers: [UInt32]
+    private var isClosed = false
+
+    /// Takes extra buffers from a port's kernel list.
+    ///
+    /// - Parameters:
+    ///   - port: A registered port opened with extra buffers
+    ///   - limit: Maximum number of buffers to take
+    /// - Throws: `NetmapError.invalidConfiguration` if the port has no rings
+    ///   or no extra buffers.
+    public init(port: borrowing NetmapPort, limit: Int = .max) throws {
+        guard port.txRingCount > 0 || port.rxRingCount > 0 else {
+            throw NetmapError.invalidConfiguration("buffer pool needs a port with rings")
+        }
+        let ring: NetmapRing
+        if port.txRingCount > 0 {
+            ring = port.txRing(0)
+        } else {
+            ring = port.rxRing(0)
+        }
+
+        var buffers: [UInt32] = []
+        buffers.reserveCapacity(min(Int(port.extraBufferCount), max(limit, 0)))
+        var current = port.extraBuffersHead
+        while current != 0, buffers.count < limit {
+            buffers.append(current)
+            current = ring.getNextExtraBuffer(current)
+        }
+        guard !buffers.isEmpty else {
+            throw NetmapError.invalidConfiguration("port has no extra buffers")
+        }
+        port.extraBuffersHead = current
+
+        // Hand out low indices first
+        buffers.reverse()
+
+        self.memoryId = port.memoryId
+        self.bufferSize = Int(ring.bufferSize)
+        self.capacity = buffers.count
+        self.ringPtr = ring.ringPtr
+        self.freeBuffers = buffers
+    }
+
+    /// Number of free buffers in the pool, excluding caches.
+    public var available: Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return freeBuffers.count
+    }
+
+    // MARK: - Allocation
+
+    /// Takes one buffer from the pool.
+    ///
+    /// - Returns: A buffer index, or nil if the pool is empty or closed
+    public func allocate() -> UInt32? {
+        lock.lock()
+        defer { lock.unlock() }
+        return freeBuffers.popLast()
+    }
+
+    /// Takes up to `count` buffers from the pool in one operation.
+    ///
+    /// - Parameters:
+    ///   - count: Number of buffers wanted
+    ///   - buffers: Array the buffer indices are appended to
+    /// - Returns: Number of buffers appended
+    @discardableResult
+    public func allocate(_ count: Int, into buffers: inout [UInt32]) -> Int {
+        lock.lock()
+        defer { lock.unlock() }
+        let taken = min(max(count, 0), freeBuffers.count)
+        buffers.append(contentsOf: freeBuffers.suffix(taken))
+        freeBuffers.removeLast(taken)
+        return taken
+    }
+
+    /// Returns one buffer to the pool.
+    ///
+    /// - Parameter buffer: A buffer index from this pool's allocator
+    /// - Note: Buffers freed after ``close(returningTo:)`` are discarded.
+    public func free(_ buffer: UInt32) {
+        lock.lock()
+        defer { lock.unlock() }
+        guard !isClosed else { return }
+        freeBuffers.append(buffer)
+    }
+
+    /// Returns many buffers to the pool in one operation.
+    ///
+    /// - Parameter buffers: Buffer indices from this pool's allocator
+    public func free<S: Sequence>(_ buffers: S) where S.Element == UInt32 {
+        lock.lock()
+        defer { lock.unlock() }
+        guard !isClosed else { return }
+        freeBuffers.append(contentsOf: buffers)
+    }
+
+    /// The address of a buffer.
+    ///
+    /// - Parameter buffer: A buffer index from this pool's allocator
+    /// - Returns: Pointer to ``bufferSize`` bytes
+    @inline(__always)
+    public func pointer(to buffer: UInt32) -> UnsafeMutableRawPointer {
+        return cnm_buf(ringPtr, buffer)!
+    }
+
+    // MARK: - Holding Packets
+
+    /// Takes a packet out of its slot by swapping in a pool buffer.
+    ///
+    /// The slot keeps its length and is flagged as changed, so the kernel
+    /// picks up the new buffer when the slot is released.
+    ///
+    /// - Parameter slot: A slot of a ring sharing this pool's allocator
+    /// - Returns: The held packet, or nil if the pool is empty
+    @inline(__always)
+    public func hold(_ slot: NetmapSlot) -> NetmapHeldBuffer? {
+        guard let buffer = allocate() else { return nil }
+        return Self.swap(slot, with: buffer)
+    }
+
+    /// Puts a held packet into a free TX slot.
+    ///
+    /// The slot's previous buffer returns to the pool.
+    ///
+    /// - Parameters:
+    ///   - held: A packet from ``hold(_:)``
+    ///   - slot: A free slot of a TX ring sharing this pool's allocator
+    @inline(__always)
+    public func place(_ held: NetmapHeldBuffer, into slot: NetmapSlot) {
+        free(Self.place(held, into: slot))
+    }
+
+    /// Drops a held packet, returning its buffer to the pool.
+    @inline(__always)
+    public func release(_ held: NetmapHeldBuffer) {
+        free(held.bufferIndex)
+    }
+
+    @inline(__always)
+    static func swap(_ slot: NetmapSlot, with buffer: UInt32) -> NetmapHeldBuffer {
+        let held = NetmapHeldBuffer(bufferIndex: slot.bufferIndex, length: slot.length)
+        slot.bufferIndex = buffer
+        slot.markBufferChanged()
+        return held
+    }
+
+    /// Installs a held buffer in a slot and returns the slot's old buffer.
+    @inline(__always)
+    static func place(_ held: NetmapHeldBuffer, into slot: NetmapSlot) -> UInt32 {
+        let old = slot.bufferIndex
+        slot.bufferIndex = held.bufferIndex
+        slot.length = held.length
+        slot.flags = .bufferChanged
+        return old
+    }
+
+    // MARK: - Closing
+
+    /// Links every free buffer back onto the port's kernel list.
+    ///
+    /// Further allocations fail and further frees are discarded.
+    ///
+    /// - Parameter port: The port the pool was created from
+    /// - Precondition: port.memoryId == memoryId
+    public func close(returningTo port: borrowing NetmapPort) {
+        precondition(port.memoryId == memoryId, "Port does not share the pool's allocator")
+
+        lock.lock()
+        defer { lock.unlock() }
+        guard !isClosed else { return }
+        isClosed = true
+
+        var head = port.extraBuffersHead
+        for buffer in freeBuffers {
+            cnm_extra_buf_set_next(ringPtr, buffer, head)
+            head = buffer
+        }
+        port.extraBuffersHead = head
+        freeBuffers.removeAll()
+    }
+
+    // MARK: - Caches
+
+    /// Creates a cache for the calling thread.
+    ///
+    /// - Parameter size: Most buffers the cache keeps before spilling
+    /// - Returns: A cache bound to this pool
+    public func makeCache(size: Int = 256) -> Cache {
+        return Cache(pool: self, size: size)
+    }
+
+    /// A single-thread front end to a pool.
+    ///
+    /// Allocation and release touch only a private array; the pool lock is
+    /// taken once per `size / 2` buffers when the cache refills or spills.
+    /// Remaining buffers return to the pool on ``flush()`` or when the cache
+    /// is deinitialized. A cache must not be shared between threads.
+    public final class Cache {
+        /// The pool backing this cache.
+        public let pool: NetmapBufferPool
+
+        /// Most buffers the cache keeps.
+        public let size: Int
+
+        private var buffers: [UInt32]
+        private let batch: Int
+
+        init(pool: NetmapBufferPool, size: Int) {
+            self.pool = pool
+            self.size = max(size, 2)
+            self.batch = max(size, 2) / 2
+            self.buffers = []
+            self.buffers.reserveCapacity(max(size, 2))
+        }
+
+        deinit {
+            flush()
+        }
+
+        /// Number of buffers in the cache.
+        public var count: Int {
+            return buffers.count
+        }
+
+        /// Takes one buffer, refilling from the pool when empty.
+        @inline(__always)
+        public func allocate() -> UInt32? {
+            if buffers.isEmpty {
+                pool.allocate(batch, into: &buffers)
+            }
+            return buffers.popLast()
+        }
+
+        /// Returns one buffer, spilling to the pool when full.
+        @inline(__always)
+        public func free(_ buffer: UInt32) {
+            if buffers.count >= size {
+                pool.free(buffers.suffix(batch))
+                buffers.removeLast(batch)
+            }
+            buffers.append(buffer)
+        }
+
+        /// Takes a packet out of its slot; see ``NetmapBufferPool/hold(_:)``.
+        @inline(__always)
+        public func hold(_ slot: NetmapSlot) -> NetmapHeldBuffer? {
+            guard let buffer = allocate() else { return nil }
+            return NetmapBufferPool.swap(slot, with: buffer)
+        }
+
+        /// Puts a held packet into a free TX slot; see ``NetmapBufferPool/place(_:into:)``.
+        @inline(__always)
+        public func place(_ held: NetmapHeldBuffer, into slot: NetmapSlot) {
+            free(NetmapBufferPool.place(held, into: slot))
+        }
+
+        /// Drops a held packet.
+        @inline(__always)
+        public func release(_ held: NetmapHeldBuffer) {
+            free(held.bufferIndex)
+        }
+
+        /// Returns every cached buffer to the pool.
+        public func flush() {
+            guard !buffers.isEmpty else { return }
+            pool.free(buffers)
+            buffers.removeAll(keepingCapacity: true)
+        }
+    }
+}
@@ -0,0 +1,548 @@
+/*
+ * Copyright (c) 2026 Kory Heard
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+import CNetmap
+import Foundation
+import Glibc
+
+/// A port whose rings are synced through the CSB by a kernel sync loop.
+///
+/// In CSB mode the application and the kernel exchange ring pointers
+/// through shared Control/Status Block entries instead of `NIOCTXSYNC` and
+/// `NIOCRXSYNC`. A kernel sync loop (kloop) on a dedicated thread polls
+/// the application's head and publishes hwcur and hwtail, so ``txSync()``
+/// and ``rxSync()`` here are a few ordered loads and stores with no system
+/// call.
+///
+/// The batch API matches ``NetmapPort``: rings come from ``txRing(_:)`` and
+/// ``rxRing(_:)`` and are processed with `withPackets`, and
+/// ``receiveBatches(timeout:limit:handler:)`` and ``sendBurst(count:fill:)``
+/// behave like their port counterparts.
+///
+/// ```swift
+/// let port = try NetmapCSBPort.open(interface: "vale0:fast")
+/// defer { port.close() }
+///
+/// while running {
+///     try port.receiveBatches(timeout: 100) { batch in
+///         for packet in batch { handle(packet) }
+///     }
+/// }
+/// print(port.statistics())
+/// ```
+///
+/// ## Memory Ordering
+///
+/// Each sync follows netmap's application-side protocol: slot writes are
+/// released before head is stored to the CSB, and hwtail is loaded with
+/// acquire semantics before any slot is read.
+///
+/// ## Kicks
+///
+/// With ``Configuration/notifications`` enabled the kloop sleeps on
+/// per-ring eventfds when idle. A sync writes the ring's eventfd only
+/// when the kernel has asked for a kick and there is new work, and a
+/// wait arms the application's need-kick flag only after finding the ring
+/// empty (or full), rechecking it behind a store-load fence. A busy
+/// datapath therefore makes no system calls. Without notifications the
+/// kloop polls every ``Configuration/sleepMicroseconds`` and waits spin.
+///
+/// ## Threading
+///
+/// The datapath methods must be called from one thread at a time.
+/// ``statistics()`` reads counters that thread updates and is only exact
+/// from that thread.
+public final class NetmapCSBPort: @unchecked Sendable {
+
+    /// Sync loop settings.
+    public struct Configuration: Sendable {
+        /// Microseconds the kloop sleeps between passes (0 to busy-poll).
+        public var sleepMicroseconds: UInt32
+
+        /// Use eventfd kicks so idle sides can sleep.
+        public var notifications: Bool
+
+        /// Kloop direct-sync mode.
+        public var mode: NetmapKloopMode
+
+        public init(
+            sleepMicroseconds: UInt32 = 0,
+            notifications: Bool = false,
+            mode: NetmapKloopMode = []
+        ) {
+            self.sleepMicroseconds = sleepMicroseconds
+            self.notifications = notifications
+            self.mode = mode
+        }
+
+        /// Busy-polling kloop, lowest latency.
+        public static let busyPoll = Configuration()
+
+        /// Eventfd-driven kloop that sleeps when idle.
+        public static let notified = Configuration(notifications: true)
+    }
+
+    /// Datapath counters.
+    public struct Statistics: Sendable, Equatable {
+        /// CSB TX syncs.
+        public var txSyncs: UInt64 = 0
+
+        /// CSB RX syncs.
+        public var rxSyncs: UInt64 = 0
+
+        /// Eventfd writes waking the kloop.
+        public var kicks: UInt64 = 0
+
+        /// Waits that blocked in `poll(2)` on the notification eventfds.
+        public var sleeps: UInt64 = 0
+
+        /// System calls made by the datapath.
+        public var syscalls: UInt64 {
+            return kicks + sleeps
+        }
+    }
+
+    /// The underlying port, registered in CSB mode.
+    public let port: NetmapPort
+
+    /// The CSB shared with the sync loop; TX rings first, then RX rings.
+    public let csb: NetmapCSB
+
+    public let configuration: Configuration
+
+    /// Number of TX rings.
+    public let txRingCount: UInt32
+
+    /// Number of RX rings.
+    public let rxRingCount: UInt32
+
+    /// Per-ring counters updated by the datapath, or `nil` to record
+    /// nothing. Set before the datapath thread starts.
+    public var ringStatistics: NetmapRingStatistics?
+
+    /// Application-to-kernel eventfds, one per CSB entry.
+    private let ioeventfds: [Int32]
+
+    /// Kernel-to-application eventfds, one per CSB entry.
+    private let irqfds: [Int32]
+
+    private var counters = Statistics()
+    private var isClosed = false
+
+    private let stateLock = NSLock()
+    private var stopping = false
+    private var loopError: Error?
+    private let loopFinished = DispatchSemaphore(value: 0)
+
+    // MARK: - Opening
+
+    /// Opens an interface in CSB mode and starts its kernel sync loop.
+    ///
+    /// The port binds every NIC ring (``NetmapRegistrationMode/allNIC``).
+    /// The kernel numbers CSB entries relative to the bound ring range, and
+    /// with every NIC ring bound that is TX ring `i` at entry `i` and RX
+    /// ring `i` at entry `txRingCount + i`, the layout the datapath uses.
+    ///
+    /// - Parameters:
+    ///   - interface: The interface name
+    ///   - flags: Registration flags
+    ///   - extraBuffers: Number of extra buffers to request
+    ///   - configuration: Sync loop settings
+    /// - Returns: A running CSB port
+    /// - Throws: `NetmapError` if the port cannot be registered in CSB mode
+    ///   or the eventfds cannot be created
+    public static func open(
+        interface: String,
+        flags: NetmapRegistrationFlags = [],
+        extraBuffers: UInt32 = 0,
+        configuration: Configuration = .busyPoll
+    ) throws -> NetmapCSBPort {
+        // One CSB entry per NIC ring
+        let info = try NetmapPort.getInfo(interface: interface)
+        let csb = try NetmapCSB(ringCount: max(Int(info.txRings) + Int(info.rxRings), 2))
+
+        let port = try NetmapPort.open(
+            interface: interface,
+            mode: .allNIC,
+            flags: flags,
+            extraBuffers: extraBuffers,
+            options: .csb(csb)
+        )
+        return try NetmapCSBPort(port: port, csb: csb, configuration: configuration)
+    }
+
+    /// Wraps a port registered with `csb` in all-NIC mode and starts its
+    /// sync loop.
+    init(port: consuming NetmapPort, csb: NetmapCSB, configuration: Configuration) throws {
+        let txCount = port.txRingCount
+        let rxCount = port.rxRingCount
+        let entries = Int(txCount + rxCount)
+        guard csb.ringCount >= entries else {
+            throw NetmapError.invalidConfiguration("CSB has \(csb.ringCount) entries for \(entries) rings")
+        }
+
+        var io: [Int32] = []
+        var irq: [Int32] = []
+        if configuration.notifications {
+            for _ in 0..<entries {
+                let ioFd = cnm_eventfd(0, CNM_EFD_NONBLOCK | CNM_EFD_CLOEXEC)
+                let irqFd = ioFd >= 0 ? cnm_eventfd(0, CNM_EFD_NONBLOCK | CNM_EFD_CLOEXEC) : -1
+                guard ioFd >= 0, irqFd >= 0 else {
+                    let error = errno
+                    if ioFd >= 0 { Glibc.close(ioFd) }
+                    (io + irq).forEach { _ = Glibc.close($0) }
+                    throw NetmapError.optionRejected(option: "SYNC_KLOOP_EVENTFDS", errno: error)
+                }
+                io.append(ioFd)
+                irq.append(irqFd)
+            }
+        }
+
+        self.port = port
+        self.csb = csb
+        self.configuration = configuration
+        self.txRingCount = txCount
+        self.rxRingCount = rxCount
+        self.ioeventfds = io
+        self.irqfds = irq
+
+        startSyncLoop()
+    }
+
+    // MARK: - Rings
+
+    /// Returns a view of TX ring `index`.
+    public func txRing(_ index: UInt32) -> NetmapRing {
+        return port.txRing(index)
+    }
+
+    /// Returns a view of RX ring `index`.
+    public func rxRing(_ index: UInt32) -> NetmapRing {
+        return port.rxRing(index)
+    }
+
+    // MARK: - Syncing
+
+    /// Publishes every TX ring's head and picks up completed slots.
+    public func txSync() {
+        for index in 0..<txRingCount {
+            txSync(ring: index)
+        }
+    }
+
+    /// Publishes every RX ring's head and picks up received packets.
+    public func rxSync() {
+        for index in 0..<rxRingCount {
+            rxSync(ring: index)
+        }
+    }
+
+    /// Syncs one TX ring through the CSB.
+    ///
+    /// - Parameter index: TX ring index
+    public func txSync(ring index: UInt32) {
+        let ring = port.txRing(index)
+        let entry = Int(index)
+        let head = ring.head
+        let hwtail = sync(ring.ringPtr, entry: entry, head: head, cur: ring.cur)
+
+        // Out of space: ask to be woken when the kernel frees slots
+        if hwtail == head, !irqfds.isEmpty {
+            armNotification(entry: entry, ring: ring.ringPtr, blockedAt: head)
+        }
+        counters.txSyncs += 1
+        ringStatistics?.recordSync(.tx, ring: index)
+    }
+
+    /// Syncs one RX ring through the CSB.
+    ///
+    /// - Parameter index: RX ring index
+    public func rxSync(ring index: UInt32) {
+        let ring = port.rxRing(index)
+        _ = sync(ring.ringPtr, entry: Int(txRingCount + index), head: ring.head, cur: ring.cur)
+        counters.rxSyncs += 1
+        ringStatistics?.recordSync(.rx, ring: index)
+    }
+
+    /// Publishes head and cur, reads hwtail into the ring, and kicks the
+    /// kernel if it sleeps with work pending.
+    @inline(__always)
+    private func sync(_ ring: UnsafeMutableRawPointer, entry: Int, head: UInt32, cur: UInt32) -> UInt32 {
+        cnm_csb_appl_write(csb.atok + entry, cur, head)
+
+        var hwtail: UInt32 = 0
+        var hwcur: UInt32 = 0
+        cnm_csb_appl_read(csb.ktoa + entry, &hwtail, &hwcur)
+        cnm_csb_ring_set_tail(ring, hwtail)
+
+        if head != hwcur, cnm_csb_ktoa_kern_need_kick(csb.ktoa + entry) != 0 {
+            kick(entry: entry)
+        }
+        return hwtail
+    }
+
+    /// Sets the need-kick flag, then rechecks hwtail behind a full fence so
+    /// a kernel update racing with the flag store is not missed.
+    private func armNotification(entry: Int, ring: UnsafeMutableRawPointer, blockedAt head: UInt32) {
+        cnm_csb_atok_set_appl_need_kick(csb.atok + entry, 1)
+        cnm_csb_full_fence()
+
+        var hwtail: UInt32 = 0
+        var hwcur: UInt32 = 0
+        cnm_csb_appl_read(csb.ktoa + entry, &hwtail, &hwcur)
+        if hwtail != head {
+            cnm_csb_atok_set_appl_need_kick(csb.atok + entry, 0)
+            cnm_csb_ring_set_tail(ring, hwtail)
+        }
+    }
+
+    private func kick(entry: Int) {
+        guard !ioeventfds.isEmpty else { return }
+        var one: UInt64 = 1
+        _ = Glibc.write(ioeventfds[entry], &one, MemoryLayout<UInt64>.size)
+        counters.kicks += 1
+    }
+
+    // MARK: - Waiting
+
+    /// Waits until an RX ring has packets.
+    ///
+    /// - Parameter timeout: Timeout in milliseconds (-1 for infinite, 0 to check once)
+    /// - Returns: true if packets are available
+    public func waitForRx(timeout: Int32 = -1) -> Bool {
+        return wait(timeout: timeout, entries: Int(txRingCount)..<Int(txRingCount + rxRingCount)) {
+            rxSync()
+            return (0..<rxRingCount).contains { !rxRing($0).isEmpty }
+        }
+    }
+
+    /// Waits until a TX ring has free slots.
+    ///
+    /// - Parameter timeout: Timeout in milliseconds (-1 for infinite, 0 to check once)
+    /// - Returns: true if slots are available
+    public func waitForTx(timeout: Int32 = -1) -> Bool {
+        return wait(timeout: timeout, entries: 0..<Int(txRingCount)) {
+            txSync()
+            return (0..<txRingCount).contains { txRing($0).hasSpace }
+        }
+    }
+
+    private func wait(timeout: Int32, entries: Range<Int>, ready: () -> Bool) -> Bool {
+        if ready() { return true }
+        guard timeout != 0 else { return false }
+
+        let deadline = timeout > 0 ? DispatchTime.now() + .milliseconds(Int(timeout)) : DispatchTime.distantFuture
+        while DispatchTime.now() < deadline {
+            if irqfds.isEmpty {
+                if configuration.sleepMicroseconds > 0 {
+                    usleep(configuration.sleepMicroseconds)
+                } else {
+                    sched_yield()
+                }
+                if ready() { return true }
+                continue
+            }
+
+            // Arm notifications, then recheck before sleeping
+            for entry in entries {
+                cnm_csb_atok_set_appl_need_kick(csb.atok + entry, 1)
+            }
+            cnm_csb_full_fence()
+            let isReady = ready()
+            if !isReady {
+                sleepOnNotifications(entries: entries, deadline: deadline)
+            }
+            for entry in entries {
+                cnm_csb_atok_set_appl_need_kick(csb.atok + entry, 0)
+            }
+            if isReady || ready() { return true }
+        }
+        return false
+    }
+
+    private func sleepOnNotifications(entries: Range<Int>, deadline: DispatchTime) {
+        var fds = entries.map { pollfd(fd: irqfds[$0], events: Int16(POLLIN), revents: 0) }
+        let now = DispatchTime.now().uptimeNanoseconds
+        let remaining: Int32
+        if deadline == .distantFuture {
+            remaining = -1
+        } else if deadline.uptimeNanoseconds > now {
+            remaining = Int32(clamping: (deadline.uptimeNanoseconds - now) / 1_000_000)
+        } else {
+            remaining = 0
+        }
+        _ = Glibc.poll(&fds, nfds_t(fds.count), remaining)
+        counters.sleeps += 1
+
+        var value: UInt64 = 0
+        for fd in fds where fd.revents & Int16(POLLIN) != 0 {
+            _ = Glibc.read(fd.fd, &value, MemoryLayout<UInt64>.size)
+        }
+    }
+
+    // MARK: - Batch API
+
+    /// Receives pending packets as borrowed views, one batch per RX ring.
+    ///
+    /// Same contract as ``NetmapPort/receiveBatches(timeout:limit:handler:)``,
+    /// with CSB syncs in place of ioctls.
+    ///
+    /// - Parameters:
+    ///   - timeout: Timeout in milliseconds for waiting for packets
+    ///   - limit: Maximum packets taken from each ring per call
+    ///   - handler: Closure called once per non-empty RX ring, in ring order
+    /// - Returns: Number of packets received
+    /// - Throws: Any error thrown by `handler`
+    @discardableResult
+    public func receiveBatches(
+        timeout: Int32 = 1000,
+        limit: Int = .max,
+        handler: (NetmapPacketBatch) throws -> Void
+    ) rethrows -> Int {
+        guard waitForRx(timeout: timeout) else {
+            if let ringStatistics {
+                for ring in port.boundRings(.rx) {
+                    ringStatistics.recordEmptyPoll(.rx, ring: ring)
+                }
+            }
+            return 0
+        }
+        return try port.drainRxRings(limit: limit, statistics: ringStatistics, handler: handler)
+    }
+
+    /// Sends a burst of packets written in place into the slot buffers.
+    ///
+    /// Same contract as ``NetmapPort/sendBurst(count:fill:)``, with one CSB
+    /// sync in place of the ioctl.
+    ///
+    /// - Parameters:
+    ///   - count: Number of packets to send
+    ///   - fill: Writes packet `index` into `buffer` and returns its length
+    /// - Returns: Burst accounting
+    /// - Throws: Any error thrown by `fill`. Slots filled before `fill`
+    ///   throws are still transmitted.
+    @discardableResult
+    public func sendBurst(
+        count: Int,
+        fill: (_ index: Int, _ buffer: UnsafeMutableRawBufferPointer) throws -> Int
+    ) throws -> NetmapBurstResult {
+        let burst = port.fillBurst(count: count, statistics: ringStatistics, fill: fill)
+        if burst.sent > 0 {
+            txSync()
+        }
+        if let error = burst.error {
+            throw error
+        }
+        return NetmapBurstResult(requested: count, sent: burst.sent, ringsUsed: burst.ringsUsed)
+    }
+
+    // MARK: - Statistics
+
+    /// Returns the datapath counters.
+    public func statistics() -> Statistics {
+        return counters
+    }
+
+    /// Error that ended the sync loop early, if any.
+    public var syncLoopError: Error? {
+        stateLock.lock()
+        defer { stateLock.unlock() }
+        return loopError
+    }
+
+    // MARK: - Sync Loop
+
+    private func startSyncLoop() {
+        let thread = Thread { [self] in
+            do {
+                if let simulated = port.simulated {
+                    simulated.runSyncLoop(
+                        csb: csb,
+                        sleepMicroseconds: configuration.sleepMicroseconds,
+                        eventfds: ioeventfds.isEmpty ? nil : (ioeventfds, irqfds)
+                    ) {
+                        shouldStop
+                    }
+                } else {
+                    try NetmapKloop.startKloop(
+                        port: port,
+                        sleepMicroseconds: configuration.sleepMicroseconds,
+                        options: kloopOptions()
+                    )
+                }
+            } catch {
+                stateLock.lock()
+                loopError = error
+                stateLock.unlock()
+            }
+            loopFinished.signal()
+        }
+        thread.name = "com.netmap.kloop.\(port.interfaceName)"
+        thread.start()
+    }
+
+    private var shouldStop: Bool {
+        stateLock.lock()
+        defer { stateLock.unlock() }
+        return stopping
+    }
+
+    private func kloopOptions() -> NetmapOptions? {
+        var options = NetmapOptions()
+        if !ioeventfds.isEmpty {
+            let entries = zip(ioeventfds, irqfds).map { NetmapKloopEventfds.RingEntry(ioeventfd: $0, irqfd: $1) }
+            options.kloopEventfds = NetmapKloopEventfds(entries: entries)
+        }
+        if !configuration.mode.isEmpty {
+            options.kloopMode = configuration.mode
+        }
+        return options.hasOptions ? options : nil
+    }
+
+    /// Stops the sync loop and closes the eventfds.
+    ///
+    /// The port itself is closed when the last reference is released.
+    public func close() {
+        guard !isClosed else { return }
+        isClosed = true
+
+        stateLock.lock()
+        stopping = true
+        stateLock.unlock()
+
+        // The stop request is lost if it races ahead of the loop's start, so repeat it
+        while loopFinished.wait(timeout: .now() + .milliseconds(10)) == .timedOut {
+            if port.simulated == nil {
+                try? NetmapKloop.stopKloop(port: port)
+            }
+        }
+
+        (ioeventfds + irqfds).forEach { _ = Glibc.close($0) }
+    }
+}
+
+// MARK: - Simulator Support
+
+extension NetmapSimulator {
+
+    /// Opens a simulated interface in CSB mode with a simulated sync loop.
+    ///
+    /// - Parameters:
+    ///   - name: Interface name
+    ///   - configuration: Sync loop settings
+    /// - Returns: A running CSB port
+    /// - Throws: `NetmapError.invalidConfiguration` for unknown names, or
+    ///   `NetmapError.optionRejected` if the eventfds cannot be created
+    public func openCSBPort(
+        _ name: String,
+        configuration: NetmapCSBPort.Configuration = .busyPoll
+    ) throws -> NetmapCSBPort {
+        let port = try openPort(name)
+        let csb = try NetmapCSB(ringCount: Int(port.txRingCount + port.rxRingCount))
+        port.simulated?.initializeCSB(csb)
+        return try NetmapCSBPort(port: port, csb: csb, configuration: configuration)
+    }
+}
@@ -53,6 +53,9 @@ public enum NetmapError: Error, CustomStringConvertible {
     /// Option was rejected by kernel.
     case optionRejected(option: String, errno: Int32)
 
+    /// A capture file could not be opened or written.
+    case fileFailed(path: String, errno: Int32)
+
     public var description: String {
         switch self {
         case .openFailed(let errno):
@@ -85,6 +88,8 @@ public enum NetmapError: Error, CustomStringConvertible {
             return "Memory allocation failed"
         case .optionRejected(let option, let errno):
             return "Option \(option) rejected: \(String(cString: strerror(errno)))"
+        case .fileFailed(let path, let errno):
+            return "Capture file \(path) failed: \(String(cString: strerror(errno)))"
         }
     }
 }
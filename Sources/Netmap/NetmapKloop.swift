@@ -69,12 +69,14 @@ public enum NetmapKloop {
     ///   - port: The netmap port to run the kloop on
     ///   - sleepMicroseconds: Microseconds to sleep between sync iterations
     ///     (0 for busy-poll, higher values reduce CPU usage)
+    ///   - options: Kloop options such as eventfds or direct mode
     /// - Throws: `NetmapError` if the kloop fails to start or encounters an error
     ///
     /// - Important: This method blocks. Call it from a background thread.
     public static func startKloop(
         port: borrowing NetmapPort,
-        sleepMicroseconds: UInt32 = 0
+        sleepMicroseconds: UInt32 = 0,
+        options: NetmapOptions? = nil
     ) throws {
         var kloop = nmreq_sync_kloop_start()
         cnm_init_sync_kloop_start(&kloop, sleepMicroseconds)
@@ -82,6 +84,14 @@ public enum NetmapKloop {
         var hdr = nmreq_header()
         cnm_init_header(&hdr, port.interfaceName, UInt16(CNM_REQ_SYNC_KLOOP_START), &kloop)
 
+        // Build option chain if options provided
+        // Note: optionStorage must stay alive until after the ioctl
+        var optionStorage: NetmapOptions.OptionStorage?
+        if let options = options, options.hasOptions {
+            optionStorage = options.buildOptionChain(header: &hdr)
+        }
+        defer { withExtendedLifetime(optionStorage) {} }
+
         // This ioctl blocks until the kloop is stopped
         guard cnm_ioctl_ctrl(port.fileDescriptor, &hdr) == 0 else {
             let err = errno
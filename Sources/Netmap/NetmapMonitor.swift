@@ -190,4 +190,44 @@ public struct NetmapMonitor: ~Copyable {
             }
         }
     }
+
+    /// Captures packets accepted by a classifier, as borrowed views.
+    ///
+    /// Packets are classified in place in the monitor's RX slots, so packets
+    /// the classifier drops cost no copy and no handler call. Each packet is
+    /// only valid inside the handler. When the handler returns false, the
+    /// rest of the current batch is released uncaptured.
+    ///
+    /// - Parameters:
+    ///   - timeout: Poll timeout in milliseconds
+    ///   - classifier: Compiled rule set selecting packets to capture
+    ///   - handler: Called for each accepted packet, return false to stop
+    /// - Throws: `NetmapError` if capture fails
+    public func capture(
+        timeout: Int32 = 1000,
+        classifier: NetmapClassifier,
+        handler: (NetmapPacket, Direction) throws -> Bool
+    ) throws {
+        while true {
+            guard try port.waitForRx(timeout: timeout) else { continue }
+            try port.rxSync()
+
+            for ringIdx in 0..<port.rxRingCount {
+                let ring = port.rxRing(ringIdx)
+                guard !ring.isEmpty else { continue }
+
+                let keepGoing = try ring.withPackets { batch in
+                    for packet in batch where classifier.accepts(packet.bytes) {
+                        if try !handler(packet, direction) {
+                            return false
+                        }
+                    }
+                    return true
+                }
+                if !keepGoing {
+                    return
+                }
+            }
+        }
+    }
 }
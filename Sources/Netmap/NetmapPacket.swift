@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2026 Kory Heard
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+import CNetmap
+import Foundation
+
+/// A borrowed view of one packet in a ring slot buffer.
+///
+/// A `NetmapPacket` points straight into the netmap shared memory region; no
+/// bytes are copied to create one. It is only valid inside the closure it is
+/// passed to: once that closure returns, the slot is released back to the
+/// kernel and the buffer may be overwritten. Use ``copyData()`` to keep a
+/// packet beyond that point.
+///
+/// ```swift
+/// try port.processPackets { ringIndex, packet in
+///     guard packet.count >= 14 else { return }
+///     let etherType = UInt16(packet[12]) << 8 | UInt16(packet[13])
+///     counters[etherType, default: 0] += 1
+/// }
+/// ```
+public struct NetmapPacket {
+    /// The slot holding the packet.
+    public let slot: NetmapSlot
+
+    /// The packet bytes, starting at the slot's buffer offset.
+    public let bytes: UnsafeRawBufferPointer
+
+    /// Packet length in bytes.
+    @inline(__always)
+    public var count: Int {
+        return bytes.count
+    }
+
+    /// The byte at `offset`.
+    ///
+    /// - Precondition: offset < count
+    @inline(__always)
+    public subscript(offset: Int) -> UInt8 {
+        return bytes[offset]
+    }
+
+    /// Loads a value from the packet without alignment requirements.
+    ///
+    /// - Parameters:
+    ///   - offset: Byte offset into the packet
+    ///   - type: The type to load
+    /// - Returns: The value, in memory byte order
+    /// - Precondition: offset + MemoryLayout<T>.size <= count
+    @inline(__always)
+    public func load<T: BitwiseCopyable>(fromByteOffset offset: Int, as type: T.Type) -> T {
+        return bytes.loadUnaligned(fromByteOffset: offset, as: type)
+    }
+
+    /// Copies the packet into a `Data` that outlives the slot.
+    public func copyData() -> Data {
+        return Data(bytes)
+    }
+
+    /// Creates a view of the packet in `slot`.
+    @inline(__always)
+    init(slotPtr: UnsafeMutablePointer<netmap_slot>, ringPtr: UnsafeMutableRawPointer) {
+        self.slot = NetmapSlot(slot: slotPtr, ringPtr: ringPtr)
+        self.bytes = UnsafeRawBufferPointer(
+            start: cnm_buf_offset(ringPtr, slotPtr),
+            count: Int(slotPtr.pointee.len)
+        )
+    }
+}
+
+/// The pending packets of one ring, as borrowed views.
+///
+/// A batch covers consecutive slots starting at the ring's head. Elements are
+/// built on access from the slot array, so iterating a batch performs no
+/// allocation. Like ``NetmapPacket``, a batch is only valid inside the
+/// closure it is passed to.
+public struct NetmapPacketBatch: RandomAccessCollection {
+    private let ringPtr: UnsafeMutableRawPointer
+    private let firstSlot: UInt32
+    private let numSlots: UInt32
+
+    /// ID of the ring the packets came from.
+    public let ringId: UInt16
+
+    public let startIndex: Int = 0
+    public let endIndex: Int
+
+    init(ring: borrowing NetmapRing, count: Int) {
+        self.ringPtr = ring.ringPtr
+        self.firstSlot = ring.head
+        self.numSlots = ring.numSlots
+        self.ringId = ring.ringId
+        self.endIndex = count
+    }
+
+    /// Ring slot index of the packet at `position`.
+    @inline(__always)
+    public func slotIndex(at position: Int) -> UInt32 {
+        let index = firstSlot + UInt32(position)
+        return index >= numSlots ? index - numSlots : index
+    }
+
+    @inline(__always)
+    public subscript(position: Int) -> NetmapPacket {
+        precondition(position >= startIndex && position < endIndex, "Packet index out of bounds")
+        return NetmapPacket(slotPtr: cnm_ring_slot(ringPtr, slotIndex(at: position))!, ringPtr: ringPtr)
+    }
+}
+
+// MARK: - NetmapRing Batch Access
+
+extension NetmapRing {
+
+    /// Passes the ring's pending slots to `body` as borrowed packet views,
+    /// then releases them.
+    ///
+    /// For an RX ring the batch holds received packets; for a TX ring it holds
+    /// free slots. Every slot in the batch is released (head and cur advance
+    /// past it) when `body` returns or throws, so no view may be used
+    /// afterwards.
+    ///
+    /// - Parameters:
+    ///   - limit: Maximum number of slots in the batch
+    ///   - body: Closure receiving the batch
+    /// - Returns: The value returned by `body`
+    public func withPackets<R>(
+        limit: Int = .max,
+        _ body: (NetmapPacketBatch) throws -> R
+    ) rethrows -> R {
+        let count = min(Int(space), max(limit, 0))
+        let batch = NetmapPacketBatch(ring: self, count: count)
+        defer {
+            if count > 0 {
+                let newHead = batch.slotIndex(at: count - 1)
+                head = next(newHead)
+                cur = head
+            }
+        }
+        return try body(batch)
+    }
+}
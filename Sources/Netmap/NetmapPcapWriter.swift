@@ -0,0 +1,548 @@
+/*
+ * Copyright (c) 2026 Kory Heard
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+import Foundation
+import Glibc
+
+/// Streams captured packets to pcapng files from a background thread.
+///
+/// The capture thread copies each packet once, straight from its slot
+/// buffer into an Enhanced Packet Block in a large block buffer. Full
+/// buffers are handed to a writer thread, which writes every buffer queued
+/// since its last pass with one `writev(2)`. The capture thread never waits
+/// on the disk: if every buffer is queued, packets are dropped and counted
+/// instead.
+///
+/// Packets longer than ``Configuration/snapLength`` are truncated. With
+/// ``Configuration/maxFileSize`` set, output rotates through
+/// ``Configuration/maxFiles`` files (`cap.0.pcapng`, `cap.1.pcapng`, ...),
+/// overwriting the oldest, and each file starts with its own section and
+/// interface headers.
+///
+/// ```swift
+/// let monitor = try NetmapMonitor.openRxMonitor(interface: "ix0", zeroCopy: true)
+/// let writer = try NetmapPcapWriter(configuration: .init(
+///     path: "/var/tmp/ix0.pcapng",
+///     snapLength: 128,
+///     maxFileSize: 1 << 30,
+///     maxFiles: 8
+/// ))
+///
+/// try monitor.capture(to: writer) { !shouldStop }
+/// writer.close()
+/// print(writer.statistics())
+/// ```
+///
+/// ## Threading
+///
+/// The `write` methods, ``flush()``, and ``close()`` must be called from a
+/// single capture thread. ``statistics()`` may be called from any thread.
+public final class NetmapPcapWriter: @unchecked Sendable {
+
+    /// Writer settings.
+    public struct Configuration: Sendable {
+        /// Output file path. With rotation, the file index is inserted
+        /// before the extension.
+        public var path: String
+
+        /// Maximum bytes stored per packet.
+        public var snapLength: Int
+
+        /// Size of each block buffer in bytes.
+        public var bufferSize: Int
+
+        /// Number of block buffers. Together with ``bufferSize`` this bounds
+        /// how long a disk stall can last before packets are dropped.
+        public var bufferCount: Int
+
+        /// Rotate to the next file once a file would exceed this many bytes,
+        /// or `nil` to write a single file.
+        public var maxFileSize: Int?
+
+        /// Number of files in the rotation ring.
+        public var maxFiles: Int
+
+        public init(
+            path: String,
+            snapLength: Int = 65535,
+            bufferSize: Int = 4 << 20,
+            bufferCount: Int = 8,
+            maxFileSize: Int? = nil,
+            maxFiles: Int = 4
+        ) {
+            self.path = path
+            self.snapLength = snapLength
+            self.bufferSize = bufferSize
+            self.bufferCount = bufferCount
+            self.maxFileSize = maxFileSize
+            self.maxFiles = maxFiles
+        }
+    }
+
+    /// Capture counters.
+    public struct Statistics: Sendable, Equatable {
+        /// Packets written to disk.
+        public var packetsWritten: UInt64 = 0
+
+        /// Bytes written to disk, including block headers.
+        public var bytesWritten: UInt64 = 0
+
+        /// Packets dropped because no buffer was free or a write failed.
+        public var packetsDropped: UInt64 = 0
+
+        /// Written packets that were cut to the snap length.
+        public var packetsTruncated: UInt64 = 0
+
+        /// Files opened, including the first.
+        public var filesOpened: UInt64 = 0
+
+        /// Failed writes and file opens.
+        public var writeErrors: UInt64 = 0
+    }
+
+    public let configuration: Configuration
+
+    // Shared between threads, guarded by condition
+    private let condition = NSCondition()
+    private var freeBuffers: [BlockBuffer]
+    private var filledBuffers: [BlockBuffer] = []
+    private var closing = false
+    private var counters = Statistics()
+    private let finished = DispatchSemaphore(value: 0)
+
+    // Capture thread only
+    private var current: BlockBuffer?
+    private var isClosed = false
+
+    // Writer thread only
+    private var fd: Int32
+    private var fileIndex = 0
+    private var fileBytes = 0
+
+    /// Section Header Block plus Interface Description Block.
+    private let fileHeader: [UInt8]
+
+    /// Enhanced Packet Block size without packet data.
+    static let packetBlockOverhead = 32
+
+    /// Creates the first output file and starts the writer thread.
+    ///
+    /// - Parameter configuration: Output and buffering settings
+    /// - Throws: `NetmapError.invalidConfiguration` for inconsistent sizes,
+    ///   or `NetmapError.fileFailed` if the first file cannot be written.
+    public init(configuration: Configuration) throws {
+        guard configuration.snapLength > 0, configuration.snapLength <= 262_144 else {
+            throw NetmapError.invalidConfiguration("snap length must be 1...262144")
+        }
+        guard configuration.bufferSize >= Self.packetBlockOverhead + (configuration.snapLength + 3) & ~3 else {
+            throw NetmapError.invalidConfiguration("buffer size must hold a full snap-length packet")
+        }
+        guard configuration.bufferCount >= 2, configuration.maxFiles >= 1 else {
+            throw NetmapError.invalidConfiguration("need at least two buffers and one file")
+        }
+
+        self.configuration = configuration
+        self.fileHeader = Self.makeFileHeader(snapLength: UInt32(configuration.snapLength))
+        self.freeBuffers = (0..<configuration.bufferCount).map { _ in BlockBuffer(capacity: configuration.bufferSize) }
+        self.fd = -1
+
+        let path = filePath(index: 0)
+        fd = try openFile(path)
+        counters.filesOpened = 1
+        fileBytes = fileHeader.count
+
+        let thread = Thread { [self] in
+            run()
+        }
+        thread.name = "com.netmap.pcap-writer"
+        thread.start()
+    }
+
+    // MARK: - Writing
+
+    /// Appends one packet.
+    ///
+    /// - Parameters:
+    ///   - packet: A borrowed packet view
+    ///   - timestamp: Capture time
+    @inline(__always)
+    public func write(_ packet: NetmapPacket, timestamp: timeval) {
+        write(packet.bytes, timestamp: timestamp)
+    }
+
+    /// Appends every packet of a batch with one timestamp.
+    ///
+    /// - Parameters:
+    ///   - batch: Packets to write
+    ///   - timestamp: Capture time, typically the ring's sync time
+    public func write(_ batch: NetmapPacketBatch, timestamp: timeval) {
+        for packet in batch {
+            write(packet.bytes, timestamp: timestamp)
+        }
+    }
+
+    /// Appends one packet from raw bytes.
+    ///
+    /// - Parameters:
+    ///   - bytes: Packet bytes starting at the Ethernet header
+    ///   - timestamp: Capture time
+    public func write(_ bytes: UnsafeRawBufferPointer, timestamp: timeval) {
+        let captured = min(bytes.count, configuration.snapLength)
+        let padded = (captured + 3) & ~3
+        let blockLength = Self.packetBlockOverhead + padded
+
+        if current == nil || current!.remaining < blockLength {
+            guard nextBuffer() else {
+                condition.lock()
+                counters.packetsDropped += 1
+                condition.unlock()
+                return
+            }
+        }
+        let buffer = current!
+
+        let micros = UInt64(timestamp.tv_sec) &* 1_000_000 &+ UInt64(timestamp.tv_usec)
+        let block = buffer.storage + buffer.used
+        block.storeBytes(of: UInt32(6), toByteOffset: 0, as: UInt32.self)
+        block.storeBytes(of: UInt32(blockLength), toByteOffset: 4, as: UInt32.self)
+        block.storeBytes(of: UInt32(0), toByteOffset: 8, as: UInt32.self)
+        block.storeBytes(of: UInt32(truncatingIfNeeded: micros >> 32), toByteOffset: 12, as: UInt32.self)
+        block.storeBytes(of: UInt32(truncatingIfNeeded: micros), toByteOffset: 16, as: UInt32.self)
+        block.storeBytes(of: UInt32(captured), toByteOffset: 20, as: UInt32.self)
+        block.storeBytes(of: UInt32(bytes.count), toByteOffset: 24, as: UInt32.self)
+        if captured > 0 {
+            memcpy(block + 28, bytes.baseAddress!, captured)
+        }
+        if padded > captured {
+            memset(block + 28 + captured, 0, padded - captured)
+        }
+        block.storeBytes(of: UInt32(blockLength), toByteOffset: 28 + padded, as: UInt32.self)
+
+        buffer.used += blockLength
+        buffer.packets += 1
+        if captured < bytes.count {
+            buffer.truncated += 1
+        }
+    }
+
+    /// Hands the partially filled buffer to the writer thread.
+    ///
+    /// Call when the capture source is idle so packets reach disk promptly.
+    public func flush() {
+        if let buffer = current, buffer.used > 0 {
+            submit(buffer)
+            current = nil
+        }
+    }
+
+    /// Flushes, waits for every queued buffer to be written, and closes the file.
+    public func close() {
+        guard !isClosed else { return }
+        isClosed = true
+        flush()
+
+        condition.lock()
+        closing = true
+        condition.signal()
+        condition.unlock()
+        finished.wait()
+    }
+
+    /// Returns the current counters.
+    ///
+    /// Written counts advance as the writer thread completes each pass.
+    public func statistics() -> Statistics {
+        condition.lock()
+        defer { condition.unlock() }
+        return counters
+    }
+
+    // MARK: - Capture Thread
+
+    /// Submits the current buffer and takes a free one without waiting.
+    private func nextBuffer() -> Bool {
+        condition.lock()
+        defer { condition.unlock() }
+
+        if let buffer = current, buffer.used > 0 {
+            filledBuffers.append(buffer)
+            condition.signal()
+            current = nil
+        }
+        current = freeBuffers.popLast() ?? current
+        return current != nil
+    }
+
+    private func submit(_ buffer: BlockBuffer) {
+        condition.lock()
+        filledBuffers.append(buffer)
+        condition.signal()
+        condition.unlock()
+    }
+
+    // MARK: - Writer Thread
+
+    private func run() {
+        while true {
+            condition.lock()
+            while filledBuffers.isEmpty && !closing {
+                condition.wait()
+            }
+            if filledBuffers.isEmpty {
+                condition.unlock()
+                break
+            }
+            let batch = filledBuffers
+            filledBuffers.removeAll(keepingCapacity: true)
+            condition.unlock()
+
+            let delta = writeBatch(batch)
+
+            condition.lock()
+            counters.packetsWritten += delta.packetsWritten
+            counters.bytesWritten += delta.bytesWritten
+            counters.packetsDropped += delta.packetsDropped
+            counters.packetsTruncated += delta.packetsTruncated
+            counters.filesOpened += delta.filesOpened
+            counters.writeErrors += delta.writeErrors
+            for buffer in batch {
+                buffer.reset()
+                freeBuffers.append(buffer)
+            }
+            condition.unlock()
+        }
+
+        if fd >= 0 {
+            Glibc.close(fd)
+            fd = -1
+        }
+        finished.signal()
+    }
+
+    /// Writes buffers in order, one `writev` per run that fits the current file.
+    private func writeBatch(_ batch: [BlockBuffer]) -> Statistics {
+        var delta = Statistics()
+        var start = 0
+
+        while start < batch.count {
+            if let maxFileSize = configuration.maxFileSize,
+               fileBytes > fileHeader.count,
+               fileBytes + batch[start].used > maxFileSize {
+                rotate(&delta)
+            } else if fd < 0 {
+                rotate(&delta)
+            }
+
+            var end = start + 1
+            var total = batch[start].used
+            while end < batch.count,
+                  configuration.maxFileSize.map({ fileBytes + total + batch[end].used <= $0 }) ?? true {
+                total += batch[end].used
+                end += 1
+            }
+
+            let group = batch[start..<end]
+            if fd >= 0, writeAll(group) {
+                fileBytes += total
+                delta.bytesWritten += UInt64(total)
+                for buffer in group {
+                    delta.packetsWritten += UInt64(buffer.packets)
+                    delta.packetsTruncated += UInt64(buffer.truncated)
+                }
+            } else {
+                delta.writeErrors += 1
+                for buffer in group {
+                    delta.packetsDropped += UInt64(buffer.packets)
+                }
+            }
+            start = end
+        }
+        return delta
+    }
+
+    /// Closes the current file and opens the next one in the ring.
+    private func rotate(_ delta: inout Statistics) {
+        if fd >= 0 {
+            Glibc.close(fd)
+            fd = -1
+        }
+        if configuration.maxFileSize != nil {
+            fileIndex = (fileIndex + 1) % configuration.maxFiles
+        }
+        do {
+            fd = try openFile(filePath(index: fileIndex))
+            fileBytes = fileHeader.count
+            delta.filesOpened += 1
+        } catch {
+            delta.writeErrors += 1
+        }
+    }
+
+    private func writeAll(_ group: ArraySlice<BlockBuffer>) -> Bool {
+        var vectors = group.map { iovec(iov_base: $0.storage, iov_len: $0.used) }
+        var index = 0
+        while index < vectors.count {
+            let written = vectors[index...].withUnsafeMutableBufferPointer { iov in
+                writev(fd, iov.baseAddress, Int32(iov.count))
+            }
+            if written < 0 {
+                if errno == EINTR { continue }
+                return false
+            }
+            // Skip fully written vectors, then trim a partial one
+            var remaining = written
+            while index < vectors.count, remaining >= vectors[index].iov_len {
+                remaining -= vectors[index].iov_len
+                index += 1
+            }
+            if remaining > 0 {
+                vectors[index].iov_base = vectors[index].iov_base! + remaining
+                vectors[index].iov_len -= remaining
+            }
+        }
+        return true
+    }
+
+    // MARK: - Files
+
+    /// Path of rotation file `index`, or the configured path without rotation.
+    func filePath(index: Int) -> String {
+        guard configuration.maxFileSize != nil else { return configuration.path }
+        let url = URL(fileURLWithPath: configuration.path)
+        let ext = url.pathExtension
+        let base = url.deletingPathExtension().path
+        return ext.isEmpty ? "\(base).\(index)" : "\(base).\(index).\(ext)"
+    }
+
+    /// Creates or truncates a file and writes the pcapng headers.
+    private func openFile(_ path: String) throws -> Int32 {
+        let fd = Glibc.open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0o644)
+        guard fd >= 0 else {
+            throw NetmapError.fileFailed(path: path, errno: errno)
+        }
+        let written = fileHeader.withUnsafeBytes { Glibc.write(fd, $0.baseAddress, $0.count) }
+        guard written == fileHeader.count else {
+            let error = errno
+            Glibc.close(fd)
+            throw NetmapError.fileFailed(path: path, errno: error)
+        }
+        return fd
+    }
+
+    /// Section Header Block and an Ethernet Interface Description Block, in host byte order.
+    static func makeFileHeader(snapLength: UInt32) -> [UInt8] {
+        var header: [UInt8] = []
+
+        func append<T: FixedWidthInteger>(_ value: T) {
+            withUnsafeBytes(of: value) { header.append(contentsOf: $0) }
+        }
+
+        // Section Header Block
+        append(UInt32(0x0A0D_0D0A))
+        append(UInt32(28))
+        append(UInt32(0x1A2B_3C4D))
+        append(UInt16(1))
+        append(UInt16(0))
+        append(Int64(-1))
+        append(UInt32(28))
+
+        // Interface Description Block: LINKTYPE_ETHERNET, microsecond timestamps
+        append(UInt32(1))
+        append(UInt32(20))
+        append(UInt16(1))
+        append(UInt16(0))
+        append(snapLength)
+        append(UInt32(20))
+
+        return header
+    }
+}
+
+// MARK: - Block Buffer
+
+extension NetmapPcapWriter {
+
+    /// One block buffer and the packets it holds.
+    final class BlockBuffer: @unchecked Sendable {
+        let storage: UnsafeMutableRawPointer
+        let capacity: Int
+        var used = 0
+        var packets = 0
+        var truncated = 0
+
+        init(capacity: Int) {
+            self.storage = UnsafeMutableRawPointer.allocate(byteCount: capacity, alignment: 16)
+            self.capacity = capacity
+        }
+
+        deinit {
+            storage.deallocate()
+        }
+
+        var remaining: Int {
+            return capacity - used
+        }
+
+        func reset() {
+            used = 0
+            packets = 0
+            truncated = 0
+        }
+    }
+}
+
+// MARK: - NetmapMonitor Integration
+
+extension NetmapMonitor {
+
+    /// Streams captured packets into a pcapng writer.
+    ///
+    /// Packets are written straight from the monitor's slot buffers with
+    /// the ring's sync time as timestamp. The writer is flushed whenever a
+    /// poll times out, so idle periods do not hold packets in memory.
+    ///
+    /// - Parameters:
+    ///   - writer: Destination writer
+    ///   - timeout: Poll timeout in milliseconds
+    ///   - classifier: Optional rule set selecting packets to write
+    ///   - shouldContinue: Checked before each poll; return false to stop
+    /// - Returns: Number of packets handed to the writer
+    /// - Throws: `NetmapError` if polling or syncing fails
+    @discardableResult
+    public func capture(
+        to writer: NetmapPcapWriter,
+        timeout: Int32 = 100,
+        classifier: NetmapClassifier? = nil,
+        while shouldContinue: () -> Bool = { true }
+    ) throws -> Int {
+        var count = 0
+        while shouldContinue() {
+            guard try port.waitForRx(timeout: timeout) else {
+                writer.flush()
+                continue
+            }
+            try port.rxSync()
+
+            for ringIdx in 0..<port.rxRingCount {
+                let ring = port.rxRing(ringIdx)
+                guard !ring.isEmpty else { continue }
+
+                let timestamp = timeval(
+                    tv_sec: time_t(ring.timestampSeconds),
+                    tv_usec: suseconds_t(ring.timestampMicroseconds)
+                )
+                ring.withPackets { batch in
+                    for packet in batch where classifier?.accepts(packet.bytes) ?? true {
+                        writer.write(packet.bytes, timestamp: timestamp)
+                        count += 1
+                    }
+                }
+            }
+        }
+        writer.flush()
+        return count
+    }
+}
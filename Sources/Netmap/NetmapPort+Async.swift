@@ -28,6 +28,19 @@ import Glibc
 /// }
 /// ```
 ///
+/// ## Zero-Copy Receive
+///
+/// `receivePackets()` copies every packet into a `Data`. At high packet rates,
+/// use the borrowed-view APIs instead:
+///
+/// ```swift
+/// try port.receiveBatches { batch in
+///     for packet in batch {
+///         process(packet.bytes)   // Points into the slot buffer
+///     }
+/// }
+/// ```
+///
 /// ## KQueue Integration
 ///
 /// For event-driven I/O with kqueue:
@@ -160,6 +173,8 @@ extension NetmapPort {
     /// Sends multiple packets asynchronously.
     ///
     /// Packets are sent in order, filling TX rings as space becomes available.
+    /// Each pass fills every ring with space and syncs once, so a burst costs
+    /// one `NIOCTXSYNC` per pass rather than one per packet.
     /// Returns the number of packets actually sent.
     ///
     /// - Parameters:
@@ -170,17 +185,157 @@ extension NetmapPort {
     public func sendPackets(_ packets: [Data], timeout: Int32 = 1000) throws -> Int {
         var sent = 0
 
-        for packet in packets {
-            if try sendPacket(packet, timeout: timeout) {
-                sent += 1
-            } else {
-                break  // Timeout, stop trying
+        while sent < packets.count {
+            let offset = sent
+            let result = try sendBurst(count: packets.count - sent) { index, buffer in
+                let packet = packets[offset + index]
+                precondition(packet.count <= buffer.count, "Data exceeds buffer size")
+                _ = packet.copyBytes(to: buffer)
+                return packet.count
+            }
+            sent += result.sent
+
+            if !result.isComplete {
+                guard try waitForTx(timeout: timeout) else {
+                    break  // Timeout, stop trying
+                }
             }
         }
 
         return sent
     }
 
+    // MARK: - Burst Transmit
+
+    /// Sends a burst of packets from caller-owned buffers with a single sync.
+    ///
+    /// Fills free slots across all TX rings in ring order, copying each
+    /// buffer straight into its slot, then issues one `txSync()`. Packets
+    /// that do not fit are left unsent; the result reports how many went out.
+    /// Never waits for space.
+    ///
+    /// - Parameter packets: Packet buffers, each at most the ring buffer size
+    /// - Returns: Burst accounting
+    /// - Throws: `NetmapError` if the sync fails
+    @discardableResult
+    public func sendBurst<C: Collection>(
+        _ packets: C
+    ) throws -> NetmapBurstResult where C.Element == UnsafeRawBufferPointer {
+        var iterator = packets.makeIterator()
+        return try sendBurst(count: packets.count) { _, buffer in
+            let packet = iterator.next()!
+            precondition(packet.count <= buffer.count, "Packet exceeds buffer size")
+            buffer.copyMemory(from: packet)
+            return packet.count
+        }
+    }
+
+    /// Sends a burst of packets written in place into the slot buffers.
+    ///
+    /// `fill` is called once per free slot, up to `count` times, with the
+    /// packet's index in the burst and the slot's buffer; it returns the
+    /// number of bytes it wrote. Slots are filled across all TX rings in ring
+    /// order and the burst is pushed with one `txSync()`, so no `Data` and
+    /// no intermediate copy is involved.
+    ///
+    /// ```swift
+    /// let result = try port.sendBurst(count: 512) { index, buffer in
+    ///     buildFrame(sequence: index, into: buffer)
+    /// }
+    /// if !result.isComplete {
+    ///     // result.unsent packets did not fit; retry after waitForTx()
+    /// }
+    /// ```
+    ///
+    /// - Parameters:
+    ///   - count: Number of packets to send
+    ///   - fill: Writes packet `index` into `buffer` and returns its length
+    /// - Returns: Burst accounting
+    /// - Throws: `NetmapError` if the sync fails, or any error thrown by `fill`.
+    ///   Slots filled before `fill` throws are still transmitted.
+    @discardableResult
+    public func sendBurst(
+        count: Int,
+        fill: (_ index: Int, _ buffer: UnsafeMutableRawBufferPointer) throws -> Int
+    ) throws -> NetmapBurstResult {
+        let burst = fillBurst(count: count, statistics: ringStatistics, fill: fill)
+
+        // One sync for the whole burst, including slots filled before an error
+        if burst.sent > 0 {
+            try txSync()
+        }
+        if let error = burst.error {
+            throw error
+        }
+
+        return NetmapBurstResult(requested: count, sent: burst.sent, ringsUsed: burst.ringsUsed)
+    }
+
+    /// Fills free TX slots for a burst and publishes head, without syncing.
+    ///
+    /// Shared by the ioctl and CSB burst paths. A ring with no space while
+    /// packets are still waiting counts as a ring-full event.
+    func fillBurst(
+        count: Int,
+        statistics: NetmapRingStatistics? = nil,
+        fill: (_ index: Int, _ buffer: UnsafeMutableRawBufferPointer) throws -> Int
+    ) -> (sent: Int, ringsUsed: Int, error: Error?) {
+        var sent = 0
+        var ringsUsed = 0
+        var fillError: Error?
+
+        rings: for ringIdx in 0..<txRingCount where sent < count {
+            let ring = txRing(ringIdx)
+            let available = min(Int(ring.space), count - sent)
+            guard available > 0 else {
+                if boundRings(.tx).contains(ringIdx) {
+                    statistics?.recordRingFull(.tx, ring: ringIdx)
+                }
+                continue
+            }
+
+            ringsUsed += 1
+            let capacity = Int(ring.bufferSize)
+            var index = ring.head
+            var filled = 0
+            var filledBytes = 0
+            defer {
+                // Publish only the slots that were actually filled
+                if filled > 0 {
+                    ring.head = index
+                    ring.cur = index
+                    statistics?.recordBatch(.tx, ring: ringIdx, packets: filled, bytes: filledBytes)
+                }
+            }
+
+            while filled < available {
+                let slot = ring.slot(at: index)
+                let offset = Int(slot.offset)
+                let buffer = UnsafeMutableRawBufferPointer(
+                    start: UnsafeMutableRawPointer(ring.buffer(for: slot)) + offset,
+                    count: capacity - offset
+                )
+
+                let length: Int
+                do {
+                    length = try fill(sent, buffer)
+                } catch {
+                    fillError = error
+                    break rings
+                }
+                precondition(length >= 0 && length <= buffer.count, "Fill length exceeds buffer size")
+
+                slot.prepareForTx(length: UInt16(length))
+                filled += 1
+                filledBytes += length
+                sent += 1
+                index = ring.next(index)
+            }
+        }
+
+        return (sent, ringsUsed, fillError)
+    }
+
     // MARK: - Batch Operations
 
     /// Processes packets in a batch with a handler closure.
@@ -220,6 +375,105 @@ extension NetmapPort {
         return count
     }
 
+    /// Processes packets in place, without copying them.
+    ///
+    /// Unlike the `Data` variant, the handler receives a borrowed
+    /// ``NetmapPacket`` that points into the slot buffer, so no `Data` is
+    /// allocated per packet. The view is only valid during the handler call.
+    ///
+    /// - Parameters:
+    ///   - timeout: Timeout in milliseconds for waiting for packets
+    ///   - handler: Closure called for each packet with ring index and packet view
+    /// - Returns: Number of packets processed
+    /// - Throws: `NetmapError` if the operation fails
+    @discardableResult
+    public func processPackets(
+        timeout: Int32 = 1000,
+        handler: (UInt32, NetmapPacket) throws -> Void
+    ) throws -> Int {
+        return try receiveBatches(timeout: timeout) { batch in
+            let ringIdx = UInt32(batch.ringId)
+            for packet in batch {
+                try handler(ringIdx, packet)
+            }
+        }
+    }
+
+    /// Receives pending packets as borrowed views, one batch per RX ring.
+    ///
+    /// Waits for RX readiness, syncs once, then calls `handler` with the
+    /// pending packets of each non-empty RX ring. The batch's slots are
+    /// released when the handler returns, so the receive path performs no
+    /// per-packet allocation or copy.
+    ///
+    /// - Parameters:
+    ///   - timeout: Timeout in milliseconds for waiting for packets
+    ///   - limit: Maximum packets taken from each ring per call
+    ///   - handler: Closure called once per non-empty RX ring, in ring order
+    /// - Returns: Number of packets received
+    /// - Throws: `NetmapError` if the operation fails, or any error thrown by `handler`
+    @discardableResult
+    public func receiveBatches(
+        timeout: Int32 = 1000,
+        limit: Int = .max,
+        handler: (NetmapPacketBatch) throws -> Void
+    ) throws -> Int {
+        let ready = try waitForRx(timeout: timeout)
+        guard ready else {
+            recordEmptyPolls()
+            return 0
+        }
+
+        try rxSync()
+
+        return try drainRxRings(limit: limit, statistics: ringStatistics, handler: handler)
+    }
+
+    /// Hands each non-empty RX ring's packets to `handler` and records them.
+    ///
+    /// Shared by the ioctl and CSB receive paths. Latency is measured from
+    /// the call, made right after the poll returns, to the end of each batch.
+    func drainRxRings(
+        limit: Int,
+        statistics: NetmapRingStatistics?,
+        handler: (NetmapPacketBatch) throws -> Void
+    ) rethrows -> Int {
+        let polled = statistics != nil ? NetmapRingStatistics.now() : 0
+        let bound = boundRings(.rx)
+
+        var count = 0
+        for ringIdx in 0..<rxRingCount {
+            let ring = rxRing(ringIdx)
+            guard !ring.isEmpty else {
+                if bound.contains(ringIdx) {
+                    statistics?.recordEmptyPoll(.rx, ring: ringIdx)
+                }
+                continue
+            }
+            count += try ring.withPackets(limit: limit) { batch in
+                try handler(batch)
+                if let statistics {
+                    var bytes = 0
+                    for packet in batch {
+                        bytes += packet.count
+                    }
+                    statistics.recordBatch(.rx, ring: ringIdx, packets: batch.count, bytes: bytes)
+                    statistics.recordLatency(.rx, ring: ringIdx, since: polled)
+                }
+                return batch.count
+            }
+        }
+        return count
+    }
+
+    /// Counts an empty poll on every bound RX ring.
+    func recordEmptyPolls() {
+        guard let ringStatistics else { return }
+        for ring in boundRings(.rx) {
+            ringStatistics.recordEmptyPoll(.rx, ring: ring)
+        }
+    }
+
     // MARK: - Event Loop Support
 
     /// Creates a simple packet processing loop.
@@ -247,3 +501,27 @@ extension NetmapPort {
         }
     }
 }
+
+// MARK: - NetmapBurstResult
+
+/// Accounting for one burst transmit.
+public struct NetmapBurstResult: Sendable, Equatable {
+    /// Packets the caller asked to send.
+    public let requested: Int
+
+    /// Packets placed in TX slots and synced.
+    public let sent: Int
+
+    /// TX rings that received at least one packet.
+    public let ringsUsed: Int
+
+    /// Packets that did not fit in the free TX slots.
+    public var unsent: Int {
+        return requested - sent
+    }
+
+    /// True if every requested packet was sent.
+    public var isComplete: Bool {
+        return sent == requested
+    }
+}
@@ -74,6 +74,13 @@ public struct NetmapPort: ~Copyable {
     /// Registration info from the kernel.
     private var regInfo: nmreq_register
 
+    /// Kernel side of a simulated port, or `nil` for a real one.
+    let simulated: NetmapSimulator.Interface?
+
+    /// Per-ring counters updated by syncs, batch receive, and burst send,
+    /// or `nil` to record nothing.
+    public var ringStatistics: NetmapRingStatistics? = nil
+
     /// The interface name.
     public let interfaceName: String
 
@@ -114,6 +121,16 @@ public struct NetmapPort: ~Copyable {
         return cnm_register_get_extra_bufs(&info)
     }
 
+    /// Memory allocator ID assigned at registration.
+    ///
+    /// Ports with the same ID share one buffer pool: NICs and VALE ports
+    /// bound to the same allocator, pipes and their parent, and ports opened
+    /// on the same external memory region. Buffers can only be swapped
+    /// between such ports. 0 if the port is not registered.
+    public var memoryId: UInt16 {
+        return regInfo.nr_mem_id
+    }
+
     /// The raw file descriptor (for use with poll/kqueue).
     public var fileDescriptor: Int32 {
         return fd
@@ -231,6 +248,21 @@ public struct NetmapPort: ~Copyable {
         self.ownsMemory = true
         self.nifpPtr = nil
         self.regInfo = nmreq_register()
+        self.simulated = nil
+    }
+
+    /// Creates a port over a simulator's memory region.
+    ///
+    /// The simulator's interface keeps the region mapped for the port's lifetime.
+    init(simulating interface: NetmapSimulator.Interface) {
+        self.fd = -1
+        self.interfaceName = interface.name
+        self.memBase = interface.region.base
+        self.memSize = interface.region.size
+        self.ownsMemory = false
+        self.regInfo = interface.registration
+        self.nifpPtr = cnm_if(interface.region.base, interface.registration.nr_offset)
+        self.simulated = interface
     }
 
     deinit {
@@ -347,7 +379,7 @@ public struct NetmapPort: ~Copyable {
     public borrowing func txRing(_ index: UInt32) -> NetmapRing {
         precondition(index < txRingCount, "TX ring index out of bounds")
         let ring = cnm_txring(nifpPtr, index)!
-        return NetmapRing(ringPtr: ring, kind: .tx)
+        return NetmapRing(ringPtr: ring, kind: .tx, memoryId: memoryId)
     }
 
     /// Gets an RX ring by index.
@@ -358,7 +390,7 @@ public struct NetmapPort: ~Copyable {
     public borrowing func rxRing(_ index: UInt32) -> NetmapRing {
         precondition(index < rxRingCount, "RX ring index out of bounds")
         let ring = cnm_rxring(nifpPtr, index)!
-        return NetmapRing(ringPtr: ring, kind: .rx)
+        return NetmapRing(ringPtr: ring, kind: .rx, memoryId: memoryId)
     }
 
     /// Iterates over all TX rings.
@@ -387,7 +419,7 @@ public struct NetmapPort: ~Copyable {
         precondition(index < hostTxRingCount, "Host TX ring index out of bounds")
         // Host rings follow NIC rings in the interface
         let ring = cnm_txring(nifpPtr, txRingCount + index)!
-        return NetmapRing(ringPtr: ring, kind: .tx)
+        return NetmapRing(ringPtr: ring, kind: .tx, memoryId: memoryId)
     }
 
     /// Gets a host RX ring by index.
@@ -401,7 +433,7 @@ public struct NetmapPort: ~Copyable {
         precondition(index < hostRxRingCount, "Host RX ring index out of bounds")
         // Host rings follow NIC rings in the interface
         let ring = cnm_rxring(nifpPtr, rxRingCount + index)!
-        return NetmapRing(ringPtr: ring, kind: .rx)
+        return NetmapRing(ringPtr: ring, kind: .rx, memoryId: memoryId)
     }
 
     /// Iterates over all host TX rings.
@@ -429,18 +461,46 @@ public struct NetmapPort: ~Copyable {
     ///
     /// Call this after filling TX slots to push packets to the NIC.
     public func txSync() throws {
-        guard cnm_ioctl_txsync(fd) == 0 else {
+        if let simulated {
+            simulated.txSync()
+        } else if cnm_ioctl_txsync(fd) != 0 {
             throw NetmapError.syncFailed(errno: errno)
         }
+        recordSyncs(.tx)
     }
 
     /// Synchronizes all RX rings with the hardware.
     ///
     /// Call this to fetch newly received packets from the NIC.
     public func rxSync() throws {
-        guard cnm_ioctl_rxsync(fd) == 0 else {
+        if let simulated {
+            simulated.rxSync()
+        } else if cnm_ioctl_rxsync(fd) != 0 {
             throw NetmapError.syncFailed(errno: errno)
         }
+        recordSyncs(.rx)
+    }
+
+    /// Counts one sync on every bound ring of a direction.
+    @inline(__always)
+    private func recordSyncs(_ kind: NetmapRingKind) {
+        guard let ringStatistics else { return }
+        for ring in boundRings(kind) {
+            ringStatistics.recordSync(kind, ring: ring)
+        }
+    }
+
+    /// NIC rings of a direction bound by this registration.
+    ///
+    /// A `.oneNIC` registration binds only `nr_ringid`; every other mode
+    /// is treated as binding all NIC rings.
+    func boundRings(_ kind: NetmapRingKind) -> Range<UInt32> {
+        let count = kind == .tx ? txRingCount : rxRingCount
+        if regInfo.nr_mode == CNM_REG_ONE_NIC {
+            let ring = UInt32(regInfo.nr_ringid)
+            return ring < count ? ring..<(ring + 1) : 0..<0
+        }
+        return 0..<count
     }
 
     // MARK: - Polling
@@ -456,6 +516,9 @@ public struct NetmapPort: ~Copyable {
         events: NetmapPollEvents,
         timeout: Int32 = -1
     ) throws -> NetmapPollEvents {
+        if let simulated {
+            return simulated.poll(events: events)
+        }
         let result = cnm_poll(fd, Int16(events.rawValue), timeout)
         if result < 0 {
             throw NetmapError.pollFailed(errno: errno)
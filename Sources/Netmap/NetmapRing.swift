@@ -54,11 +54,17 @@ public struct NetmapRing: ~Copyable {
     /// Opaque pointer to the underlying netmap_ring structure.
     /// We use UnsafeMutableRawPointer because netmap_ring is over-aligned and
     /// cannot be directly used as a Swift type.
-    private let ringPtr: UnsafeMutableRawPointer
+    let ringPtr: UnsafeMutableRawPointer
 
     /// The kind of ring (TX or RX).
     public let kind: NetmapRingKind
 
+    /// Memory allocator ID of the port the ring belongs to (0 if unknown).
+    ///
+    /// Rings with the same non-zero ID index the same buffer pool, so
+    /// buffers can be swapped between them.
+    public let memoryId: UInt16
+
     /// Ring ID within the interface.
     public var ringId: UInt16 {
         return cnm_ring_id(ringPtr)
@@ -130,9 +136,10 @@ public struct NetmapRing: ~Copyable {
     // MARK: - Initialization
 
     /// Creates a ring view from a raw pointer.
-    init(ringPtr: UnsafeMutableRawPointer, kind: NetmapRingKind) {
+    init(ringPtr: UnsafeMutableRawPointer, kind: NetmapRingKind, memoryId: UInt16 = 0) {
         self.ringPtr = ringPtr
         self.kind = kind
+        self.memoryId = memoryId
     }
 
     // MARK: - Slot Access
@@ -0,0 +1,415 @@
+/*
+ * Copyright (c) 2026 Kory Heard
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+import CNetmap
+import Foundation
+
+/// Always-on per-ring counters and poll-to-process latency histograms.
+///
+/// Each ring gets its own block of counters, padded to 128 bytes so rings
+/// driven by different threads never share a cache line (or an adjacent
+/// line pulled in by the prefetcher), followed by a log-linear latency
+/// histogram. Recording is a relaxed load and store per counter with no
+/// lock and no read-modify-write, which is safe because every ring has a
+/// single writer: the thread that drives it.
+///
+/// ``snapshot()`` may be called from any thread. It copies the counters
+/// with relaxed loads, so it never stalls the datapath and is cheap enough
+/// to scrape every second.
+///
+/// ```swift
+/// var port = try NetmapPort.open(interface: "ix0")
+/// let stats = port.enableRingStatistics()
+///
+/// // Scraper thread
+/// var previous = stats.snapshot()
+/// while true {
+///     sleep(1)
+///     let current = stats.snapshot()
+///     for ring in current.delta(since: previous).rings where ring.packets > 0 {
+///         print(ring.kind, ring.index, ring.packets, ring.averageBatchSize,
+///               ring.latency.percentile(99))
+///     }
+///     previous = current
+/// }
+/// ```
+///
+/// ``NetmapPort``, ``NetmapCSBPort`` and ``NetmapWorkerGroup`` record into
+/// an attached instance automatically. Custom loops can call the `record`
+/// methods directly.
+public final class NetmapRingStatistics: @unchecked Sendable {
+
+    /// Number of TX rings tracked.
+    public let txRingCount: Int
+
+    /// Number of RX rings tracked.
+    public let rxRingCount: Int
+
+    /// Per-ring blocks: counters, then histogram buckets.
+    private let storage: UnsafeMutableRawPointer
+
+    // Counter words at the start of each block
+    private static let packetsWord = 0
+    private static let bytesWord = 1
+    private static let emptyPollsWord = 2
+    private static let syncsWord = 3
+    private static let ringFullWord = 4
+    private static let batchesWord = 5
+    private static let latencySumWord = 6
+    private static let latencyMaxWord = 7
+
+    /// Counter area, padded to two cache lines.
+    private static let countersSize = 128
+
+    /// Bytes per ring block, a multiple of 128.
+    static let blockSize = countersSize + NetmapLatencyHistogram.bucketCount * MemoryLayout<UInt64>.stride
+
+    /// Creates zeroed statistics for the given ring counts.
+    ///
+    /// - Parameters:
+    ///   - txRings: Number of TX rings
+    ///   - rxRings: Number of RX rings
+    public init(txRings: Int, rxRings: Int) {
+        self.txRingCount = max(txRings, 0)
+        self.rxRingCount = max(rxRings, 0)
+        let size = max(txRingCount + rxRingCount, 1) * Self.blockSize
+        self.storage = UnsafeMutableRawPointer.allocate(byteCount: size, alignment: 128)
+        memset(storage, 0, size)
+    }
+
+    /// Creates zeroed statistics sized for a port's rings.
+    public convenience init(port: borrowing NetmapPort) {
+        self.init(txRings: Int(port.txRingCount), rxRings: Int(port.rxRingCount))
+    }
+
+    deinit {
+        storage.deallocate()
+    }
+
+    // MARK: - Recording
+
+    /// Monotonic time in nanoseconds, for latency start stamps.
+    @inline(__always)
+    public static func now() -> UInt64 {
+        return cnm_monotonic_ns()
+    }
+
+    /// Records one processed batch.
+    ///
+    /// - Parameters:
+    ///   - kind: Ring direction
+    ///   - ring: Ring index
+    ///   - packets: Packets in the batch
+    ///   - bytes: Bytes in the batch
+    @inline(__always)
+    public func recordBatch(_ kind: NetmapRingKind, ring: UInt32, packets: Int, bytes: Int) {
+        guard let block = block(kind, ring) else { return }
+        add(block, Self.packetsWord, UInt64(packets))
+        add(block, Self.bytesWord, UInt64(bytes))
+        add(block, Self.batchesWord, 1)
+    }
+
+    /// Records a poll or sync that found the ring with nothing to do.
+    @inline(__always)
+    public func recordEmptyPoll(_ kind: NetmapRingKind, ring: UInt32) {
+        guard let block = block(kind, ring) else { return }
+        add(block, Self.emptyPollsWord, 1)
+    }
+
+    /// Records one sync of the ring.
+    @inline(__always)
+    public func recordSync(_ kind: NetmapRingKind, ring: UInt32) {
+        guard let block = block(kind, ring) else { return }
+        add(block, Self.syncsWord, 1)
+    }
+
+    /// Records a TX ring found full, or an RX ring found with no free slot.
+    @inline(__always)
+    public func recordRingFull(_ kind: NetmapRingKind, ring: UInt32) {
+        guard let block = block(kind, ring) else { return }
+        add(block, Self.ringFullWord, 1)
+    }
+
+    /// Records the time from a poll returning to the batch being processed.
+    ///
+    /// - Parameters:
+    ///   - kind: Ring direction
+    ///   - ring: Ring index
+    ///   - nanoseconds: Elapsed time
+    @inline(__always)
+    public func recordLatency(_ kind: NetmapRingKind, ring: UInt32, nanoseconds: UInt64) {
+        guard let block = block(kind, ring) else { return }
+        add(block, Self.latencySumWord, nanoseconds)
+        cnm_counter_max(word(block, Self.latencyMaxWord), nanoseconds)
+        let buckets = (block + Self.countersSize).assumingMemoryBound(to: UInt64.self)
+        cnm_counter_add(buckets + NetmapLatencyHistogram.bucket(for: nanoseconds), 1)
+    }
+
+    /// Records latency measured from `start`, a value of ``now()``.
+    @inline(__always)
+    public func recordLatency(_ kind: NetmapRingKind, ring: UInt32, since start: UInt64) {
+        let end = Self.now()
+        recordLatency(kind, ring: ring, nanoseconds: end > start ? end - start : 0)
+    }
+
+    @inline(__always)
+    private func block(_ kind: NetmapRingKind, _ ring: UInt32) -> UnsafeMutableRawPointer? {
+        let index: Int
+        switch kind {
+        case .tx:
+            guard Int(ring) < txRingCount else { return nil }
+            index = Int(ring)
+        case .rx:
+            guard Int(ring) < rxRingCount else { return nil }
+            index = txRingCount + Int(ring)
+        }
+        return storage + index * Self.blockSize
+    }
+
+    @inline(__always)
+    private func word(_ block: UnsafeMutableRawPointer, _ index: Int) -> UnsafeMutablePointer<UInt64> {
+        return block.assumingMemoryBound(to: UInt64.self) + index
+    }
+
+    @inline(__always)
+    private func add(_ block: UnsafeMutableRawPointer, _ index: Int, _ value: UInt64) {
+        cnm_counter_add(word(block, index), value)
+    }
+
+    // MARK: - Snapshots
+
+    /// Copies every ring's counters and histogram.
+    public func snapshot() -> NetmapRingStatisticsSnapshot {
+        var rings: [NetmapRingStatisticsSnapshot.Ring] = []
+        rings.reserveCapacity(txRingCount + rxRingCount)
+
+        for index in 0..<(txRingCount + rxRingCount) {
+            let block = storage + index * Self.blockSize
+            let load = { (word: Int) in cnm_counter_load(self.word(block, word)) }
+
+            let buckets = (block + Self.countersSize).assumingMemoryBound(to: UInt64.self)
+            var counts = [UInt64](repeating: 0, count: NetmapLatencyHistogram.bucketCount)
+            var total: UInt64 = 0
+            for bucket in 0..<counts.count {
+                counts[bucket] = cnm_counter_load(buckets + bucket)
+                total &+= counts[bucket]
+            }
+
+            let isTx = index < txRingCount
+            rings.append(NetmapRingStatisticsSnapshot.Ring(
+                kind: isTx ? .tx : .rx,
+                index: UInt32(isTx ? index : index - txRingCount),
+                packets: load(Self.packetsWord),
+                bytes: load(Self.bytesWord),
+                emptyPolls: load(Self.emptyPollsWord),
+                syncs: load(Self.syncsWord),
+                ringFullEvents: load(Self.ringFullWord),
+                batches: load(Self.batchesWord),
+                latency: NetmapLatencyHistogram(
+                    counts: counts,
+                    count: total,
+                    sum: load(Self.latencySumWord),
+                    maximum: load(Self.latencyMaxWord)
+                )
+            ))
+        }
+        return NetmapRingStatisticsSnapshot(timestamp: Self.now(), rings: rings)
+    }
+}
+
+// MARK: - Port Integration
+
+extension NetmapPort {
+
+    /// Attaches zeroed statistics sized for this port's rings.
+    ///
+    /// - Returns: The attached statistics, also available as ``ringStatistics``
+    @discardableResult
+    public mutating func enableRingStatistics() -> NetmapRingStatistics {
+        let statistics = NetmapRingStatistics(port: self)
+        ringStatistics = statistics
+        return statistics
+    }
+}
+
+// MARK: - Snapshot
+
+/// A point-in-time copy of ``NetmapRingStatistics``.
+public struct NetmapRingStatisticsSnapshot: Sendable {
+
+    /// Counters of one ring.
+    public struct Ring: Sendable, Equatable {
+        /// Ring direction.
+        public let kind: NetmapRingKind
+
+        /// Ring index within its direction.
+        public let index: UInt32
+
+        /// Packets processed.
+        public var packets: UInt64
+
+        /// Bytes processed.
+        public var bytes: UInt64
+
+        /// Polls or syncs that found nothing to do.
+        public var emptyPolls: UInt64
+
+        /// Syncs of the ring.
+        public var syncs: UInt64
+
+        /// Times the ring was full when packets were waiting to go out.
+        public var ringFullEvents: UInt64
+
+        /// Batches processed.
+        public var batches: UInt64
+
+        /// Poll-to-process latency.
+        public var latency: NetmapLatencyHistogram
+
+        /// Mean packets per batch, the main batching-efficiency signal.
+        public var averageBatchSize: Double {
+            return batches > 0 ? Double(packets) / Double(batches) : 0
+        }
+    }
+
+    /// Monotonic time of the snapshot in nanoseconds.
+    public let timestamp: UInt64
+
+    /// TX rings first, then RX rings.
+    public let rings: [Ring]
+
+    /// Seconds between an earlier snapshot and this one.
+    public func seconds(since earlier: NetmapRingStatisticsSnapshot) -> Double {
+        return timestamp > earlier.timestamp ? Double(timestamp - earlier.timestamp) / 1e9 : 0
+    }
+
+    /// Counts accumulated since an earlier snapshot of the same statistics.
+    ///
+    /// The latency maximum is carried over from this snapshot, since a
+    /// maximum cannot be subtracted.
+    public func delta(since earlier: NetmapRingStatisticsSnapshot) -> NetmapRingStatisticsSnapshot {
+        precondition(rings.count == earlier.rings.count, "Snapshots of different statistics")
+        let deltas = zip(rings, earlier.rings).map { now, then in
+            Ring(
+                kind: now.kind,
+                index: now.index,
+                packets: now.packets &- then.packets,
+                bytes: now.bytes &- then.bytes,
+                emptyPolls: now.emptyPolls &- then.emptyPolls,
+                syncs: now.syncs &- then.syncs,
+                ringFullEvents: now.ringFullEvents &- then.ringFullEvents,
+                batches: now.batches &- then.batches,
+                latency: now.latency.subtracting(then.latency)
+            )
+        }
+        return NetmapRingStatisticsSnapshot(timestamp: timestamp, rings: deltas)
+    }
+}
+
+// MARK: - Latency Histogram
+
+/// A log-linear (HDR-style) histogram of nanosecond latencies.
+///
+/// Values below 32 ns get exact buckets; above that, every power of two is
+/// split into 16 equal buckets, so any recorded value is reported within
+/// 6.25% of its true value. Buckets cover up to 2^36 ns (about 68 s);
+/// larger values land in the last bucket.
+public struct NetmapLatencyHistogram: Sendable, Equatable {
+
+    /// Number of buckets.
+    public static let bucketCount = 528
+
+    /// Count per bucket.
+    public private(set) var counts: [UInt64]
+
+    /// Number of recorded values.
+    public private(set) var count: UInt64
+
+    /// Sum of recorded values in nanoseconds.
+    public private(set) var sum: UInt64
+
+    /// Largest recorded value in nanoseconds.
+    public private(set) var maximum: UInt64
+
+    /// Creates an empty histogram.
+    public init() {
+        self.init(counts: [UInt64](repeating: 0, count: Self.bucketCount), count: 0, sum: 0, maximum: 0)
+    }
+
+    init(counts: [UInt64], count: UInt64, sum: UInt64, maximum: UInt64) {
+        self.counts = counts
+        self.count = count
+        self.sum = sum
+        self.maximum = maximum
+    }
+
+    /// Records one value.
+    public mutating func record(_ nanoseconds: UInt64) {
+        counts[Self.bucket(for: nanoseconds)] += 1
+        count += 1
+        sum &+= nanoseconds
+        maximum = Swift.max(maximum, nanoseconds)
+    }
+
+    /// Mean value in nanoseconds.
+    public var mean: Double {
+        return count > 0 ? Double(sum) / Double(count) : 0
+    }
+
+    /// The value at or below which `percent` of recorded values fall.
+    ///
+    /// - Parameter percent: Percentile in 0...100
+    /// - Returns: Upper bound of the bucket holding that rank, capped at
+    ///   ``maximum``, or 0 if the histogram is empty
+    public func percentile(_ percent: Double) -> UInt64 {
+        guard count > 0 else { return 0 }
+        let rank = Swift.max(UInt64((Swift.min(Swift.max(percent, 0), 100) / 100 * Double(count)).rounded(.up)), 1)
+        var seen: UInt64 = 0
+        for (bucket, bucketCount) in counts.enumerated() where bucketCount > 0 {
+            seen += bucketCount
+            if seen >= rank {
+                return Swift.min(Self.upperBound(of: bucket), maximum)
+            }
+        }
+        return maximum
+    }
+
+    /// Bucket counts accumulated since `earlier`; see
+    /// ``NetmapRingStatisticsSnapshot/delta(since:)``.
+    public func subtracting(_ earlier: NetmapLatencyHistogram) -> NetmapLatencyHistogram {
+        return NetmapLatencyHistogram(
+            counts: zip(counts, earlier.counts).map { $0 &- $1 },
+            count: count &- earlier.count,
+            sum: sum &- earlier.sum,
+            maximum: maximum
+        )
+    }
+
+    // MARK: Bucketing
+
+    /// Bucket index for a value.
+    @inline(__always)
+    static func bucket(for value: UInt64) -> Int {
+        guard value >= 32 else { return Int(value) }
+        let msb = 63 - value.leadingZeroBitCount
+        // Keep the top five bits: value >> shift is in 16...31
+        let shift = msb - 4
+        return Swift.min(shift * 16 + Int(value >> UInt64(shift)), bucketCount - 1)
+    }
+
+    /// Smallest value in a bucket.
+    static func lowerBound(of bucket: Int) -> UInt64 {
+        guard bucket >= 32 else { return UInt64(bucket) }
+        let shift = bucket / 16 - 1
+        return UInt64(bucket - shift * 16) << UInt64(shift)
+    }
+
+    /// Largest value in a bucket.
+    static func upperBound(of bucket: Int) -> UInt64 {
+        guard bucket < bucketCount - 1 else { return UInt64.max }
+        return lowerBound(of: bucket + 1) - 1
+    }
+}
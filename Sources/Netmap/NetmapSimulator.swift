@@ -0,0 +1,684 @@
+/*
+ * Copyright (c) 2026 Kory Heard
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+import CNetmap
+import Foundation
+import Glibc
+
+/// An in-memory netmap backend for tests and benchmarks.
+///
+/// A simulator lays out `netmap_if`, `netmap_ring`, and buffer memory in an
+/// anonymous mapping exactly as the kernel does, and plays the kernel's part
+/// on sync and poll: it consumes TX slots and produces RX slots. Ports opened
+/// with ``openPort(_:)`` are ordinary ``NetmapPort`` values, so rings,
+/// slots, packet batches, bursts, and ``NetmapZeroCopy`` forwarding run
+/// unchanged and without `/dev/netmap`.
+///
+/// Every interface of one simulator shares a single buffer pool and memory
+/// ID, like ports on one VALE switch, so forwarding between them takes the
+/// zero-copy path. Interfaces of different simulators do not share memory.
+///
+/// ```swift
+/// let sim = try NetmapSimulator(interfaces: [
+///     .init(name: "sim0", traffic: .repeating(Data(count: 60)), transmit: .deliver(to: "sim1")),
+///     .init(name: "sim1"),
+/// ])
+/// let port0 = try sim.openPort("sim0")
+/// let port1 = try sim.openPort("sim1")
+///
+/// try port0.rxSync()                       // The fake kernel fills RX rings
+/// NetmapZeroCopy.forwardAll(from: port0, to: port0)
+/// try port0.txSync()                       // ...and delivers TX to sim1
+/// ```
+///
+/// ## Kernel Emulation
+///
+/// - **txsync**: slots between the kernel's position and `head` are counted
+///   as transmitted, copied to the peer's RX ring when the interface
+///   delivers, and returned to the application at once.
+/// - **rxsync**: slots released by the application are refilled from
+///   injected packets first, then from the configured traffic source,
+///   leaving one slot empty as the kernel does.
+/// - **poll**: runs both syncs and never blocks.
+///
+/// Sync operations of all interfaces are serialized by one lock, so ports
+/// of one simulator may be driven from different threads.
+public final class NetmapSimulator: @unchecked Sendable {
+
+    /// Source of packets for an interface's RX rings.
+    public enum Traffic: Sendable {
+        /// Only injected packets are received.
+        case none
+
+        /// Every free RX slot receives a copy of this packet.
+        case repeating(Data)
+
+        /// Called for every free RX slot with the ring index and the slot
+        /// buffer; returns the packet length, or 0 to leave the slot empty.
+        case generator(@Sendable (_ ring: UInt32, _ buffer: UnsafeMutableRawBufferPointer) -> Int)
+    }
+
+    /// What happens to transmitted packets.
+    public enum Transmit: Sendable {
+        /// Transmitted packets are counted and dropped.
+        case discard
+
+        /// Transmitted packets are copied to the named interface's RX ring
+        /// with the same index (modulo its RX ring count).
+        case deliver(to: String)
+    }
+
+    /// Layout and behaviour of one simulated interface.
+    public struct InterfaceConfiguration: Sendable {
+        /// Interface name passed to ``NetmapSimulator/openPort(_:)``.
+        public var name: String
+
+        /// Number of TX rings.
+        public var txRings: Int
+
+        /// Number of RX rings.
+        public var rxRings: Int
+
+        /// Slots per ring.
+        public var slotsPerRing: Int
+
+        /// RX packet source.
+        public var traffic: Traffic
+
+        /// TX packet destination.
+        public var transmit: Transmit
+
+        /// Buffers linked into the port's extra buffer list.
+        public var extraBuffers: Int
+
+        public init(
+            name: String,
+            txRings: Int = 1,
+            rxRings: Int = 1,
+            slotsPerRing: Int = 1024,
+            traffic: Traffic = .none,
+            transmit: Transmit = .discard,
+            extraBuffers: Int = 0
+        ) {
+            self.name = name
+            self.txRings = txRings
+            self.rxRings = rxRings
+            self.slotsPerRing = slotsPerRing
+            self.traffic = traffic
+            self.transmit = transmit
+            self.extraBuffers = extraBuffers
+        }
+    }
+
+    /// Kernel-side packet counters for one interface.
+    public struct Statistics: Sendable, Equatable {
+        /// Packets consumed from TX rings.
+        public var transmittedPackets: UInt64 = 0
+
+        /// Bytes consumed from TX rings.
+        public var transmittedBytes: UInt64 = 0
+
+        /// Packets placed in RX rings.
+        public var receivedPackets: UInt64 = 0
+
+        /// Bytes placed in RX rings.
+        public var receivedBytes: UInt64 = 0
+
+        /// Delivered packets dropped because the peer's RX ring was full.
+        public var droppedPackets: UInt64 = 0
+    }
+
+    /// Memory ID shared by every port of this simulator.
+    public let memoryId: UInt16
+
+    /// Size of every buffer in bytes.
+    public let bufferSize: Int
+
+    private let region: Region
+    private let interfaces: [String: Interface]
+
+    /// Memory IDs for simulators start well above kernel allocator IDs.
+    private static let nextMemoryId = MemoryIdAllocator()
+
+    /// Page alignment for rings and the buffer pool.
+    private static let alignment = 4096
+
+    /// Creates a simulator with the given interfaces.
+    ///
+    /// - Parameters:
+    ///   - interfaces: Interfaces to lay out, with unique names
+    ///   - bufferSize: Size of every buffer in bytes
+    /// - Throws: `NetmapError.invalidConfiguration` for bad sizes, duplicate
+    ///   names, or unknown delivery targets, or `NetmapError.mmapFailed` if
+    ///   the region cannot be mapped.
+    public init(interfaces configurations: [InterfaceConfiguration], bufferSize: Int = 2048) throws {
+        guard !configurations.isEmpty else {
+            throw NetmapError.invalidConfiguration("simulator needs at least one interface")
+        }
+        guard bufferSize >= 64, bufferSize <= Int(UInt16.max), bufferSize % 64 == 0 else {
+            throw NetmapError.invalidConfiguration("buffer size must be a multiple of 64 up to 65535")
+        }
+        var names = Set<String>()
+        for config in configurations {
+            guard config.txRings >= 1, config.rxRings >= 1, config.slotsPerRing >= 2, config.extraBuffers >= 0 else {
+                throw NetmapError.invalidConfiguration("\(config.name): needs at least one ring of each kind and two slots per ring")
+            }
+            guard config.name.utf8.count < Int(CNM_REQ_IFNAMSIZ), names.insert(config.name).inserted else {
+                throw NetmapError.invalidInterfaceName(config.name)
+            }
+        }
+        for config in configurations {
+            if case .deliver(let target) = config.transmit, !names.contains(target) {
+                throw NetmapError.invalidConfiguration("\(config.name): unknown delivery target \(target)")
+            }
+        }
+
+        // Lay out interfaces, then rings, then the buffer pool
+        var offset = 0
+        var ifOffsets: [Int] = []
+        for config in configurations {
+            ifOffsets.append(offset)
+            offset += Self.align(cnm_sim_if_size(UInt32(config.txRings + config.rxRings)), to: 64)
+        }
+        var ringOffsets: [[Int]] = []
+        for config in configurations {
+            offset = Self.align(offset, to: Self.alignment)
+            var offsets: [Int] = []
+            for _ in 0..<(config.txRings + config.rxRings) {
+                offsets.append(offset)
+                offset += Self.align(cnm_sim_ring_size(UInt32(config.slotsPerRing)), to: Self.alignment)
+            }
+            ringOffsets.append(offsets)
+        }
+        let poolOffset = Self.align(offset, to: Self.alignment)
+        // Buffers 0 and 1 are reserved, as in the kernel allocator
+        let totalBuffers = configurations.reduce(0) {
+            $0 + ($1.txRings + $1.rxRings) * $1.slotsPerRing + $1.extraBuffers
+        }
+        let size = poolOffset + (totalBuffers + 2) * bufferSize
+
+        let region = try Region(size: size)
+        let memoryId = Self.nextMemoryId.next()
+        let lock = NSLock()
+
+        var firstBuffer: UInt32 = 2
+        var interfaces: [String: Interface] = [:]
+        for (index, config) in configurations.enumerated() {
+            let nifp = region.base + ifOffsets[index]
+            cnm_sim_init_if(nifp, config.name, UInt32(config.txRings), UInt32(config.rxRings))
+
+            var tx: [UnsafeMutableRawPointer] = []
+            var rx: [UnsafeMutableRawPointer] = []
+            for (ringIndex, ringOffset) in ringOffsets[index].enumerated() {
+                let ring = region.base + ringOffset
+                let isTx = ringIndex < config.txRings
+                cnm_sim_set_ring_ofs(nifp, UInt32(ringIndex), ringOffset - ifOffsets[index])
+                cnm_sim_init_ring(
+                    ring,
+                    Int64(poolOffset - ringOffset),
+                    UInt32(config.slotsPerRing),
+                    UInt32(bufferSize),
+                    UInt16(isTx ? ringIndex : ringIndex - config.txRings),
+                    isTx ? NetmapRingKind.tx.rawValue : NetmapRingKind.rx.rawValue,
+                    firstBuffer
+                )
+                firstBuffer += UInt32(config.slotsPerRing)
+                if isTx { tx.append(ring) } else { rx.append(ring) }
+            }
+
+            // Link extra buffers in index order, as the kernel hands them out
+            if config.extraBuffers > 0 {
+                let first = firstBuffer
+                for buffer in first..<first + UInt32(config.extraBuffers) {
+                    let next = buffer + 1 < first + UInt32(config.extraBuffers) ? buffer + 1 : 0
+                    cnm_extra_buf_set_next(tx[0], buffer, next)
+                }
+                cnm_if_set_bufs_head(nifp, first)
+                firstBuffer += UInt32(config.extraBuffers)
+            }
+
+            var registration = nmreq_register()
+            cnm_sim_init_register(
+                &registration,
+                UInt64(ifOffsets[index]),
+                UInt64(size),
+                memoryId,
+                UInt32(config.txRings),
+                UInt32(config.rxRings),
+                UInt32(config.slotsPerRing)
+            )
+            cnm_register_set_extra_bufs(&registration, UInt32(config.extraBuffers))
+
+            interfaces[config.name] = Interface(
+                configuration: config,
+                region: region,
+                registration: registration,
+                txRings: tx,
+                rxRings: rx,
+                lock: lock
+            )
+        }
+
+        for config in configurations {
+            if case .deliver(let target) = config.transmit {
+                interfaces[config.name]!.peer = interfaces[target]
+            }
+        }
+
+        self.region = region
+        self.interfaces = interfaces
+        self.memoryId = memoryId
+        self.bufferSize = bufferSize
+    }
+
+    /// Creates a simulator with a single interface.
+    ///
+    /// - Parameters:
+    ///   - interface: The interface to lay out
+    ///   - bufferSize: Size of every buffer in bytes
+    /// - Throws: See ``init(interfaces:bufferSize:)``
+    public convenience init(_ interface: InterfaceConfiguration, bufferSize: Int = 2048) throws {
+        try self.init(interfaces: [interface], bufferSize: bufferSize)
+    }
+
+    // MARK: - Ports
+
+    /// Opens a port on a simulated interface.
+    ///
+    /// The port exposes every ring of the interface, as with `.allNIC`. Its
+    /// file descriptor is -1; kqueue integration is not simulated.
+    ///
+    /// - Parameter name: Interface name
+    /// - Returns: A port whose syncs and polls are served by the simulator
+    /// - Throws: `NetmapError.invalidInterfaceName` if no such interface exists
+    public func openPort(_ name: String) throws -> NetmapPort {
+        guard let interface = interfaces[name] else {
+            throw NetmapError.invalidInterfaceName(name)
+        }
+        return NetmapPort(simulating: interface)
+    }
+
+    /// Queues a packet for an RX ring; it is received on the next rxsync.
+    ///
+    /// Injected packets are received before generated traffic.
+    ///
+    /// - Parameters:
+    ///   - packet: Packet bytes, at most ``bufferSize`` long
+    ///   - name: Interface name
+    ///   - ring: RX ring index
+    public func inject(_ packet: Data, into name: String, ring: UInt32 = 0) {
+        guard let interface = interfaces[name] else { return }
+        precondition(packet.count <= bufferSize, "Packet exceeds buffer size")
+        interface.inject(packet, ring: Int(ring))
+    }
+
+    /// Returns the kernel-side counters for an interface.
+    public func statistics(for name: String) -> Statistics {
+        return interfaces[name]?.statistics ?? Statistics()
+    }
+
+    private static func align(_ value: Int, to alignment: Int) -> Int {
+        return (value + alignment - 1) & ~(alignment - 1)
+    }
+}
+
+// MARK: - Kernel Side
+
+extension NetmapSimulator {
+
+    /// The kernel side of one simulated interface.
+    final class Interface: @unchecked Sendable {
+        let name: String
+        let region: Region
+        let registration: nmreq_register
+        weak var peer: Interface?
+
+        private let txRings: [UnsafeMutableRawPointer]
+        private let rxRings: [UnsafeMutableRawPointer]
+        private let traffic: Traffic
+        private let lock: NSLock
+
+        /// Next TX slot the kernel has not yet consumed, per ring.
+        private var txPosition: [UInt32]
+        private var injected: [[Data]]
+        private var counters = Statistics()
+
+        /// CSB exchanged with a running sync loop, or `nil` when rings are
+        /// synced through the ring structures.
+        private var csb: NetmapCSB?
+
+        /// Kernel-to-application eventfds of a notified sync loop, used to
+        /// interrupt the application when a peer delivers packets.
+        private var irqfds: [Int32] = []
+
+        init(
+            configuration: InterfaceConfiguration,
+            region: Region,
+            registration: nmreq_register,
+            txRings: [UnsafeMutableRawPointer],
+            rxRings: [UnsafeMutableRawPointer],
+            lock: NSLock
+        ) {
+            self.name = configuration.name
+            self.region = region
+            self.registration = registration
+            self.txRings = txRings
+            self.rxRings = rxRings
+            self.traffic = configuration.traffic
+            self.lock = lock
+            self.txPosition = Array(repeating: 0, count: txRings.count)
+            self.injected = Array(repeating: [], count: rxRings.count)
+        }
+
+        var statistics: Statistics {
+            lock.lock()
+            defer { lock.unlock() }
+            return counters
+        }
+
+        func inject(_ packet: Data, ring: Int) {
+            lock.lock()
+            injected[ring % injected.count].append(packet)
+            lock.unlock()
+        }
+
+        func txSync() {
+            lock.lock()
+            defer { lock.unlock() }
+            transmitLocked()
+        }
+
+        func rxSync() {
+            lock.lock()
+            defer { lock.unlock() }
+            receiveLocked()
+        }
+
+        /// Runs both syncs and reports readiness; never blocks.
+        func poll(events: NetmapPollEvents) -> NetmapPollEvents {
+            lock.lock()
+            defer { lock.unlock() }
+            transmitLocked()
+            receiveLocked()
+
+            var ready: NetmapPollEvents = []
+            if events.contains(.readable), rxRings.contains(where: { cnm_ring_empty($0) == 0 }) {
+                ready.insert(.readable)
+            }
+            if events.contains(.writable), txRings.contains(where: { cnm_ring_empty($0) == 0 }) {
+                ready.insert(.writable)
+            }
+            return ready
+        }
+
+        /// Seeds CSB entries from the rings, as registration in CSB mode does.
+        func initializeCSB(_ csb: NetmapCSB) {
+            lock.lock()
+            defer { lock.unlock() }
+            for (index, ring) in (txRings + rxRings).enumerated() {
+                cnm_csb_atok_set_cur(csb.atok + index, cnm_ring_cur(ring))
+                cnm_csb_atok_set_head(csb.atok + index, cnm_ring_head(ring))
+                cnm_sim_csb_write(csb.ktoa + index, cnm_ring_head(ring), cnm_ring_tail(ring))
+            }
+        }
+
+        /// Runs a kernel sync loop over the CSB until `shouldStop` returns true.
+        ///
+        /// Like the kernel's kloop, the loop takes head from the CSB atok
+        /// entries and reports hwcur and hwtail through ktoa, leaving the
+        /// ring's own tail to the application. TX rings come first in the
+        /// CSB, then RX rings.
+        ///
+        /// With `eventfds`, one pair per CSB entry, the loop follows the
+        /// kloop's notification protocol: it writes an entry's irqfd when
+        /// the entry moved and the application asked for a kick, and when
+        /// a pass finds no work it sets the kernel need-kick flags and
+        /// sleeps on the ioeventfds. The sleep is capped at
+        /// ``notificationPollMilliseconds`` so injected packets and stop
+        /// requests are still picked up, standing in for device interrupts.
+        func runSyncLoop(
+            csb: NetmapCSB,
+            sleepMicroseconds: UInt32,
+            eventfds: (io: [Int32], irq: [Int32])? = nil,
+            until shouldStop: () -> Bool
+        ) {
+            lock.lock()
+            self.csb = csb
+            self.irqfds = eventfds?.irq ?? []
+            lock.unlock()
+
+            while !shouldStop() {
+                let moved = syncPass(csb)
+                if let eventfds {
+                    notify(eventfds.irq, entries: moved, csb: csb)
+                    if moved.isEmpty {
+                        sleepUntilKicked(eventfds, csb: csb)
+                    }
+                } else if sleepMicroseconds > 0 {
+                    usleep(sleepMicroseconds)
+                } else {
+                    sched_yield()
+                }
+            }
+
+            lock.lock()
+            self.csb = nil
+            self.irqfds = []
+            lock.unlock()
+        }
+
+        /// Longest a notified sync loop sleeps without a kick.
+        static let notificationPollMilliseconds: Int32 = 10
+
+        // MARK: Private
+
+        /// Runs one transmit and receive pass and returns the CSB entries
+        /// whose hwcur or hwtail changed.
+        private func syncPass(_ csb: NetmapCSB) -> [Int] {
+            let entries = txRings.count + rxRings.count
+            let before = (0..<entries).map { (cnm_csb_ktoa_hwcur(csb.ktoa + $0), cnm_csb_ktoa_hwtail(csb.ktoa + $0)) }
+            lock.lock()
+            transmitLocked()
+            receiveLocked()
+            lock.unlock()
+            return (0..<entries).filter {
+                before[$0] != (cnm_csb_ktoa_hwcur(csb.ktoa + $0), cnm_csb_ktoa_hwtail(csb.ktoa + $0))
+            }
+        }
+
+        /// Kicks the application on moved entries it is waiting on.
+        private func notify(_ irqfds: [Int32], entries: [Int], csb: NetmapCSB) {
+            guard !entries.isEmpty else { return }
+            cnm_csb_full_fence()
+            var one: UInt64 = 1
+            for entry in entries where cnm_csb_atok_appl_need_kick(csb.atok + entry) != 0 {
+                _ = Glibc.write(irqfds[entry], &one, MemoryLayout<UInt64>.size)
+            }
+        }
+
+        /// Sets the kernel need-kick flags, rechecks for work behind a full
+        /// fence, and sleeps on the ioeventfds if there is still none.
+        private func sleepUntilKicked(_ eventfds: (io: [Int32], irq: [Int32]), csb: NetmapCSB) {
+            for entry in eventfds.io.indices {
+                cnm_sim_csb_set_kern_need_kick(csb.ktoa + entry, 1)
+            }
+            cnm_csb_full_fence()
+
+            let moved = syncPass(csb)
+            if moved.isEmpty {
+                var fds = eventfds.io.map { pollfd(fd: $0, events: Int16(POLLIN), revents: 0) }
+                _ = Glibc.poll(&fds, nfds_t(fds.count), Self.notificationPollMilliseconds)
+                var value: UInt64 = 0
+                for fd in fds where fd.revents & Int16(POLLIN) != 0 {
+                    _ = Glibc.read(fd.fd, &value, MemoryLayout<UInt64>.size)
+                }
+            }
+
+            for entry in eventfds.io.indices {
+                cnm_sim_csb_set_kern_need_kick(csb.ktoa + entry, 0)
+            }
+            notify(eventfds.irq, entries: moved, csb: csb)
+        }
+
+        /// Head as the kernel sees it: from the CSB in sync-loop mode.
+        private func kernelHead(_ ring: UnsafeMutableRawPointer, csbIndex: Int) -> UInt32 {
+            guard let csb else { return cnm_ring_head(ring) }
+            var head: UInt32 = 0
+            var cur: UInt32 = 0
+            cnm_sim_csb_read(csb.atok + csbIndex, &head, &cur)
+            return head
+        }
+
+        /// The kernel's tail: the last one it published.
+        private func kernelTail(_ ring: UnsafeMutableRawPointer, csbIndex: Int) -> UInt32 {
+            guard let csb else { return cnm_ring_tail(ring) }
+            return cnm_csb_ktoa_hwtail(csb.ktoa + csbIndex)
+        }
+
+        private func publish(_ ring: UnsafeMutableRawPointer, csbIndex: Int, hwcur: UInt32, tail: UInt32) {
+            if let csb {
+                cnm_sim_csb_write(csb.ktoa + csbIndex, hwcur, tail)
+            } else {
+                cnm_sim_set_tail(ring, tail)
+            }
+        }
+
+        private func transmitLocked() {
+            for (index, ring) in txRings.enumerated() {
+                let numSlots = cnm_ring_num_slots(ring)
+                let head = kernelHead(ring, csbIndex: index)
+                var position = txPosition[index]
+
+                while position != head {
+                    let slot = cnm_ring_slot(ring, position)!
+                    let length = Int(slot.pointee.len)
+                    let buffer = cnm_buf(ring, slot.pointee.buf_idx)!
+                    counters.transmittedPackets += 1
+                    counters.transmittedBytes += UInt64(length)
+                    if let peer, !peer.deliverLocked(buffer, length: length, ring: index) {
+                        counters.droppedPackets += 1
+                    }
+                    slot.pointee.flags &= ~CNM_NS_BUF_CHANGED
+                    position = position + 1 == numSlots ? 0 : position + 1
+                }
+
+                // Everything is transmitted at once; the kernel keeps one slot
+                txPosition[index] = head
+                publish(ring, csbIndex: index, hwcur: head, tail: head == 0 ? numSlots - 1 : head - 1)
+            }
+        }
+
+        /// Places one packet on an RX ring; false if the ring is full.
+        private func deliverLocked(_ source: UnsafeRawPointer, length: Int, ring index: Int) -> Bool {
+            let ringIndex = index % rxRings.count
+            let ring = rxRings[ringIndex]
+            let csbIndex = txRings.count + ringIndex
+            let numSlots = cnm_ring_num_slots(ring)
+            let head = kernelHead(ring, csbIndex: csbIndex)
+            let tail = kernelTail(ring, csbIndex: csbIndex)
+            let next = tail + 1 == numSlots ? 0 : tail + 1
+            guard next != head else { return false }
+
+            let slot = cnm_ring_slot(ring, tail)!
+            memcpy(cnm_buf(ring, slot.pointee.buf_idx), source, length)
+            slot.pointee.len = UInt16(length)
+            slot.pointee.flags = 0
+            publish(ring, csbIndex: csbIndex, hwcur: head, tail: next)
+            counters.receivedPackets += 1
+            counters.receivedBytes += UInt64(length)
+
+            // A peer's sync loop published this, not ours, so raise the
+            // interrupt here if the application is waiting on the ring
+            if let csb, !irqfds.isEmpty {
+                cnm_csb_full_fence()
+                if cnm_csb_atok_appl_need_kick(csb.atok + csbIndex) != 0 {
+                    var one: UInt64 = 1
+                    _ = Glibc.write(irqfds[csbIndex], &one, MemoryLayout<UInt64>.size)
+                }
+            }
+            return true
+        }
+
+        private func receiveLocked() {
+            let bufferSize = Int(cnm_ring_buf_size(rxRings[0]))
+            for (index, ring) in rxRings.enumerated() {
+                let csbIndex = txRings.count + index
+                let numSlots = cnm_ring_num_slots(ring)
+                let head = kernelHead(ring, csbIndex: csbIndex)
+                var tail = kernelTail(ring, csbIndex: csbIndex)
+                var queued = injected[index].startIndex
+
+                while true {
+                    let next = tail + 1 == numSlots ? 0 : tail + 1
+                    guard next != head else { break }
+
+                    let slot = cnm_ring_slot(ring, tail)!
+                    let buffer = UnsafeMutableRawPointer(cnm_buf(ring, slot.pointee.buf_idx)!)
+                    let length: Int
+                    if queued < injected[index].endIndex {
+                        let packet = injected[index][queued]
+                        queued += 1
+                        packet.copyBytes(to: buffer.assumingMemoryBound(to: UInt8.self), count: packet.count)
+                        length = packet.count
+                    } else {
+                        switch traffic {
+                        case .none:
+                            length = 0
+                        case .repeating(let packet):
+                            packet.copyBytes(to: buffer.assumingMemoryBound(to: UInt8.self), count: packet.count)
+                            length = packet.count
+                        case .generator(let generate):
+                            length = min(generate(UInt32(index), UnsafeMutableRawBufferPointer(start: buffer, count: bufferSize)), bufferSize)
+                        }
+                    }
+                    guard length > 0 else { break }
+
+                    slot.pointee.len = UInt16(length)
+                    slot.pointee.flags = 0
+                    counters.receivedPackets += 1
+                    counters.receivedBytes += UInt64(length)
+                    tail = next
+                }
+
+                injected[index].removeFirst(queued - injected[index].startIndex)
+                publish(ring, csbIndex: csbIndex, hwcur: head, tail: tail)
+            }
+        }
+    }
+
+    /// The anonymous mapping backing a simulator and its ports.
+    final class Region: @unchecked Sendable {
+        let base: UnsafeMutableRawPointer
+        let size: Int
+
+        init(size: Int) throws {
+            guard let mem = mmap(nil, size, PROT_READ | PROT_WRITE, MAP_ANON | MAP_PRIVATE, -1, 0),
+                  mem != UnsafeMutableRawPointer(bitPattern: -1) else {
+                throw NetmapError.mmapFailed(errno: errno)
+            }
+            self.base = mem
+            self.size = size
+        }
+
+        deinit {
+            munmap(base, size)
+        }
+    }
+
+    /// Hands out memory IDs that cannot collide with kernel allocators.
+    final class MemoryIdAllocator: @unchecked Sendable {
+        private let lock = NSLock()
+        private var upcoming: UInt16 = 0xF000
+
+        func next() -> UInt16 {
+            lock.lock()
+            defer { lock.unlock() }
+            let id = upcoming
+            upcoming = upcoming == UInt16.max ? 0xF000 : upcoming + 1
+            return id
+        }
+    }
+}
@@ -0,0 +1,341 @@
+/*
+ * Copyright (c) 2026 Kory Heard
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+import CNetmap
+import Foundation
+
+/// Software RSS: spreads one RX ring's flows across many TX rings.
+///
+/// ``NetmapZeroCopy/forwardAll(from:to:)`` maps source ring N to one
+/// destination ring, so a single busy RX queue can only ever feed one
+/// consumer. A steering stage hashes each packet's 5-tuple, looks the hash
+/// up in an indirection table, and moves the packet to the selected
+/// destination ring, swapping buffers when the rings share memory and
+/// copying otherwise. Packets of one flow always land on the same ring.
+///
+/// Destinations are any TX rings, typically those of a multi-ring port or
+/// the master ends of netmap pipes, each read by its own worker:
+///
+/// ```swift
+/// let nic = try NetmapPort.open(interface: "ix0", mode: .oneNIC, ringId: 0)
+/// let pipe0 = try NetmapPort.open(interface: "ix0{0", mode: .pipeMaster)
+/// let pipe1 = try NetmapPort.open(interface: "ix0{1", mode: .pipeMaster)
+///
+/// var targets = NetmapSteeringTargets()
+/// targets.append(pipe0.txRing(0))
+/// targets.append(pipe1.txRing(0))
+///
+/// // Workers open "ix0}0" and "ix0}1" with .pipeSlave
+/// let steering = NetmapSteering(destinations: targets.count)
+/// while true {
+///     guard try nic.waitForRx(timeout: 100) else { continue }
+///     steering.steer(from: nic.rxRing(0), to: targets)
+///     try pipe0.txSync()
+///     try pipe1.txSync()
+/// }
+/// ```
+///
+/// ## Hashes
+///
+/// - ``Hash/toeplitz(key:)`` computes the Toeplitz hash NICs use for RSS,
+///   so software steering can reproduce hardware queue selection. It is
+///   table-driven: one lookup and XOR per input byte.
+/// - ``Hash/multiplicative`` folds the tuple into 64 bits and mixes it with
+///   two multiplies. It is cheaper and distributes as well, but matches no
+///   hardware.
+///
+/// Non-IP packets hash to 0.
+public struct NetmapSteering: Sendable {
+
+    /// Flow hash function.
+    public enum Hash: Sendable {
+        /// Toeplitz hash with the given key (at least 40 bytes).
+        case toeplitz(key: [UInt8])
+        /// Multiply-xorshift hash over the folded 5-tuple.
+        case multiplicative
+
+        /// Toeplitz with the Microsoft RSS verification key used by most NIC drivers.
+        public static let defaultToeplitz = Hash.toeplitz(key: NetmapSteering.defaultToeplitzKey)
+    }
+
+    /// The Microsoft RSS verification key.
+    public static let defaultToeplitzKey: [UInt8] = [
+        0x6d, 0x5a, 0x56, 0xda, 0x25, 0x5b, 0x0e, 0xc2,
+        0x41, 0x67, 0x25, 0x3d, 0x43, 0xa3, 0x8f, 0xb0,
+        0xd0, 0xca, 0x2b, 0xcb, 0xae, 0x7b, 0x30, 0xb4,
+        0x77, 0xcb, 0x2d, 0xa3, 0x80, 0x30, 0xf2, 0x0c,
+        0x6a, 0x42, 0xb7, 0x3b, 0xbe, 0xac, 0x01, 0xfa,
+    ]
+
+    /// Number of destinations.
+    public let destinations: Int
+
+    /// Hash-to-destination indirection table; its size is a power of two.
+    public private(set) var indirectionTable: [UInt16]
+
+    private let hashFunction: Hash
+
+    /// Toeplitz contribution of each byte value at each input position.
+    private let toeplitzTable: [UInt32]
+
+    /// Longest hash input: two IPv6 addresses and two ports.
+    static let maxInputLength = 36
+
+    /// Creates a steering stage.
+    ///
+    /// - Parameters:
+    ///   - hash: Flow hash function
+    ///   - destinations: Number of destination rings
+    ///   - tableSize: Indirection table entries, rounded up to a power of two
+    /// - Precondition: destinations >= 1; a Toeplitz key has at least 40 bytes
+    public init(hash: Hash = .defaultToeplitz, destinations: Int, tableSize: Int = 128) {
+        precondition(destinations >= 1, "At least one destination is required")
+        self.destinations = destinations
+        self.hashFunction = hash
+
+        var size = 1
+        while size < max(tableSize, destinations) { size <<= 1 }
+        self.indirectionTable = (0..<size).map { UInt16($0 % destinations) }
+
+        if case .toeplitz(let key) = hash {
+            self.toeplitzTable = Self.buildToeplitzTable(key: key)
+        } else {
+            self.toeplitzTable = []
+        }
+    }
+
+    /// Replaces the indirection table, e.g. to weight destinations.
+    ///
+    /// - Parameter table: Destination per entry; count must be a power of two
+    /// - Precondition: every entry is below ``destinations``
+    public mutating func setIndirectionTable(_ table: [UInt16]) {
+        precondition(!table.isEmpty && table.count & (table.count - 1) == 0, "Table size must be a power of two")
+        precondition(table.allSatisfy { Int($0) < destinations }, "Table entry out of range")
+        indirectionTable = table
+    }
+
+    // MARK: - Hashing
+
+    /// Hashes a packet's IP addresses and, for TCP, UDP, and SCTP, ports.
+    ///
+    /// - Parameter packet: Packet bytes starting at the Ethernet header
+    /// - Returns: The flow hash, or 0 for non-IP packets
+    public func hash(_ packet: UnsafeRawBufferPointer) -> UInt32 {
+        let key = PacketKey(packet)
+        let width: Int
+        switch key.l3Class {
+        case 1: width = 4
+        case 2: width = 16
+        default: return 0
+        }
+        let hasPorts = key.bytes[PacketKey.portsValidOffset] != 0
+
+        switch hashFunction {
+        case .toeplitz:
+            return toeplitz(key, addressWidth: width, hasPorts: hasPorts)
+        case .multiplicative:
+            return multiplicative(key, hasPorts: hasPorts)
+        }
+    }
+
+    /// Returns the destination index for a packet.
+    ///
+    /// - Parameter packet: Packet bytes starting at the Ethernet header
+    @inline(__always)
+    public func destination(for packet: UnsafeRawBufferPointer) -> Int {
+        return Int(indirectionTable[Int(hash(packet)) & (indirectionTable.count - 1)])
+    }
+
+    // MARK: - Steering
+
+    /// Moves the source ring's packets to the destinations chosen by hash.
+    ///
+    /// Every packet taken from the source is either placed on its
+    /// destination ring or, if that ring is full, dropped and counted.
+    ///
+    /// - Parameters:
+    ///   - source: Source RX ring
+    ///   - targets: Destination TX rings; must hold ``destinations`` rings
+    ///   - limit: Maximum packets to take from the source
+    /// - Returns: Per-destination counts and drops
+    @discardableResult
+    public func steer(
+        from source: borrowing NetmapRing,
+        to targets: NetmapSteeringTargets,
+        limit: Int = .max
+    ) -> NetmapSteeringResult {
+        precondition(targets.count == destinations, "Target count does not match destinations")
+
+        var counts = [Int](repeating: 0, count: destinations)
+        var dropped = 0
+        var zeroCopy = 0
+        var copied = 0
+
+        source.withPackets(limit: limit) { batch in
+            for packet in batch {
+                let index = destination(for: packet.bytes)
+                let ring = targets.ring(at: index)
+                let shared = NetmapZeroCopy.sharesMemory(source, ring)
+
+                guard ring.hasSpace, shared || packet.count <= Int(ring.bufferSize) else {
+                    dropped += 1
+                    continue
+                }
+
+                var txSlot = ring.currentSlot
+                if shared {
+                    var rxSlot = packet.slot
+                    NetmapZeroCopy.swapBuffers(&rxSlot, &txSlot)
+                    zeroCopy += 1
+                } else {
+                    ring.setBuffer(for: &txSlot, source: packet.bytes.baseAddress!, length: packet.count)
+                    copied += 1
+                }
+                ring.advance()
+                counts[index] += 1
+            }
+        }
+
+        NetmapZeroCopy.statistics.record(zeroCopy: zeroCopy, copied: copied)
+        return NetmapSteeringResult(perDestination: counts, dropped: dropped)
+    }
+
+    /// Spreads the source ring's packets across every TX ring of a port.
+    ///
+    /// - Parameters:
+    ///   - source: Source RX ring
+    ///   - destination: Port whose TX rings receive the packets; it must
+    ///     have ``destinations`` TX rings
+    ///   - limit: Maximum packets to take from the source
+    /// - Returns: Per-ring counts and drops
+    @discardableResult
+    public func steer(
+        from source: borrowing NetmapRing,
+        to destination: borrowing NetmapPort,
+        limit: Int = .max
+    ) -> NetmapSteeringResult {
+        var targets = NetmapSteeringTargets()
+        destination.forEachTxRing { targets.append($0) }
+        return steer(from: source, to: targets, limit: limit)
+    }
+
+    // MARK: - Private
+
+    private func toeplitz(_ key: PacketKey, addressWidth width: Int, hasPorts: Bool) -> UInt32 {
+        var result: UInt32 = 0
+        var position = 0
+
+        @inline(__always)
+        func add(_ byte: UInt8) {
+            result ^= toeplitzTable[position << 8 | Int(byte)]
+            position += 1
+        }
+
+        for i in 0..<width { add(key.bytes[PacketKey.sourceOffset + i]) }
+        for i in 0..<width { add(key.bytes[PacketKey.destinationOffset + i]) }
+        if hasPorts {
+            add(UInt8(key.ports[0] >> 8))
+            add(UInt8(key.ports[0] & 0xFF))
+            add(UInt8(key.ports[1] >> 8))
+            add(UInt8(key.ports[1] & 0xFF))
+        }
+        return result
+    }
+
+    private func multiplicative(_ key: PacketKey, hasPorts: Bool) -> UInt32 {
+        // Fold 40 bytes of addresses into 64 bits, 8 bytes at a time
+        var folded: UInt64 = 0
+        withUnsafeBytes(of: key.bytes) { raw in
+            for offset in stride(from: PacketKey.sourceOffset, to: PacketKey.destinationOffset + 16, by: 8) {
+                folded = (folded ^ raw.loadUnaligned(fromByteOffset: offset, as: UInt64.self)) &* 0x9E37_79B9_7F4A_7C15
+            }
+        }
+        if hasPorts {
+            folded ^= UInt64(key.ports[0]) << 16 | UInt64(key.ports[1])
+        }
+        folded ^= UInt64(key.bytes[PacketKey.protocolOffset]) << 32
+
+        // Final avalanche (splitmix64)
+        folded ^= folded >> 30
+        folded &*= 0xBF58_476D_1CE4_E5B9
+        folded ^= folded >> 27
+        folded &*= 0x94D0_49BB_1331_11EB
+        folded ^= folded >> 31
+        return UInt32(truncatingIfNeeded: folded)
+    }
+
+    /// Builds the per-byte Toeplitz table for inputs up to ``maxInputLength``.
+    private static func buildToeplitzTable(key: [UInt8]) -> [UInt32] {
+        precondition(key.count >= maxInputLength + 4, "Toeplitz key must be at least 40 bytes")
+
+        // 32-bit key window starting at each input bit
+        let windows: [UInt32] = (0..<(maxInputLength * 8)).map { bit in
+            var window: UInt32 = 0
+            for j in 0..<32 {
+                let keyBit = bit + j
+                window = window << 1 | UInt32((key[keyBit >> 3] >> (7 - UInt8(keyBit & 7))) & 1)
+            }
+            return window
+        }
+
+        var table = [UInt32](repeating: 0, count: maxInputLength * 256)
+        for position in 0..<maxInputLength {
+            for value in 0..<256 {
+                var result: UInt32 = 0
+                for bit in 0..<8 where value & (0x80 >> bit) != 0 {
+                    result ^= windows[position * 8 + bit]
+                }
+                table[position << 8 | value] = result
+            }
+        }
+        return table
+    }
+}
+
+// MARK: - Targets
+
+/// Destination TX rings for ``NetmapSteering``.
+///
+/// Holds references to rings of open ports; the ports must stay open for
+/// as long as the targets are used.
+public struct NetmapSteeringTargets: @unchecked Sendable {
+    private var rings: [(pointer: UnsafeMutableRawPointer, memoryId: UInt16)] = []
+
+    public init() {}
+
+    /// Number of target rings.
+    public var count: Int {
+        return rings.count
+    }
+
+    /// Adds a TX ring as the next destination.
+    ///
+    /// - Parameter ring: A TX ring of an open port
+    public mutating func append(_ ring: borrowing NetmapRing) {
+        precondition(ring.kind == .tx, "Steering targets must be TX rings")
+        rings.append((ring.ringPtr, ring.memoryId))
+    }
+
+    @inline(__always)
+    func ring(at index: Int) -> NetmapRing {
+        let target = rings[index]
+        return NetmapRing(ringPtr: target.pointer, kind: .tx, memoryId: target.memoryId)
+    }
+}
+
+/// Outcome of one steering pass.
+public struct NetmapSteeringResult: Sendable, Equatable {
+    /// Packets placed on each destination ring.
+    public let perDestination: [Int]
+
+    /// Packets dropped because their destination ring was full.
+    public let dropped: Int
+
+    /// Total packets placed on destination rings.
+    public var steered: Int {
+        return perDestination.reduce(0, +)
+    }
+}
@@ -0,0 +1,490 @@
+/*
+ * Copyright (c) 2026 Kory Heard
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+import CNetmap
+import Cpuset
+import Foundation
+import Glibc
+
+/// Runs one pinned polling thread per hardware ring pair of an interface.
+///
+/// Multi-queue NICs spread flows across RX rings with RSS, and the usual
+/// deployment serves each ring pair from its own core. A worker group opens
+/// one `.oneNIC` registration per ring pair, starts a thread for each, pins
+/// it with `Cpuset.setAffinity`, and runs a poll loop that hands each
+/// received batch to a shared handler together with the worker's port, so
+/// the handler can transmit on the same ring pair.
+///
+/// With NUMA awareness enabled, workers are placed on CPUs in the NIC's
+/// memory domain (from `dev.<driver>.<unit>.%domain`) and prefer that domain
+/// for allocations.
+///
+/// ```swift
+/// let group = NetmapWorkerGroup(
+///     configuration: .init(interface: "ix0")
+/// ) { batch, port in
+///     let tx = port.txRing(UInt32(batch.ringId))
+///     for packet in batch where tx.hasSpace {
+///         var slot = tx.currentSlot
+///         tx.setBuffer(for: &slot, source: packet.bytes.baseAddress!, length: packet.count)
+///         tx.advance()
+///     }
+/// }
+/// try group.start()
+/// // ...
+/// for ring in group.statistics() {
+///     print("ring \(ring.ring) on cpu \(ring.cpu ?? -1): \(ring.packetsPerSecond) pps")
+/// }
+/// group.stop()
+/// ```
+public final class NetmapWorkerGroup: @unchecked Sendable {
+
+    /// Worker group settings.
+    public struct Configuration: Sendable {
+        /// The NIC to serve.
+        public var interface: String
+
+        /// Ring pairs to serve, or `nil` for every RX ring of the interface.
+        public var rings: [UInt16]?
+
+        /// CPUs to pin workers to, assigned in order and reused cyclically.
+        /// When `nil`, CPUs are chosen from the process's cpuset.
+        public var cpus: [Int]?
+
+        /// Prefer CPUs and memory in the NIC's NUMA domain when choosing
+        /// CPUs automatically.
+        public var numaAware: Bool
+
+        /// Poll timeout per loop iteration in milliseconds. Bounds how long
+        /// ``NetmapWorkerGroup/stop()`` waits for an idle worker.
+        public var pollTimeout: Int32
+
+        /// Maximum packets passed to the handler per batch.
+        public var batchLimit: Int
+
+        /// Additional registration flags for every worker's port.
+        public var flags: NetmapRegistrationFlags
+
+        public init(
+            interface: String,
+            rings: [UInt16]? = nil,
+            cpus: [Int]? = nil,
+            numaAware: Bool = true,
+            pollTimeout: Int32 = 100,
+            batchLimit: Int = 512,
+            flags: NetmapRegistrationFlags = []
+        ) {
+            self.interface = interface
+            self.rings = rings
+            self.cpus = cpus
+            self.numaAware = numaAware
+            self.pollTimeout = pollTimeout
+            self.batchLimit = batchLimit
+            self.flags = flags
+        }
+    }
+
+    /// Processes one received batch on a worker thread.
+    ///
+    /// The port is the worker's own `.oneNIC` registration; its TX ring with
+    /// the batch's ring ID is free for the handler to fill. TX slots are
+    /// pushed by the next poll. Throwing stops that worker; the error is
+    /// reported in ``RingStatistics/failure``.
+    public typealias BatchHandler = @Sendable (_ batch: NetmapPacketBatch, _ port: borrowing NetmapPort) throws -> Void
+
+    /// Opens the port serving one ring pair. Tests substitute one that
+    /// opens ``NetmapSimulator`` ports.
+    typealias PortOpener = @Sendable (_ configuration: Configuration, _ ring: UInt16) throws -> NetmapPort
+
+    /// Counters for one worker, with rates since the previous snapshot.
+    public struct RingStatistics: Sendable {
+        /// Ring pair served by the worker.
+        public let ring: UInt16
+
+        /// CPU the worker is pinned to, if pinning succeeded.
+        public let cpu: Int?
+
+        /// Packets handed to the handler.
+        public let packets: UInt64
+
+        /// Bytes handed to the handler.
+        public let bytes: UInt64
+
+        /// Poll wakeups that found no packets.
+        public let emptyPolls: UInt64
+
+        /// Packets per second since the previous call to ``NetmapWorkerGroup/statistics()``.
+        public let packetsPerSecond: Double
+
+        /// Bits per second since the previous call to ``NetmapWorkerGroup/statistics()``.
+        public let bitsPerSecond: Double
+
+        /// Error that stopped the worker, if any.
+        public let failure: (any Error)?
+    }
+
+    public let configuration: Configuration
+
+    private let handler: BatchHandler
+    private let openPort: PortOpener
+    private let lock = NSLock()
+    private var running = false
+    private var workers: [Worker] = []
+    private var currentRingStatistics: NetmapRingStatistics?
+
+    /// Creates a worker group. Call ``start()`` to open the ports and start the threads.
+    ///
+    /// - Parameters:
+    ///   - configuration: Interface, rings, and placement
+    ///   - handler: Called on the worker thread for every received batch
+    public convenience init(configuration: Configuration, handler: @escaping BatchHandler) {
+        self.init(configuration: configuration, handler: handler) { configuration, ring in
+            try NetmapPort.open(
+                interface: configuration.interface,
+                mode: .oneNIC,
+                flags: configuration.flags,
+                ringId: ring
+            )
+        }
+    }
+
+    init(configuration: Configuration, handler: @escaping BatchHandler, openPort: @escaping PortOpener) {
+        self.configuration = configuration
+        self.handler = handler
+        self.openPort = openPort
+    }
+
+    deinit {
+        stop()
+    }
+
+    // MARK: - Lifecycle
+
+    /// Opens one port per ring pair and starts the pinned worker threads.
+    ///
+    /// Returns once every worker has registered its port. If any registration
+    /// fails, the workers already started are stopped and the error is thrown.
+    ///
+    /// - Throws: `NetmapError` if the interface cannot be queried or a ring
+    ///   cannot be registered, or `Cpuset.Error` if CPUs cannot be listed.
+    public func start() throws {
+        // Claim the group under the lock so concurrent calls start it once
+        lock.lock()
+        let alreadyRunning = running
+        running = true
+        lock.unlock()
+        guard !alreadyRunning else { return }
+
+        do {
+            try startWorkers()
+        } catch {
+            lock.lock()
+            running = false
+            lock.unlock()
+            throw error
+        }
+    }
+
+    private func startWorkers() throws {
+
+        let rings: [UInt16]
+        if let configured = configuration.rings {
+            rings = configured
+        } else {
+            let info = try NetmapPort.getInfo(interface: configuration.interface)
+            rings = (0..<info.rxRings).map { $0 }
+        }
+        let cpus = try placementCPUs()
+        let domain = configuration.numaAware ? Self.numaDomain(of: configuration.interface) : nil
+        let ringCount = Int(rings.max().map { $0 + 1 } ?? 0)
+        let ringStatistics = NetmapRingStatistics(txRings: ringCount, rxRings: ringCount)
+
+        var started: [Worker] = []
+        for (index, ring) in rings.enumerated() {
+            let worker = Worker(
+                ring: ring,
+                cpu: cpus.isEmpty ? nil : cpus[index % cpus.count],
+                domain: domain
+            )
+            started.append(worker)
+            worker.start(configuration: configuration, statistics: ringStatistics, handler: handler, openPort: openPort)
+        }
+
+        // Wait for every registration before reporting success
+        var failure: Error?
+        for worker in started {
+            if let error = worker.waitUntilRegistered(), failure == nil {
+                failure = error
+            }
+        }
+        if let failure {
+            started.forEach { $0.stop() }
+            throw failure
+        }
+
+        lock.lock()
+        guard running else {
+            // stop() ran while the workers were registering
+            lock.unlock()
+            started.forEach { $0.stop() }
+            return
+        }
+        workers = started
+        currentRingStatistics = ringStatistics
+        lock.unlock()
+    }
+
+    /// Stops every worker and waits for its thread to exit.
+    ///
+    /// Idle workers notice within ``Configuration/pollTimeout``.
+    public func stop() {
+        lock.lock()
+        let stopping = workers
+        workers = []
+        running = false
+        lock.unlock()
+        stopping.forEach { $0.stop() }
+    }
+
+    /// Returns per-ring counters, with rates over the interval since the
+    /// previous call.
+    public func statistics() -> [RingStatistics] {
+        lock.lock()
+        let current = workers
+        lock.unlock()
+        return current.map { $0.snapshot() }
+    }
+
+    /// Lock-free per-ring counters and poll-to-process latency histograms
+    /// for the running workers, indexed by ring, or `nil` before ``start()``.
+    ///
+    /// Cheaper to scrape than ``statistics()``, which takes every worker's
+    /// lock; take a ``NetmapRingStatistics/snapshot()`` and diff it against
+    /// the previous one for rates.
+    public var ringStatistics: NetmapRingStatistics? {
+        lock.lock()
+        defer { lock.unlock() }
+        return currentRingStatistics
+    }
+
+    // MARK: - Placement
+
+    /// CPUs to assign workers to, in order.
+    private func placementCPUs() throws -> [Int] {
+        if let cpus = configuration.cpus {
+            return cpus
+        }
+
+        let available = try Cpuset.availableCPUs()
+        if configuration.numaAware,
+           let domain = Self.numaDomain(of: configuration.interface),
+           let local = try? Cpuset.getAffinity(level: .which, for: .domain(Int32(domain))) {
+            let domainCPUs = available.filter { local.isSet(cpu: $0) }
+            if !domainCPUs.isEmpty {
+                return domainCPUs
+            }
+        }
+        return available
+    }
+
+    /// NUMA domain of a NIC, from `dev.<driver>.<unit>.%domain`.
+    ///
+    /// Returns `nil` for VALE ports, pipes, and drivers that do not report one.
+    static func numaDomain(of interface: String) -> Int? {
+        guard let unitStart = interface.firstIndex(where: { $0.isNumber }),
+              unitStart != interface.startIndex,
+              interface[unitStart...].allSatisfy({ $0.isNumber }) else {
+            return nil
+        }
+        let driver = interface[..<unitStart]
+        let unit = interface[unitStart...]
+
+        var domain: Int32 = 0
+        var size = MemoryLayout<Int32>.size
+        guard sysctlbyname("dev.\(driver).\(unit).%domain", &domain, &size, nil, 0) == 0 else {
+            return nil
+        }
+        return Int(domain)
+    }
+}
+
+// MARK: - Worker
+
+extension NetmapWorkerGroup {
+
+    /// One ring pair, its thread, and its counters.
+    final class Worker: @unchecked Sendable {
+        let ring: UInt16
+        let cpu: Int?
+        let domain: Int?
+
+        private let lock = NSLock()
+        private let registered = DispatchSemaphore(value: 0)
+        private let exited = DispatchSemaphore(value: 0)
+        private var registrationError: Error?
+        private var stopRequested = false
+        private var hasExited = false
+        private var pinned = false
+        private var failure: Error?
+
+        // Published once per poll iteration
+        private var packets: UInt64 = 0
+        private var bytes: UInt64 = 0
+        private var emptyPolls: UInt64 = 0
+
+        // Rate baseline, touched only by snapshot()
+        private var lastPackets: UInt64 = 0
+        private var lastBytes: UInt64 = 0
+        private var lastSnapshot = ContinuousClock.now
+
+        init(ring: UInt16, cpu: Int?, domain: Int?) {
+            self.ring = ring
+            self.cpu = cpu
+            self.domain = domain
+        }
+
+        func start(
+            configuration: Configuration,
+            statistics: NetmapRingStatistics,
+            handler: @escaping BatchHandler,
+            openPort: @escaping PortOpener
+        ) {
+            let thread = Thread { [self] in
+                run(configuration: configuration, statistics: statistics, handler: handler, openPort: openPort)
+                lock.lock()
+                hasExited = true
+                lock.unlock()
+                exited.signal()
+            }
+            thread.name = "com.netmap.worker.\(ring)"
+            thread.start()
+        }
+
+        /// Blocks until the port is registered; returns the registration error, if any.
+        func waitUntilRegistered() -> Error? {
+            registered.wait()
+            lock.lock()
+            defer { lock.unlock() }
+            return registrationError
+        }
+
+        func stop() {
+            lock.lock()
+            stopRequested = true
+            let done = hasExited
+            lock.unlock()
+            if !done {
+                exited.wait()
+                exited.signal()   // Let later stop() calls through
+            }
+        }
+
+        func snapshot() -> RingStatistics {
+            let now = ContinuousClock.now
+            lock.lock()
+            let totalPackets = packets
+            let totalBytes = bytes
+            let empty = emptyPolls
+            let error = failure
+            let isPinned = pinned
+            let elapsed = now - lastSnapshot
+            let deltaPackets = totalPackets - lastPackets
+            let deltaBytes = totalBytes - lastBytes
+            lastPackets = totalPackets
+            lastBytes = totalBytes
+            lastSnapshot = now
+            lock.unlock()
+
+            let seconds = Double(elapsed.components.seconds) + Double(elapsed.components.attoseconds) / 1e18
+            return RingStatistics(
+                ring: ring,
+                cpu: isPinned ? cpu : nil,
+                packets: totalPackets,
+                bytes: totalBytes,
+                emptyPolls: empty,
+                packetsPerSecond: seconds > 0 ? Double(deltaPackets) / seconds : 0,
+                bitsPerSecond: seconds > 0 ? Double(deltaBytes) * 8 / seconds : 0,
+                failure: error
+            )
+        }
+
+        private var shouldStop: Bool {
+            lock.lock()
+            defer { lock.unlock() }
+            return stopRequested
+        }
+
+        private func run(
+            configuration: Configuration,
+            statistics: NetmapRingStatistics,
+            handler: BatchHandler,
+            openPort: PortOpener
+        ) {
+            // Pin before registering so ring memory is first touched locally
+            if let cpu, (try? Cpuset.setAffinity(CPUSet(cpu: cpu), for: .currentThread)) != nil {
+                lock.lock()
+                pinned = true
+                lock.unlock()
+            }
+            if let domain {
+                try? Cpuset.preferDomain(domain)
+            }
+
+            var port: NetmapPort
+            do {
+                port = try openPort(configuration, ring)
+            } catch {
+                lock.lock()
+                registrationError = error
+                lock.unlock()
+                registered.signal()
+                return
+            }
+            registered.signal()
+            port.ringStatistics = statistics
+
+            let rxRing = port.rxRing(UInt32(ring))
+            while !shouldStop {
+                do {
+                    // poll() also runs rxsync and flushes pending TX slots
+                    let ready = try port.waitForRx(timeout: configuration.pollTimeout)
+                    statistics.recordSync(.rx, ring: UInt32(ring))
+                    guard ready, !rxRing.isEmpty else {
+                        statistics.recordEmptyPoll(.rx, ring: UInt32(ring))
+                        lock.lock()
+                        emptyPolls += 1
+                        lock.unlock()
+                        continue
+                    }
+
+                    let polled = NetmapRingStatistics.now()
+                    var batchBytes: UInt64 = 0
+                    let batchPackets = try rxRing.withPackets(limit: configuration.batchLimit) { batch in
+                        for packet in batch {
+                            batchBytes += UInt64(packet.count)
+                        }
+                        try handler(batch, port)
+                        return UInt64(batch.count)
+                    }
+                    statistics.recordBatch(.rx, ring: UInt32(ring), packets: Int(batchPackets), bytes: Int(batchBytes))
+                    statistics.recordLatency(.rx, ring: UInt32(ring), since: polled)
+
+                    lock.lock()
+                    packets += batchPackets
+                    bytes += batchBytes
+                    lock.unlock()
+                } catch NetmapError.pollFailed(let code) where code == EINTR {
+                    continue
+                } catch {
+                    lock.lock()
+                    failure = error
+                    lock.unlock()
+                    break
+                }
+            }
+        }
+    }
+}
@@ -42,8 +42,19 @@ import Foundation
 /// However, zero-copy requires:
 /// - Both ports share the same memory region (same memory ID)
 /// - Care with buffer lifetime (don't use swapped buffer until TX completes)
+///
+/// The forwarding helpers check ``NetmapRing/memoryId`` and swap buffers
+/// only when the rings share an allocator. Otherwise they copy packets in
+/// batches, prefetching source buffers a few slots ahead. ``statistics``
+/// counts packets taken by each path.
 public enum NetmapZeroCopy {
 
+    /// Slots ahead of the current one whose buffers are prefetched on the copy path.
+    static let prefetchDistance = 4
+
+    /// Process-wide forwarding counters.
+    public static let statistics = Statistics()
+
     // MARK: - Buffer Swapping
 
     /// Swaps buffer indices between two slots for zero-copy forwarding.
@@ -93,10 +104,13 @@ public enum NetmapZeroCopy {
 
     // MARK: - Batch Operations
 
-    /// Forwards packets from source to destination ring using zero-copy.
+    /// Forwards packets from source to destination ring.
     ///
-    /// This is the main high-performance forwarding function. It swaps
-    /// buffer indices between corresponding slots in the two rings.
+    /// This is the main high-performance forwarding function. When the rings
+    /// share a memory allocator it swaps buffer indices between corresponding
+    /// slots; otherwise it copies each packet into the destination buffer.
+    /// Packets larger than the destination buffer size are dropped on the
+    /// copy path.
     ///
     /// - Parameters:
     ///   - source: Source RX ring
@@ -109,9 +123,15 @@ public enum NetmapZeroCopy {
         to destination: borrowing NetmapRing,
         maxPackets: Int = 0
     ) -> Int {
-        var count = 0
         let limit = maxPackets > 0 ? maxPackets : Int.max
 
+        guard sharesMemory(source, destination) else {
+            let copied = copyForward(from: source, to: destination, limit: limit)
+            statistics.record(zeroCopy: 0, copied: copied)
+            return copied
+        }
+
+        var count = 0
         while !source.isEmpty && destination.hasSpace && count < limit {
             var rxSlot = source.currentSlot
             var txSlot = destination.currentSlot
@@ -123,13 +143,68 @@ public enum NetmapZeroCopy {
             count += 1
         }
 
+        statistics.record(zeroCopy: count, copied: 0)
         return count
     }
 
+    /// Copies a batch of packets between rings in different allocators.
+    ///
+    /// The batch size is fixed up front from both rings' space, so the loop
+    /// touches only slot and buffer memory, and head/cur are published once.
+    ///
+    /// - Returns: Number of packets copied
+    static func copyForward(
+        from source: borrowing NetmapRing,
+        to destination: borrowing NetmapRing,
+        limit: Int
+    ) -> Int {
+        let batch = min(Int(source.space), Int(destination.space), limit)
+        guard batch > 0 else { return 0 }
+
+        let maxLength = Int(destination.bufferSize)
+        var rxIndex = source.head
+        var txIndex = destination.head
+
+        // Prime the prefetch window
+        var ahead = rxIndex
+        var prefetched = 0
+        while prefetched < min(prefetchDistance, batch) {
+            cnm_prefetch(source.buffer(for: source.slot(at: ahead)))
+            ahead = source.next(ahead)
+            prefetched += 1
+        }
+
+        var copied = 0
+        for _ in 0..<batch {
+            if prefetched < batch {
+                cnm_prefetch(source.buffer(for: source.slot(at: ahead)))
+                ahead = source.next(ahead)
+                prefetched += 1
+            }
+
+            let rxSlot = source.slot(at: rxIndex)
+            let length = Int(rxSlot.length)
+            if length <= maxLength {
+                var txSlot = destination.slot(at: txIndex)
+                destination.setBuffer(for: &txSlot, source: source.buffer(for: rxSlot), length: length)
+                txIndex = destination.next(txIndex)
+                copied += 1
+            }
+            rxIndex = source.next(rxIndex)
+        }
+
+        source.head = rxIndex
+        source.cur = rxIndex
+        destination.head = txIndex
+        destination.cur = txIndex
+        return copied
+    }
+
     /// Forwards packets with a filter function.
     ///
-    /// Only packets where the filter returns true are forwarded.
-    /// Filtered packets are still advanced in the source ring.
+    /// Only packets where the filter returns true are forwarded, by buffer
+    /// swap when the rings share memory and by copy otherwise. Filtered
+    /// packets are still advanced in the source ring.
     ///
     /// - Parameters:
     ///   - source: Source RX ring
@@ -143,15 +218,23 @@ public enum NetmapZeroCopy {
     ) -> (forwarded: Int, filtered: Int) {
         var forwarded = 0
         var filtered = 0
+        let shared = sharesMemory(source, destination)
+        let maxLength = Int(destination.bufferSize)
 
         while !source.isEmpty {
             let rxSlot = source.currentSlot
             let data = source.bufferData(for: rxSlot)
 
-            if filter(data) && destination.hasSpace {
-                var rxSlotMut = source.currentSlot
+            if filter(data) && destination.hasSpace && (shared || data.count <= maxLength) {
                 var txSlot = destination.currentSlot
-                swapBuffers(&rxSlotMut, &txSlot)
+                if shared {
+                    var rxSlotMut = source.currentSlot
+                    swapBuffers(&rxSlotMut, &txSlot)
+                } else {
+                    data.withUnsafeBytes { bytes in
+                        destination.setBuffer(for: &txSlot, source: bytes.baseAddress!, length: bytes.count)
+                    }
+                }
                 destination.advance()
                 forwarded += 1
             } else {
@@ -161,6 +244,66 @@ public enum NetmapZeroCopy {
             source.advance()
         }
 
+        statistics.record(zeroCopy: shared ? forwarded : 0, copied: shared ? 0 : forwarded)
+        return (forwarded, filtered)
+    }
+
+    /// Packets classified per batch by ``forwardFiltered(from:to:classifier:)``.
+    static let classifierBatch = 64
+
+    /// Forwards packets accepted by a compiled classifier.
+    ///
+    /// Unlike the closure-based overload, packets are classified a batch at
+    /// a time straight from the slot buffers, with no per-packet closure
+    /// call or `Data` allocation. Accepted packets are swapped or copied as
+    /// in ``forward(from:to:maxPackets:)``; dropped packets, and accepted
+    /// packets that find no TX space, are released from the source ring.
+    ///
+    /// - Parameters:
+    ///   - source: Source RX ring
+    ///   - destination: Destination TX ring
+    ///   - classifier: Compiled rule set
+    /// - Returns: Tuple of (forwarded count, filtered count)
+    @discardableResult
+    public static func forwardFiltered(
+        from source: borrowing NetmapRing,
+        to destination: borrowing NetmapRing,
+        classifier: NetmapClassifier
+    ) -> (forwarded: Int, filtered: Int) {
+        var forwarded = 0
+        var filtered = 0
+        let shared = sharesMemory(source, destination)
+        let maxLength = Int(destination.bufferSize)
+
+        withUnsafeTemporaryAllocation(of: NetmapFilterRule.Action.self, capacity: classifierBatch) { verdicts in
+            while !source.isEmpty {
+                source.withPackets(limit: classifierBatch) { batch in
+                    classifier.classify(batch, into: verdicts)
+
+                    for position in batch.indices {
+                        let packet = batch[position]
+                        guard verdicts[position] == .accept,
+                              destination.hasSpace,
+                              shared || packet.count <= maxLength else {
+                            filtered += 1
+                            continue
+                        }
+
+                        var txSlot = destination.currentSlot
+                        if shared {
+                            var rxSlot = packet.slot
+                            swapBuffers(&rxSlot, &txSlot)
+                        } else {
+                            destination.setBuffer(for: &txSlot, source: packet.bytes.baseAddress!, length: packet.count)
+                        }
+                        destination.advance()
+                        forwarded += 1
+                    }
+                }
+            }
+        }
+
+        statistics.record(zeroCopy: shared ? forwarded : 0, copied: shared ? 0 : forwarded)
         return (forwarded, filtered)
     }
 
@@ -179,12 +322,17 @@ public enum NetmapZeroCopy {
 
         /// Destination ring used.
         public let destinationRing: UInt32
+
+        /// Whether packets were forwarded by buffer swap rather than copy.
+        public let zeroCopy: Bool
     }
 
     /// Forwards packets from all source rings to corresponding destination rings.
     ///
     /// This handles multiple ring pairs, matching source ring N to destination ring N.
     /// If there are more source rings than destination rings, they wrap around.
+    /// Each pair is forwarded with ``forward(from:to:maxPackets:)``, so ports
+    /// in different allocators fall back to copying.
     ///
     /// - Parameters:
     ///   - source: Source port
@@ -196,6 +344,7 @@ public enum NetmapZeroCopy {
     ) -> [ForwardResult] {
         var results: [ForwardResult] = []
         let dstRingCount = destination.txRingCount
+        let shared = sharesMemory(source, destination)
 
         for srcIdx in 0..<source.rxRingCount {
             let dstIdx = srcIdx % dstRingCount
@@ -209,7 +358,8 @@ public enum NetmapZeroCopy {
                 forwarded: forwarded,
                 dropped: dropped,
                 sourceRing: srcIdx,
-                destinationRing: dstIdx
+                destinationRing: dstIdx,
+                zeroCopy: shared
             ))
         }
 
@@ -221,8 +371,9 @@ public enum NetmapZeroCopy {
     /// Checks if two ports share the same memory region.
     ///
     /// Zero-copy operations only work between ports that share memory.
-    /// VALE ports and pipes typically share memory, while different
-    /// physical NICs may not.
+    /// Ports share memory when the kernel registered them with the same
+    /// allocator (``NetmapPort/memoryId``), which covers VALE ports, pipes,
+    /// and NICs bound to a common allocator alike.
     ///
     /// - Parameters:
     ///   - port1: First port
@@ -232,11 +383,145 @@ public enum NetmapZeroCopy {
         _ port1: borrowing NetmapPort,
         _ port2: borrowing NetmapPort
     ) -> Bool {
-        // For VALE ports on the same switch, they share memory
-        // This is a heuristic - proper check requires comparing memory IDs
-        // which would need additional API support
-        return NetmapVALE.isVALEName(port1.interfaceName) &&
-               NetmapVALE.isVALEName(port2.interfaceName)
+        return port1.memoryId != 0 && port1.memoryId == port2.memoryId
+    }
+
+    /// Checks if two rings index the same buffer pool.
+    ///
+    /// - Parameters:
+    ///   - ring1: First ring
+    ///   - ring2: Second ring
+    /// - Returns: true if buffers can be swapped between the rings
+    public static func sharesMemory(
+        _ ring1: borrowing NetmapRing,
+        _ ring2: borrowing NetmapRing
+    ) -> Bool {
+        return ring1.memoryId != 0 && ring1.memoryId == ring2.memoryId
+    }
+}
+
+// MARK: - Statistics
+
+extension NetmapZeroCopy {
+
+    /// Counts of packets forwarded by buffer swap and by copy.
+    ///
+    /// Updated once per forwarding call, so the cost is independent of
+    /// batch size. Each thread writes its own cache-line block with
+    /// `cnm_counter_add`, so forwarding threads take no lock and share no
+    /// counter; ``snapshot()`` sums the blocks. Use it to check that a
+    /// forwarding setup takes the zero-copy path.
+    public final class Statistics: @unchecked Sendable {
+
+        /// Counter values at one point in time.
+        public struct Snapshot: Sendable, Equatable {
+            /// Packets forwarded by swapping buffer indices.
+            public let zeroCopyPackets: UInt64
+
+            /// Packets forwarded by copying into the destination buffer.
+            public let copiedPackets: UInt64
+        }
+
+        // Per-thread block layout, one cache line
+        private static let blockWords = 8
+        private static let zeroCopyWord = 0
+        private static let copiedWord = 1
+        private static let ownerWord = 2
+
+        /// Guards `blocks`, `idle`, and `baseline`; never taken by `record`
+        /// once the calling thread has a block.
+        private let lock = NSLock()
+        private var key = pthread_key_t()
+        private var blocks: [UnsafeMutablePointer<UInt64>] = []
+        private var idle: [UnsafeMutablePointer<UInt64>] = []
+        private var baseline = Snapshot(zeroCopyPackets: 0, copiedPackets: 0)
+
+        /// Instances live for the process: exiting threads hand their block
+        /// back through an unretained pointer stored in it.
+        init() {
+            pthread_key_create(&key) { block in
+                guard let block else { return }
+                let words = block.assumingMemoryBound(to: UInt64.self)
+                let owner = UnsafeRawPointer(bitPattern: UInt(words[Statistics.ownerWord]))!
+                Unmanaged<Statistics>.fromOpaque(owner).takeUnretainedValue().retire(words)
+            }
+        }
+
+        /// Returns the current counter values.
+        public func snapshot() -> Snapshot {
+            lock.lock()
+            defer { lock.unlock() }
+            let total = sum()
+            return Snapshot(
+                zeroCopyPackets: total.zeroCopyPackets &- baseline.zeroCopyPackets,
+                copiedPackets: total.copiedPackets &- baseline.copiedPackets
+            )
+        }
+
+        /// Resets both counters to zero.
+        ///
+        /// The per-thread blocks belong to their writers, so this records the
+        /// current totals as a baseline instead of clearing them.
+        public func reset() {
+            lock.lock()
+            baseline = sum()
+            lock.unlock()
+        }
+
+        @inline(__always)
+        func record(zeroCopy: Int, copied: Int) {
+            guard zeroCopy > 0 || copied > 0 else { return }
+            let block = threadBlock()
+            cnm_counter_add(block + Self.zeroCopyWord, UInt64(zeroCopy))
+            cnm_counter_add(block + Self.copiedWord, UInt64(copied))
+        }
+
+        // MARK: Private
+
+        /// The calling thread's block, claimed on its first forwarding call.
+        @inline(__always)
+        private func threadBlock() -> UnsafeMutablePointer<UInt64> {
+            if let block = pthread_getspecific(key) {
+                return block.assumingMemoryBound(to: UInt64.self)
+            }
+            return claimBlock()
+        }
+
+        /// Reuses a block left by an exited thread, keeping its counts, or
+        /// allocates a new one.
+        private func claimBlock() -> UnsafeMutablePointer<UInt64> {
+            lock.lock()
+            let block: UnsafeMutablePointer<UInt64>
+            if let reused = idle.popLast() {
+                block = reused
+            } else {
+                block = UnsafeMutableRawPointer
+                    .allocate(byteCount: Self.blockWords * MemoryLayout<UInt64>.size, alignment: 64)
+                    .initializeMemory(as: UInt64.self, repeating: 0, count: Self.blockWords)
+                block[Self.ownerWord] = UInt64(UInt(bitPattern: Unmanaged.passUnretained(self).toOpaque()))
+                blocks.append(block)
+            }
+            lock.unlock()
+            pthread_setspecific(key, block)
+            return block
+        }
+
+        private func retire(_ block: UnsafeMutablePointer<UInt64>) {
+            lock.lock()
+            idle.append(block)
+            lock.unlock()
+        }
+
+        /// Totals across every block. Caller holds `lock`.
+        private func sum() -> Snapshot {
+            var zeroCopy: UInt64 = 0
+            var copied: UInt64 = 0
+            for block in blocks {
+                zeroCopy &+= cnm_counter_load(block + Self.zeroCopyWord)
+                copied &+= cnm_counter_load(block + Self.copiedWord)
+            }
+            return Snapshot(zeroCopyPackets: zeroCopy, copiedPackets: copied)
+        }
     }
 }
 
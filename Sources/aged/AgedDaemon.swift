@@ -196,6 +196,17 @@ struct AgedDaemon: AsyncParsableCommand {
             verbose: verbose || foreground
         )
 
+        // Requests from all connections share one bounded worker pool, so a
+        // slow storage operation for one client does not stall the others
+        let dispatcher = FPCDispatcher(
+            configuration: .init(maxConcurrentRequests: 32, maxInFlightPerConnection: 8, ordering: .perConnection),
+            onError: { error, _ in
+                if verbose {
+                    print("Error handling message: \(error)")
+                }
+            }
+        )
+
         if verbose || foreground {
             print("Accepting connections...")
         }
@@ -209,6 +220,7 @@ struct AgedDaemon: AsyncParsableCommand {
                     await handleConnection(
                         endpoint: endpoint,
                         handler: handler,
+                        dispatcher: dispatcher,
                         verbose: verbose
                     )
                 }
@@ -300,6 +312,7 @@ struct AgedDaemon: AsyncParsableCommand {
     private func handleConnection(
         endpoint: FPCEndpoint,
         handler: RequestHandler,
+        dispatcher: FPCDispatcher,
         verbose: Bool
     ) async {
         // Get peer credentials
@@ -322,19 +335,8 @@ struct AgedDaemon: AsyncParsableCommand {
 
         // Process messages until disconnection
         do {
-            let messages = try await endpoint.incoming()
-            for await message in messages {
-                do {
-                    try await handler.handle(
-                        message: message,
-                        peerCredentials: creds,
-                        endpoint: endpoint
-                    )
-                } catch {
-                    if verbose {
-                        print("Error handling message: \(error)")
-                    }
-                }
+            try await dispatcher.serve(endpoint) { message, _ in
+                await handler.response(to: message, peerCredentials: creds)
             }
         } catch {
             if verbose {
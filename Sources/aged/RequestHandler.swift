@@ -69,31 +69,30 @@ actor RequestHandler {
 
     // MARK: - Request Processing
 
-    /// Handles a request from a client.
+    /// Computes the response to a request from a client.
+    ///
+    /// The caller sends the returned message; see `FPCDispatcher`.
     ///
     /// - Parameters:
     ///   - message: The incoming FPC message
     ///   - peerCredentials: Credentials of the peer process
-    ///   - endpoint: The endpoint to send the response on
-    func handle(
-        message: FPCMessage,
-        peerCredentials: PeerCredentials,
-        endpoint: FPCEndpoint
-    ) async throws {
+    /// - Returns: The response message, correlated with `message`
+    func response(
+        to message: FPCMessage,
+        peerCredentials: PeerCredentials
+    ) async -> FPCMessage {
         // Decode the request
         let request: AgeSignalRequest
         do {
             request = try AgeSignalRequest.from(message: message)
         } catch {
             log("Invalid request from PID \(peerCredentials.pid): \(error)")
-            let response = AgeSignalResponse.error(.invalidRequest)
-            try await endpoint.send(response.toMessage(replyingTo: message))
-            return
+            return AgeSignalResponse.error(.invalidRequest).toMessage(replyingTo: message)
         }
 
         // Process based on request type
         let response = await processRequest(request, from: peerCredentials)
-        try await endpoint.send(response.toMessage(replyingTo: message))
+        return response.toMessage(replyingTo: message)
     }
 
     // MARK: - Authorization
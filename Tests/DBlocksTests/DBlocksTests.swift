@@ -2475,10 +2475,12 @@ struct DBlocksSpeculationTests {
         #expect(AggregationValue.min(-1).asInt == -1)
         #expect(AggregationValue.max(99).asInt == 99)
         #expect(AggregationValue.avg(7).asInt == 7)
-        #expect(AggregationValue.stddev(2).asInt == 2)
-        #expect(AggregationValue.quantize(Data()).asInt == nil)
-        #expect(AggregationValue.lquantize(Data()).asInt == nil)
-        #expect(AggregationValue.llquantize(Data()).asInt == nil)
+        // Values 1 and 3: mean 2, population deviation 1.
+        #expect(AggregationValue.stddev(.init(count: 2, sum: 4, sumOfSquaresLow: 10)).asInt == 1)
+        let empty = AggregationHistogram(layout: .quantize, counts: [])
+        #expect(AggregationValue.quantize(empty).asInt == nil)
+        #expect(AggregationValue.lquantize(empty).asInt == nil)
+        #expect(AggregationValue.llquantize(empty).asInt == nil)
         #expect(AggregationValue.unknown(action: 0, Data()).asInt == nil)
     }
 
@@ -3775,36 +3777,52 @@ struct DBlocksSpeculationScopesTests {
 @Suite("DBlocks Aggregation Decoder Stddev")
 struct DBlocksAggDecoderStddevTests {
 
-    @Test("decodeValue: STDDEV exposes the rolling mean (sum/count)")
+    @Test("decodeValue: STDDEV computes the deviation from (count, sum, sumsq)")
     func testDecodeStddev() {
-        // libdtrace stddev layout: (count, sum, sum_of_squares) — three
-        // Int64 fields. Our decoder surfaces sum/count (the rolling
-        // mean) and ignores the third field, matching the documented
-        // contract in Aggregation.swift.
-        var buf = [UInt8](repeating: 0, count: 24)
+        // libdtrace stddev layout: count, sum, then the 128-bit sum of
+        // squares as low/high words. Samples 10, 20, 30, 40, 50:
+        // mean 30, sumsq 5500, population deviation sqrt(200).
+        var buf = [UInt8](repeating: 0, count: 32)
         buf.withUnsafeMutableBytes { ptr in
             ptr.storeBytes(of: Int64(5),    toByteOffset: 0,  as: Int64.self) // count
             ptr.storeBytes(of: Int64(150),  toByteOffset: 8,  as: Int64.self) // sum
-            ptr.storeBytes(of: Int64(9999), toByteOffset: 16, as: Int64.self) // sum_of_squares (ignored)
+            ptr.storeBytes(of: UInt64(5500), toByteOffset: 16, as: UInt64.self) // sumsq low
         }
         buf.withUnsafeBytes { rawBuf in
-            #expect(AggregationRecord.decodeValue(
+            let value = AggregationRecord.decodeValue(
                 action: UInt16(CDTRACE_AGG_STDDEV.rawValue),
-                offset: 0, size: 24, buffer: rawBuf.baseAddress!
-            ) == .stddev(30))
+                offset: 0, size: 32, buffer: rawBuf.baseAddress!
+            )
+            guard case .stddev(let moments) = value else {
+                Issue.record("expected .stddev, got \(value)")
+                return
+            }
+            #expect(moments.mean == 30)
+            #expect(abs(moments.standardDeviation - 200.0.squareRoot()) < 1e-9)
+            #expect(value.asInt == 14)
         }
     }
 
     @Test("decodeValue: STDDEV with zero count returns 0 (no division)")
     func testDecodeStddevZeroCount() {
-        let buf = [UInt8](repeating: 0, count: 24)
+        let buf = [UInt8](repeating: 0, count: 32)
         buf.withUnsafeBytes { rawBuf in
-            #expect(AggregationRecord.decodeValue(
+            let value = AggregationRecord.decodeValue(
                 action: UInt16(CDTRACE_AGG_STDDEV.rawValue),
-                offset: 0, size: 24, buffer: rawBuf.baseAddress!
-            ) == .stddev(0))
+                offset: 0, size: 32, buffer: rawBuf.baseAddress!
+            )
+            #expect(value == .stddev(.init(count: 0, sum: 0, sumOfSquaresLow: 0)))
+            #expect(value.asInt == 0)
         }
     }
+
+    @Test("Stddev moments merge with a carry into the high word")
+    func testStddevMerge() {
+        let a = AggregationMoments(count: 1, sum: 1, sumOfSquaresLow: .max)
+        let b = AggregationMoments(count: 2, sum: 3, sumOfSquaresLow: 1)
+        #expect(a.merging(b) == AggregationMoments(
+            count: 3, sum: 4, sumOfSquaresLow: 0, sumOfSquaresHigh: 1))
+    }
 }
 
 // MARK: - JSON round-trip + validate() across recent feature surfaces
@@ -5149,3 +5167,412 @@ struct DBlocksEndToEndTests {
                 "expected BEGIN printf in captured output, got: \(output)")
     }
 }
+
+// MARK: - Histogram value decoder
+
+@Suite("DBlocks Aggregation Histograms")
+struct DBlocksAggHistogramTests {
+
+    /// Lays out a record as the kernel would: an optional parameter
+    /// word followed by `int64` counts.
+    private func decode(_ action: cdtrace_agg_action_t, arg: UInt64? = nil, counts: [Int64]) -> AggregationValue {
+        var words: [UInt64] = []
+        if let arg { words.append(arg) }
+        words += counts.map { UInt64(bitPattern: $0) }
+        return words.withUnsafeBytes { raw in
+            AggregationRecord.decodeValue(
+                action: UInt16(action.rawValue),
+                offset: 0, size: raw.count, buffer: raw.baseAddress!
+            )
+        }
+    }
+
+    @Test("quantize buckets follow DTrace's power-of-two bounds")
+    func testQuantizeBounds() {
+        var counts = [Int64](repeating: 0, count: 127)
+        counts[62] = 1   // -1
+        counts[63] = 2   // 0
+        counts[65] = 3   // 2...3
+        counts[74] = 4   // 1024...2047
+        guard case .quantize(let h) = decode(CDTRACE_AGG_QUANTIZE, counts: counts) else {
+            Issue.record("expected .quantize")
+            return
+        }
+        let buckets = h.nonEmptyBuckets
+        #expect(buckets.map(\.range) == [-1...(-1), 0...0, 2...3, 1024...2047])
+        #expect(buckets.map(\.count) == [1, 2, 3, 4])
+        #expect(h.buckets.first?.range == Int64.min...(-(Int64(1) << 62)))
+        #expect(h.buckets.last?.range == (Int64(1) << 62)...Int64.max)
+        #expect(h.totalCount == 10)
+    }
+
+    @Test("lquantize decodes its parameter word and edge buckets")
+    func testLquantizeBounds() {
+        // lquantize(v, 0, 100, 10): base 0, step 10, 10 levels.
+        let arg = (UInt64(10) << 48) | (UInt64(10) << 32) | UInt64(0)
+        var counts = [Int64](repeating: 0, count: 12)
+        counts[0] = 1    // < 0
+        counts[3] = 5    // 20...29
+        counts[11] = 2   // >= 100
+        guard case .lquantize(let h) = decode(CDTRACE_AGG_LQUANTIZE, arg: arg, counts: counts) else {
+            Issue.record("expected .lquantize")
+            return
+        }
+        #expect(h.layout == .linear(base: 0, step: 10, levels: 10))
+        #expect(h.nonEmptyBuckets.map(\.range) == [Int64.min...(-1), 20...29, 100...Int64.max])
+    }
+
+    @Test("lquantize with a negative base keeps the sign")
+    func testLquantizeNegativeBase() {
+        let base = Int32(-50)
+        let arg = (UInt64(25) << 48) | (UInt64(4) << 32) | UInt64(UInt32(bitPattern: base))
+        guard case .lquantize(let h) = decode(CDTRACE_AGG_LQUANTIZE, arg: arg, counts: [0, 1, 0, 0, 0, 0]) else {
+            Issue.record("expected .lquantize")
+            return
+        }
+        #expect(h.layout == .linear(base: -50, step: 25, levels: 4))
+        #expect(h.nonEmptyBuckets.first?.range == -50...(-26))
+    }
+
+    @Test("llquantize buckets split each power of the factor")
+    func testLlquantizeBounds() {
+        // llquantize(v, 10, 0, 1, 10): <1, 1..9 by 1, 10..90 by 10, >=100.
+        let arg = (UInt64(10) << 48) | (UInt64(0) << 32) | (UInt64(1) << 16) | UInt64(10)
+        let layout = AggregationHistogram.Layout.logLinear(factor: 10, low: 0, high: 1, steps: 10)
+        let lower = AggregationHistogram.lowerBounds(for: layout)
+        let expected: [Int64] = [Int64.min, 1, 2, 3, 4, 5, 6, 7, 8, 9,
+                                 10, 20, 30, 40, 50, 60, 70, 80, 90, 100]
+        #expect(lower == expected)
+
+        var counts = [Int64](repeating: 0, count: lower.count)
+        counts[5] = 7    // 5
+        counts[12] = 1   // 30...39
+        guard case .llquantize(let h) = decode(CDTRACE_AGG_LLQUANTIZE, arg: arg, counts: counts) else {
+            Issue.record("expected .llquantize")
+            return
+        }
+        #expect(h.layout == layout)
+        #expect(h.nonEmptyBuckets.map(\.range) == [5...5, 30...39])
+    }
+
+    @Test("A histogram record without its parameter word stays raw")
+    func testTruncatedLquantize() {
+        let v = decode(CDTRACE_AGG_LQUANTIZE, counts: [])
+        guard case .unknown = v else {
+            Issue.record("expected .unknown, got \(v)")
+            return
+        }
+    }
+
+    @Test("Percentiles interpolate inside the bucket that holds the rank")
+    func testPercentiles() {
+        var counts = [Int64](repeating: 0, count: 12)
+        counts[1] = 50   // 0...9
+        counts[2] = 50   // 10...19
+        let h = AggregationHistogram(layout: .linear(base: 0, step: 10, levels: 10), counts: counts)
+        #expect(h.percentile(50) == 9)
+        #expect(h.percentile(75) == 14)
+        #expect(h.percentile(100) == 19)
+        #expect(AggregationHistogram(layout: .quantize, counts: []).percentile(50) == nil)
+    }
+
+    @Test("Histograms merge by layout; mismatched layouts refuse")
+    func testHistogramMerge() {
+        let layout = AggregationHistogram.Layout.linear(base: 0, step: 10, levels: 2)
+        let a = AggregationHistogram(layout: layout, counts: [0, 1, 2, 0])
+        let b = AggregationHistogram(layout: layout, counts: [3, 0, 2, 1])
+        #expect(a.merging(b)?.counts == [3, 1, 4, 1])
+
+        let other = AggregationHistogram(layout: .linear(base: 0, step: 5, levels: 2), counts: [])
+        #expect(a.merging(other) == nil)
+        #expect(AggregationValue.avg(1).merging(.avg(2)) == nil)
+    }
+
+    @Test("Snapshots merge row by row on name and keys")
+    func testSnapshotMerge() {
+        let layout = AggregationHistogram.Layout.linear(base: 0, step: 10, levels: 2)
+        let first = [
+            AggregationRecord(name: "calls", keys: [.string("read")], value: .count(2)),
+            AggregationRecord(name: "lat", keys: [], value: .lquantize(.init(layout: layout, counts: [0, 1, 0, 0]))),
+        ]
+        let second = [
+            AggregationRecord(name: "calls", keys: [.string("read")], value: .count(3)),
+            AggregationRecord(name: "calls", keys: [.string("write")], value: .count(1)),
+            AggregationRecord(name: "lat", keys: [], value: .lquantize(.init(layout: layout, counts: [0, 0, 4, 0]))),
+        ]
+        let merged = AggregationRecord.merge([first, second])
+        #expect(merged.count == 3)
+        #expect(merged[0].value == .count(5))
+        #expect(merged[1].value.histogram?.counts == [0, 1, 4, 0])
+        #expect(merged[2].keys == [.string("write")])
+    }
+}
+
+// MARK: - Delta snapshotter (driven without a live handle)
+
+@Suite("DBlocks Aggregation Snapshotter")
+struct DBlocksAggSnapshotterTests {
+
+    /// `@calls[int64 key] = count()`: key at offset 0, value at 8.
+    private let countLayout = AggregationSnapshotter.Aggregation(
+        name: "calls",
+        keys: [.init(action: 0, offset: 0, size: 8)],
+        value: .init(action: UInt16(CDTRACE_AGG_COUNT.rawValue), offset: 8, size: 8)
+    )
+
+    /// Feeds one row to the snapshotter; returns whether it asked for
+    /// the row to be cleared.
+    @discardableResult
+    private func observe(
+        _ snapshotter: AggregationSnapshotter, _ aggregation: Int, key: Int64, words: [Int64]
+    ) -> Bool {
+        ([key] + words).withUnsafeBytes { raw in
+            snapshotter.observe(aggregation: aggregation, buffer: raw.baseAddress!) == .clear
+        }
+    }
+
+    @Test("Only new and changed rows are reported, with differences")
+    func testChangedRows() {
+        let snapshotter = AggregationSnapshotter()
+        let agg = snapshotter.intern(countLayout)
+
+        #expect(!observe(snapshotter, agg, key: 1, words: [5]))
+        let first = snapshotter.finishScrape()
+        #expect(first == [AggregationDelta(name: "calls", keys: [.int(1)], value: .count(5), change: .count(5), isNew: true)])
+
+        observe(snapshotter, agg, key: 1, words: [5])
+        #expect(snapshotter.finishScrape().isEmpty)
+
+        observe(snapshotter, agg, key: 1, words: [8])
+        observe(snapshotter, agg, key: 2, words: [1])
+        let third = snapshotter.finishScrape()
+        #expect(third.count == 2)
+        #expect(third[0].value == .count(8))
+        #expect(third[0].change == .count(3))
+        #expect(!third[0].isNew)
+        #expect(third[1].keys == [.int(2)])
+        #expect(third[1].isNew)
+        #expect(snapshotter.rowCount == 2)
+    }
+
+    @Test("Clearing mode asks for each reported row to be cleared")
+    func testClearing() {
+        let snapshotter = AggregationSnapshotter(clearing: true)
+        let agg = snapshotter.intern(countLayout)
+
+        #expect(observe(snapshotter, agg, key: 1, words: [5]))
+        _ = snapshotter.finishScrape()
+
+        // The library zeroed the row; two more events since.
+        #expect(observe(snapshotter, agg, key: 1, words: [2]))
+        #expect(snapshotter.finishScrape().map(\.change) == [.count(2)])
+
+        // Idle interval: still zero, nothing reported, nothing to clear.
+        #expect(!observe(snapshotter, agg, key: 1, words: [0]))
+        #expect(snapshotter.finishScrape().isEmpty)
+    }
+
+    @Test("Cleared lquantize rows keep their parameter word")
+    func testClearingKeepsLquantizeParameters() {
+        let snapshotter = AggregationSnapshotter(clearing: true)
+        let agg = snapshotter.intern(.init(
+            name: "lat",
+            keys: [.init(action: 0, offset: 0, size: 8)],
+            value: .init(action: UInt16(CDTRACE_AGG_LQUANTIZE.rawValue), offset: 8, size: 40)
+        ))
+        // base 0, step 10, 2 levels: parameter word + 4 buckets.
+        let arg = Int64(bitPattern: (UInt64(10) << 48) | (UInt64(2) << 32))
+
+        observe(snapshotter, agg, key: 7, words: [arg, 0, 3, 0, 0])
+        _ = snapshotter.finishScrape()
+        #expect(!observe(snapshotter, agg, key: 7, words: [arg, 0, 0, 0, 0]))
+        #expect(snapshotter.finishScrape().isEmpty)
+    }
+
+    @Test("The table grows and still finds every row")
+    func testGrowth() {
+        let snapshotter = AggregationSnapshotter(capacity: 1)
+        let agg = snapshotter.intern(countLayout)
+
+        for key in 0..<500 {
+            observe(snapshotter, agg, key: Int64(key), words: [1])
+        }
+        #expect(snapshotter.finishScrape().count == 500)
+
+        for key in 0..<500 {
+            observe(snapshotter, agg, key: Int64(key), words: [key == 250 ? 2 : 1])
+        }
+        let deltas = snapshotter.finishScrape()
+        #expect(deltas.map(\.keys) == [[.int(250)]])
+        #expect(snapshotter.rowCount == 500)
+
+        snapshotter.reset()
+        #expect(snapshotter.rowCount == 0)
+    }
+}
+
+@Suite("DBlocks Script Cache")
+struct DBlocksCacheTests {
+
+    private func makeCache() -> DBlocksCache {
+        let directory = FileManager.default.temporaryDirectory
+            .appendingPathComponent("dblocks-cache-\(UUID().uuidString)")
+        return DBlocksCache(directory: directory)
+    }
+
+    private let script = DBlocks {
+        Probe("syscall:::entry") { Count(by: "probefunc") }
+    }
+
+    @Test("A hit returns the stored source without calling the generator")
+    func testHit() throws {
+        let cache = makeCache()
+        defer { try? FileManager.default.removeItem(at: cache.directory) }
+
+        var calls = 0
+        let first = try cache.entry(for: "counts") { calls += 1; return script }
+        let second = try cache.entry(for: "counts") { calls += 1; return script }
+
+        #expect(calls == 1)
+        #expect(!first.isCached)
+        #expect(second.isCached)
+        #expect(second.source == script.source)
+        #expect(try second.script().source == script.source)
+    }
+
+    @Test("Options are part of the key")
+    func testOptions() throws {
+        let cache = makeCache()
+        defer { try? FileManager.default.removeItem(at: cache.directory) }
+
+        var calls = 0
+        _ = try cache.entry(for: "counts", options: ["target": "all"]) { calls += 1; return script }
+        _ = try cache.entry(for: "counts", options: ["target": "pid 1"]) { calls += 1; return script }
+        _ = try cache.entry(for: "counts", options: ["target": "all"]) { calls += 1; return script }
+        #expect(calls == 2)
+    }
+
+    @Test("A corrupted source is regenerated")
+    func testCorruption() throws {
+        let cache = makeCache()
+        defer { try? FileManager.default.removeItem(at: cache.directory) }
+
+        _ = try cache.entry(for: "counts") { script }
+        let name = DBlocksCache.fileName(key: "counts", options: [:])
+        let sourceURL = cache.directory.appendingPathComponent(name + ".d")
+        try Data("syscall:::entry {".utf8).write(to: sourceURL)
+
+        let entry = try cache.entry(for: "counts") { script }
+        #expect(!entry.isCached)
+        #expect(entry.source == script.source)
+        #expect(try String(contentsOf: sourceURL, encoding: .utf8) == script.source)
+    }
+
+    @Test("Invalid scripts throw and are not stored")
+    func testInvalid() throws {
+        let cache = makeCache()
+        defer { try? FileManager.default.removeItem(at: cache.directory) }
+
+        #expect(throws: DBlocksError.self) {
+            try cache.entry(for: "empty") { DBlocks() }
+        }
+        let name = DBlocksCache.fileName(key: "empty", options: [:])
+        #expect(!FileManager.default.fileExists(
+            atPath: cache.directory.appendingPathComponent(name + ".manifest").path
+        ))
+    }
+
+    @Test("Lint warnings are stored with the entry")
+    func testWarnings() throws {
+        let cache = makeCache()
+        defer { try? FileManager.default.removeItem(at: cache.directory) }
+
+        let linted = DBlocks {
+            Probe("profile-997") { Exit(0) }
+        }
+        let first = try cache.entry(for: "linted") { linted }
+        let second = try cache.entry(for: "linted") { linted }
+        #expect(!first.warnings.isEmpty)
+        #expect(second.warnings == first.warnings)
+    }
+
+    @Test("The directory is private to this user")
+    func testDirectoryMode() throws {
+        let cache = makeCache()
+        defer { try? FileManager.default.removeItem(at: cache.directory) }
+
+        _ = try cache.entry(for: "counts") { script }
+        let attributes = try FileManager.default.attributesOfItem(atPath: cache.directory.path)
+        #expect((attributes[.posixPermissions] as? NSNumber)?.intValue == 0o700)
+
+        let name = DBlocksCache.fileName(key: "counts", options: [:])
+        let manifest = cache.directory.appendingPathComponent(name + ".manifest").path
+        let fileAttributes = try FileManager.default.attributesOfItem(atPath: manifest)
+        #expect((fileAttributes[.posixPermissions] as? NSNumber)?.intValue == 0o600)
+    }
+
+    @Test("Files writable by others are not trusted")
+    func testWritableFile() throws {
+        let cache = makeCache()
+        defer { try? FileManager.default.removeItem(at: cache.directory) }
+
+        _ = try cache.entry(for: "counts") { script }
+        let name = DBlocksCache.fileName(key: "counts", options: [:])
+        let sourcePath = cache.directory.appendingPathComponent(name + ".d").path
+        try FileManager.default.setAttributes([.posixPermissions: 0o666], ofItemAtPath: sourcePath)
+
+        var calls = 0
+        let entry = try cache.entry(for: "counts") { calls += 1; return script }
+        #expect(!entry.isCached)
+        #expect(calls == 1)
+    }
+
+    @Test("A directory writable by others is never read or written")
+    func testWritableDirectory() throws {
+        let cache = makeCache()
+        defer { try? FileManager.default.removeItem(at: cache.directory) }
+
+        try FileManager.default.createDirectory(
+            at: cache.directory,
+            withIntermediateDirectories: true,
+            attributes: [.posixPermissions: 0o777]
+        )
+        try FileManager.default.setAttributes([.posixPermissions: 0o777], ofItemAtPath: cache.directory.path)
+
+        var calls = 0
+        _ = try cache.entry(for: "counts") { calls += 1; return script }
+        _ = try cache.entry(for: "counts") { calls += 1; return script }
+        #expect(calls == 2)
+        #expect(try FileManager.default.contentsOfDirectory(atPath: cache.directory.path).isEmpty)
+    }
+
+    @Test("removeAll leaves files the cache did not name")
+    func testRemoveAll() throws {
+        let cache = makeCache()
+        defer { try? FileManager.default.removeItem(at: cache.directory) }
+
+        _ = try cache.entry(for: "counts") { script }
+        let others = ["notes.json", "settings.d", "0123456789abcdef.txt", "0123456789abcdeg.json"]
+        for file in others {
+            try Data().write(to: cache.directory.appendingPathComponent(file))
+        }
+
+        try cache.removeAll()
+        let remaining = try FileManager.default.contentsOfDirectory(atPath: cache.directory.path)
+        #expect(Set(remaining) == Set(others))
+    }
+
+    @Test("File names depend on the cache and library versions")
+    func testVersionedNames() {
+        let unversioned = DBlocksCache.fingerprint(Data("counts".utf8))
+        #expect(DBlocksCache.fileName(key: "counts", options: [:]) != unversioned)
+        #expect(DBlocksCache.isCacheFile(URL(fileURLWithPath: "/c/\(unversioned).manifest")))
+        #expect(!DBlocksCache.isCacheFile(URL(fileURLWithPath: "/c/\(unversioned).txt")))
+    }
+
+    @Test("Fingerprints are stable FNV-1a")
+    func testFingerprint() {
+        #expect(DBlocksCache.fingerprint(Data()) == "cbf29ce484222325")
+        #expect(DBlocksCache.fingerprint(Data("a".utf8)) == "af63dc4c8601ec8c")
+    }
+}
@@ -6,6 +6,7 @@
 
 import Testing
 @testable import DTraceCore
+import CDTrace
 import Glibc
 
 
@@ -423,6 +424,26 @@ struct DTraceHandleIntegrationTests {
         #expect(Bool(true))  // If we get here, registration succeeded
     }
 
+    @Test("Cached compiles reuse programs until an option changes")
+    func testCompileCached() throws {
+        guard getuid() == 0 else {
+            print("Skipping testCompileCached: requires root privileges")
+            return
+        }
+
+        let handle = try DTraceHandle.open()
+        let source = "BEGIN { exit(0); }"
+        let first = try handle.compileCached(source)
+        let second = try handle.compileCached(source)
+        #expect(first.unsafeProgram() == second.unsafeProgram())
+        #expect(handle.cachedProgramCount == 1)
+
+        try handle.setOption("strsize", value: "512")
+        let third = try handle.compileCached(source)
+        #expect(third.unsafeProgram() != first.unsafeProgram())
+        #expect(handle.cachedProgramCount == 2)
+    }
+
     @Test("Aggregate walk with empty aggregations")
     func testAggregateWalkAPI() throws {
         guard getuid() == 0 else {
@@ -457,3 +478,197 @@ struct DTraceHandleIntegrationTests {
         #expect(count == 0)  // No aggregations in this simple program
     }
 }
+
+@Suite("DTraceCore Record Stream Tests")
+struct DTraceRecordStreamTests {
+
+    private func decode(_ action: cdtrace_act_kind_t, _ bytes: [UInt8], format: UInt16 = 0) -> DTraceRecordValue? {
+        bytes.withUnsafeBytes { buffer in
+            DTraceRecordValue.decode(
+                action: UInt16(action.rawValue),
+                size: bytes.count,
+                format: format,
+                data: buffer.baseAddress!
+            )
+        }
+    }
+
+    private func words(_ values: [UInt64]) -> [UInt8] {
+        values.flatMap { value in (0..<8).map { UInt8(truncatingIfNeeded: value >> ($0 * 8)) } }
+    }
+
+    @Test("trace() records decode as signed integers, strings, or bytes")
+    func decodeTrace() {
+        #expect(decode(CDTRACE_ACT_DIFEXPR, [0xff]) == .int(-1))
+        #expect(decode(CDTRACE_ACT_DIFEXPR, [0x34, 0x12]) == .int(0x1234))
+        #expect(decode(CDTRACE_ACT_DIFEXPR, [0xfe, 0xff, 0xff, 0xff]) == .int(-2))
+        #expect(decode(CDTRACE_ACT_DIFEXPR, words([42])) == .int(42))
+        #expect(decode(CDTRACE_ACT_DIFEXPR, Array("sshd".utf8) + [0, 0, 0, 0, 0, 0]) == .string("sshd"))
+        #expect(decode(CDTRACE_ACT_DIFEXPR, [1, 2, 3, 0, 5]) == .bytes([1, 2, 3, 0, 5]))
+        #expect(decode(CDTRACE_ACT_DIFEXPR, [0, 0, 0]) == .bytes([0, 0, 0]))
+    }
+
+    @Test("Action records decode by kind; exit() records are skipped")
+    func decodeActions() {
+        #expect(decode(CDTRACE_ACT_EXIT, [0, 0, 0, 0]) == nil)
+        #expect(decode(CDTRACE_ACT_PRINTF, [], format: 3) ==
+            .format(action: UInt16(CDTRACE_ACT_PRINTF.rawValue), index: 3))
+        #expect(decode(CDTRACE_ACT_STACK, words([0xa0, 0xb0, 0, 0])) == .stack([0xa0, 0xb0]))
+        #expect(decode(CDTRACE_ACT_USTACK, words([1234, 0xc0, 0, 0])) == .userStack(pid: 1234, frames: [0xc0]))
+        #expect(decode(CDTRACE_ACT_SYM, words([0xd0])) == .address(0xd0))
+        #expect(decode(CDTRACE_ACT_UADDR, words([1234, 0xe0])) == .address(0xe0))
+    }
+
+    @Test("Events are grouped into batches of batchSize, flushed on demand")
+    func batching() async {
+        let stream = DTraceRecordStream(batchSize: 2)
+        for i in 0..<3 {
+            stream.begin(cpu: Int32(i), pdesc: nil)
+            let value = words([UInt64(i)])
+            value.withUnsafeBytes {
+                stream.record(action: UInt16(CDTRACE_ACT_DIFEXPR.rawValue), size: 8, format: 0, data: $0.baseAddress!)
+            }
+            let exit: [UInt8] = [0, 0, 0, 0]
+            exit.withUnsafeBytes {
+                stream.record(action: UInt16(CDTRACE_ACT_EXIT.rawValue), size: 4, format: 0, data: $0.baseAddress!)
+            }
+            stream.end()
+        }
+        stream.finish()
+
+        var batches: [DTraceRecordBatch] = []
+        for await batch in stream.batches {
+            batches.append(batch)
+        }
+        #expect(batches.map(\.count) == [2, 1])
+        #expect(batches[0][1].cpu == 1)
+        #expect(Array(batches[0][1].values) == [.int(1)])
+        #expect(Array(batches[1][0].values) == [.int(2)])
+        #expect(stream.droppedBatches == 0)
+    }
+
+    @Test("Printf-like records that carry data yield their first argument")
+    func printfArgument() async {
+        let stream = DTraceRecordStream(batchSize: 8)
+        stream.begin(cpu: 0, pdesc: nil)
+        let argument = words([7])
+        argument.withUnsafeBytes {
+            stream.record(action: UInt16(CDTRACE_ACT_PRINTF.rawValue), size: 8, format: 1, data: $0.baseAddress!)
+        }
+        stream.end()
+        stream.finish()
+
+        var values: [DTraceRecordValue] = []
+        for await batch in stream.batches {
+            values += batch.values
+        }
+        #expect(values == [.format(action: UInt16(CDTRACE_ACT_PRINTF.rawValue), index: 1), .int(7)])
+    }
+
+    @Test("Batches beyond the buffer are dropped and counted")
+    func dropping() {
+        let stream = DTraceRecordStream(batchSize: 1, bufferedBatches: 1)
+        for _ in 0..<3 {
+            stream.begin(cpu: 0, pdesc: nil)
+            stream.end()
+        }
+        #expect(stream.droppedBatches == 2)
+        #expect(stream.droppedEvents == 2)
+    }
+}
+
+@Suite("DTraceCore Consumer Tests")
+struct DTraceConsumerTests {
+
+    private func batch(events: Int) -> DTraceRecordBatch {
+        var batch = DTraceRecordBatch(capacity: events)
+        for i in 0..<events {
+            batch.begin(cpu: Int32(i), probe: DTraceProbeDescription(provider: "p", module: "m", function: "f", name: "n"))
+        }
+        return batch
+    }
+
+    @Test("Drops double the switch rate, then the recommended buffer size")
+    func rateIncreasesOnDrops() {
+        var controller = DTraceRateController(configuration: .init(
+            bufferSize: 1 << 20, maximumBufferSize: 4 << 20,
+            switchRate: 100, maximumSwitchRate: 400
+        ))
+        controller.update(events: 10, drops: 5)
+        #expect(controller.switchRate == 200)
+        controller.update(events: 10, drops: 5)
+        #expect(controller.switchRate == 400)
+        #expect(controller.recommendedBufferSize == 1 << 20)
+
+        controller.update(events: 10, drops: 5)
+        controller.update(events: 10, drops: 5)
+        controller.update(events: 10, drops: 5)
+        #expect(controller.switchRate == 400)
+        #expect(controller.recommendedBufferSize == 4 << 20)
+    }
+
+    @Test("Consecutive empty polls halve the switch rate down to the minimum")
+    func rateDecaysWhenIdle() {
+        var controller = DTraceRateController(configuration: .init(
+            switchRate: 40, minimumSwitchRate: 10, idlePollsBeforeSlowdown: 2
+        ))
+        controller.update(events: 0, drops: 0)
+        controller.update(events: 1, drops: 0)
+        controller.update(events: 0, drops: 0)
+        #expect(controller.switchRate == 40)
+        controller.update(events: 0, drops: 0)
+        #expect(controller.switchRate == 20)
+        for _ in 0..<10 {
+            controller.update(events: 0, drops: 0)
+        }
+        #expect(controller.switchRate == 10)
+    }
+
+    @Test("An unset buffer size and switch rate fall back to the defaults")
+    func rateDefaults() {
+        let controller = DTraceRateController(configuration: .init(minimumSwitchRate: 1))
+        #expect(controller.switchRate == DTraceConsumer.Configuration.defaultSwitchRate)
+        #expect(controller.recommendedBufferSize == DTraceConsumer.Configuration.defaultBufferSize)
+    }
+
+    @Test("Queue is bounded, FIFO, and rounds its capacity up")
+    func queueBounds() {
+        let queue = DTraceBatchQueue(capacity: 3)
+        #expect(queue.capacity == 4)
+        for i in 1...4 {
+            #expect(queue.enqueue(batch(events: i)))
+        }
+        #expect(!queue.enqueue(batch(events: 5)))
+        #expect(queue.count == 4)
+        #expect(queue.dequeue()?.count == 1)
+        #expect(queue.enqueue(batch(events: 5)))
+        #expect((2...5).map { _ in queue.dequeue()?.count ?? 0 } == [2, 3, 4, 5])
+        #expect(queue.dequeue() == nil)
+        #expect(queue.count == 0)
+    }
+
+    @Test("Queue hands batches across threads in order")
+    func queueAcrossThreads() async {
+        let queue = DTraceBatchQueue(capacity: 8)
+        let total = 2000
+        let producer = Task.detached {
+            var next = 1
+            while next <= total {
+                if queue.enqueue(batch(events: next % 7 + 1)) {
+                    next += 1
+                }
+            }
+        }
+
+        var received: [Int] = []
+        while received.count < total {
+            if let batch = queue.dequeue() {
+                received.append(batch.count)
+            } else {
+                await Task.yield()
+            }
+        }
+        await producer.value
+        #expect(received == (1...total).map { $0 % 7 + 1 })
+    }
+}
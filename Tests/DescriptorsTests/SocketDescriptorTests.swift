@@ -97,6 +97,42 @@ final class SocketDescriptorTests: XCTestCase {
             XCTFail("Expected EOF after shutdown")
         }
     }
+
+    func testRecvMultipleReturnsPrefixAndClosesRejectedDescriptors() throws {
+        let pair = try SystemSocketDescriptor.socketPair(
+            domain: .unix,
+            type: .seqpacket,
+            protocol: .default
+        )
+        defer {
+            pair.first.close()
+            pair.second.close()
+        }
+
+        var pipeFDs: [Int32] = [-1, -1]
+        XCTAssertEqual(Glibc.pipe(&pipeFDs), 0)
+        defer { Glibc.close(pipeFDs[0]) }
+        _ = Glibc.fcntl(pipeFDs[0], F_SETFL, O_NONBLOCK)
+
+        // The second record overflows its 16-byte slot; the third carries the
+        // only remaining reference to the pipe's write end.
+        try pair.first.sendDescriptors([], payload: Data("first".utf8))
+        try pair.first.sendDescriptors([], payload: Data(repeating: 0, count: 64))
+        try pair.first.sendDescriptors([OpaqueDescriptorRef(pipeFDs[1])], payload: Data("third".utf8))
+
+        let batch = RecvBatchBuffer(capacity: 4, recordSize: 16)
+        let records = try pair.second.recvMultipleWithCredentials(into: batch)
+        XCTAssertEqual(records.count, 1)
+        XCTAssertEqual(Data(batch.bytes(at: 0, count: records[0].byteCount)), Data("first".utf8))
+
+        XCTAssertThrowsError(try pair.second.recvMultipleWithCredentials(into: batch)) { error in
+            XCTAssertEqual((error as? POSIXError)?.code, .EMSGSIZE)
+        }
+
+        // Every write end is closed, so the pipe reads EOF instead of EAGAIN
+        var byte: UInt8 = 0
+        XCTAssertEqual(Glibc.read(pipeFDs[0], &byte, 1), 0)
+    }
 }
 
 // Concrete implementation for testing
@@ -58,6 +58,9 @@ final class BPCTests: XCTestCase {
         XCTAssertEqual(MessageID.subscribe.rawValue, 5)
         XCTAssertEqual(MessageID.subscribeAck.rawValue, 6)
         XCTAssertEqual(MessageID.event.rawValue, 7)
+        XCTAssertEqual(MessageID.slabPoolOffer.rawValue, 8)
+        XCTAssertEqual(MessageID.slabCredit.rawValue, 9)
+        XCTAssertEqual(MessageID.frameVersionOffer.rawValue, 10)
         XCTAssertEqual(MessageID.error.rawValue, 255)
     }
 
@@ -233,6 +236,35 @@ final class BPCTests: XCTestCase {
         XCTAssertEqual(original, decoded)
     }
 
+    func testWireHeaderEncodeIntoRawBuffer() throws {
+        let header = FPCFrameHeader(
+            messageID: 99,
+            correlationID: 0x0102030405060708,
+            payloadLength: 60_000,
+            descriptorCount: 3,
+            flags: FPCFrameLayout.flagOOLPayload
+        )
+
+        // Pre-fill with garbage to verify reserved bytes are zeroed
+        var raw = [UInt8](repeating: 0xEE, count: FPCFrameLayout.headerSize)
+        raw.withUnsafeMutableBytes { header.encode(into: $0) }
+
+        XCTAssertEqual(Data(raw), header.encode())
+        XCTAssertTrue(raw[19...].allSatisfy { $0 == 0 })
+
+        let decoded = try raw.withUnsafeBytes { try FPCFrameHeader.decode(from: $0) }
+        XCTAssertEqual(decoded, header)
+    }
+
+    func testWireHeaderDecodeFromDataSlice() throws {
+        let header = FPCFrameHeader(messageID: 5, correlationID: 6, payloadLength: 0, descriptorCount: 1)
+        let padded = Data([0xAA, 0xBB]) + header.encode()
+
+        // Slices keep their parent's indices; decoding must still start at the slice
+        let decoded = try FPCFrameHeader.decode(from: padded[2...])
+        XCTAssertEqual(decoded, header)
+    }
+
     // MARK: - WireHeader Validation
 
     func testWireHeaderValidateSuccess() throws {
@@ -264,6 +296,26 @@ final class BPCTests: XCTestCase {
         }
     }
 
+    func testWireHeaderValidateRejectsCompactVersion() {
+        // Version 1 frames use the compact layout, never the 256-byte header
+        let header = FPCFrameHeader(
+            messageID: 1,
+            correlationID: 0,
+            payloadLength: 0,
+            descriptorCount: 0,
+            version: FPCFrameLayout.compactVersion
+        )
+
+        XCTAssertThrowsError(try header.validate()) { error in
+            if case FPCError.unsupportedVersion(let v) = error {
+                XCTAssertEqual(v, FPCFrameLayout.compactVersion)
+            } else {
+                XCTFail("Expected unsupportedVersion error")
+            }
+        }
+        XCTAssertNoThrow(try FPCCompactHeader(header: header, descriptorKinds: FPCFrameTrailer(descriptorKinds: [])).validate())
+    }
+
     func testWireHeaderValidateTooManyDescriptors() {
         let header = FPCFrameHeader(
             messageID: 1,
@@ -305,6 +357,288 @@ final class BPCTests: XCTestCase {
         }
     }
 
+    func testWireHeaderValidateSlabPayload() throws {
+        let header = FPCFrameHeader(
+            messageID: 1,
+            correlationID: 0,
+            payloadLength: UInt32(FPCSlabReference.encodedSize),
+            descriptorCount: 0,
+            flags: FPCFrameLayout.flagSlabPayload
+        )
+
+        XCTAssertTrue(header.hasSlabPayload)
+        XCTAssertNoThrow(try header.validate())
+    }
+
+    func testWireHeaderValidateSlabPayloadWrongLength() {
+        let header = FPCFrameHeader(
+            messageID: 1,
+            correlationID: 0,
+            payloadLength: 100,  // Must be exactly one slab reference
+            descriptorCount: 0,
+            flags: FPCFrameLayout.flagSlabPayload
+        )
+
+        XCTAssertThrowsError(try header.validate()) { error in
+            XCTAssertEqual(error as? FPCError, FPCError.invalidMessageFormat)
+        }
+    }
+
+    func testWireHeaderValidateSlabAndOOLExclusive() {
+        let header = FPCFrameHeader(
+            messageID: 1,
+            correlationID: 0,
+            payloadLength: 0,
+            descriptorCount: 1,
+            flags: FPCFrameLayout.flagOOLPayload | FPCFrameLayout.flagSlabPayload
+        )
+
+        XCTAssertThrowsError(try header.validate()) { error in
+            XCTAssertEqual(error as? FPCError, FPCError.invalidMessageFormat)
+        }
+    }
+
+    // MARK: - Slab Pool
+
+    func testSlabReferenceRoundTrip() throws {
+        let original = FPCSlabReference(index: 7, length: 1_048_576)
+        let data = original.encode()
+
+        XCTAssertEqual(data.count, FPCSlabReference.encodedSize)
+        XCTAssertEqual(try FPCSlabReference.decode(from: data), original)
+    }
+
+    func testSlabReferenceDecodeWrongSize() {
+        XCTAssertThrowsError(try FPCSlabReference.decode(from: Data(count: 4))) { error in
+            XCTAssertEqual(error as? FPCError, FPCError.invalidMessageFormat)
+        }
+    }
+
+    func testSlabConfigurationRoundTrip() throws {
+        let original = FPCSlabConfiguration(slabSize: 65536, slabCount: 4)
+        XCTAssertEqual(try FPCSlabConfiguration.decode(from: original.encode()), original)
+        XCTAssertEqual(original.totalSize, 262144)
+    }
+
+    func testSlabConfigurationRejectsEmptyPool() {
+        let empty = FPCSlabConfiguration(slabSize: 4096, slabCount: 0)
+        XCTAssertThrowsError(try FPCSlabConfiguration.decode(from: empty.encode()))
+    }
+
+    func testSlabConfigurationRejectsOverflowingOffer() {
+        // slabSize = slabCount = UInt32.max: the product overflows Int
+        let hostile = Data(repeating: 0xFF, count: FPCSlabConfiguration.encodedSize)
+        XCTAssertThrowsError(try FPCSlabConfiguration.decode(from: hostile)) { error in
+            XCTAssertEqual(error as? FPCError, FPCError.invalidMessageFormat)
+        }
+    }
+
+    func testSlabConfigurationRejectsOversizedOffer() {
+        let oversized = FPCSlabConfiguration(slabSize: 1 << 20, slabCount: 4096)
+        XCTAssertThrowsError(try FPCSlabConfiguration.decode(from: oversized.encode())) { error in
+            XCTAssertEqual(error as? FPCError, FPCError.invalidMessageFormat)
+        }
+    }
+
+    func testSlabPoolAcquireRelease() throws {
+        let (pool, _) = try FPCSlabPool.create(configuration: FPCSlabConfiguration(slabSize: 4096, slabCount: 2))
+
+        let first = pool.acquire()
+        let second = pool.acquire()
+        XCTAssertEqual(first, 0)
+        XCTAssertEqual(second, 1)
+        XCTAssertNil(pool.acquire())
+
+        pool.release([1, 99])  // Out-of-range indices are ignored
+        XCTAssertEqual(pool.availableCount, 1)
+        XCTAssertEqual(pool.acquire(), 1)
+    }
+
+    func testSlabPoolIgnoresCreditsForSlabsNotInFlight() throws {
+        let (pool, _) = try FPCSlabPool.create(configuration: FPCSlabConfiguration(slabSize: 4096, slabCount: 2))
+
+        // Never handed out
+        XCTAssertEqual(pool.release([0, 1]), 0)
+        XCTAssertEqual(pool.availableCount, 2)
+
+        let index = try XCTUnwrap(pool.acquire())
+        XCTAssertEqual(pool.release([index, index]), 1)  // Duplicate in one credit
+        XCTAssertEqual(pool.release([index]), 0)         // Duplicate credit
+        XCTAssertEqual(pool.availableCount, 2)
+
+        // Each slab is handed out once
+        let first = pool.acquire()
+        let second = pool.acquire()
+        XCTAssertNotNil(first)
+        XCTAssertNotNil(second)
+        XCTAssertNotEqual(first, second)
+        XCTAssertNil(pool.acquire())
+    }
+
+    // MARK: - Receive Buffer Pool
+
+    func testReceiveBufferPoolRecyclesBuffers() {
+        let pool = FPCReceiveBufferPool(bufferSize: 1024)
+
+        let first = pool.acquire()
+        XCTAssertEqual(first.count, 1024)
+        pool.release(first)
+
+        let second = pool.acquire()
+        XCTAssertEqual(second.baseAddress, first.baseAddress)
+        pool.release(second)
+    }
+
+    func testReceiveBufferPoolAdoptReturnsBufferOnRelease() {
+        let pool = FPCReceiveBufferPool(bufferSize: 1024)
+        let buffer = pool.acquire()
+        for i in 0..<16 { buffer[i] = UInt8(i) }
+
+        var payload: Data? = pool.adopt(buffer, payload: UnsafeRawBufferPointer(rebasing: buffer[4..<12]))
+        XCTAssertEqual(payload, Data((4..<12).map { UInt8($0) }))
+
+        // While the payload is alive the buffer is not handed out again
+        let other = pool.acquire()
+        XCTAssertNotEqual(other.baseAddress, buffer.baseAddress)
+        pool.release(other)
+
+        payload = nil
+        let reused = [pool.acquire(), pool.acquire()].map(\.baseAddress)
+        XCTAssertTrue(reused.contains(buffer.baseAddress))
+    }
+
+    // MARK: - Correlation Table
+
+    func testCorrelationTableInsertLookupRemove() {
+        var table = CorrelationTable<String>(capacity: 4)
+        table.insert("a", for: 1)
+        table.insert("b", for: 2)
+
+        XCTAssertEqual(table.count, 2)
+        XCTAssertEqual(table.value(forKey: 1), "a")
+        XCTAssertEqual(table.removeValue(forKey: 2), "b")
+        XCTAssertNil(table.value(forKey: 2))
+        XCTAssertNil(table.removeValue(forKey: 99))
+        XCTAssertEqual(table.count, 1)
+    }
+
+    func testCorrelationTableGrowsAndKeepsProbeRunsIntact() {
+        var table = CorrelationTable<UInt64>(capacity: 4)
+        for id in UInt64(1)...10_000 {
+            table.insert(id * 2, for: id)
+        }
+        // Remove every third entry, exercising backward-shift deletion
+        for id in stride(from: UInt64(3), through: 10_000, by: 3) {
+            XCTAssertEqual(table.removeValue(forKey: id), id * 2)
+        }
+        for id in UInt64(1)...10_000 {
+            XCTAssertEqual(table.value(forKey: id), id % 3 == 0 ? nil : id * 2)
+        }
+        XCTAssertEqual(table.removeAll().count, 6_667)
+        XCTAssertTrue(table.isEmpty)
+    }
+
+    // MARK: - Timer Wheel
+
+    func testTimerWheelExpiresInDeadlineOrder() {
+        let origin = ContinuousClock.now
+        var wheel = TimerWheel(slotCount: 8, origin: origin)
+        wheel.schedule(1, after: .milliseconds(20), now: origin)
+        wheel.schedule(2, after: .milliseconds(50), now: origin)
+        wheel.schedule(3, after: .seconds(1), now: origin)   // Wraps the 8-slot wheel
+
+        XCTAssertEqual(wheel.advance(to: origin + .milliseconds(10)), [])
+        XCTAssertEqual(wheel.advance(to: origin + .milliseconds(25)), [1])
+        XCTAssertEqual(wheel.advance(to: origin + .milliseconds(500)), [2])
+        XCTAssertEqual(wheel.count, 1)
+        XCTAssertEqual(wheel.advance(to: origin + .seconds(2)), [3])
+        XCTAssertTrue(wheel.isEmpty)
+    }
+
+    func testTimerWheelCancelRemovesEntry() {
+        let origin = ContinuousClock.now
+        var wheel = TimerWheel(slotCount: 8, origin: origin)
+        let first = wheel.schedule(1, after: .milliseconds(20), now: origin)
+        let second = wheel.schedule(2, after: .milliseconds(20), now: origin)
+
+        XCTAssertTrue(wheel.cancel(1, deadline: first))
+        XCTAssertFalse(wheel.cancel(1, deadline: first))
+        XCTAssertEqual(wheel.count, 1)
+        XCTAssertEqual(wheel.advance(to: origin + .milliseconds(30)), [2])
+        XCTAssertFalse(wheel.cancel(2, deadline: second))
+        XCTAssertTrue(wheel.isEmpty)
+    }
+
+    func testTimerWheelCancelsWithinOneCrowdedBucket() {
+        let origin = ContinuousClock.now
+        var wheel = TimerWheel(slotCount: 8, origin: origin)
+        var deadlines: [UInt64: UInt64] = [:]
+        for id in UInt64(1)...1000 {
+            deadlines[id] = wheel.schedule(id, after: .milliseconds(20), now: origin)
+        }
+
+        // Cancel out of order so entries are swapped into the holes
+        for id in UInt64(1)...1000 where id % 3 != 0 {
+            XCTAssertTrue(wheel.cancel(id, deadline: deadlines[id]!))
+        }
+        XCTAssertFalse(wheel.cancel(1, deadline: deadlines[1]!))
+        XCTAssertEqual(wheel.count, 333)
+
+        let expired = wheel.advance(to: origin + .milliseconds(30))
+        XCTAssertEqual(Set(expired), Set((UInt64(1)...1000).filter { $0 % 3 == 0 }))
+        XCTAssertTrue(wheel.isEmpty)
+    }
+
+    func testTimerWheelNeverFiresEarly() {
+        let origin = ContinuousClock.now
+        var wheel = TimerWheel(origin: origin)
+        wheel.schedule(1, after: .milliseconds(15), now: origin)
+
+        // Rounded up to the 20ms tick
+        XCTAssertEqual(wheel.advance(to: origin + .milliseconds(19)), [])
+        XCTAssertEqual(wheel.advance(to: origin + .milliseconds(20)), [1])
+    }
+
+    // MARK: - Message Credential Cache
+
+    private let sampleCredentials = SocketCredentials(
+        realUID: 1001, effectiveUID: 1001, realGID: 20, effectiveGID: 20, pid: 4242, groups: [20, 0, 5]
+    )
+
+    func testCredentialCacheDisabledByDefault() {
+        let cache = MessageCredentialCache()
+        XCTAssertNil(cache.socketCredentialCache)
+        XCTAssertNil(cache.messageCredentials(nil))
+
+        let converted = cache.messageCredentials(sampleCredentials)
+        XCTAssertEqual(converted?.pid, 4242)
+        XCTAssertEqual(converted?.groups, [20, 0, 5])
+    }
+
+    func testCredentialCacheReusesUnchangedCredentials() {
+        let cache = MessageCredentialCache()
+        cache.configure(.cached)
+        XCTAssertNotNil(cache.socketCredentialCache)
+
+        let first = cache.messageCredentials(sampleCredentials)
+        let second = cache.messageCredentials(sampleCredentials)
+        XCTAssertEqual(first, second)
+
+        let changed = SocketCredentials(
+            realUID: 1001, effectiveUID: 0, realGID: 20, effectiveGID: 20, pid: 4242, groups: [20, 0, 5]
+        )
+        let third = cache.messageCredentials(changed)
+        XCTAssertEqual(third?.effectiveUID, 0)
+        XCTAssertEqual(third?.isSetuid, true)
+    }
+
+    func testCredentialCacheConnectionOnlyDisablesCaching() {
+        let cache = MessageCredentialCache()
+        cache.configure(.cached)
+        cache.configure(.connectionOnly)
+        XCTAssertNil(cache.socketCredentialCache)
+    }
+
     // MARK: - WireTrailer Encoding
 
     func testWireTrailerEncodeEmpty() {
@@ -334,6 +668,20 @@ final class BPCTests: XCTestCase {
         XCTAssertEqual(data[1], 1)    // file
     }
 
+    func testWireTrailerEncodeIntoRawBuffer() throws {
+        let trailer = FPCFrameTrailer(descriptorKinds: [10, 6])
+
+        var raw = [UInt8](repeating: 0xEE, count: FPCFrameLayout.trailerSize)
+        raw.withUnsafeMutableBytes { trailer.encode(into: $0, hasOOLPayload: true) }
+
+        XCTAssertEqual(raw[0], DescriptorKind.oolPayloadWireValue)
+        XCTAssertEqual(raw[1], 6)
+        XCTAssertTrue(raw[2...].allSatisfy { $0 == 0 })
+
+        let decoded = try raw.withUnsafeBytes { try FPCFrameTrailer.decode(from: $0, descriptorCount: 2) }
+        XCTAssertEqual(decoded.descriptorKinds, [DescriptorKind.oolPayloadWireValue, 6])
+    }
+
     // MARK: - WireTrailer Decoding
 
     func testWireTrailerDecodeEmpty() throws {
@@ -524,6 +872,70 @@ final class BPCTests: XCTestCase {
         XCTAssertEqual(decoded.trailer, original.trailer)
     }
 
+    // MARK: - Compact (v1) Framing
+
+    func testCompactFrameSize() {
+        let header = FPCFrameHeader(messageID: 1, correlationID: 0, payloadLength: 5, descriptorCount: 2)
+        let frame = FPCFrame(header: header, payload: Data("hello".utf8), trailer: FPCFrameTrailer(descriptorKinds: [1, 4]))
+
+        // 19-byte fixed header + 2 kind bytes + 5 payload bytes, no trailer
+        XCTAssertEqual(frame.encodeCompact().count, 26)
+        XCTAssertEqual(frame.encode().count, 517)
+    }
+
+    func testCompactFrameLayout() {
+        let header = FPCFrameHeader(messageID: 0x01020304, correlationID: 7, payloadLength: 0, descriptorCount: 1)
+        let data = FPCFrame(header: header, payload: Data(), trailer: FPCFrameTrailer(descriptorKinds: [4])).encodeCompact()
+
+        XCTAssertEqual(data.withUnsafeBytes { $0.loadUnaligned(as: UInt32.self) }, 0x01020304)
+        XCTAssertEqual(data[16], 1)   // descriptorCount
+        XCTAssertEqual(data[17], FPCFrameLayout.compactVersion)
+        XCTAssertEqual(data[19], 4)   // first descriptor kind
+    }
+
+    func testCompactFrameRoundTrip() throws {
+        let payload = Data("Test payload with some data!".utf8)
+        let header = FPCFrameHeader(
+            messageID: 42,
+            correlationID: 0xCAFEBABE,
+            payloadLength: UInt32(payload.count),
+            descriptorCount: 3
+        )
+        let trailer = FPCFrameTrailer(descriptorKinds: [1, 4, 8])
+        let original = FPCFrame(header: header, payload: payload, trailer: trailer)
+
+        let decoded = try FPCFrame.decode(from: original.encodeCompact())
+
+        XCTAssertEqual(decoded.header.version, FPCFrameLayout.compactVersion)
+        XCTAssertEqual(decoded.header.messageID, 42)
+        XCTAssertEqual(decoded.header.correlationID, 0xCAFEBABE)
+        XCTAssertEqual(decoded.payload, payload)
+        XCTAssertEqual(decoded.trailer, trailer)
+    }
+
+    func testCompactHeaderMarksOOLDescriptor() throws {
+        let header = FPCFrameHeader(
+            messageID: 1,
+            correlationID: 0,
+            payloadLength: 0,
+            descriptorCount: 2,
+            flags: FPCFrameLayout.flagOOLPayload
+        )
+        let data = FPCFrame(header: header, payload: Data(), trailer: FPCFrameTrailer(descriptorKinds: [5, 1])).encodeCompact()
+
+        XCTAssertEqual(data[19], DescriptorKind.oolPayloadWireValue)
+        XCTAssertEqual(data[20], 1)
+        XCTAssertNoThrow(try FPCFrame.decode(from: data))
+    }
+
+    func testCompactFrameDecodeTruncated() {
+        let header = FPCFrameHeader(messageID: 1, correlationID: 0, payloadLength: 4, descriptorCount: 0)
+        let data = FPCFrame(header: header, payload: Data([1, 2, 3, 4]), trailer: FPCFrameTrailer()).encodeCompact()
+
+        XCTAssertThrowsError(try FPCFrame.decode(from: data.prefix(data.count - 1)))
+        XCTAssertThrowsError(try Data(count: 10).withUnsafeBytes { try FPCCompactHeader.decode(from: $0) })
+    }
+
     func testWireMessageToMessage() throws {
         let header = FPCFrameHeader(
             messageID: MessageID.pong.rawValue,
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2026 Kory Heard
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+import XCTest
+import Glibc
+@testable import FPC
+import Descriptors
+
+// MARK: - Batch Benchmark
+
+/// Measures small-message throughput with and without batching.
+///
+/// The baseline sends each message with ``FPCEndpoint/send(_:)`` and receives
+/// one message per `recvmsg(2)`. The batched run uses
+/// ``FPCEndpoint/send(contentsOf:)`` and ``FPCEndpoint/enableBatchedReceive(maxMessages:)``,
+/// so both directions cost one system call per batch.
+///
+/// The throughput benchmarks only run when `FPC_BENCHMARK` is set. Set
+/// `FPC_BENCHMARK_MESSAGES` to override the message count.
+final class FPCBatchBenchmarkTests: XCTestCase {
+
+    private var messageCount: Int {
+        if let env = ProcessInfo.processInfo.environment["FPC_BENCHMARK_MESSAGES"], let count = Int(env) {
+            return count
+        }
+        return 100_000
+    }
+
+    private let payload = Data(repeating: 0xAB, count: 64)
+
+    func testUnbatchedThroughput() async throws {
+        try skipUnlessBenchmarking()
+        let rate = try await measureThroughput(batchSize: 1)
+        print("FPC unbatched 64B messages/sec=\(Int(rate))")
+    }
+
+    func testBatchedThroughput() async throws {
+        try skipUnlessBenchmarking()
+        for batchSize in [8, 32, 64] {
+            let rate = try await measureThroughput(batchSize: batchSize)
+            print("FPC batched   64B batch=\(batchSize) messages/sec=\(Int(rate))")
+        }
+    }
+
+    func testBatchPreservesOrderAcrossTransports() async throws {
+        let (client, server) = try FPCEndpoint.pair()
+        await server.enableBatchedReceive(maxMessages: 8)
+        await client.start()
+        await server.start()
+
+        // The large payload goes out-of-line mid-batch and must keep its place
+        var messages: [FPCMessage] = (0..<20).map { i in
+            FPCMessage(id: .ping, payload: Data([UInt8(i)]))
+        }
+        messages.insert(FPCMessage(id: .ping, payload: Data(repeating: 0xCD, count: 256 * 1024)), at: 10)
+
+        let stream = try await server.incoming()
+        try await client.send(contentsOf: messages)
+
+        var received: [FPCMessage] = []
+        for await message in stream {
+            received.append(message)
+            if received.count == messages.count { break }
+        }
+
+        XCTAssertEqual(received.map(\.payload), messages.map(\.payload))
+
+        await client.stop()
+        await server.stop()
+    }
+
+    // MARK: - Harness
+
+    private func measureThroughput(batchSize: Int) async throws -> Double {
+        let (client, server) = try FPCEndpoint.pair()
+        if batchSize > 1 {
+            await server.enableBatchedReceive(maxMessages: batchSize)
+        }
+        await client.start()
+        await server.start()
+
+        let total = messageCount
+        let stream = try await server.incoming()
+        let receiver = Task.detached {
+            var count = 0
+            for await _ in stream {
+                count += 1
+                if count == total { break }
+            }
+            return count
+        }
+
+        let clock = ContinuousClock()
+        let start = clock.now
+
+        let message = FPCMessage(id: .ping, payload: payload)
+        if batchSize > 1 {
+            let batch = [FPCMessage](repeating: message, count: batchSize)
+            var sent = 0
+            while sent < total {
+                let count = min(batchSize, total - sent)
+                try await client.send(contentsOf: count == batchSize ? batch : Array(batch.prefix(count)))
+                sent += count
+            }
+        } else {
+            for _ in 0..<total {
+                try await client.send(message)
+            }
+        }
+
+        let received = await receiver.value
+        let elapsed = clock.now - start
+        XCTAssertEqual(received, total)
+
+        await client.stop()
+        await server.stop()
+
+        let seconds = Double(elapsed.components.seconds) + Double(elapsed.components.attoseconds) / 1e18
+        return Double(total) / seconds
+    }
+}
@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2026 Kory Heard
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+import XCTest
+
+extension XCTestCase {
+    /// Skips the calling benchmark unless `FPC_BENCHMARK` is set.
+    ///
+    /// Benchmarks push large message or connection counts and are too slow
+    /// for the default `swift test` run.
+    func skipUnlessBenchmarking() throws {
+        try XCTSkipUnless(
+            ProcessInfo.processInfo.environment["FPC_BENCHMARK"] != nil,
+            "Set FPC_BENCHMARK=1 to run benchmarks"
+        )
+    }
+}
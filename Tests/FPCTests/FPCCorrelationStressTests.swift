@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2026 Kory Heard
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+import XCTest
+import Glibc
+@testable import FPC
+import Descriptors
+
+// MARK: - Correlation Stress
+
+/// Drives an endpoint with a very large number of outstanding requests.
+///
+/// The server withholds every reply until all requests have arrived, so the
+/// client's correlation table and timer wheel hold the full set at once. The
+/// test reports the peak RSS growth and the p50/p99/p99.9 request latency.
+///
+/// The outstanding-requests run only happens when `FPC_BENCHMARK` is set.
+/// Set `FPC_STRESS_REQUESTS` to override its request count.
+final class FPCCorrelationStressTests: XCTestCase {
+
+    private var requestCount: Int {
+        if let env = ProcessInfo.processInfo.environment["FPC_STRESS_REQUESTS"], let count = Int(env) {
+            return count
+        }
+        return 100_000
+    }
+
+    func testOutstandingRequests() async throws {
+        try skipUnlessBenchmarking()
+        let (client, server) = try FPCEndpoint.pair()
+        await client.start()
+        await server.start()
+
+        let total = requestCount
+        let stream = try await server.incoming()
+        let serverTask = Task.detached {
+            var tokens: [FPCReplyToken] = []
+            tokens.reserveCapacity(total)
+            for await message in stream {
+                tokens.append(message.replyToken)
+                if tokens.count == total { break }
+            }
+            for token in tokens {
+                try await server.reply(to: token, id: .pong)
+            }
+        }
+
+        let rssBefore = Self.maxResidentKilobytes()
+        let clock = ContinuousClock()
+        let latencies = try await withThrowingTaskGroup(of: Duration.self) { group in
+            for _ in 0..<total {
+                group.addTask {
+                    let start = clock.now
+                    _ = try await client.request(FPCMessage.request(.ping), timeout: .seconds(120))
+                    return clock.now - start
+                }
+            }
+            var all: [Duration] = []
+            all.reserveCapacity(total)
+            for try await latency in group { all.append(latency) }
+            return all.sorted()
+        }
+        let rssAfter = Self.maxResidentKilobytes()
+
+        try await serverTask.value
+        XCTAssertEqual(latencies.count, total)
+
+        print("""
+            FPC correlation requests=\(total) \
+            rssGrowthKB=\(rssAfter - rssBefore) \
+            p50=\(latencies[total / 2]) \
+            p99=\(latencies[total * 99 / 100]) \
+            p999=\(latencies[total * 999 / 1000])
+            """)
+
+        await client.stop()
+        await server.stop()
+    }
+
+    func testTimeoutsExpireInBatches() async throws {
+        let (client, server) = try FPCEndpoint.pair()
+        await client.start()
+        await server.start()
+
+        // The server never replies
+        let stream = try await server.incoming()
+        let drain = Task.detached { for await _ in stream {} }
+
+        let count = 10_000
+        let clock = ContinuousClock()
+        let start = clock.now
+        let timedOut = try await withThrowingTaskGroup(of: Bool.self) { group in
+            for _ in 0..<count {
+                group.addTask {
+                    do {
+                        _ = try await client.request(FPCMessage.request(.ping), timeout: .milliseconds(100))
+                        return false
+                    } catch FPCError.timeout {
+                        return true
+                    }
+                }
+            }
+            var timedOut = 0
+            for try await result in group where result { timedOut += 1 }
+            return timedOut
+        }
+        let elapsed = clock.now - start
+
+        XCTAssertEqual(timedOut, count)
+        XCTAssertLessThan(elapsed, .seconds(10))
+
+        await client.stop()
+        await server.stop()
+        drain.cancel()
+    }
+
+    // MARK: - Helpers
+
+    /// Peak resident set size of this process, in kilobytes.
+    private static func maxResidentKilobytes() -> Int {
+        var usage = rusage()
+        guard getrusage(RUSAGE_SELF, &usage) == 0 else { return -1 }
+        return Int(usage.ru_maxrss)
+    }
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2026 Kory Heard
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+import XCTest
+import Glibc
+@testable import FPC
+
+// MARK: - Credential Modes
+
+/// Exercises ``FPCEndpoint/setCredentialMode(_:)`` end to end over paired
+/// endpoints, checking what the receiving side sees on each message.
+final class FPCCredentialModeTests: XCTestCase {
+
+    func testPerMessageCredentialsByDefault() async throws {
+        let (client, server) = try await makePair()
+        var incoming = try await server.incoming().makeAsyncIterator()
+        let messages = try await receive(3, from: &incoming, sentBy: client)
+
+        for message in messages {
+            let credentials = try XCTUnwrap(message.senderCredentials)
+            XCTAssertEqual(credentials.effectiveUID, geteuid())
+            XCTAssertEqual(credentials.pid, getpid())
+        }
+        XCTAssertEqual(server.credentialCacheStatistics.hits, 0)
+        XCTAssertEqual(server.credentialCacheStatistics.misses, 0)
+
+        await client.stop()
+        await server.stop()
+    }
+
+    func testConnectionOnlyDropsPerMessageCredentials() async throws {
+        let (client, server) = try await makePair()
+        var incoming = try await server.incoming().makeAsyncIterator()
+        try await server.setCredentialMode(.connectionOnly)
+
+        let messages = try await receive(3, from: &incoming, sentBy: client)
+        for message in messages {
+            XCTAssertNil(message.senderCredentials)
+        }
+
+        // The connection-time credentials are still available
+        let peer = try await server.getPeerCredentials()
+        XCTAssertEqual(peer.uid, geteuid())
+        XCTAssertEqual(peer.pid, getpid())
+
+        await client.stop()
+        await server.stop()
+    }
+
+    func testCachedReusesCredentialsAcrossMessages() async throws {
+        let (client, server) = try await makePair()
+        var incoming = try await server.incoming().makeAsyncIterator()
+        try await server.setCredentialMode(.cached)
+
+        let count = 8
+        let messages = try await receive(count, from: &incoming, sentBy: client)
+        let first = try XCTUnwrap(messages.first?.senderCredentials)
+        XCTAssertEqual(first.effectiveUID, geteuid())
+        XCTAssertEqual(first.pid, getpid())
+        for message in messages {
+            XCTAssertEqual(message.senderCredentials, first)
+        }
+
+        // Only the first SCM_CREDS2 is decoded; the rest are cache hits
+        let statistics = server.credentialCacheStatistics
+        XCTAssertEqual(statistics.misses, 1)
+        XCTAssertEqual(statistics.hits, count - 1)
+
+        await client.stop()
+        await server.stop()
+    }
+
+    func testSwitchingBackToPerMessageRestoresCredentials() async throws {
+        let (client, server) = try await makePair()
+        var incoming = try await server.incoming().makeAsyncIterator()
+
+        try await server.setCredentialMode(.connectionOnly)
+        let dropped = try await receive(1, from: &incoming, sentBy: client)
+        XCTAssertNil(dropped.first?.senderCredentials)
+
+        try await server.setCredentialMode(.perMessage)
+        let restored = try await receive(1, from: &incoming, sentBy: client)
+        XCTAssertNotNil(restored.first?.senderCredentials)
+
+        await client.stop()
+        await server.stop()
+    }
+
+    // MARK: - Helpers
+
+    private func makePair() async throws -> (FPCEndpoint, FPCEndpoint) {
+        let (client, server) = try FPCEndpoint.pair()
+        await client.start()
+        await server.start()
+        return (client, server)
+    }
+
+    /// Sends `count` unsolicited pings from `client` and collects them from
+    /// `messages`, the server's incoming stream.
+    private func receive(
+        _ count: Int,
+        from messages: inout AsyncStream<FPCMessage>.AsyncIterator,
+        sentBy client: FPCEndpoint
+    ) async throws -> [FPCMessage] {
+        for _ in 0..<count {
+            try await client.send(FPCMessage(id: .ping))
+        }
+        var received: [FPCMessage] = []
+        for _ in 0..<count {
+            guard let message = await messages.next() else {
+                throw FPCError.disconnected
+            }
+            received.append(message)
+        }
+        return received
+    }
+}
@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2026 Kory Heard
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+import XCTest
+import Glibc
+@testable import FPC
+import Descriptors
+
+// MARK: - Dispatcher
+
+/// Exercises ``FPCDispatcher`` over paired endpoints: cross-connection
+/// concurrency, per-connection reply ordering, and the in-flight window.
+final class FPCDispatcherTests: XCTestCase {
+
+    func testSlowRequestDoesNotBlockOtherConnection() async throws {
+        let dispatcher = FPCDispatcher()
+        let (slowClient, slowServer) = try await makePair()
+        let (fastClient, fastServer) = try await makePair()
+
+        let handler: FPCDispatcher.Handler = { request, _ in
+            if request.id == .lookup {
+                try await Task.sleep(for: .seconds(2))
+            }
+            return FPCMessage(id: .pong)
+        }
+        let slowServe = Task { try await dispatcher.serve(slowServer, handler: handler) }
+        let fastServe = Task { try await dispatcher.serve(fastServer, handler: handler) }
+
+        let slowRequest = Task { try await slowClient.request(FPCMessage.request(.lookup), timeout: .seconds(10)) }
+
+        let clock = ContinuousClock()
+        let start = clock.now
+        let reply = try await fastClient.request(FPCMessage.request(.ping), timeout: .seconds(10))
+        XCTAssertEqual(reply.id, .pong)
+        XCTAssertLessThan(clock.now - start, .seconds(1))
+
+        _ = try await slowRequest.value
+
+        for endpoint in [slowClient, slowServer, fastClient, fastServer] {
+            await endpoint.stop()
+        }
+        _ = await slowServe.result
+        _ = await fastServe.result
+    }
+
+    func testPerConnectionOrdering() async throws {
+        let dispatcher = FPCDispatcher(configuration: .init(ordering: .perConnection))
+        let (client, server) = try await makePair()
+
+        // Earlier requests take longest, so unordered replies would reverse
+        let count = 10
+        let serve = Task {
+            try await dispatcher.serve(server) { request, _ in
+                let delay = (count + 1 - Int(request.correlationID)) * 20
+                try await Task.sleep(for: .milliseconds(delay))
+                return FPCMessage(id: .pong)
+            }
+        }
+
+        // Send with explicit correlation IDs so the replies land on incoming()
+        let replies = try await client.incoming()
+        for id in 1...count {
+            try await client.send(FPCMessage(id: .ping, correlationID: UInt64(id)))
+        }
+
+        var order: [UInt64] = []
+        for await reply in replies {
+            order.append(reply.correlationID)
+            if order.count == count { break }
+        }
+        XCTAssertEqual(order, (1...UInt64(count)).map { $0 })
+
+        await client.stop()
+        await server.stop()
+        _ = await serve.result
+    }
+
+    func testInFlightWindowLimitsConcurrency() async throws {
+        let window = 4
+        let dispatcher = FPCDispatcher(configuration: .init(maxInFlightPerConnection: window))
+        let (client, server) = try await makePair()
+
+        let gauge = ConcurrencyGauge()
+        let serve = Task {
+            try await dispatcher.serve(server) { _, _ in
+                gauge.enter()
+                defer { gauge.leave() }
+                try await Task.sleep(for: .milliseconds(20))
+                return FPCMessage(id: .pong)
+            }
+        }
+
+        let total = 40
+        try await withThrowingTaskGroup(of: Void.self) { group in
+            for _ in 0..<total {
+                group.addTask {
+                    _ = try await client.request(FPCMessage.request(.ping), timeout: .seconds(10))
+                }
+            }
+            try await group.waitForAll()
+        }
+
+        XCTAssertEqual(gauge.completed, total)
+        XCTAssertLessThanOrEqual(gauge.peak, window)
+
+        await client.stop()
+        await server.stop()
+        _ = await serve.result
+    }
+
+    func testFloodIsBufferedInTheSocketNotTheStream() async throws {
+        let window = 4
+        let dispatcher = FPCDispatcher(configuration: .init(maxInFlightPerConnection: window))
+        let (client, server) = try await makePair()
+
+        // Every handler samples how many requests the server has taken off
+        // the socket: queued in the stream, held, or being handled
+        let backlog = ConcurrencyGauge()
+        let serve = Task {
+            try await dispatcher.serve(server) { _, endpoint in
+                backlog.record(await endpoint.incomingBacklog)
+                try await Task.sleep(for: .milliseconds(5))
+                return FPCMessage(id: .pong)
+            }
+        }
+
+        // Flood without waiting for replies; correlation IDs route the
+        // replies back to incoming()
+        let total = 200
+        let replies = try await client.incoming()
+        let flood = Task {
+            for id in 1...total {
+                try await client.send(FPCMessage(id: .ping, correlationID: UInt64(id)))
+            }
+        }
+
+        var received = 0
+        for await _ in replies {
+            received += 1
+            if received == total { break }
+        }
+        try await flood.value
+
+        XCTAssertEqual(received, total)
+        XCTAssertLessThanOrEqual(backlog.peak, window)
+
+        await client.stop()
+        await server.stop()
+        _ = await serve.result
+    }
+
+    func testHandlerRequestCompletesWhileWindowIsFull() async throws {
+        let dispatcher = FPCDispatcher(configuration: .init(maxInFlightPerConnection: 1))
+        let (client, server) = try await makePair()
+
+        // The handler asks the client a question before replying; the
+        // second ping fills the window and pauses the server's receiving
+        let serve = Task {
+            try await dispatcher.serve(server) { request, endpoint in
+                let answer = try await endpoint.request(FPCMessage.request(.lookup), timeout: .seconds(5))
+                return FPCMessage(id: .pong, payload: answer.payload)
+            }
+        }
+
+        // The client answers the server's lookups from its own stream
+        let questions = try await client.incoming()
+        let answer = Task {
+            for await question in questions where question.id == .lookup {
+                try await client.reply(to: question, id: .lookupReply, payload: Data("answer".utf8))
+            }
+        }
+
+        try await withThrowingTaskGroup(of: FPCMessage.self) { group in
+            for _ in 0..<2 {
+                group.addTask {
+                    try await client.request(FPCMessage.request(.ping), timeout: .seconds(10))
+                }
+            }
+            for try await reply in group {
+                XCTAssertEqual(reply.id, .pong)
+                XCTAssertEqual(reply.payload, Data("answer".utf8))
+            }
+        }
+
+        await client.stop()
+        await server.stop()
+        _ = await serve.result
+        answer.cancel()
+    }
+
+    // MARK: - Helpers
+
+    private func makePair() async throws -> (FPCEndpoint, FPCEndpoint) {
+        let (client, server) = try FPCEndpoint.pair()
+        await client.start()
+        await server.start()
+        return (client, server)
+    }
+}
+
+/// Tracks how many handlers are running at once.
+private final class ConcurrencyGauge: @unchecked Sendable {
+    private let lock = NSLock()
+    private var current = 0
+    private var maximum = 0
+    private var finished = 0
+
+    func enter() {
+        lock.lock()
+        current += 1
+        maximum = max(maximum, current)
+        lock.unlock()
+    }
+
+    /// Records an externally measured level.
+    func record(_ level: Int) {
+        lock.lock()
+        maximum = max(maximum, level)
+        lock.unlock()
+    }
+
+    func leave() {
+        lock.lock()
+        current -= 1
+        finished += 1
+        lock.unlock()
+    }
+
+    var peak: Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return maximum
+    }
+
+    var completed: Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return finished
+    }
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2026 Kory Heard
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+import XCTest
+import Glibc
+@testable import FPC
+import Descriptors
+
+// MARK: - Event Loop Benchmark
+
+/// Compares the per-endpoint DispatchQueue backend with the shared kqueue
+/// ``FPCEventLoop`` as the number of connections grows.
+///
+/// For each connection count, the benchmark reports the process thread count
+/// while every connection is idle (receive loops parked), and the p50/p99
+/// round-trip latency of a ping/pong exchange on every connection at once.
+///
+/// The scaling benchmarks open hundreds of connections and only run when
+/// `FPC_BENCHMARK` is set. Set `FPC_BENCHMARK_CONNECTIONS` (comma-separated)
+/// to override the sizes.
+final class FPCEventLoopBenchmarkTests: XCTestCase {
+
+    private var connectionCounts: [Int] {
+        if let env = ProcessInfo.processInfo.environment["FPC_BENCHMARK_CONNECTIONS"] {
+            return env.split(separator: ",").compactMap { Int($0) }
+        }
+        return [16, 128, 512]
+    }
+
+    func testDispatchQueueBackendScaling() async throws {
+        try skipUnlessBenchmarking()
+        for connections in connectionCounts {
+            let result = try await runPingPong(connections: connections, eventLoop: nil)
+            print("FPC dispatch  connections=\(connections) \(result)")
+        }
+    }
+
+    func testEventLoopBackendScaling() async throws {
+        try skipUnlessBenchmarking()
+        for connections in connectionCounts {
+            let loop = try FPCEventLoop(threadCount: 2)
+            let result = try await runPingPong(connections: connections, eventLoop: loop)
+            loop.shutdown()
+            print("FPC eventloop connections=\(connections) \(result)")
+        }
+    }
+
+    func testEventLoopRoundTrip() async throws {
+        let loop = try FPCEventLoop(threadCount: 1)
+        defer { loop.shutdown() }
+
+        let (client, server) = try FPCEndpoint.pair(eventLoop: loop)
+        await client.start()
+        await server.start()
+
+        let serverTask = Task.detached {
+            for await message in try await server.incoming() {
+                try await server.reply(to: message, id: .pong, payload: message.payload)
+            }
+        }
+
+        let reply = try await client.request(FPCMessage.request(.ping, payload: Data("hi".utf8)), timeout: .seconds(5))
+        XCTAssertEqual(reply.id, .pong)
+        XCTAssertEqual(reply.payload, Data("hi".utf8))
+
+        await client.stop()
+        await server.stop()
+        serverTask.cancel()
+    }
+
+    // MARK: - Harness
+
+    private struct Result: CustomStringConvertible {
+        let idleThreads: Int
+        let p50: Duration
+        let p99: Duration
+
+        var description: String {
+            "idleThreads=\(idleThreads) p50=\(p50) p99=\(p99)"
+        }
+    }
+
+    private func runPingPong(connections: Int, eventLoop: FPCEventLoop?) async throws -> Result {
+        var clients: [FPCEndpoint] = []
+        var servers: [FPCEndpoint] = []
+        for _ in 0..<connections {
+            let (client, server) = try FPCEndpoint.pair(eventLoop: eventLoop)
+            await client.start()
+            await server.start()
+            clients.append(client)
+            servers.append(server)
+        }
+
+        let serverTasks = servers.map { server in
+            Task.detached {
+                for await message in try await server.incoming() {
+                    try await server.reply(to: message, id: .pong)
+                }
+            }
+        }
+
+        // Let every receive loop park before sampling
+        try await Task.sleep(for: .milliseconds(200))
+        let idleThreads = Self.processThreadCount()
+
+        let clock = ContinuousClock()
+        let latencies = try await withThrowingTaskGroup(of: Duration.self) { group in
+            for client in clients {
+                group.addTask {
+                    let start = clock.now
+                    _ = try await client.request(FPCMessage.request(.ping), timeout: .seconds(30))
+                    return clock.now - start
+                }
+            }
+            var all: [Duration] = []
+            for try await latency in group { all.append(latency) }
+            return all.sorted()
+        }
+
+        for endpoint in clients + servers { await endpoint.stop() }
+        serverTasks.forEach { $0.cancel() }
+
+        return Result(
+            idleThreads: idleThreads,
+            p50: latencies[latencies.count / 2],
+            p99: latencies[min(latencies.count - 1, latencies.count * 99 / 100)]
+        )
+    }
+
+    /// Number of threads in this process, via `kern.proc.pid` with
+    /// `KERN_PROC_INC_THREAD` (one `kinfo_proc` per thread).
+    private static func processThreadCount() -> Int {
+        let KERN_PROC_INC_THREAD: Int32 = 0x10
+        var mib: [Int32] = [CTL_KERN, KERN_PROC, KERN_PROC_PID | KERN_PROC_INC_THREAD, getpid()]
+        var size = 0
+        guard sysctl(&mib, 4, nil, &size, nil, 0) == 0, size > 0 else { return -1 }
+
+        var buffer = [UInt8](repeating: 0, count: size)
+        guard sysctl(&mib, 4, &buffer, &size, nil, 0) == 0 else { return -1 }
+
+        // ki_structsize is the first field of kinfo_proc
+        let structSize = buffer.withUnsafeBytes { Int($0.load(as: Int32.self)) }
+        return structSize > 0 ? size / structSize : -1
+    }
+}
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2026 Kory Heard
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+import XCTest
+import Glibc
+@testable import FPC
+import Descriptors
+import Capabilities
+
+// MARK: - Framing Benchmark
+
+/// Compares v0 (256-byte header + 256-byte trailer) and compact v1 framing
+/// for small messages.
+///
+/// Reports the p50/p99 round-trip latency of sequential 5-byte requests, and
+/// one-way throughput of 5-byte messages.
+///
+/// The benchmarks only run when `FPC_BENCHMARK` is set. Set
+/// `FPC_BENCHMARK_MESSAGES` to override the message count.
+final class FPCFramingBenchmarkTests: XCTestCase {
+
+    private var messageCount: Int {
+        if let env = ProcessInfo.processInfo.environment["FPC_BENCHMARK_MESSAGES"], let count = Int(env) {
+            return count
+        }
+        return 50_000
+    }
+
+    private let payload = Data("query".utf8)
+
+    func testV0SmallMessages() async throws {
+        try skipUnlessBenchmarking()
+        let result = try await run(compact: false)
+        print("FPC framing v0 \(result)")
+    }
+
+    func testV1SmallMessages() async throws {
+        try skipUnlessBenchmarking()
+        let result = try await run(compact: true)
+        print("FPC framing v1 \(result)")
+    }
+
+    func testCompactFramingRoundTrip() async throws {
+        let (client, server) = try await makePair(compact: true)
+
+        let serverTask = Task.detached {
+            for await message in try await server.incoming() {
+                try await server.reply(to: message, id: .pong, payload: message.payload)
+            }
+        }
+
+        for i in 0..<4 {
+            let payload = Data(repeating: UInt8(i), count: i * 100)
+            let reply = try await client.request(FPCMessage.request(.ping, payload: payload), timeout: .seconds(5))
+            XCTAssertEqual(reply.payload, payload)
+        }
+        XCTAssertTrue(client.sendsCompactFrames)
+        XCTAssertTrue(server.sendsCompactFrames)
+
+        await client.stop()
+        await server.stop()
+        serverTask.cancel()
+    }
+
+    func testCompactFramesOnTheWire() async throws {
+        var fds: [Int32] = [-1, -1]
+        XCTAssertEqual(Glibc.socketpair(AF_UNIX, SOCK_SEQPACKET, 0, &fds), 0)
+        let raw = fds[1]
+        defer { Glibc.close(raw) }
+
+        let endpoint = FPCEndpoint(socket: SocketCapability(fds[0]))
+        await endpoint.enableCompactFraming()
+        await endpoint.start()
+
+        // Until the peer's offer arrives, frames use v0
+        let probe = FPCMessage(id: .ping, payload: Data("before".utf8))
+        try await endpoint.send(probe)
+        let v0 = try receiveFrame(from: raw, id: .ping)
+        XCTAssertEqual(v0[FPCFrameLayout.versionOffset], FPCFrameLayout.currentVersion)
+        XCTAssertEqual(v0.count, FPCFrameLayout.minimumMessageSize + probe.payload.count)
+
+        let offer = FPCFrame(from: FPCMessage(id: .frameVersionOffer, payload: Data([FPCFrameLayout.compactVersion])))
+        try offer.encode().withUnsafeBytes { bytes in
+            XCTAssertEqual(Glibc.send(raw, bytes.baseAddress, bytes.count, 0), bytes.count)
+        }
+        let deadline = ContinuousClock.now + .seconds(5)
+        while !endpoint.sendsCompactFrames, ContinuousClock.now < deadline {
+            try await Task.sleep(for: .milliseconds(1))
+        }
+        XCTAssertTrue(endpoint.sendsCompactFrames)
+
+        let message = FPCMessage(id: .ping, payload: Data("after".utf8))
+        try await endpoint.send(message)
+        let v1 = try receiveFrame(from: raw, id: .ping)
+        XCTAssertEqual(v1[FPCFrameLayout.versionOffset], FPCFrameLayout.compactVersion)
+        XCTAssertEqual(v1.count, FPCFrameLayout.compactHeaderSize + message.payload.count)
+        XCTAssertEqual(Data(v1.suffix(message.payload.count)), message.payload)
+
+        await endpoint.stop()
+    }
+
+    /// Reads datagrams from `fd` until one carries message `id`.
+    private func receiveFrame(from fd: Int32, id: MessageID) throws -> [UInt8] {
+        var buffer = [UInt8](repeating: 0, count: 64 * 1024)
+        while true {
+            let count = Glibc.recv(fd, &buffer, buffer.count, 0)
+            guard count > 0 else {
+                throw FPCError.disconnected
+            }
+            let frame = Array(buffer[..<count])
+            let messageID = frame.withUnsafeBytes {
+                $0.loadUnaligned(fromByteOffset: FPCFrameLayout.messageIDOffset, as: UInt32.self)
+            }
+            if messageID == id.rawValue {
+                return frame
+            }
+        }
+    }
+
+    // MARK: - Harness
+
+    private struct Result: CustomStringConvertible {
+        let p50: Duration
+        let p99: Duration
+        let messagesPerSecond: Double
+
+        var description: String {
+            "p50=\(p50) p99=\(p99) messages/sec=\(Int(messagesPerSecond))"
+        }
+    }
+
+    private func makePair(compact: Bool) async throws -> (FPCEndpoint, FPCEndpoint) {
+        let (client, server) = try FPCEndpoint.pair()
+        if compact {
+            await client.enableCompactFraming()
+            await server.enableCompactFraming()
+        }
+        await client.start()
+        await server.start()
+        return (client, server)
+    }
+
+    private func run(compact: Bool) async throws -> Result {
+        let (client, server) = try await makePair(compact: compact)
+
+        let total = messageCount
+        let stream = try await server.incoming()
+        let serverTask = Task.detached {
+            var unsolicited = 0
+            for await message in stream {
+                if message.correlationID != 0 {
+                    try await server.reply(to: message, id: .pong)
+                } else {
+                    unsolicited += 1
+                    if unsolicited == total { break }
+                }
+            }
+            return unsolicited
+        }
+
+        // Warm up, and give both framing offers time to land
+        for _ in 0..<100 {
+            _ = try await client.request(FPCMessage.request(.ping, payload: payload), timeout: .seconds(5))
+        }
+        try await Task.sleep(for: .milliseconds(50))
+
+        let clock = ContinuousClock()
+        var latencies: [Duration] = []
+        latencies.reserveCapacity(total / 10)
+        for _ in 0..<(total / 10) {
+            let start = clock.now
+            _ = try await client.request(FPCMessage.request(.ping, payload: payload), timeout: .seconds(5))
+            latencies.append(clock.now - start)
+        }
+        latencies.sort()
+
+        let start = clock.now
+        let message = FPCMessage(id: .event, payload: payload)
+        for _ in 0..<total {
+            try await client.send(message)
+        }
+        let received = try await serverTask.value
+        let elapsed = clock.now - start
+        XCTAssertEqual(received, total)
+
+        await client.stop()
+        await server.stop()
+
+        let seconds = Double(elapsed.components.seconds) + Double(elapsed.components.attoseconds) / 1e18
+        return Result(
+            p50: latencies[latencies.count / 2],
+            p99: latencies[min(latencies.count - 1, latencies.count * 99 / 100)],
+            messagesPerSecond: Double(total) / seconds
+        )
+    }
+}
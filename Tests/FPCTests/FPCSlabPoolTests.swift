@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2026 Kory Heard
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+import XCTest
+@testable import FPC
+import Descriptors
+
+// MARK: - Slab Pool
+
+/// Sends large payloads over paired endpoints with a slab pool enabled and
+/// checks that slabs come back through the peer's credits.
+final class FPCSlabPoolTests: XCTestCase {
+
+    /// Larger than the inline limit, smaller than one slab.
+    private let payloadSize = 128 * 1024
+    private let configuration = FPCSlabConfiguration(slabSize: 256 * 1024, slabCount: 2)
+
+    func testLargePayloadsRoundTripThroughSlabs() async throws {
+        let (client, server) = try FPCEndpoint.pair()
+        await client.enableSlabPool(configuration)
+        await client.start()
+
+        // The server is not reading yet, so no credit can come back: the
+        // first two sends take both slabs and the third falls back to shm.
+        let payloads = (0..<3).map { makePayload(seed: UInt8($0)) }
+        for payload in payloads {
+            try await client.send(FPCMessage(id: .event, payload: payload))
+        }
+        XCTAssertEqual(client.slabPoolAvailableCount, 0)
+
+        await server.start()
+        var messages = try await server.incoming().makeAsyncIterator()
+        for payload in payloads {
+            let message = try XCTUnwrap(await messages.next())
+            XCTAssertEqual(message.id, .event)
+            XCTAssertEqual(message.payload, payload)
+        }
+        try await waitForSlabs(client, count: configuration.slabCount)
+
+        // Recycled slabs carry new payloads intact
+        for round in 0..<8 {
+            let payload = makePayload(seed: UInt8(100 + round))
+            try await client.send(FPCMessage(id: .event, payload: payload))
+            let message = try XCTUnwrap(await messages.next())
+            XCTAssertEqual(message.payload, payload)
+        }
+        try await waitForSlabs(client, count: configuration.slabCount)
+
+        await client.stop()
+        await server.stop()
+    }
+
+    // MARK: - Helpers
+
+    private func makePayload(seed: UInt8) -> Data {
+        Data((0..<payloadSize).map { UInt8(truncatingIfNeeded: $0) &+ seed })
+    }
+
+    /// Waits for the peer's credits to return `count` slabs to the pool.
+    private func waitForSlabs(_ endpoint: FPCEndpoint, count: Int) async throws {
+        let deadline = ContinuousClock.now + .seconds(5)
+        while endpoint.slabPoolAvailableCount != count, ContinuousClock.now < deadline {
+            try await Task.sleep(for: .milliseconds(10))
+        }
+        XCTAssertEqual(endpoint.slabPoolAvailableCount, count)
+    }
+}
@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) 2026 Kory Heard
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+import Testing
+import Foundation
+@testable import Netmap
+
+// MARK: - Packet Rate Benchmarks
+
+/// Measures the Swift packet paths against the in-memory simulator.
+///
+/// The simulator's kernel side costs a fixed amount per packet, so changes
+/// in these rates track the receive, burst, and forwarding loops. Needs no
+/// /dev/netmap, so it runs on any host.
+///
+/// The suite is opt-in and manual: each benchmark pushes millions of packets
+/// and only prints rates, with no thresholds, so it runs only when
+/// `NETMAP_BENCHMARK` is set and is not part of the default test run.
+/// Compare its output before and after a change to catch regressions. Set
+/// `NETMAP_BENCHMARK_PACKETS` to override the packet count.
+@Suite(
+    "Netmap Packet Rate Benchmarks",
+    .serialized,
+    .enabled(if: ProcessInfo.processInfo.environment["NETMAP_BENCHMARK"] != nil)
+)
+struct NetmapBenchmarkTests {
+
+    private var packetCount: Int {
+        if let env = ProcessInfo.processInfo.environment["NETMAP_BENCHMARK_PACKETS"], let count = Int(env) {
+            return count
+        }
+        return 2_000_000
+    }
+
+    private let frame = Data(repeating: 0xAB, count: 60)
+
+    @Test("Batch receive rate")
+    func receiveRate() throws {
+        let sim = try NetmapSimulator(.init(name: "sim0", traffic: .repeating(frame)))
+        let port = try sim.openPort("sim0")
+
+        let total = packetCount
+        var received = 0
+        var checksum = 0
+        let elapsed = try measure {
+            while received < total {
+                received += try port.receiveBatches(timeout: 0) { batch in
+                    for packet in batch {
+                        checksum &+= Int(packet[0])
+                    }
+                }
+            }
+        }
+
+        #expect(checksum == received * 0xAB)
+        report("rx batch", packets: received, elapsed: elapsed)
+    }
+
+    @Test("Burst transmit rate")
+    func transmitRate() throws {
+        let sim = try NetmapSimulator(.init(name: "sim0"))
+        let port = try sim.openPort("sim0")
+
+        let total = packetCount
+        var sent = 0
+        let elapsed = try measure {
+            while sent < total {
+                let result = try port.sendBurst(count: 512) { _, buffer in
+                    frame.copyBytes(to: buffer)
+                }
+                sent += result.sent
+            }
+        }
+
+        #expect(sim.statistics(for: "sim0").transmittedPackets == UInt64(sent))
+        report("tx burst", packets: sent, elapsed: elapsed)
+    }
+
+    @Test("Zero-copy forwarding rate")
+    func zeroCopyForwardRate() throws {
+        let sim = try NetmapSimulator(interfaces: [
+            .init(name: "sim0", traffic: .repeating(frame)),
+            .init(name: "sim1"),
+        ])
+        let source = try sim.openPort("sim0")
+        let destination = try sim.openPort("sim1")
+
+        let before = NetmapZeroCopy.statistics.snapshot()
+        let forwarded = try forwardLoop(from: source, to: destination)
+        let after = NetmapZeroCopy.statistics.snapshot()
+
+        #expect(after.zeroCopyPackets - before.zeroCopyPackets >= UInt64(forwarded.packets))
+        report("forward zero-copy", packets: forwarded.packets, elapsed: forwarded.elapsed)
+    }
+
+    @Test("Copy forwarding rate")
+    func copyForwardRate() throws {
+        let simA = try NetmapSimulator(.init(name: "sim0", traffic: .repeating(frame)))
+        let simB = try NetmapSimulator(.init(name: "sim1"))
+        let source = try simA.openPort("sim0")
+        let destination = try simB.openPort("sim1")
+
+        let before = NetmapZeroCopy.statistics.snapshot()
+        let forwarded = try forwardLoop(from: source, to: destination)
+        let after = NetmapZeroCopy.statistics.snapshot()
+
+        #expect(after.copiedPackets - before.copiedPackets >= UInt64(forwarded.packets))
+        report("forward copy", packets: forwarded.packets, elapsed: forwarded.elapsed)
+    }
+
+    @Test("Receive rate and syscalls per packet: ioctl vs CSB")
+    func csbReceiveRate() throws {
+        let total = packetCount
+
+        // ioctl path: each call is a poll plus an NIOCRXSYNC on a real port,
+        // counted here from the port's recorded syncs
+        let simA = try NetmapSimulator(.init(name: "sim0", traffic: .repeating(frame)))
+        var port = try simA.openPort("sim0")
+        let ringStatistics = NetmapRingStatistics(port: port)
+        port.ringStatistics = ringStatistics
+        var received = 0
+        var polls: UInt64 = 0
+        let ioctlElapsed = try measure {
+            while received < total {
+                received += try port.receiveBatches(timeout: 0) { _ in }
+                polls += 1
+            }
+        }
+        let rxSyncs = ringStatistics.snapshot().rings.first { $0.kind == .rx }?.syncs ?? 0
+        #expect(rxSyncs > 0)
+        report("rx ioctl", packets: received, elapsed: ioctlElapsed)
+        reportSyscalls("rx ioctl", syscalls: polls + rxSyncs, packets: received)
+
+        // CSB path: syncs are loads and stores; only kicks and sleeps are
+        // system calls
+        let modes: [(String, NetmapCSBPort.Configuration)] = [("rx csb", .busyPoll), ("rx csb notified", .notified)]
+        for (name, configuration) in modes {
+            let sim = try NetmapSimulator(.init(name: "sim0", traffic: .repeating(frame)))
+            let csbPort = try sim.openCSBPort("sim0", configuration: configuration)
+            defer { csbPort.close() }
+            var csbReceived = 0
+            let elapsed = measure {
+                while csbReceived < total {
+                    csbReceived += csbPort.receiveBatches(timeout: 100) { _ in }
+                }
+            }
+            #expect(csbPort.syncLoopError == nil)
+            report(name, packets: csbReceived, elapsed: elapsed)
+            reportSyscalls(name, syscalls: csbPort.statistics().syscalls, packets: csbReceived)
+        }
+    }
+
+    @Test("One-packet round-trip latency: rxSync vs notified CSB")
+    func csbLatency() throws {
+        let rounds = max(packetCount / 200, 100)
+        let topology: [NetmapSimulator.InterfaceConfiguration] = [
+            .init(name: "sim0", transmit: .deliver(to: "sim1")),
+            .init(name: "sim1"),
+        ]
+
+        // ioctl path: spin on rxSync until the packet lands
+        let simA = try NetmapSimulator(interfaces: topology)
+        let txPort = try simA.openPort("sim0")
+        let rxPort = try simA.openPort("sim1")
+        let ioctlLatency = try latency(rounds: rounds) {
+            while try txPort.sendBurst(count: 1, fill: fill).sent == 0 {}
+        } receive: {
+            try rxPort.rxSync()
+            return rxPort.rxRing(0).withPackets { $0.count }
+        }
+        reportLatency("rxSync", latency: ioctlLatency)
+
+        // Notified CSB: the receiver sleeps on its eventfd until kicked
+        let simB = try NetmapSimulator(interfaces: topology)
+        let csbTx = try simB.openCSBPort("sim0", configuration: .notified)
+        let csbRx = try simB.openCSBPort("sim1", configuration: .notified)
+        defer {
+            csbTx.close()
+            csbRx.close()
+        }
+        let notifiedLatency = try latency(rounds: rounds) {
+            while try csbTx.sendBurst(count: 1, fill: fill).sent == 0 {}
+        } receive: {
+            csbRx.receiveBatches(timeout: 1000) { _ in }
+        }
+        reportLatency("csb notified", latency: notifiedLatency)
+        reportSyscalls(
+            "csb notified round trip",
+            syscalls: csbTx.statistics().syscalls + csbRx.statistics().syscalls,
+            packets: rounds
+        )
+
+        #expect(csbTx.syncLoopError == nil && csbRx.syncLoopError == nil)
+        // A missed kick would cost the full 1 s wait
+        #expect(notifiedLatency.median < .milliseconds(100))
+    }
+
+    // MARK: - Helpers
+
+    private func fill(_ index: Int, _ buffer: UnsafeMutableRawBufferPointer) -> Int {
+        frame.copyBytes(to: buffer)
+        return frame.count
+    }
+
+    /// Median and 99th percentile time from send until the packet is received.
+    private func latency(
+        rounds: Int,
+        send: () throws -> Void,
+        receive: () throws -> Int
+    ) throws -> (median: Duration, p99: Duration) {
+        let clock = ContinuousClock()
+        var samples: [Duration] = []
+        samples.reserveCapacity(rounds)
+        for _ in 0..<rounds {
+            let start = clock.now
+            try send()
+            while try receive() == 0 {}
+            samples.append(clock.now - start)
+        }
+        samples.sort()
+        return (samples[samples.count / 2], samples[min(samples.count - 1, samples.count * 99 / 100)])
+    }
+
+    private func forwardLoop(
+        from source: borrowing NetmapPort,
+        to destination: borrowing NetmapPort
+    ) throws -> (packets: Int, elapsed: Duration) {
+        let total = packetCount
+        var forwarded = 0
+        let elapsed = try measure {
+            while forwarded < total {
+                try source.rxSync()
+                for result in NetmapZeroCopy.forwardAll(from: source, to: destination) {
+                    forwarded += result.forwarded
+                }
+                try destination.txSync()
+            }
+        }
+        return (forwarded, elapsed)
+    }
+
+    private func measure(_ body: () throws -> Void) rethrows -> Duration {
+        let clock = ContinuousClock()
+        let start = clock.now
+        try body()
+        return clock.now - start
+    }
+
+    private func report(_ name: String, packets: Int, elapsed: Duration) {
+        let seconds = Double(elapsed.components.seconds) + Double(elapsed.components.attoseconds) / 1e18
+        let mpps = seconds > 0 ? Double(packets) / seconds / 1e6 : 0
+        print("Netmap sim \(name) 60B packets=\(packets) Mpps=\(String(format: "%.2f", mpps))")
+    }
+
+    private func reportSyscalls(_ name: String, syscalls: UInt64, packets: Int) {
+        let perPacket = packets > 0 ? Double(syscalls) / Double(packets) : 0
+        print("Netmap sim \(name) syscalls=\(syscalls) per-packet=\(String(format: "%.4f", perPacket))")
+    }
+
+    private func reportLatency(_ name: String, latency: (median: Duration, p99: Duration)) {
+        func micros(_ duration: Duration) -> String {
+            let value = Double(duration.components.seconds) * 1e6 + Double(duration.components.attoseconds) / 1e12
+            return String(format: "%.2f", value)
+        }
+        print("Netmap sim \(name) latency median-us=\(micros(latency.median)) p99-us=\(micros(latency.p99))")
+    }
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2026 Kory Heard
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+import Testing
+import Foundation
+@testable import Netmap
+
+/// Tests for the extra-buffer pool.
+@Suite("Netmap Buffer Pool Tests")
+struct NetmapBufferPoolTests {
+
+    @Test("Pool takes the kernel list and returns it on close")
+    func drainAndReturn() throws {
+        let sim = try NetmapSimulator(.init(name: "sim0", slotsPerRing: 64, extraBuffers: 32))
+        let port = try sim.openPort("sim0")
+        #expect(port.extraBufferCount == 32)
+
+        let pool = try NetmapBufferPool(port: port)
+        #expect(pool.capacity == 32)
+        #expect(pool.available == 32)
+        #expect(port.extraBuffersHead == 0)
+
+        pool.close(returningTo: port)
+        var returned: Set<UInt32> = []
+        port.forEachExtraBuffer { returned.insert($0) }
+        #expect(returned.count == 32)
+        #expect(pool.allocate() == nil)
+    }
+
+    @Test("Limit leaves the rest of the list with the kernel")
+    func limit() throws {
+        let sim = try NetmapSimulator(.init(name: "sim0", slotsPerRing: 64, extraBuffers: 32))
+        let port = try sim.openPort("sim0")
+
+        let pool = try NetmapBufferPool(port: port, limit: 10)
+        #expect(pool.capacity == 10)
+        var remaining = 0
+        port.forEachExtraBuffer { _ in remaining += 1 }
+        #expect(remaining == 22)
+    }
+
+    @Test("A port without extra buffers is rejected")
+    func noExtraBuffers() throws {
+        let sim = try NetmapSimulator(.init(name: "sim0", slotsPerRing: 64))
+        let port = try sim.openPort("sim0")
+        #expect(throws: NetmapError.self) {
+            _ = try NetmapBufferPool(port: port)
+        }
+    }
+
+    @Test("Bulk allocation and release move many buffers at once")
+    func bulk() throws {
+        let sim = try NetmapSimulator(.init(name: "sim0", slotsPerRing: 64, extraBuffers: 32))
+        let port = try sim.openPort("sim0")
+        let pool = try NetmapBufferPool(port: port)
+
+        var buffers: [UInt32] = []
+        #expect(pool.allocate(20, into: &buffers) == 20)
+        #expect(pool.allocate(20, into: &buffers) == 12)
+        #expect(Set(buffers).count == 32)
+        #expect(pool.available == 0)
+
+        pool.free(buffers)
+        #expect(pool.available == 32)
+    }
+
+    @Test("Caches refill and spill in half-size batches")
+    func cache() throws {
+        let sim = try NetmapSimulator(.init(name: "sim0", slotsPerRing: 64, extraBuffers: 32))
+        let port = try sim.openPort("sim0")
+        let pool = try NetmapBufferPool(port: port)
+        let cache = pool.makeCache(size: 8)
+
+        let first = cache.allocate()
+        #expect(first != nil)
+        #expect(cache.count == 3)
+        #expect(pool.available == 28)
+
+        var held: [UInt32] = [first!]
+        for _ in 0..<20 {
+            held.append(cache.allocate()!)
+        }
+        for buffer in held {
+            cache.free(buffer)
+        }
+        #expect(cache.count <= 8)
+
+        cache.flush()
+        #expect(cache.count == 0)
+        #expect(pool.available == 32)
+    }
+
+    @Test("Held packets leave the ring and transmit without copying")
+    func holdAndPlace() throws {
+        let sim = try NetmapSimulator(.init(name: "sim0", slotsPerRing: 64, extraBuffers: 16))
+        let frame = Data((0..<60).map { UInt8($0) })
+        for _ in 0..<4 {
+            sim.inject(frame, into: "sim0")
+        }
+        let port = try sim.openPort("sim0")
+        let pool = try NetmapBufferPool(port: port)
+        try port.rxSync()
+
+        var queue: [NetmapHeldBuffer] = []
+        var original: [UInt32] = []
+        port.rxRing(0).withPackets { batch in
+            for packet in batch {
+                original.append(packet.slot.bufferIndex)
+                queue.append(pool.hold(packet.slot)!)
+                #expect(packet.slot.flags.contains(.bufferChanged))
+            }
+        }
+        #expect(queue.map(\.bufferIndex) == original)
+        #expect(pool.available == 12)
+
+        // RX buffers are refilled while the held packets stay intact
+        for _ in 0..<4 {
+            sim.inject(Data(repeating: 0xFF, count: 60), into: "sim0")
+        }
+        try port.rxSync()
+        port.rxRing(0).withPackets { _ in }
+        #expect(Data(bytes: pool.pointer(to: queue[0].bufferIndex), count: 60) == frame)
+
+        let tx = port.txRing(0)
+        let sent = tx.withPackets(limit: queue.count) { slots in
+            for (slot, held) in zip(slots, queue) {
+                pool.place(held, into: slot.slot)
+            }
+            return slots.count
+        }
+        #expect(sent == 4)
+        #expect(pool.available == 16)
+        try port.txSync()
+
+        let stats = sim.statistics(for: "sim0")
+        #expect(stats.transmittedPackets == 4)
+        #expect(stats.transmittedBytes == 240)
+    }
+}
@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2026 Kory Heard
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+import Testing
+import Foundation
+@testable import Netmap
+
+/// Tests for the CSB datapath against the simulator's sync loop.
+@Suite("Netmap CSB Port Tests")
+struct NetmapCSBPortTests {
+
+    private let frame = Data((0..<60).map { UInt8($0) })
+
+    @Test("Packets arrive through the CSB")
+    func receive() throws {
+        let sim = try NetmapSimulator(.init(name: "sim0", slotsPerRing: 64))
+        let port = try sim.openCSBPort("sim0")
+        defer { port.close() }
+
+        for _ in 0..<10 {
+            sim.inject(frame, into: "sim0")
+        }
+
+        var received = 0
+        var payloads: [Data] = []
+        let deadline = Date().addingTimeInterval(5)
+        while received < 10, Date() < deadline {
+            received += port.receiveBatches(timeout: 100) { batch in
+                payloads += batch.map { $0.copyData() }
+            }
+        }
+
+        #expect(received == 10)
+        #expect(payloads.allSatisfy { $0 == frame })
+        let stats = port.statistics()
+        #expect(stats.rxSyncs > 0)
+        #expect(port.syncLoopError == nil)
+    }
+
+    @Test("Ring tail follows the CSB hwtail")
+    func tailFromCSB() throws {
+        let sim = try NetmapSimulator(.init(name: "sim0", slotsPerRing: 64))
+        let port = try sim.openCSBPort("sim0")
+        defer { port.close() }
+
+        sim.inject(frame, into: "sim0")
+        #expect(port.waitForRx(timeout: 5000))
+
+        let entry = Int(port.txRingCount)
+        #expect(port.rxRing(0).tail == port.csb.getHwtail(ring: entry))
+        #expect(port.rxRing(0).space == 1)
+    }
+
+    @Test("Bursts are consumed by the sync loop")
+    func transmit() throws {
+        let sim = try NetmapSimulator(.init(name: "sim0", slotsPerRing: 64))
+        let port = try sim.openCSBPort("sim0")
+        defer { port.close() }
+
+        let result = try port.sendBurst(count: 20) { _, buffer in
+            frame.copyBytes(to: buffer)
+            return frame.count
+        }
+        #expect(result.sent == 20)
+
+        let deadline = Date().addingTimeInterval(5)
+        while sim.statistics(for: "sim0").transmittedPackets < 20, Date() < deadline {
+            port.txSync()
+        }
+        #expect(sim.statistics(for: "sim0").transmittedPackets == 20)
+
+        // Completed slots come back as free space
+        #expect(port.waitForTx(timeout: 1000))
+        #expect(port.txRing(0).space == 63)
+    }
+
+    @Test("An idle RX wait sleeps until the sync loop kicks it")
+    func rxWaitSleeps() throws {
+        let sim = try NetmapSimulator(.init(name: "sim0", slotsPerRing: 64))
+        let port = try sim.openCSBPort("sim0", configuration: .notified)
+        defer { port.close() }
+
+        DispatchQueue.global().asyncAfter(deadline: .now() + .milliseconds(50)) {
+            sim.inject(frame, into: "sim0")
+        }
+        #expect(port.waitForRx(timeout: 5000))
+        #expect(port.rxRing(0).space == 1)
+        #expect(port.statistics().sleeps > 0)
+        #expect(port.syncLoopError == nil)
+    }
+
+    @Test("A packet delivered by a peer wakes a sleeping RX wait")
+    func peerDeliveryWakesRxWait() throws {
+        let sim = try NetmapSimulator(interfaces: [
+            .init(name: "sim0", slotsPerRing: 64, transmit: .deliver(to: "sim1")),
+            .init(name: "sim1", slotsPerRing: 64),
+        ])
+        let tx = try sim.openCSBPort("sim0", configuration: .notified)
+        let rx = try sim.openCSBPort("sim1", configuration: .notified)
+        defer {
+            tx.close()
+            rx.close()
+        }
+
+        DispatchQueue.global().asyncAfter(deadline: .now() + .milliseconds(50)) {
+            _ = try? tx.sendBurst(count: 1) { _, buffer in
+                frame.copyBytes(to: buffer)
+                return frame.count
+            }
+        }
+
+        // Without the kick the wait would run to its timeout
+        let clock = ContinuousClock()
+        let start = clock.now
+        #expect(rx.waitForRx(timeout: 5000))
+        #expect(clock.now - start < .seconds(2))
+        #expect(rx.rxRing(0).space == 1)
+        #expect(rx.statistics().sleeps > 0)
+    }
+
+    @Test("A sync kicks the sync loop once it has gone to sleep")
+    func txKicksSleepingLoop() throws {
+        let sim = try NetmapSimulator(.init(name: "sim0", slotsPerRing: 64))
+        let port = try sim.openCSBPort("sim0", configuration: .notified)
+        defer { port.close() }
+
+        // The loop wakes on its own every few milliseconds, so a burst can
+        // land while it is awake; retry until one finds it asleep.
+        var sent: UInt64 = 0
+        var attempts = 0
+        while port.statistics().kicks == 0, attempts < 100 {
+            attempts += 1
+            let deadline = Date().addingTimeInterval(1)
+            while !port.csb.getKernNeedKick(ring: 0), Date() < deadline {
+                sched_yield()
+            }
+            let result = try port.sendBurst(count: 1) { _, buffer in
+                frame.copyBytes(to: buffer)
+                return frame.count
+            }
+            sent += UInt64(result.sent)
+        }
+        #expect(port.statistics().kicks > 0)
+
+        let deadline = Date().addingTimeInterval(5)
+        while sim.statistics(for: "sim0").transmittedPackets < sent, Date() < deadline {
+            usleep(1000)
+        }
+        #expect(sim.statistics(for: "sim0").transmittedPackets == sent)
+    }
+
+    @Test("A full TX ring is woken when the sync loop frees slots")
+    func txWaitOnFullRing() throws {
+        let sim = try NetmapSimulator(.init(name: "sim0", slotsPerRing: 64))
+        let port = try sim.openCSBPort("sim0", configuration: .notified)
+        defer { port.close() }
+
+        let result = try port.sendBurst(count: 63) { _, buffer in
+            frame.copyBytes(to: buffer)
+            return frame.count
+        }
+        #expect(result.sent == 63)
+
+        let deadline = Date().addingTimeInterval(5)
+        while port.txRing(0).space < 63, Date() < deadline {
+            _ = port.waitForTx(timeout: 100)
+        }
+        #expect(port.txRing(0).space == 63)
+        #expect(sim.statistics(for: "sim0").transmittedPackets == 63)
+    }
+
+    @Test("A notified wait times out on an idle port")
+    func notifiedIdleTimeout() throws {
+        let sim = try NetmapSimulator(.init(name: "sim0"))
+        let port = try sim.openCSBPort("sim0", configuration: .notified)
+        defer { port.close() }
+
+        #expect(!port.waitForRx(timeout: 20))
+        #expect(port.statistics().sleeps > 0)
+    }
+
+    @Test("waitForRx times out on an idle port")
+    func idleTimeout() throws {
+        let sim = try NetmapSimulator(.init(name: "sim0"))
+        let port = try sim.openCSBPort("sim0", configuration: .init(sleepMicroseconds: 100))
+        defer { port.close() }
+
+        #expect(!port.waitForRx(timeout: 0))
+        #expect(!port.waitForRx(timeout: 20))
+    }
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2026 Kory Heard
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+import Testing
+import Foundation
+@testable import Netmap
+
+/// Tests for the compiled packet classifier.
+@Suite("Netmap Classifier Tests")
+struct NetmapClassifierTests {
+
+    @Test("Address prefixes parse from CIDR strings")
+    func prefixParsing() {
+        let v4 = NetmapAddressPrefix("10.1.0.0/16")
+        #expect(v4?.address == [10, 1, 0, 0])
+        #expect(v4?.length == 16)
+        #expect(v4?.isIPv6 == false)
+
+        let v6 = NetmapAddressPrefix("2001:db8::/32")
+        #expect(v6?.address.count == 16)
+        #expect(v6?.length == 32)
+
+        #expect(NetmapAddressPrefix("192.0.2.1")?.length == 32)
+        #expect(NetmapAddressPrefix("10.0.0.0/33") == nil)
+        #expect(NetmapAddressPrefix("not-an-address") == nil)
+    }
+
+    @Test("Rules match IPv4 5-tuple fields")
+    func ipv4Rules() {
+        let classifier = NetmapClassifier(rules: [
+            NetmapFilterRule(.accept, ipProtocol: 6, destinationPorts: 443...443),
+            NetmapFilterRule(.drop, source: NetmapAddressPrefix("10.0.0.0/8")),
+        ], defaultAction: .accept)
+
+        let https = Self.ipv4(source: [10, 0, 0, 1], proto: 6, destinationPort: 443)
+        let dns = Self.ipv4(source: [10, 0, 0, 1], proto: 17, destinationPort: 53)
+        let outside = Self.ipv4(source: [192, 0, 2, 1], proto: 17, destinationPort: 53)
+
+        #expect(Self.classify(classifier, https) == .accept)
+        #expect(Self.matching(classifier, https) == 0)
+        #expect(Self.classify(classifier, dns) == .drop)
+        #expect(Self.matching(classifier, dns) == 1)
+        #expect(Self.classify(classifier, outside) == .accept)
+        #expect(Self.matching(classifier, outside) == nil)
+    }
+
+    @Test("Rules match VLAN, IPv6 and EtherType")
+    func vlanAndIPv6Rules() {
+        let classifier = NetmapClassifier(rules: [
+            NetmapFilterRule(.accept, vlanId: 100),
+            NetmapFilterRule(.accept, destination: NetmapAddressPrefix("2001:db8::/32"), sourcePorts: 1024...65535),
+            NetmapFilterRule(.accept, etherType: 0x0806),
+        ], defaultAction: .drop)
+
+        #expect(Self.classify(classifier, Self.ipv4(source: [192, 0, 2, 1], proto: 17, destinationPort: 53, vlan: 100)) == .accept)
+        #expect(Self.classify(classifier, Self.ipv4(source: [192, 0, 2, 1], proto: 17, destinationPort: 53, vlan: 200)) == .drop)
+        #expect(Self.classify(classifier, Self.ipv6(destinationPrefix: [0x20, 0x01, 0x0d, 0xb8], sourcePort: 40000)) == .accept)
+        #expect(Self.classify(classifier, Self.ipv6(destinationPrefix: [0x20, 0x01, 0x0d, 0xb8], sourcePort: 80)) == .drop)
+        #expect(Self.classify(classifier, Self.ipv6(destinationPrefix: [0xfe, 0x80, 0x00, 0x00], sourcePort: 40000)) == .drop)
+
+        var arp = [UInt8](repeating: 0, count: 42)
+        arp[12] = 0x08
+        arp[13] = 0x06
+        #expect(Self.classify(classifier, arp) == .accept)
+        #expect(Self.classify(classifier, [0x00, 0x01]) == .drop)
+    }
+
+    @Test("forwardFiltered with a classifier forwards accepted packets")
+    func forwardWithClassifier() throws {
+        let web = Data(Self.ipv4(source: [192, 0, 2, 1], proto: 6, destinationPort: 80))
+        let other = Data(Self.ipv4(source: [192, 0, 2, 1], proto: 6, destinationPort: 22))
+        let sim = try NetmapSimulator(interfaces: [.init(name: "sim0"), .init(name: "sim1")])
+        for i in 0..<10 {
+            sim.inject(i % 2 == 0 ? web : other, into: "sim0")
+        }
+
+        let source = try sim.openPort("sim0")
+        let destination = try sim.openPort("sim1")
+        try source.rxSync()
+
+        let classifier = NetmapClassifier(rules: [
+            NetmapFilterRule(.accept, destinationPorts: 80...80),
+        ], defaultAction: .drop)
+        let result = NetmapZeroCopy.forwardFiltered(
+            from: source.rxRing(0),
+            to: destination.txRing(0),
+            classifier: classifier
+        )
+
+        #expect(result.forwarded == 5)
+        #expect(result.filtered == 5)
+        #expect(source.rxRing(0).isEmpty)
+        let tx = destination.txRing(0)
+        #expect(tx.bufferData(for: tx.slot(at: 0)) == web)
+    }
+
+    // MARK: - Helpers
+
+    private static func classify(_ classifier: NetmapClassifier, _ packet: [UInt8]) -> NetmapFilterRule.Action {
+        return packet.withUnsafeBytes { classifier.classify($0) }
+    }
+
+    private static func matching(_ classifier: NetmapClassifier, _ packet: [UInt8]) -> Int? {
+        return packet.withUnsafeBytes { classifier.matchingRule($0) }
+    }
+
+    /// Ethernet + IPv4 + 8 bytes of L4 header.
+    private static func ipv4(
+        source: [UInt8],
+        proto: UInt8,
+        destinationPort: UInt16,
+        vlan: UInt16? = nil
+    ) -> [UInt8] {
+        var frame = [UInt8](repeating: 0, count: 12)
+        if let vlan {
+            frame += [0x81, 0x00, UInt8(vlan >> 8), UInt8(vlan & 0xFF)]
+        }
+        frame += [0x08, 0x00]
+        var ip = [UInt8](repeating: 0, count: 20)
+        ip[0] = 0x45
+        ip[9] = proto
+        ip.replaceSubrange(12..<16, with: source)
+        ip.replaceSubrange(16..<20, with: [192, 0, 2, 99])
+        frame += ip
+        frame += [0x30, 0x39, UInt8(destinationPort >> 8), UInt8(destinationPort & 0xFF), 0, 0, 0, 0]
+        return frame
+    }
+
+    /// Ethernet + IPv6 (UDP) + 8 bytes of L4 header.
+    private static func ipv6(destinationPrefix: [UInt8], sourcePort: UInt16) -> [UInt8] {
+        var frame = [UInt8](repeating: 0, count: 12) + [0x86, 0xDD]
+        var ip = [UInt8](repeating: 0, count: 40)
+        ip[0] = 0x60
+        ip[6] = 17
+        ip.replaceSubrange(24..<28, with: destinationPrefix)
+        ip[39] = 1
+        frame += ip
+        frame += [UInt8(sourcePort >> 8), UInt8(sourcePort & 0xFF), 0, 53, 0, 0, 0, 0]
+        return frame
+    }
+}
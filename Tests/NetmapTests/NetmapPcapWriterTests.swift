@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2026 Kory Heard
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+import Testing
+import Foundation
+import Glibc
+@testable import Netmap
+
+/// Tests for the pcapng capture writer.
+@Suite("Netmap Pcap Writer Tests")
+struct NetmapPcapWriterTests {
+
+    @Test("File starts with section and interface headers")
+    func fileHeader() throws {
+        let path = Self.temporaryPath("header")
+        defer { unlink(path) }
+
+        let writer = try NetmapPcapWriter(configuration: .init(path: path, snapLength: 256))
+        writer.close()
+
+        let file = try Data(contentsOf: URL(fileURLWithPath: path))
+        #expect(file.count == 48)
+        #expect(Self.u32(file, 0) == 0x0A0D_0D0A)
+        #expect(Self.u32(file, 8) == 0x1A2B_3C4D)
+        #expect(Self.u32(file, 28) == 1)
+        #expect(Self.u32(file, 40) == 256)
+    }
+
+    @Test("Packets become Enhanced Packet Blocks cut to the snap length")
+    func packetBlocks() throws {
+        let path = Self.temporaryPath("blocks")
+        defer { unlink(path) }
+
+        let writer = try NetmapPcapWriter(configuration: .init(path: path, snapLength: 64, bufferSize: 4096))
+        let short = [UInt8](repeating: 0xAA, count: 61)
+        let long = [UInt8](repeating: 0xBB, count: 1500)
+        let timestamp = timeval(tv_sec: 1_700_000_000, tv_usec: 123_456)
+        short.withUnsafeBytes { writer.write($0, timestamp: timestamp) }
+        long.withUnsafeBytes { writer.write($0, timestamp: timestamp) }
+        writer.close()
+
+        let stats = writer.statistics()
+        #expect(stats.packetsWritten == 2)
+        #expect(stats.packetsTruncated == 1)
+        #expect(stats.packetsDropped == 0)
+
+        let blocks = Self.packetBlocks(try Data(contentsOf: URL(fileURLWithPath: path)))
+        #expect(blocks.count == 2)
+        #expect(blocks[0].captured == 61)
+        #expect(blocks[0].original == 61)
+        #expect(blocks[1].captured == 64)
+        #expect(blocks[1].original == 1500)
+        #expect(blocks[0].microseconds == 1_700_000_000_123_456)
+        #expect(blocks[1].data == Data(repeating: 0xBB, count: 64))
+    }
+
+    @Test("Full buffers are written as capture proceeds")
+    func manyBuffers() throws {
+        let path = Self.temporaryPath("many")
+        defer { unlink(path) }
+
+        let writer = try NetmapPcapWriter(configuration: .init(path: path, bufferSize: 4096, bufferCount: 64))
+        let packet = [UInt8](repeating: 0x11, count: 60)
+        let timestamp = timeval(tv_sec: 0, tv_usec: 0)
+        for _ in 0..<1000 {
+            packet.withUnsafeBytes { writer.write($0, timestamp: timestamp) }
+        }
+        writer.close()
+
+        let stats = writer.statistics()
+        #expect(stats.packetsWritten == 1000)
+        #expect(stats.packetsDropped == 0)
+        let blocks = Self.packetBlocks(try Data(contentsOf: URL(fileURLWithPath: path)))
+        #expect(UInt64(blocks.count) == stats.packetsWritten)
+    }
+
+    @Test("Output rotates through a ring of files")
+    func rotation() throws {
+        let path = Self.temporaryPath("rotate")
+        let writer = try NetmapPcapWriter(configuration: .init(
+            path: path,
+            snapLength: 128,
+            bufferSize: 1024,
+            bufferCount: 256,
+            maxFileSize: 2048,
+            maxFiles: 3
+        ))
+        let paths = (0..<3).map { writer.filePath(index: $0) }
+        defer { paths.forEach { unlink($0) } }
+        #expect(paths[1].hasSuffix(".1.pcapng"))
+
+        let packet = [UInt8](repeating: 0x22, count: 100)
+        let timestamp = timeval(tv_sec: 0, tv_usec: 0)
+        for _ in 0..<200 {
+            packet.withUnsafeBytes { writer.write($0, timestamp: timestamp) }
+            writer.flush()
+        }
+        writer.close()
+
+        let stats = writer.statistics()
+        #expect(stats.filesOpened > 3)
+        for path in paths {
+            let file = try Data(contentsOf: URL(fileURLWithPath: path))
+            #expect(file.count <= 2048)
+            #expect(Self.u32(file, 0) == 0x0A0D_0D0A)
+        }
+    }
+
+    @Test("Packets are written from simulated RX slots")
+    func writeFromRing() throws {
+        let path = Self.temporaryPath("ring")
+        defer { unlink(path) }
+
+        let sim = try NetmapSimulator(.init(name: "sim0"))
+        let frame = Data((0..<60).map { UInt8($0) })
+        for _ in 0..<8 {
+            sim.inject(frame, into: "sim0")
+        }
+        let port = try sim.openPort("sim0")
+        try port.rxSync()
+
+        let writer = try NetmapPcapWriter(configuration: .init(path: path))
+        let ring = port.rxRing(0)
+        ring.withPackets { batch in
+            writer.write(batch, timestamp: timeval(tv_sec: 1, tv_usec: 0))
+        }
+        writer.close()
+
+        let blocks = Self.packetBlocks(try Data(contentsOf: URL(fileURLWithPath: path)))
+        #expect(blocks.count == 8)
+        #expect(blocks.allSatisfy { $0.data == frame })
+        #expect(ring.isEmpty)
+    }
+
+    // MARK: - Helpers
+
+    private struct PacketBlock {
+        var microseconds: UInt64
+        var captured: Int
+        var original: Int
+        var data: Data
+    }
+
+    private static func temporaryPath(_ name: String) -> String {
+        return NSTemporaryDirectory() + "netmap-\(name)-\(getpid()).pcapng"
+    }
+
+    private static func u32(_ data: Data, _ offset: Int) -> UInt32 {
+        return data.withUnsafeBytes { $0.loadUnaligned(fromByteOffset: offset, as: UInt32.self) }
+    }
+
+    /// Walks the blocks after the headers and decodes each Enhanced Packet Block.
+    private static func packetBlocks(_ file: Data) -> [PacketBlock] {
+        var blocks: [PacketBlock] = []
+        var offset = 48
+        while offset + 12 <= file.count {
+            let type = u32(file, offset)
+            let length = Int(u32(file, offset + 4))
+            guard length >= 12, offset + length <= file.count else { break }
+            if type == 6 {
+                let captured = Int(u32(file, offset + 20))
+                let start = file.startIndex + offset + 28
+                blocks.append(PacketBlock(
+                    microseconds: UInt64(u32(file, offset + 12)) << 32 | UInt64(u32(file, offset + 16)),
+                    captured: captured,
+                    original: Int(u32(file, offset + 24)),
+                    data: file.subdata(in: start..<start + captured)
+                ))
+            }
+            offset += length
+        }
+        return blocks
+    }
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2026 Kory Heard
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+import Testing
+import Foundation
+@testable import Netmap
+
+/// Tests for per-ring counters and the latency histogram.
+@Suite("Netmap Ring Statistics Tests")
+struct NetmapRingStatisticsTests {
+
+    private let frame = Data((0..<60).map { UInt8($0) })
+
+    @Test("Ring blocks are padded to whole cache lines")
+    func blockLayout() {
+        #expect(NetmapRingStatistics.blockSize % 128 == 0)
+    }
+
+    @Test("Every value falls inside its bucket, within 1/16 of its width")
+    func bucketBounds() {
+        var values: [UInt64] = Array(0..<300)
+        for shift in 5..<36 {
+            let base = UInt64(1) << UInt64(shift)
+            values += [base - 1, base, base + 1, base + base / 3]
+        }
+        for value in values {
+            let bucket = NetmapLatencyHistogram.bucket(for: value)
+            let lower = NetmapLatencyHistogram.lowerBound(of: bucket)
+            let upper = NetmapLatencyHistogram.upperBound(of: bucket)
+            #expect(lower <= value && value <= upper)
+            #expect(upper - lower <= max(lower / 16, 1))
+        }
+        #expect(NetmapLatencyHistogram.bucket(for: 31) == 31)
+        #expect(NetmapLatencyHistogram.bucket(for: 32) == 32)
+        #expect(NetmapLatencyHistogram.bucket(for: .max) == NetmapLatencyHistogram.bucketCount - 1)
+    }
+
+    @Test("Percentiles come from bucket bounds, capped at the maximum")
+    func percentiles() {
+        var histogram = NetmapLatencyHistogram()
+        #expect(histogram.percentile(50) == 0)
+
+        for value in UInt64(1)...100 {
+            histogram.record(value)
+        }
+        #expect(histogram.count == 100)
+        #expect(histogram.maximum == 100)
+        #expect(histogram.mean == 50.5)
+        #expect(histogram.percentile(10) == 10)
+        #expect((50...53).contains(histogram.percentile(50)))
+        #expect(histogram.percentile(100) == 100)
+    }
+
+    @Test("Batch receive records packets, bytes, syncs, empty polls, and latency")
+    func receive() throws {
+        let sim = try NetmapSimulator(.init(name: "sim0", slotsPerRing: 64))
+        var port = try sim.openPort("sim0")
+        let stats = port.enableRingStatistics()
+
+        for _ in 0..<10 {
+            sim.inject(frame, into: "sim0")
+        }
+        #expect(try port.receiveBatches(timeout: 0) { _ in } == 10)
+        #expect(try port.receiveBatches(timeout: 0) { _ in } == 0)
+
+        let rx = stats.snapshot().rings[1]
+        #expect(rx.kind == .rx)
+        #expect(rx.packets == 10)
+        #expect(rx.bytes == 600)
+        #expect(rx.batches == 1)
+        #expect(rx.averageBatchSize == 10)
+        #expect(rx.syncs == 1)
+        #expect(rx.emptyPolls == 1)
+        #expect(rx.latency.count == 1)
+    }
+
+    @Test("Bursts record packets and ring-full events")
+    func transmit() throws {
+        let sim = try NetmapSimulator(.init(name: "sim0", slotsPerRing: 64))
+        let port = try sim.openPort("sim0")
+        let stats = NetmapRingStatistics(port: port)
+
+        let frame = self.frame
+        let fill: (Int, UnsafeMutableRawBufferPointer) -> Int = { _, buffer in
+            frame.copyBytes(to: buffer)
+            return frame.count
+        }
+        #expect(port.fillBurst(count: 100, statistics: stats, fill: fill).sent == 63)
+        #expect(port.fillBurst(count: 10, statistics: stats, fill: fill).sent == 0)
+
+        let tx = stats.snapshot().rings[0]
+        #expect(tx.kind == .tx)
+        #expect(tx.packets == 63)
+        #expect(tx.bytes == 63 * 60)
+        #expect(tx.ringFullEvents == 1)
+    }
+
+    @Test("Deltas count only what happened between snapshots")
+    func delta() {
+        let stats = NetmapRingStatistics(txRings: 1, rxRings: 2)
+        stats.recordBatch(.rx, ring: 1, packets: 4, bytes: 256)
+        stats.recordLatency(.rx, ring: 1, nanoseconds: 1000)
+        let first = stats.snapshot()
+
+        stats.recordBatch(.rx, ring: 1, packets: 6, bytes: 384)
+        stats.recordLatency(.rx, ring: 1, nanoseconds: 2000)
+        stats.recordBatch(.rx, ring: 7, packets: 1, bytes: 1)
+        let delta = stats.snapshot().delta(since: first)
+
+        #expect(delta.rings.count == 3)
+        let ring = delta.rings[2]
+        #expect(ring.index == 1)
+        #expect(ring.packets == 6)
+        #expect(ring.bytes == 384)
+        #expect(ring.latency.count == 1)
+        #expect(ring.latency.sum == 2000)
+        #expect(delta.rings[0].packets == 0)
+    }
+}
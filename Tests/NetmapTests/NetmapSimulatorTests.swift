@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2026 Kory Heard
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+import Testing
+import Foundation
+@testable import Netmap
+
+/// Tests for the in-memory simulator backend.
+///
+/// These run without /dev/netmap.
+@Suite("Netmap Simulator Tests")
+struct NetmapSimulatorTests {
+
+    @Test("Simulated port exposes the configured layout")
+    func layout() throws {
+        let sim = try NetmapSimulator(.init(name: "sim0", txRings: 2, rxRings: 3, slotsPerRing: 256))
+        let port = try sim.openPort("sim0")
+
+        #expect(port.isRegistered)
+        #expect(port.txRingCount == 2)
+        #expect(port.rxRingCount == 3)
+        #expect(port.memoryId == sim.memoryId)
+
+        let tx = port.txRing(1)
+        #expect(tx.numSlots == 256)
+        #expect(tx.bufferSize == 2048)
+        #expect(tx.ringId == 1)
+        #expect(tx.space == 255)
+        #expect(port.rxRing(2).isEmpty)
+    }
+
+    @Test("Unknown interfaces and targets are rejected")
+    func invalidConfiguration() throws {
+        let sim = try NetmapSimulator(.init(name: "sim0"))
+        #expect(throws: NetmapError.self) { _ = try sim.openPort("sim1") }
+        #expect(throws: NetmapError.self) {
+            _ = try NetmapSimulator(.init(name: "sim0", transmit: .deliver(to: "nowhere")))
+        }
+    }
+
+    @Test("Injected packets are received in order")
+    func injectAndReceive() throws {
+        let sim = try NetmapSimulator(.init(name: "sim0"))
+        let port = try sim.openPort("sim0")
+
+        for i in 0..<3 {
+            sim.inject(Data([UInt8(i), 0xAA, 0xBB, 0xCC]), into: "sim0")
+        }
+
+        var markers: [UInt8] = []
+        let received = try port.receiveBatches(timeout: 0) { batch in
+            for packet in batch {
+                markers.append(packet[0])
+            }
+        }
+
+        #expect(received == 3)
+        #expect(markers == [0, 1, 2])
+        #expect(port.rxRing(0).isEmpty)
+        #expect(sim.statistics(for: "sim0").receivedPackets == 3)
+    }
+
+    @Test("Repeating traffic fills every free slot but one")
+    func repeatingTraffic() throws {
+        let sim = try NetmapSimulator(.init(name: "sim0", slotsPerRing: 64, traffic: .repeating(Data(count: 60))))
+        let port = try sim.openPort("sim0")
+
+        try port.rxSync()
+        #expect(port.rxRing(0).space == 63)
+
+        // Releasing slots lets the kernel side refill them
+        port.rxRing(0).advance(by: 10)
+        try port.rxSync()
+        #expect(port.rxRing(0).space == 63)
+        #expect(sim.statistics(for: "sim0").receivedPackets == 73)
+    }
+
+    @Test("Transmitted packets are delivered to the peer")
+    func deliver() throws {
+        let sim = try NetmapSimulator(interfaces: [
+            .init(name: "sim0", transmit: .deliver(to: "sim1")),
+            .init(name: "sim1"),
+        ])
+        let sender = try sim.openPort("sim0")
+        let receiver = try sim.openPort("sim1")
+
+        #expect(try sender.sendPacket(Data([0x01, 0x02, 0x03, 0x04])))
+        let packet = try receiver.receivePacket(timeout: 0)
+        #expect(packet == Data([0x01, 0x02, 0x03, 0x04]))
+
+        let stats = sim.statistics(for: "sim0")
+        #expect(stats.transmittedPackets == 1)
+        #expect(stats.transmittedBytes == 4)
+        #expect(sender.txRing(0).space == 1023)
+    }
+
+    @Test("Forwarding between interfaces of one simulator is zero-copy")
+    func zeroCopyForward() throws {
+        let sim = try NetmapSimulator(interfaces: [
+            .init(name: "sim0", traffic: .repeating(Data(count: 60))),
+            .init(name: "sim1"),
+        ])
+        let source = try sim.openPort("sim0")
+        let destination = try sim.openPort("sim1")
+        #expect(NetmapZeroCopy.sharesMemory(source, destination))
+
+        try source.rxSync()
+        let results = NetmapZeroCopy.forwardAll(from: source, to: destination)
+        try destination.txSync()
+
+        #expect(results.count == 1)
+        #expect(results[0].zeroCopy)
+        #expect(results[0].forwarded == 1023)
+        #expect(sim.statistics(for: "sim1").transmittedPackets == 1023)
+    }
+
+    @Test("Forwarding between simulators copies")
+    func copyForward() throws {
+        let simA = try NetmapSimulator(.init(name: "sim0", traffic: .repeating(Data(repeating: 0x5A, count: 60))))
+        let simB = try NetmapSimulator(.init(name: "sim0"))
+        let source = try simA.openPort("sim0")
+        let destination = try simB.openPort("sim0")
+        #expect(!NetmapZeroCopy.sharesMemory(source, destination))
+
+        try source.rxSync()
+        let forwarded = NetmapZeroCopy.forward(from: source.rxRing(0), to: destination.txRing(0), maxPackets: 100)
+        #expect(forwarded == 100)
+
+        let tx = destination.txRing(0)
+        let slot = tx.slot(at: 0)
+        #expect(slot.length == 60)
+        #expect(tx.bufferData(for: slot) == Data(repeating: 0x5A, count: 60))
+    }
+}
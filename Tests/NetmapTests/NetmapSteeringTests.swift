@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2026 Kory Heard
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+import Testing
+import Foundation
+@testable import Netmap
+
+/// Tests for software flow steering.
+@Suite("Netmap Steering Tests")
+struct NetmapSteeringTests {
+
+    @Test("Toeplitz hash matches the Microsoft RSS verification vectors")
+    func toeplitzVectors() {
+        let steering = NetmapSteering(destinations: 1)
+
+        // 66.9.149.187:2794 -> 161.142.100.80:1766
+        let tcp = Self.ipv4(source: [66, 9, 149, 187], destination: [161, 142, 100, 80], proto: 6, ports: (2794, 1766))
+        let ip = Self.ipv4(source: [66, 9, 149, 187], destination: [161, 142, 100, 80], proto: 1, ports: (0, 0))
+
+        #expect(tcp.withUnsafeBytes { steering.hash($0) } == 0x51CC_C178)
+        #expect(ip.withUnsafeBytes { steering.hash($0) } == 0x323E_8FC2)
+    }
+
+    @Test("Non-IP packets hash to zero")
+    func nonIP() {
+        let steering = NetmapSteering(hash: .multiplicative, destinations: 4)
+        var arp = [UInt8](repeating: 0, count: 42)
+        arp[12] = 0x08
+        arp[13] = 0x06
+        #expect(arp.withUnsafeBytes { steering.hash($0) } == 0)
+    }
+
+    @Test("Indirection table rounds up and covers every destination")
+    func indirectionTable() {
+        let steering = NetmapSteering(hash: .multiplicative, destinations: 3, tableSize: 100)
+        #expect(steering.indirectionTable.count == 128)
+        #expect(Set(steering.indirectionTable) == [0, 1, 2])
+    }
+
+    @Test("Steering spreads flows across TX rings and keeps flows together")
+    func steerAcrossRings() throws {
+        let sim = try NetmapSimulator(interfaces: [
+            .init(name: "sim0"),
+            .init(name: "sim1", txRings: 4),
+        ])
+        let source = try sim.openPort("sim0")
+        let destination = try sim.openPort("sim1")
+
+        // 64 flows, each sent twice
+        for _ in 0..<2 {
+            for flow in 0..<64 {
+                let packet = Self.ipv4(
+                    source: [10, 0, 0, UInt8(flow)],
+                    destination: [10, 0, 1, 1],
+                    proto: 17,
+                    ports: (UInt16(1000 + flow), 53)
+                )
+                sim.inject(Data(packet), into: "sim0")
+            }
+        }
+        try source.rxSync()
+
+        let steering = NetmapSteering(destinations: 4)
+        let result = steering.steer(from: source.rxRing(0), to: destination)
+
+        #expect(result.steered == 128)
+        #expect(result.dropped == 0)
+        #expect(result.perDestination.allSatisfy { $0 > 0 })
+        #expect(result.perDestination.allSatisfy { $0 % 2 == 0 })
+        #expect(source.rxRing(0).isEmpty)
+    }
+
+    @Test("Steering copies between separate allocators")
+    func steerWithCopy() throws {
+        let simA = try NetmapSimulator(.init(name: "sim0"))
+        let simB = try NetmapSimulator(.init(name: "sim1", txRings: 2))
+        let packet = Data(Self.ipv4(source: [192, 0, 2, 1], destination: [192, 0, 2, 2], proto: 6, ports: (40000, 80)))
+        simA.inject(packet, into: "sim0")
+
+        let source = try simA.openPort("sim0")
+        let destination = try simB.openPort("sim1")
+        try source.rxSync()
+
+        var targets = NetmapSteeringTargets()
+        destination.forEachTxRing { targets.append($0) }
+        let steering = NetmapSteering(hash: .multiplicative, destinations: targets.count)
+        let result = steering.steer(from: source.rxRing(0), to: targets)
+
+        #expect(result.steered == 1)
+        let index = result.perDestination.firstIndex(of: 1)!
+        let tx = destination.txRing(UInt32(index))
+        #expect(tx.bufferData(for: tx.slot(at: 0)) == packet)
+    }
+
+    // MARK: - Helpers
+
+    /// Ethernet + IPv4 + 8 bytes of L4 header.
+    private static func ipv4(
+        source: [UInt8],
+        destination: [UInt8],
+        proto: UInt8,
+        ports: (UInt16, UInt16)
+    ) -> [UInt8] {
+        var frame = [UInt8](repeating: 0, count: 12) + [0x08, 0x00]
+        var ip = [UInt8](repeating: 0, count: 20)
+        ip[0] = 0x45
+        ip[9] = proto
+        ip.replaceSubrange(12..<16, with: source)
+        ip.replaceSubrange(16..<20, with: destination)
+        frame += ip
+        frame += [UInt8(ports.0 >> 8), UInt8(ports.0 & 0xFF), UInt8(ports.1 >> 8), UInt8(ports.1 & 0xFF), 0, 0, 0, 0]
+        return frame
+    }
+}
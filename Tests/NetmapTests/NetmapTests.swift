@@ -805,6 +805,80 @@ struct ZeroCopyTests {
         #expect(NetmapVALE.isVALEName("vale0:test") == true)
         #expect(NetmapVALE.isVALEName("em0") == false)
     }
+
+    @Test("Ports on one allocator share memory and forward by swap")
+    func sharedAllocatorForward() throws {
+        // Interfaces of one simulator share an allocator; VALE ports only do
+        // when registered with an explicit nr_mem_id, so use the simulator
+        let sim = try NetmapSimulator(interfaces: [
+            .init(name: "sim0", slotsPerRing: 64),
+            .init(name: "sim1", slotsPerRing: 64),
+        ])
+        let other = try NetmapSimulator(.init(name: "sim2", slotsPerRing: 64))
+        let port0 = try sim.openPort("sim0")
+        let port1 = try sim.openPort("sim1")
+        let port2 = try other.openPort("sim2")
+
+        #expect(port0.memoryId != 0)
+        #expect(port0.memoryId == port1.memoryId)
+        #expect(port0.rxRing(0).memoryId == port0.memoryId)
+        #expect(NetmapZeroCopy.sharesMemory(port0, port1))
+        #expect(!NetmapZeroCopy.sharesMemory(port0, port2))
+        #expect(!NetmapZeroCopy.sharesMemory(port0.rxRing(0), port2.txRing(0)))
+
+        for i in 0..<4 {
+            sim.inject(Data([0xAA, 0xBB, 0xCC, UInt8(i)]), into: "sim0")
+        }
+        try port0.rxSync()
+
+        let before = NetmapZeroCopy.statistics.snapshot()
+        let forwarded = NetmapZeroCopy.forward(from: port0.rxRing(0), to: port1.txRing(0))
+        let after = NetmapZeroCopy.statistics.snapshot()
+
+        #expect(forwarded == 4)
+        // Other tests may forward concurrently, so only check the lower bound
+        #expect(after.zeroCopyPackets - before.zeroCopyPackets >= 4)
+
+        // Across allocators the same call falls back to copying
+        for i in 0..<2 {
+            sim.inject(Data([0xDD, UInt8(i)]), into: "sim0")
+        }
+        try port0.rxSync()
+        let beforeCopy = NetmapZeroCopy.statistics.snapshot()
+        #expect(NetmapZeroCopy.forward(from: port0.rxRing(0), to: port2.txRing(0)) == 2)
+        #expect(NetmapZeroCopy.statistics.snapshot().copiedPackets - beforeCopy.copiedPackets >= 2)
+    }
+
+    @Test("Forwarding statistics sum per-thread counters")
+    func forwardingStatisticsSumThreads() {
+        // A private instance, so concurrent tests don't disturb the totals
+        let statistics = NetmapZeroCopy.Statistics()
+        let threads = 8
+        let calls = 1000
+
+        // Threads exit after each round, so the second round may reuse blocks
+        for _ in 0..<2 {
+            let group = DispatchGroup()
+            for _ in 0..<threads {
+                group.enter()
+                Thread {
+                    for _ in 0..<calls {
+                        statistics.record(zeroCopy: 3, copied: 1)
+                    }
+                    group.leave()
+                }.start()
+            }
+            group.wait()
+        }
+
+        let expected = UInt64(2 * threads * calls)
+        #expect(statistics.snapshot() == .init(zeroCopyPackets: 3 * expected, copiedPackets: expected))
+
+        statistics.reset()
+        #expect(statistics.snapshot() == .init(zeroCopyPackets: 0, copiedPackets: 0))
+        statistics.record(zeroCopy: 2, copied: 0)
+        #expect(statistics.snapshot().zeroCopyPackets == 2)
+    }
 }
 
 // MARK: - Async I/O Tests
@@ -839,6 +913,52 @@ struct AsyncIOTests {
         }
     }
 
+    @Test("sendBurst fills slots in place")
+    func burstTransmit() throws {
+        do {
+            let port = try NetmapPort.open(interface: "vale0:bursttest")
+
+            var freeSlots = 0
+            port.forEachTxRing { ring in
+                freeSlots += Int(ring.space)
+            }
+
+            let requested = freeSlots + 8
+            let result = try port.sendBurst(count: requested) { index, buffer in
+                buffer.storeBytes(of: UInt32(index).bigEndian, as: UInt32.self)
+                return 64
+            }
+
+            #expect(result.requested == requested)
+            #expect(result.sent == freeSlots)
+            #expect(result.unsent == 8)
+            #expect(!result.isComplete)
+            #expect(result.ringsUsed >= 1)
+        } catch NetmapError.openFailed {
+            print("Skipping: netmap device not available")
+        }
+    }
+
+    @Test("sendBurst sends borrowed buffers")
+    func burstTransmitBorrowed() throws {
+        do {
+            let port = try NetmapPort.open(interface: "vale0:burstbuf")
+
+            let storage = UnsafeMutableRawBufferPointer.allocate(byteCount: 16 * 60, alignment: 64)
+            defer { storage.deallocate() }
+            storage.initializeMemory(as: UInt8.self, repeating: 0xEE)
+
+            let buffers = (0..<16).map { i in
+                UnsafeRawBufferPointer(rebasing: storage[(i * 60)..<((i + 1) * 60)])
+            }
+            let result = try port.sendBurst(buffers)
+
+            #expect(result.sent + result.unsent == 16)
+        } catch NetmapError.openFailed {
+            print("Skipping: netmap device not available")
+        }
+    }
+
     @Test("processPackets batch processing")
     func batchProcessing() throws {
         do {
@@ -865,6 +985,128 @@ struct AsyncIOTests {
             print("Skipping: netmap device not available")
         }
     }
+
+    @Test("receiveBatches hands out borrowed packet views")
+    func borrowedBatchReceive() throws {
+        do {
+            let port1 = try NetmapPort.open(interface: "vale0:borrow1")
+            let port2 = try NetmapPort.open(interface: "vale0:borrow2")
+
+            for i in 0..<5 {
+                _ = try port1.sendPacket(Data([UInt8(i), 0xAA, 0xBB, 0xCC]))
+            }
+
+            usleep(50000)
+
+            var lengths: [Int] = []
+            var markers: [UInt8] = []
+            let received = try port2.receiveBatches(timeout: 10) { batch in
+                for packet in batch {
+                    lengths.append(packet.count)
+                    markers.append(packet[1])
+                }
+            }
+
+            // May or may not have received depending on VALE timing
+            #expect(received == lengths.count)
+            #expect(lengths.allSatisfy { $0 >= 4 })
+            #expect(markers.allSatisfy { $0 == 0xAA })
+
+            // Released slots leave the RX rings empty
+            var pending = 0
+            port2.forEachRxRing { ring in
+                pending += Int(ring.space)
+            }
+            #expect(pending == 0 || received == 0)
+        } catch NetmapError.openFailed {
+            print("Skipping: netmap device not available")
+        }
+    }
+}
+
+// MARK: - Worker Group Tests
+
+@Suite("Worker Group Tests")
+struct WorkerGroupTests {
+
+    @Test("NUMA domain lookup ignores non-NIC names")
+    func numaDomainNames() {
+        #expect(NetmapWorkerGroup.numaDomain(of: "vale0:port") == nil)
+        #expect(NetmapWorkerGroup.numaDomain(of: "lo") == nil)
+        #expect(NetmapWorkerGroup.numaDomain(of: "0") == nil)
+    }
+
+    @Test("Worker group counts packets and bytes per ring")
+    func workerGroupCounts() throws {
+        let sim = try NetmapSimulator(.init(name: "sim0", txRings: 2, rxRings: 2, slotsPerRing: 64))
+        let group = NetmapWorkerGroup(
+            configuration: .init(interface: "sim0", rings: [0, 1], cpus: [], numaAware: false, pollTimeout: 10),
+            handler: { _, _ in },
+            openPort: { _, _ in try sim.openPort("sim0") }
+        )
+
+        try group.start()
+        for i in 0..<8 {
+            sim.inject(Data(repeating: UInt8(i), count: 60), into: "sim0", ring: 0)
+        }
+        for i in 0..<3 {
+            sim.inject(Data(repeating: UInt8(i), count: 128), into: "sim0", ring: 1)
+        }
+
+        let deadline = ContinuousClock.now + .seconds(5)
+        var stats = group.statistics()
+        while stats.reduce(0, { $0 + $1.packets }) < 11, ContinuousClock.now < deadline {
+            usleep(1000)
+            stats = group.statistics()
+        }
+        group.stop()
+
+        let byRing = Dictionary(uniqueKeysWithValues: stats.map { ($0.ring, $0) })
+        #expect(byRing[0]?.packets == 8)
+        #expect(byRing[0]?.bytes == 8 * 60)
+        #expect(byRing[1]?.packets == 3)
+        #expect(byRing[1]?.bytes == 3 * 128)
+        #expect(stats.allSatisfy { $0.failure == nil && $0.cpu == nil })
+        #expect(group.statistics().isEmpty)
+    }
+
+    @Test("Concurrent start() opens each ring once")
+    func workerGroupConcurrentStart() throws {
+        let sim = try NetmapSimulator(.init(name: "sim0", txRings: 2, rxRings: 2, slotsPerRing: 64))
+        let opens = OpenCounter()
+        let group = NetmapWorkerGroup(
+            configuration: .init(interface: "sim0", rings: [0, 1], cpus: [], numaAware: false, pollTimeout: 10),
+            handler: { _, _ in },
+            openPort: { _, _ in
+                opens.increment()
+                return try sim.openPort("sim0")
+            }
+        )
+
+        DispatchQueue.concurrentPerform(iterations: 8) { _ in
+            try? group.start()
+        }
+        #expect(opens.value == 2)
+        #expect(group.statistics().count == 2)
+        group.stop()
+    }
+}
+
+private final class OpenCounter: @unchecked Sendable {
+    private let lock = NSLock()
+    private var count = 0
+
+    func increment() {
+        lock.lock()
+        count += 1
+        lock.unlock()
+    }
+
+    var value: Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return count
+    }
 }
 
 // MARK: - Host Ring Tests